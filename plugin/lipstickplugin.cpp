@@ -17,7 +17,9 @@
 #include "lipstickplugin.h"
 
 #include <QtQml>
+#include <components/launchericonprovider.h>
 #include <components/launcheritem.h>
+#include <components/launchersearchmodel.h>
 #include <components/launcherwatchermodel.h>
 #include <notifications/notificationpreviewpresenter.h>
 #include <notifications/notificationfeedbackplayer.h>
@@ -55,6 +57,7 @@ void LipstickPlugin::registerTypes(const char *uri)
     qmlRegisterType<LauncherItem>("org.nemomobile.lipstick", 0, 1, "LauncherItem");
     qmlRegisterType<LauncherFolderModelType>("org.nemomobile.lipstick", 0, 1, "LauncherFolderModel");
     qmlRegisterType<LauncherFolderItem>("org.nemomobile.lipstick", 0, 1, "LauncherFolderItem");
+    qmlRegisterType<LauncherSearchModel>("org.nemomobile.lipstick", 0, 1, "LauncherSearchModel");
 
     qmlRegisterUncreatableType<NotificationPreviewPresenter>("org.nemomobile.lipstick", 0, 1, "NotificationPreviewPresenter", "This type is initialized by HomeApplication");
     qmlRegisterUncreatableType<NotificationFeedbackPlayer>("org.nemomobile.lipstick", 0, 1, "NotificationFeedbackPlayer", "This type is initialized by HomeApplication");
@@ -70,9 +73,17 @@ void LipstickPlugin::registerTypes(const char *uri)
     qmlRegisterType<WindowProperty>("org.nemomobile.lipstick", 0, 1, "WindowProperty");
     qmlRegisterSingletonType<LipstickApi>("org.nemomobile.lipstick", 0, 1, "Lipstick", lipstickApi_callback);
     qmlRegisterUncreatableType<ScreenshotResult>("org.nemomobile.lipstick", 0, 1, "ScreenshotResult", "This type is initialized by LipstickApi");
+    qmlRegisterUncreatableType<ScreenshotBurst>("org.nemomobile.lipstick", 0, 1, "ScreenshotBurst", "This type is initialized by LipstickApi");
 
     qmlRegisterType<LipstickCompositorWindow>();
     qmlRegisterType<QObjectListModel>();
 
     qmlRegisterRevision<QQuickWindow,1>("org.nemomobile.lipstick", 0, 1);
 }
+
+void LipstickPlugin::initializeEngine(QQmlEngine *engine, const char *uri)
+{
+    Q_UNUSED(uri);
+
+    engine->addImageProvider(LauncherIconProvider::providerId(), new LauncherIconProvider);
+}
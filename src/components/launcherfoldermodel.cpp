@@ -20,7 +20,12 @@
 #include <QXmlStreamWriter>
 #include <QFile>
 #include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
 #include <QTemporaryFile>
+#include <QThreadPool>
 #include <QStandardPaths>
 #include <QDir>
 #include <QStack>
@@ -70,11 +75,270 @@ struct FolderItem {
     LauncherItem *item;
 };
 
+// Compact form of a menu file. Menus are stored in document order, the
+// first one being the top level menu.
+struct LauncherMenuEntry
+{
+    LauncherMenuEntry()
+        : menu(-1)
+    {
+    }
+
+    explicit LauncherMenuEntry(const QString &filename)
+        : filename(filename)
+        , menu(-1)
+    {
+    }
+
+    explicit LauncherMenuEntry(int menu)
+        : menu(menu)
+    {
+    }
+
+    bool operator==(const LauncherMenuEntry &other) const
+    {
+        return menu == other.menu && filename == other.filename;
+    }
+
+    QString filename;
+    int menu; // Index of a sub menu, or -1 for an application
+};
+
+struct LauncherMenu
+{
+    bool operator==(const LauncherMenu &other) const
+    {
+        return name == other.name && directory == other.directory && entries == other.entries;
+    }
+
+    QString name;
+    QString directory;
+    QVector<LauncherMenuEntry> entries;
+};
+
+static QVector<LauncherMenu> readMenus(QIODevice *device)
+{
+    QVector<LauncherMenu> menus;
+    QStack<int> openMenus;
+    QString textData;
+
+    QXmlStreamReader xml(device);
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement()) {
+            if (xml.name() == QLatin1String("Menu")) {
+                if (!openMenus.isEmpty()) {
+                    menus[openMenus.top()].entries.append(LauncherMenuEntry(menus.count()));
+                }
+                openMenus.push(menus.count());
+                menus.append(LauncherMenu());
+            }
+        } else if (xml.isEndElement()) {
+            if (xml.name() == QLatin1String("Menu")) {
+                if (!openMenus.isEmpty()) {
+                    openMenus.pop();
+                }
+            } else if (!openMenus.isEmpty()) {
+                LauncherMenu &menu = menus[openMenus.top()];
+                if (xml.name() == QLatin1String("Name")) {
+                    menu.name = textData;
+                } else if (xml.name() == QLatin1String("Directory")) {
+                    menu.directory = textData;
+                } else if (xml.name() == QLatin1String("Filename")) {
+                    menu.entries.append(LauncherMenuEntry(textData));
+                }
+            }
+            textData.clear();
+        } else if (xml.isCharacters()) {
+            textData = xml.text().toString();
+        }
+    }
+
+    return menus;
+}
+
+static void writeMenu(QXmlStreamWriter &xml, const QVector<LauncherMenu> &menus, int menuIndex)
+{
+    const LauncherMenu &menu = menus.at(menuIndex);
+
+    xml.writeStartElement("Menu");
+    xml.writeTextElement("Name", menu.name);
+    if (!menu.directory.isEmpty())
+        xml.writeTextElement("Directory", menu.directory);
+
+    for (const LauncherMenuEntry &entry : menu.entries) {
+        if (entry.menu >= 0) {
+            writeMenu(xml, menus, entry.menu);
+        } else {
+            xml.writeTextElement("Filename", entry.filename);
+        }
+    }
+    xml.writeEndElement();
+}
+
+// Writes menu and .directory files on a background thread. Files are
+// replaced atomically, and writes requested before the previous ones have
+// been picked up are merged so that only the latest content is written.
+class LauncherFolderWriter
+{
+public:
+    LauncherFolderWriter();
+    ~LauncherFolderWriter();
+
+    void setSaved(const QString &menuFile, const QVector<LauncherMenu> &menus);
+    void write(const QString &menuFile, const QVector<LauncherMenu> &menus,
+               const QHash<QString, QString> &directoryIcons);
+
+    void writePending();
+
+private:
+    static void writeMenuFile(const QString &menuFile, const QVector<LauncherMenu> &menus);
+    static void writeDirectoryFile(const QString &directoryFile, const QString &iconId);
+
+    // Last menu handed to the writer, only accessed from the GUI thread
+    QString m_savedMenuFile;
+    QVector<LauncherMenu> m_savedMenus;
+
+    QMutex m_mutex;
+    QHash<QString, QVector<LauncherMenu> > m_pendingMenus;
+    QHash<QString, QString> m_pendingDirectoryIcons;
+    bool m_writeScheduled;
+    QThreadPool m_pool;
+};
+
+class LauncherFolderWriteJob : public QRunnable
+{
+public:
+    explicit LauncherFolderWriteJob(LauncherFolderWriter *writer)
+        : m_writer(writer)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        m_writer->writePending();
+    }
+
+private:
+    LauncherFolderWriter * const m_writer;
+};
+
+LauncherFolderWriter::LauncherFolderWriter()
+    : m_writeScheduled(false)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+LauncherFolderWriter::~LauncherFolderWriter()
+{
+    m_pool.waitForDone();
+}
+
+void LauncherFolderWriter::setSaved(const QString &menuFile, const QVector<LauncherMenu> &menus)
+{
+    m_savedMenuFile = menuFile;
+    m_savedMenus = menus;
+}
+
+void LauncherFolderWriter::write(const QString &menuFile, const QVector<LauncherMenu> &menus,
+                                 const QHash<QString, QString> &directoryIcons)
+{
+    const bool menuChanged = menuFile != m_savedMenuFile || !(menus == m_savedMenus);
+    if (!menuChanged && directoryIcons.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (menuChanged) {
+        m_pendingMenus.insert(menuFile, menus);
+        setSaved(menuFile, menus);
+    }
+    for (QHash<QString, QString>::const_iterator it = directoryIcons.constBegin(); it != directoryIcons.constEnd(); ++it) {
+        m_pendingDirectoryIcons.insert(it.key(), it.value());
+    }
+
+    if (!m_writeScheduled) {
+        m_writeScheduled = true;
+        m_pool.start(new LauncherFolderWriteJob(this));
+    }
+}
+
+void LauncherFolderWriter::writePending()
+{
+    QHash<QString, QVector<LauncherMenu> > menus;
+    QHash<QString, QString> directoryIcons;
+    {
+        QMutexLocker locker(&m_mutex);
+        menus.swap(m_pendingMenus);
+        directoryIcons.swap(m_pendingDirectoryIcons);
+        m_writeScheduled = false;
+    }
+
+    for (QHash<QString, QString>::const_iterator it = directoryIcons.constBegin(); it != directoryIcons.constEnd(); ++it) {
+        writeDirectoryFile(it.key(), it.value());
+    }
+
+    for (QHash<QString, QVector<LauncherMenu> >::const_iterator it = menus.constBegin(); it != menus.constEnd(); ++it) {
+        writeMenuFile(it.key(), it.value());
+    }
+}
+
+void LauncherFolderWriter::writeMenuFile(const QString &menuFile, const QVector<LauncherMenu> &menus)
+{
+    QSaveFile file(menuFile);
+    if (menus.isEmpty() || !file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to save apps menu" << menuFile;
+        return;
+    }
+
+    QXmlStreamWriter xml(&file);
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+    writeMenu(xml, menus, 0);
+    xml.writeEndDocument();
+
+    if (!file.commit()) {
+        qWarning() << "Failed to save apps menu" << menuFile << file.errorString();
+    }
+}
+
+void LauncherFolderWriter::writeDirectoryFile(const QString &directoryFile, const QString &iconId)
+{
+    GKeyFile *keyfile = g_key_file_new();
+    GError *err = NULL;
+
+    // Keep whatever else the file contains
+    g_key_file_load_from_file(keyfile, directoryFile.toLatin1(), G_KEY_FILE_NONE, NULL);
+    g_key_file_set_string(keyfile, "Desktop Entry", "Icon", iconId.toLatin1());
+
+    gsize length = 0;
+    gchar *data = g_key_file_to_data(keyfile, &length, &err);
+    g_key_file_free(keyfile);
+
+    if (err != NULL) {
+        qWarning() << "Failed to save .directory file" << err->message;
+        g_error_free(err);
+        return;
+    }
+
+    QSaveFile file(directoryFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot open" << directoryFile;
+    } else {
+        file.write(data, length);
+        if (!file.commit()) {
+            qWarning() << "Cannot write" << directoryFile << file.errorString();
+        }
+    }
+    g_free(data);
+}
+
 // This is modeled after the freedesktop.org menu files http://standards.freedesktop.org/menu-spec/latest/
 // but handles only the basic elements, i.e. no merging, filtering, layout, etc. is supported.
 
 LauncherFolderItem::LauncherFolderItem(QObject *parent)
-    : QObjectListModel(parent), m_iconId(DEFAULT_ICON_ID)
+    : QObjectListModel(parent), m_iconId(DEFAULT_ICON_ID), m_directoryFileDirty(false)
 {
     connect(this, SIGNAL(itemRemoved(QObject*)), this, SLOT(handleRemoved(QObject*)));
     connect(this, SIGNAL(itemAdded(QObject*)), this, SLOT(handleAdded(QObject*)));
@@ -243,39 +507,23 @@ void LauncherFolderItem::loadDirectoryFile(const QString &filename)
     g_key_file_free(keyfile);
 }
 
+// The file content is written by the folder model with its next save
 void LauncherFolderItem::saveDirectoryFile()
 {
-    QScopedPointer<QFile> dirFile;
     if (m_directoryFile.isEmpty()) {
-        QTemporaryFile *tempFile = new QTemporaryFile(absoluteConfigPath("FolderXXXXXX.directory"));
-        dirFile.reset(tempFile);
-        tempFile->open();
-        tempFile->setAutoRemove(false);
-        m_directoryFile = tempFile->fileName();
+        // Reserve a unique name right away, the menu refers to it
+        QTemporaryFile tempFile(absoluteConfigPath("FolderXXXXXX.directory"));
+        if (!tempFile.open()) {
+            qWarning() << "Cannot open" << tempFile.fileTemplate();
+            return;
+        }
+        tempFile.setAutoRemove(false);
+        m_directoryFile = tempFile.fileName();
         emit directoryFileChanged();
-        emit saveNeeded();
-    } else {
-        dirFile.reset(new QFile(m_directoryFile));
-        dirFile.data()->open(QIODevice::WriteOnly);
-    }
-
-    if (!dirFile.data()->isOpen()) {
-        qWarning() << "Cannot open" << m_directoryFile;
-        return;
     }
 
-    GKeyFile *keyfile = g_key_file_new();
-    GError *err = NULL;
-
-    g_key_file_load_from_file(keyfile, m_directoryFile.toLatin1(), G_KEY_FILE_NONE, &err);
-    g_key_file_set_string(keyfile, "Desktop Entry", "Icon", m_iconId.toLatin1());
-
-    gchar *data = g_key_file_to_data(keyfile, NULL, &err);
-    dirFile.data()->write(data);
-    dirFile.data()->close();
-    g_free(data);
-
-    g_key_file_free(keyfile);
+    m_directoryFileDirty = true;
+    emit saveNeeded();
 }
 
 void LauncherFolderItem::clear()
@@ -373,6 +621,7 @@ public:
 LauncherFolderModel::LauncherFolderModel(QObject *parent)
     : LauncherFolderItem(parent)
     , m_launcherModel(new DeferredLauncherModel(this))
+    , m_writer(new LauncherFolderWriter)
     , m_loading(false)
     , m_initialized(false)
 {
@@ -388,6 +637,7 @@ LauncherFolderModel::LauncherFolderModel(QObject *parent)
 LauncherFolderModel::LauncherFolderModel(InitializationMode, QObject *parent)
     : LauncherFolderItem(parent)
     , m_launcherModel(new DeferredLauncherModel(this))
+    , m_writer(new LauncherFolderWriter)
     , m_loading(false)
     , m_initialized(false)
 {
@@ -398,6 +648,16 @@ LauncherFolderModel::LauncherFolderModel(InitializationMode, QObject *parent)
     connect(m_launcherModel, &LauncherModel::categoriesChanged, this, &LauncherFolderModel::categoriesChanged);
 }
 
+LauncherFolderModel::~LauncherFolderModel()
+{
+    // Don't lose changes that are still waiting for the save timer
+    if (m_saveTimer.isActive())
+        save();
+
+    // Waits for pending writes to finish
+    delete m_writer;
+}
+
 void LauncherFolderModel::initialize()
 {
     if (m_initialized)
@@ -691,31 +951,31 @@ static QString configurationFileForScope(const QString &scope)
 void LauncherFolderModel::save()
 {
     m_saveTimer.stop();
-    QFile file(configurationFileForScope(m_launcherModel->scope()));
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to save apps menu" << configFile();
-        return;
-    }
 
     // Folder might have been removed. Let's update blacklisted apps and their folders.
     // When folder is removed, an app is shifted back to main level.
     updateAppsInBlacklistedFolders();
 
-    QXmlStreamWriter xml(&file);
-    xml.setAutoFormatting(true);
-    xml.writeStartDocument();
+    QVector<LauncherMenu> menus;
+    QHash<QString, QString> directoryIcons;
+    snapshotFolder(menus, directoryIcons, this, QString());
 
-    QString directoryId;
-    saveFolder(xml, this, directoryId);
-    xml.writeEndDocument();
+    // Only changed files are written, and that happens in the background
+    m_writer->write(configurationFileForScope(m_launcherModel->scope()), menus, directoryIcons);
 }
 
-void LauncherFolderModel::saveFolder(QXmlStreamWriter &xml, LauncherFolderItem *folder, const QString &directoryId)
+int LauncherFolderModel::snapshotFolder(QVector<LauncherMenu> &menus, QHash<QString, QString> &directoryIcons,
+                                        LauncherFolderItem *folder, const QString &directoryId)
 {
-    xml.writeStartElement("Menu");
-    xml.writeTextElement("Name", folder->title());
-    if (!folder->directoryFile().isEmpty())
-        xml.writeTextElement("Directory", folder->directoryFile());
+    const int menuIndex = menus.count();
+    menus.append(LauncherMenu());
+    menus[menuIndex].name = folder->title();
+    menus[menuIndex].directory = folder->directoryFile();
+
+    if (folder->m_directoryFileDirty) {
+        folder->m_directoryFileDirty = false;
+        directoryIcons.insert(folder->directoryFile(), folder->iconId());
+    }
 
     for (int i = 0; i < folder->rowCount(); ++i) {
         LauncherItem *item = qobject_cast<LauncherItem*>(folder->get(i));
@@ -745,19 +1005,21 @@ void LauncherFolderModel::saveFolder(QXmlStreamWriter &xml, LauncherFolderItem *
 
         for (const QString &desktopFile : desktopFiles) {
             if (LauncherItem * item = m_launcherModel->itemInModel(desktopFile)) {
-                xml.writeTextElement("Filename", item->filename());
+                menus[menuIndex].entries.append(LauncherMenuEntry(item->filename()));
             }
         }
 
         if (item) {
             if (!item->isTemporary()) {
-                xml.writeTextElement("Filename", item->filename());
+                menus[menuIndex].entries.append(LauncherMenuEntry(item->filename()));
             }
         } else if (subFolder) {
-            saveFolder(xml, subFolder, subFolder->directoryFile());
+            const int subMenuIndex = snapshotFolder(menus, directoryIcons, subFolder, subFolder->directoryFile());
+            menus[menuIndex].entries.append(LauncherMenuEntry(subMenuIndex));
         }
     }
-    xml.writeEndElement();
+
+    return menuIndex;
 }
 
 void LauncherFolderModel::load()
@@ -765,7 +1027,8 @@ void LauncherFolderModel::load()
     m_loading = true;
     clear();
 
-    QFile file(configurationFileForScope(m_launcherModel->scope()));
+    const QString menuFile = configurationFileForScope(m_launcherModel->scope());
+    QFile file(menuFile);
     if (!file.open(QIODevice::ReadOnly)) {
         // We haven't saved a folder model yet - import all apps.
         import();
@@ -773,83 +1036,91 @@ void LauncherFolderModel::load()
         return;
     }
 
+    // Parse the whole menu first, so that each folder can be populated at once
+    const QVector<LauncherMenu> menus = readMenus(&file);
+    m_writer->setSaved(menuFile, menus);
+
+    // Resolve entries by path or file name like LauncherModel::indexInModel(),
+    // where the first item in the model wins
+    QHash<QString, int> itemIndices;
+    for (int i = m_launcherModel->itemCount() - 1; i >= 0; --i) {
+        if (LauncherItem *item = qobject_cast<LauncherItem*>(m_launcherModel->get(i))) {
+            itemIndices.insert(item->filename(), i);
+            itemIndices.insert(item->filePath(), i);
+        }
+    }
+
     QVector<bool> loadedItems(m_launcherModel->itemCount());
     loadedItems.fill(false);
-    QStack<LauncherFolderItem*> menus;
-    QString textData;
 
-    QXmlStreamReader xml(&file);
-    while (!xml.atEnd()) {
-        xml.readNext();
-        if (xml.isStartElement()) {
-            if (xml.name() == QLatin1String("Menu")) {
-                LauncherFolderItem *folder = 0;
-                if (menus.isEmpty())
-                    folder = this;
-                else
-                    folder = new LauncherFolderItem(this);
-                if (!menus.isEmpty()) {
-                    folder->setParentFolder(menus.top());
-                    menus.top()->addItem(folder);
-                }
-                menus.push(folder);
-            }
-        } else if (xml.isEndElement()) {
-            if (xml.name() == QLatin1String("Menu")) {
-                menus.pop();
-            } else if (xml.name() == QLatin1String("Name")) {
-                if (!menus.isEmpty()) {
-                    menus.top()->setTitle(textData);
-                }
-            } else if (xml.name() == QLatin1String("Directory")) {
-                if (!menus.isEmpty()) {
-                    LauncherFolderItem *folder = menus.top();
-                    folder->loadDirectoryFile(textData);
-                }
-            } else if (xml.name() == QLatin1String("Filename")) {
-                if (!menus.isEmpty()) {
-                    int idx = m_launcherModel->indexInModel(textData);
-                    if (idx >= 0) {
-                        loadedItems[idx] = true;
-                        LauncherItem *item = qobject_cast<LauncherItem*>(m_launcherModel->get(idx));
-                        if (item) {
-                            LauncherFolderItem *folder = menus.top();
-                            if (!item->isBlacklisted()) {
-                                folder->addItem(item);
-                            } else {
-                                QString positionId;
-                                // Current count == normal index.
-                                int lastIndex = folder->itemCount();
-                                if (!folder->parentFolder()) {
-                                    positionId = QString::number(lastIndex);
-                                } else {
-                                    positionId = QString("%1-%2").arg(folder->directoryFile()).arg(lastIndex);
-                                }
-
-                                m_blacklistedApplications.insert(item->filePath(), positionId);
-                            }
-                        }
-                    }
-                }
-            }
-            textData.clear();
-        } else if (xml.isCharacters()) {
-            textData = xml.text().toString();
-        }
+    if (!menus.isEmpty()) {
+        buildFolder(menus, 0, this, itemIndices, loadedItems);
     }
 
+    QList<QObject *> unloadedItems;
     for (int i = 0; i < loadedItems.count(); ++i) {
         if (!loadedItems.at(i)) {
             LauncherItem *item = qobject_cast<LauncherItem*>(m_launcherModel->get(i));
             if (item) {
                 if (!item->isBlacklisted()) {
-                    addItem(item);
+                    unloadedItems.append(item);
                 } else {
-                    m_blacklistedApplications.insert(item->filePath(), QString::number(itemCount()));
+                    m_blacklistedApplications.insert(item->filePath(), QString::number(itemCount() + unloadedItems.count()));
                 }
             }
         }
     }
+    addItems(unloadedItems);
 
     m_loading = false;
 }
+
+void LauncherFolderModel::buildFolder(const QVector<LauncherMenu> &menus, int menuIndex, LauncherFolderItem *folder,
+                                      const QHash<QString, int> &itemIndices, QVector<bool> &loadedItems)
+{
+    const LauncherMenu &menu = menus.at(menuIndex);
+
+    folder->setTitle(menu.name);
+    if (!menu.directory.isEmpty()) {
+        folder->loadDirectoryFile(menu.directory);
+    }
+
+    QList<QObject *> items;
+    for (const LauncherMenuEntry &entry : menu.entries) {
+        if (entry.menu >= 0) {
+            LauncherFolderItem *subFolder = new LauncherFolderItem(this);
+            subFolder->setParentFolder(folder);
+            buildFolder(menus, entry.menu, subFolder, itemIndices, loadedItems);
+            items.append(subFolder);
+            continue;
+        }
+
+        const int idx = itemIndices.value(entry.filename, -1);
+        if (idx < 0) {
+            continue;
+        }
+
+        loadedItems[idx] = true;
+        LauncherItem *item = qobject_cast<LauncherItem*>(m_launcherModel->get(idx));
+        if (!item) {
+            continue;
+        }
+
+        if (!item->isBlacklisted()) {
+            items.append(item);
+        } else {
+            QString positionId;
+            // Current count == normal index.
+            int lastIndex = items.count();
+            if (!folder->parentFolder()) {
+                positionId = QString::number(lastIndex);
+            } else {
+                positionId = QString("%1-%2").arg(folder->directoryFile()).arg(lastIndex);
+            }
+
+            m_blacklistedApplications.insert(item->filePath(), positionId);
+        }
+    }
+
+    folder->addItems(items);
+}
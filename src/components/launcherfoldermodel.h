@@ -16,8 +16,10 @@
 #ifndef LAUNCHERFOLDERMODEL_H
 #define LAUNCHERFOLDERMODEL_H
 
+#include <QHash>
 #include <QObject>
 #include <QStringList>
+#include <QVector>
 #include <QPointer>
 #include <QSharedPointer>
 #include <QTimer>
@@ -26,9 +28,10 @@
 #include "lipstickglobal.h"
 
 class LauncherModel;
-class QXmlStreamWriter;
 class MDesktopEntry;
 class LauncherItem;
+class LauncherFolderWriter;
+struct LauncherMenu;
 
 class LIPSTICK_EXPORT LauncherFolderItem : public QObjectListModel
 {
@@ -86,6 +89,9 @@ private:
     QString m_directoryFile;
     QSharedPointer<MDesktopEntry> m_desktopEntry;
     QPointer<LauncherFolderItem> m_parentFolder;
+    bool m_directoryFileDirty;
+
+    friend class LauncherFolderModel;
 };
 
 class DeferredLauncherModel;
@@ -100,6 +106,7 @@ class LIPSTICK_EXPORT LauncherFolderModel : public LauncherFolderItem
     Q_PROPERTY(LauncherModel *allItems READ allItems CONSTANT)
 public:
     LauncherFolderModel(QObject *parent = 0);
+    ~LauncherFolderModel();
 
     LauncherModel *allItems() const;
 
@@ -157,13 +164,17 @@ private slots:
     void updateblacklistedApplications();
 
 private:
-    void saveFolder(QXmlStreamWriter &xml, LauncherFolderItem *folder, const QString &directoryId);
+    int snapshotFolder(QVector<LauncherMenu> &menus, QHash<QString, QString> &directoryIcons,
+                       LauncherFolderItem *folder, const QString &directoryId);
+    void buildFolder(const QVector<LauncherMenu> &menus, int menuIndex, LauncherFolderItem *folder,
+                     const QHash<QString, int> &itemIndices, QVector<bool> &loadedItems);
     void blacklistApps(LauncherFolderItem *folder, const QString &directoryId);
     void removeAppsFromBlacklist();
     void updateAppsInBlacklistedFolders();
     LauncherFolderItem *findContainerFolder(const QString &directoryId) const;
 
     DeferredLauncherModel *m_launcherModel;
+    LauncherFolderWriter *m_writer;
     QTimer m_saveTimer;
     bool m_loading;
     bool m_initialized;
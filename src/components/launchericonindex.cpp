@@ -0,0 +1,133 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#include "launchericonindex.h"
+
+#include <QDir>
+
+#include <algorithm>
+
+static const QString IconSuffix = QStringLiteral(".png");
+
+LauncherIconIndex::LauncherIconIndex()
+{
+}
+
+QStringList LauncherIconIndex::directories() const
+{
+    return m_directories;
+}
+
+void LauncherIconIndex::setDirectories(const QStringList &directories)
+{
+    if (m_directories == directories) {
+        return;
+    }
+
+    // Directory priorities are encoded as indices, so any change in the
+    // list invalidates the whole index.
+    m_directories = directories;
+    m_icons.clear();
+
+    for (int i = 0; i < m_directories.count(); ++i) {
+        scanDirectory(i);
+    }
+}
+
+void LauncherIconIndex::scanDirectory(int index)
+{
+    const QDir dir(m_directories.at(index));
+    const QStringList entries = dir.entryList(QStringList() << QStringLiteral("*.png"), QDir::Files);
+
+    for (const QString &entry : entries) {
+        QVector<int> &providers = m_icons[entry.left(entry.length() - IconSuffix.length())];
+        // Directories are scanned in priority order, so appending keeps the list sorted
+        if (providers.isEmpty() || providers.last() != index) {
+            providers.append(index);
+        }
+    }
+}
+
+int LauncherIconIndex::directoryIndex(const QString &filePath, QString *iconId) const
+{
+    if (!filePath.endsWith(IconSuffix)) {
+        return -1;
+    }
+
+    const int slash = filePath.lastIndexOf(QLatin1Char('/')) + 1;
+    const int index = m_directories.indexOf(filePath.left(slash));
+    if (index >= 0 && iconId) {
+        *iconId = filePath.mid(slash, filePath.length() - slash - IconSuffix.length());
+    }
+    return index;
+}
+
+QString LauncherIconIndex::iconPath(const QString &iconId) const
+{
+    QHash<QString, QVector<int> >::const_iterator it = m_icons.constFind(iconId);
+    if (it == m_icons.constEnd() || it->isEmpty()) {
+        return QString();
+    }
+
+    return m_directories.at(it->first()) + iconId + IconSuffix;
+}
+
+QString LauncherIconIndex::iconIdForPath(const QString &filePath) const
+{
+    QString iconId;
+    directoryIndex(filePath, &iconId);
+    return iconId;
+}
+
+bool LauncherIconIndex::addFile(const QString &filePath)
+{
+    QString iconId;
+    const int index = directoryIndex(filePath, &iconId);
+    if (index < 0 || iconId.isEmpty()) {
+        return false;
+    }
+
+    QVector<int> &providers = m_icons[iconId];
+    QVector<int>::iterator it = std::lower_bound(providers.begin(), providers.end(), index);
+    if (it == providers.end() || *it != index) {
+        providers.insert(it, index);
+    }
+    return true;
+}
+
+bool LauncherIconIndex::removeFile(const QString &filePath)
+{
+    QString iconId;
+    const int index = directoryIndex(filePath, &iconId);
+    if (index < 0) {
+        return false;
+    }
+
+    QHash<QString, QVector<int> >::iterator it = m_icons.find(iconId);
+    if (it == m_icons.end()) {
+        return false;
+    }
+
+    it->removeAll(index);
+    if (it->isEmpty()) {
+        m_icons.erase(it);
+    }
+    return true;
+}
+
+int LauncherIconIndex::count() const
+{
+    return m_icons.count();
+}
@@ -0,0 +1,58 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#ifndef LAUNCHERICONINDEX_H
+#define LAUNCHERICONINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Maps icon names to icon files in a set of icon directories.
+ *
+ * Each directory is listed once when it is added, after which the index is
+ * kept up to date with addFile() and removeFile() as the launcher monitor
+ * reports changes. When the same icon name exists in several directories the
+ * file from the directory listed first wins, matching the order in which the
+ * directories used to be probed.
+ */
+class LauncherIconIndex
+{
+public:
+    LauncherIconIndex();
+
+    QStringList directories() const;
+    void setDirectories(const QStringList &directories);
+
+    QString iconPath(const QString &iconId) const;
+    QString iconIdForPath(const QString &filePath) const;
+
+    bool addFile(const QString &filePath);
+    bool removeFile(const QString &filePath);
+
+    int count() const;
+
+private:
+    int directoryIndex(const QString &filePath, QString *iconId) const;
+    void scanDirectory(int index);
+
+    QStringList m_directories;
+    // Icon name -> sorted indices of the directories providing it
+    QHash<QString, QVector<int> > m_icons;
+};
+
+#endif // LAUNCHERICONINDEX_H
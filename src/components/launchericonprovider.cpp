@@ -0,0 +1,259 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#include "launchericonprovider.h"
+
+#include <QCache>
+#include <QDebug>
+#include <QImage>
+#include <QImageReader>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSet>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+// Default upper bound for decoded icons, in kilobytes. An 86x86 icon takes
+// about 29 kB, so this holds a few hundred launcher icons.
+#define LAUNCHER_ICON_CACHE_DEFAULT_KB 8192
+
+// Number of threads decoding icons in parallel
+#define LAUNCHER_ICON_DECODE_THREADS 2
+
+class LauncherIconCache
+{
+public:
+    LauncherIconCache();
+
+    QImage image(const QString &iconId, const QSize &size);
+    void preload(const QString &iconId, const QSize &size);
+    void start(QRunnable *runnable);
+
+    int maxCost() const;
+    void setMaxCost(int kilobytes);
+    void clear();
+
+private:
+    static QString key(const QString &iconId, const QSize &size);
+    static QImage decode(const QString &iconId, const QSize &size);
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_decoded;
+    QCache<QString, QImage> m_images;
+    QSet<QString> m_decoding;
+    QThreadPool m_pool;
+};
+
+Q_GLOBAL_STATIC(LauncherIconCache, iconCache)
+
+LauncherIconCache::LauncherIconCache()
+    : m_images(LAUNCHER_ICON_CACHE_DEFAULT_KB)
+{
+    m_pool.setMaxThreadCount(LAUNCHER_ICON_DECODE_THREADS);
+}
+
+QString LauncherIconCache::key(const QString &iconId, const QSize &size)
+{
+    return QStringLiteral("%1@%2x%3").arg(iconId).arg(size.width()).arg(size.height());
+}
+
+QImage LauncherIconCache::decode(const QString &iconId, const QSize &size)
+{
+    // Strip the "#serial=N" suffix LauncherItem uses to force reloads
+    QString path = iconId.section(QLatin1Char('#'), 0, 0);
+    if (!path.startsWith(QLatin1Char('/'))) {
+        path.prepend(QLatin1Char('/'));
+    }
+
+    QImageReader reader(path);
+    QSize scaledSize = reader.size();
+    if (size.isValid() && scaledSize.isValid()
+            && (scaledSize.width() > size.width() || scaledSize.height() > size.height())) {
+        scaledSize.scale(size, Qt::KeepAspectRatio);
+        reader.setScaledSize(scaledSize);
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Failed to decode launcher icon" << path << reader.errorString();
+        return image;
+    }
+
+    // Converting here spares the render thread a conversion on upload
+    return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+QImage LauncherIconCache::image(const QString &iconId, const QSize &size)
+{
+    const QString cacheKey = key(iconId, size);
+
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        if (QImage *cached = m_images.object(cacheKey)) {
+            return *cached;
+        } else if (!m_decoding.contains(cacheKey)) {
+            break;
+        }
+        // Another thread, typically a preload, is already decoding this icon
+        m_decoded.wait(&m_mutex);
+    }
+    m_decoding.insert(cacheKey);
+    locker.unlock();
+
+    const QImage image = decode(iconId, size);
+
+    locker.relock();
+    m_decoding.remove(cacheKey);
+    if (!image.isNull()) {
+        m_images.insert(cacheKey, new QImage(image), qMax(1, image.byteCount() / 1024));
+    }
+    m_decoded.wakeAll();
+
+    return image;
+}
+
+class LauncherIconPreloader : public QRunnable
+{
+public:
+    LauncherIconPreloader(const QString &iconId, const QSize &size)
+        : m_iconId(iconId)
+        , m_size(size)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        iconCache()->image(m_iconId, m_size);
+    }
+
+private:
+    const QString m_iconId;
+    const QSize m_size;
+};
+
+void LauncherIconCache::preload(const QString &iconId, const QSize &size)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        const QString cacheKey = key(iconId, size);
+        if (m_images.contains(cacheKey) || m_decoding.contains(cacheKey)) {
+            return;
+        }
+    }
+
+    m_pool.start(new LauncherIconPreloader(iconId, size));
+}
+
+void LauncherIconCache::start(QRunnable *runnable)
+{
+    m_pool.start(runnable);
+}
+
+int LauncherIconCache::maxCost() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_images.maxCost();
+}
+
+void LauncherIconCache::setMaxCost(int kilobytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.setMaxCost(kilobytes);
+}
+
+void LauncherIconCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.clear();
+}
+
+class LauncherIconResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    LauncherIconResponse(const QString &iconId, const QSize &requestedSize)
+        : m_iconId(iconId)
+        , m_requestedSize(requestedSize)
+    {
+        // Deleted by the QML engine once finished() has been handled
+        setAutoDelete(false);
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override
+    {
+        return m_image.isNull()
+                ? QStringLiteral("Failed to load launcher icon %1").arg(m_iconId)
+                : QString();
+    }
+
+    void run() override
+    {
+        m_image = iconCache()->image(m_iconId, m_requestedSize);
+        emit finished();
+    }
+
+private:
+    const QString m_iconId;
+    const QSize m_requestedSize;
+    QImage m_image;
+};
+
+LauncherIconProvider::LauncherIconProvider()
+{
+}
+
+LauncherIconProvider::~LauncherIconProvider()
+{
+}
+
+QString LauncherIconProvider::providerId()
+{
+    return QStringLiteral("lipstick-launcher-icon");
+}
+
+QQuickImageResponse *LauncherIconProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    LauncherIconResponse *response = new LauncherIconResponse(id, requestedSize);
+    iconCache()->start(response);
+    return response;
+}
+
+void LauncherIconProvider::preload(const QString &iconId, const QSize &size)
+{
+    if (iconId.startsWith(QLatin1Char('/'))) {
+        iconCache()->preload(iconId, size);
+    }
+}
+
+int LauncherIconProvider::cacheSize()
+{
+    return iconCache()->maxCost();
+}
+
+void LauncherIconProvider::setCacheSize(int kilobytes)
+{
+    iconCache()->setMaxCost(kilobytes);
+}
+
+void LauncherIconProvider::clearCache()
+{
+    iconCache()->clear();
+}
@@ -0,0 +1,51 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#ifndef LAUNCHERICONPROVIDER_H
+#define LAUNCHERICONPROVIDER_H
+
+#include <QQuickAsyncImageProvider>
+
+#include "lipstickglobal.h"
+
+/**
+ * Image provider for launcher icon files.
+ *
+ * Icons are decoded and scaled down to the requested source size on a
+ * worker thread and kept in a process wide cache bounded by memory use, so
+ * that the launcher grid can be painted from already decoded images. The
+ * same cache is filled ahead of time by LauncherModel::preloadIconSize.
+ *
+ * Use as "image://lipstick-launcher-icon/" + LauncherItem::iconId for items
+ * whose icon id is an absolute file path.
+ */
+class LIPSTICK_EXPORT LauncherIconProvider : public QQuickAsyncImageProvider
+{
+public:
+    LauncherIconProvider();
+    ~LauncherIconProvider();
+
+    static QString providerId();
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+    static void preload(const QString &iconId, const QSize &size);
+
+    static int cacheSize();
+    static void setCacheSize(int kilobytes);
+    static void clearCache();
+};
+
+#endif // LAUNCHERICONPROVIDER_H
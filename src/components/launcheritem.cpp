@@ -319,6 +319,11 @@ QStringList LauncherItem::mimeType() const
     return !m_desktopEntry.isNull() ? m_desktopEntry->mimeType() : QStringList();
 }
 
+QStringList LauncherItem::keywords() const
+{
+    return readValue("Keywords").split(QLatin1Char(';'), QString::SkipEmptyParts);
+}
+
 QString LauncherItem::titleUnlocalized() const
 {
     if (m_isTemporary) {
@@ -55,6 +55,7 @@ class LIPSTICK_EXPORT LauncherItem : public QObject
     Q_PROPERTY(QString iconId READ iconId NOTIFY itemChanged)
     Q_PROPERTY(QStringList desktopCategories READ desktopCategories NOTIFY itemChanged)
     Q_PROPERTY(QStringList mimeType READ mimeType NOTIFY itemChanged)
+    Q_PROPERTY(QStringList keywords READ keywords NOTIFY itemChanged)
     Q_PROPERTY(QString titleUnlocalized READ titleUnlocalized NOTIFY itemChanged)
     Q_PROPERTY(bool shouldDisplay READ shouldDisplay NOTIFY itemChanged)
     Q_PROPERTY(bool isSandboxed READ isSandboxed NOTIFY itemChanged)
@@ -88,6 +89,7 @@ public:
     QString iconId() const;
     QStringList desktopCategories() const;
     QStringList mimeType() const;
+    QStringList keywords() const;
     QString titleUnlocalized() const;
     bool shouldDisplay() const;
     bool isSandboxed() const;
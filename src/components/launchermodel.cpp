@@ -15,13 +15,14 @@
 // Copyright (c) 2012, Timur Kristóf <venemo@fedoraproject.org>
 
 #include <QDir>
-#include <QFileSystemWatcher>
 #include <QDBusConnection>
 #include <QDebug>
 #include <QFile>
+#include <QSet>
 #include <QSettings>
 #include <QStandardPaths>
 
+#include "launchericonprovider.h"
 #include "launcheritem.h"
 #include "launchermodel.h"
 
@@ -54,11 +55,6 @@ static inline bool isIconFile(const QString &filename)
     return filename.startsWith(QLatin1Char('/')) && filename.endsWith(".png");
 }
 
-static inline QString filenameFromIconId(const QString &filename, const QString &path)
-{
-    return QString("%1%2%3").arg(path).arg(filename).arg(".png");
-}
-
 static inline bool isVisibleDesktopFile(const QString &filename)
 {
     LauncherItem item(filename);
@@ -66,6 +62,16 @@ static inline bool isVisibleDesktopFile(const QString &filename)
     return item.isValid() && item.shouldDisplay();
 }
 
+static QString launcherOrderFile()
+{
+    return QSettings("nemomobile", "lipstick").fileName();
+}
+
+static QString launcherOrderGroup(const QString &prefix)
+{
+    return prefix.left(prefix.count() - 1);
+}
+
 static QStringList defaultDirectories()
 {
     QString userLocalAppsPath = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
@@ -83,15 +89,16 @@ LauncherModel::LauncherModel(QObject *parent) :
     QObjectListModel(parent),
     m_directories(defaultDirectories()),
     m_iconDirectories(LAUNCHER_ICONS_PATH),
-    m_fileSystemWatcher(),
-    m_launcherSettings("nemomobile", "lipstick"),
+    m_launcherOrder(launcherOrderFile()),
     m_globalSettings("/usr/share/lipstick/lipstick.conf", QSettings::IniFormat),
     m_launcherOrderPrefix(QStringLiteral("LauncherOrder/")),
     m_dbusWatcher(this),
     m_packageNameToDBusService(),
     m_temporaryLaunchers(),
-    m_initialized(false)
+    m_initialized(false),
+    m_reordering(false)
 {
+    m_launcherOrder.setGroup(launcherOrderGroup(m_launcherOrderPrefix));
     initialize();
 }
 
@@ -99,15 +106,16 @@ LauncherModel::LauncherModel(InitializationMode, QObject *parent) :
     QObjectListModel(parent),
     m_directories(defaultDirectories()),
     m_iconDirectories(LAUNCHER_ICONS_PATH),
-    m_fileSystemWatcher(),
-    m_launcherSettings("nemomobile", "lipstick"),
+    m_launcherOrder(launcherOrderFile()),
     m_globalSettings("/usr/share/lipstick/lipstick.conf", QSettings::IniFormat),
     m_launcherOrderPrefix(QStringLiteral("LauncherOrder/")),
     m_dbusWatcher(this),
     m_packageNameToDBusService(),
     m_temporaryLaunchers(),
-    m_initialized(false)
+    m_initialized(false),
+    m_reordering(false)
 {
+    m_launcherOrder.setGroup(launcherOrderGroup(m_launcherOrderPrefix));
 }
 
 void LauncherModel::initialize()
@@ -124,6 +132,7 @@ void LauncherModel::initialize()
 
     m_launcherMonitor.setDirectories(m_directories);
     m_launcherMonitor.setIconDirectories(iconDirectories);
+    m_iconIndex.setDirectories(iconDirectories);
 
     // Set up the monitor for icon and desktop file changes
     connect(&m_launcherMonitor, SIGNAL(filesUpdated(const QStringList &, const QStringList &, const QStringList &)),
@@ -135,9 +144,8 @@ void LauncherModel::initialize()
     // Save order of icons when model is changed
     connect(this, SIGNAL(rowsMoved(const QModelIndex&,int,int,const QModelIndex&,int)), this, SLOT(savePositions()));
 
-    // Watch for changes to the item order settings file
-    m_fileSystemWatcher.addPath(m_launcherSettings.fileName());
-    connect(&m_fileSystemWatcher, SIGNAL(fileChanged(QString)), this, SLOT(monitoredFileChanged(QString)));
+    // Reorder when the item order settings file is changed by someone else
+    connect(&m_launcherOrder, &LauncherOrderStore::changed, this, &LauncherModel::reorderItems);
 
     // Used to watch for owner changes during installation progress
     m_dbusWatcher.setConnection(QDBusConnection::sessionBus());
@@ -157,6 +165,12 @@ void LauncherModel::onFilesUpdated(const QStringList &added,
 {
     QStringList modifiedAndNeedUpdating = modified;
 
+    // Keep the icon index in sync before resolving icons for new items
+    updateIconIndex(added, removed);
+
+    // Icon ids already applied to launcher items while handling this update
+    QSet<QString> updatedIconIds;
+
     // First, remove all removed launcher items before adding new ones
     for (const QString &filename : removed) {
         if (isDesktopFile(m_directories, filename)) {
@@ -201,7 +215,7 @@ void LauncherModel::onFilesUpdated(const QStringList &added,
                 item = addItemIfValid(filename);
 
                 if (item != NULL) {
-                    updateItemsWithIcon(item->getOriginalIconId(), QString());
+                    updatedIconIds.insert(updateItemsWithIcon(item->getOriginalIconId(), QString()));
                 }
             } else {
                 // This case happens if a .desktop file is found as new, but we
@@ -215,7 +229,11 @@ void LauncherModel::onFilesUpdated(const QStringList &added,
                 modifiedAndNeedUpdating << filename;
             }
         } else if (isIconFile(filename)) {
-            updateItemsWithIcon(QString(), filename);
+            // Items that were added above already picked this icon up from the index
+            const QString iconId = m_iconIndex.iconIdForPath(filename);
+            if (!iconId.isEmpty() && !updatedIconIds.contains(iconId)) {
+                updateItemsWithIcon(iconId, filename);
+            }
         }
     }
 
@@ -249,57 +267,52 @@ void LauncherModel::onFilesUpdated(const QStringList &added,
     savePositions();
 }
 
-void LauncherModel::updateItemsWithIcon(const QString &iconId, const QString &filename)
+QString LauncherModel::updateItemsWithIcon(const QString &iconId, const QString &filename)
 {
     LAUNCHER_DEBUG("updateItemsWithIcon: iconId=" << iconId << "filename=" << filename);
 
-    QStringList iconDirectories = m_launcherMonitor.iconDirectories();
-
     // Try to determine icon id from filename
-    QString id = iconId;
-    if (id.isEmpty()) {
-        QFileInfo fileInfo(filename);
-        if (iconDirectories.contains(fileInfo.path() + "/")) {
-            id = fileInfo.baseName();
-        }
-    }
+    const QString id = iconId.isEmpty() ? m_iconIndex.iconIdForPath(filename) : iconId;
 
     // Prefer to use scalable icons in icon directories, sorted by the closest icon size
-    QString scalableIconFilename;
-    if (!id.isEmpty()) {
-        for (const QString &iconPath : iconDirectories) {
-            QString filename = filenameFromIconId(id, iconPath);
-            if (QFile(filename).exists()) {
-                scalableIconFilename = filename;
-                break;
-            }
-        }
+    const QString scalableIconFilename = !id.isEmpty() ? m_iconIndex.iconPath(id) : QString();
+
+    if (scalableIconFilename.isEmpty()) {
+        return QString();
     }
 
-    if (!scalableIconFilename.isEmpty()) {
-        // Use the most suitable scalable icon in the launcher items that share the icon id
-        for (LauncherItem *item : *getList<LauncherItem>()) {
-            if (id == item->getOriginalIconId()) {
-                item->setIconFilename(scalableIconFilename);
-                LAUNCHER_DEBUG("Scalable icon" << scalableIconFilename << "was updated for id" << id);
-            }
+    // Use the most suitable scalable icon in the launcher items that share the icon id
+    for (LauncherItem *item : *getList<LauncherItem>()) {
+        if (id == item->getOriginalIconId()) {
+            item->setIconFilename(scalableIconFilename);
+            preloadIcon(item);
+            LAUNCHER_DEBUG("Scalable icon" << scalableIconFilename << "was updated for id" << id);
         }
     }
+
+    return id;
 }
 
-void LauncherModel::monitoredFileChanged(const QString &changedPath)
+void LauncherModel::updateIconIndex(const QStringList &added, const QStringList &removed)
 {
-    if (changedPath == m_launcherSettings.fileName()) {
-        loadPositions();
-    } else {
-        qWarning() << "Unknown monitored file in LauncherModel:" << changedPath;
+    for (const QString &filename : removed) {
+        if (isIconFile(filename)) {
+            m_iconIndex.removeFile(filename);
+        }
+    }
+
+    for (const QString &filename : added) {
+        if (isIconFile(filename)) {
+            m_iconIndex.addFile(filename);
+        }
     }
 }
 
-void LauncherModel::loadPositions()
+void LauncherModel::preloadIcon(LauncherItem *item)
 {
-    m_launcherSettings.sync();
-    reorderItems();
+    if (m_preloadIconSize.isValid()) {
+        LauncherIconProvider::preload(item->iconId(), m_preloadIconSize);
+    }
 }
 
 void LauncherModel::reorderItems()
@@ -337,6 +350,10 @@ void LauncherModel::reorderItems()
         }
     }
 
+    // Every move() below would save the positions, do that once at the end instead
+    bool moved = false;
+    m_reordering = true;
+
     for (int gridPos = 0; gridPos < reordered.count(); ++gridPos) {
         LauncherItem *item = reordered.at(gridPos);
         LAUNCHER_DEBUG("Moving" << item->filePath() << "to" << gridPos);
@@ -355,6 +372,13 @@ void LauncherModel::reorderItems()
             continue;
 
         move(currentPos, gridPos);
+        moved = true;
+    }
+
+    m_reordering = false;
+
+    if (moved) {
+        savePositions();
     }
 }
 
@@ -405,6 +429,7 @@ void LauncherModel::setIconDirectories(QStringList newDirectories)
             newDirectories = m_iconDirectories;
             if (!newDirectories.contains(LAUNCHER_ICONS_PATH))
                 newDirectories << LAUNCHER_ICONS_PATH;
+            m_iconIndex.setDirectories(newDirectories);
             m_launcherMonitor.setIconDirectories(newDirectories);
         }
     }
@@ -453,10 +478,28 @@ void LauncherModel::setScope(const QString &scope)
         m_launcherOrderPrefix = !m_scope.isEmpty()
                 ? scope + QStringLiteral("/LauncherOrder/")
                 : QStringLiteral("LauncherOrder/");
+        m_launcherOrder.setGroup(launcherOrderGroup(m_launcherOrderPrefix));
         emit scopeChanged();
 
         if (m_initialized) {
-            loadPositions();
+            reorderItems();
+        }
+    }
+}
+
+QSize LauncherModel::preloadIconSize() const
+{
+    return m_preloadIconSize;
+}
+
+void LauncherModel::setPreloadIconSize(const QSize &size)
+{
+    if (m_preloadIconSize != size) {
+        m_preloadIconSize = size;
+        emit preloadIconSizeChanged();
+
+        for (LauncherItem *item : *getList<LauncherItem>()) {
+            preloadIcon(item);
         }
     }
 }
@@ -683,19 +726,19 @@ void LauncherModel::requestLaunch(const QString &packageName)
 
 void LauncherModel::savePositions()
 {
-    m_fileSystemWatcher.removePath(m_launcherSettings.fileName());
+    if (m_reordering) {
+        return;
+    }
 
-    m_launcherSettings.remove(m_launcherOrderPrefix.left(m_launcherOrderPrefix.count() - 1));
+    QStringList paths;
     QList<LauncherItem *> *currentLauncherList = getList<LauncherItem>();
-
-    int pos = 0;
+    paths.reserve(currentLauncherList->count());
     foreach (LauncherItem *item, *currentLauncherList) {
-        m_launcherSettings.setValue(m_launcherOrderPrefix + item->filePath(), pos);
-        ++pos;
+        paths.append(item->filePath());
     }
 
-    m_launcherSettings.sync();
-    m_fileSystemWatcher.addPath(m_launcherSettings.fileName());
+    // Only the entries that moved are written, in the background
+    m_launcherOrder.setPositions(paths);
 }
 
 int LauncherModel::findItem(const QString &path, LauncherItem **item)
@@ -804,14 +847,13 @@ LauncherItem *LauncherModel::packageInModel(const QString &packageName)
 
 QVariant LauncherModel::launcherPos(const QString &path)
 {
-    QString key = m_launcherOrderPrefix + path;
-
-    if (m_launcherSettings.contains(key)) {
-        return m_launcherSettings.value(key);
+    const QVariant pos = m_launcherOrder.position(path);
+    if (pos.isValid()) {
+        return pos;
     }
 
     // fall back to vendor configuration if the user hasn't specified a location
-    return m_globalSettings.value(key);
+    return m_globalSettings.value(m_launcherOrderPrefix + path);
 }
 
 LauncherItem *LauncherModel::addItemIfValid(const QString &path)
@@ -826,6 +868,7 @@ LauncherItem *LauncherModel::addItemIfValid(const QString &path)
 
     if (isValid && shouldDisplay) {
         addItem(item);
+        preloadIcon(item);
     } else if (isValid) {
         m_hiddenLaunchers.append(item);
         item = NULL;
@@ -19,14 +19,16 @@
 
 #include <QObject>
 #include <QSettings>
-#include <QFileSystemWatcher>
 #include <QDBusServiceWatcher>
 #include <QMap>
+#include <QSize>
 
 #include "qobjectlistmodel.h"
 #include "lipstickglobal.h"
 #include "launchermonitor.h"
 #include "launcherdbus.h"
+#include "launchericonindex.h"
+#include "launcherorderstore.h"
 
 class LauncherItem;
 
@@ -40,11 +42,11 @@ class LIPSTICK_EXPORT LauncherModel : public QObjectListModel
     Q_PROPERTY(QStringList categories READ categories WRITE setCategories NOTIFY categoriesChanged)
     Q_PROPERTY(QStringList blacklistedApplications READ blacklistedApplications WRITE setBlacklistedApplications NOTIFY blacklistedApplicationsChanged)
     Q_PROPERTY(QString scope READ scope WRITE setScope NOTIFY scopeChanged)
+    Q_PROPERTY(QSize preloadIconSize READ preloadIconSize WRITE setPreloadIconSize NOTIFY preloadIconSizeChanged)
 
     Q_ENUMS(ItemType)
 
 private slots:
-    void monitoredFileChanged(const QString &changedPath);
     void onFilesUpdated(const QStringList &added, const QStringList &modified, const QStringList &removed);
     void onServiceUnregistered(const QString &serviceName);
 
@@ -73,6 +75,9 @@ public:
     QString scope() const;
     void setScope(const QString &scope);
 
+    QSize preloadIconSize() const;
+    void setPreloadIconSize(const QSize &size);
+
     void updatingStarted(const QString &packageName, const QString &label,
             const QString &iconPath, QString desktopFile, const QString &serviceName);
     void updatingProgress(const QString &packageName, int progress, const QString &serviceName);
@@ -98,6 +103,7 @@ signals:
     void categoriesChanged();
     void blacklistedApplicationsChanged();
     void scopeChanged();
+    void preloadIconSizeChanged();
     void notifyLaunching(LauncherItem *item);
     void canceledNotifyLaunching(LauncherItem *item);
 
@@ -112,13 +118,14 @@ protected:
 
 private:
     void reorderItems();
-    void loadPositions();
     bool displayCategory(LauncherItem *item) const;
     int findItem(const QString &path, LauncherItem **item);
     LauncherItem *packageInModel(const QString &packageName);
     QVariant launcherPos(const QString &path);
     LauncherItem *addItemIfValid(const QString &path);
-    void updateItemsWithIcon(const QString &iconId, const QString &filename);
+    QString updateItemsWithIcon(const QString &iconId, const QString &filename);
+    void updateIconIndex(const QStringList &added, const QStringList &removed);
+    void preloadIcon(LauncherItem *item);
     void updateWatchedDBusServices();
     void setTemporary(LauncherItem *item);
     void unsetTemporary(LauncherItem *item);
@@ -130,18 +137,20 @@ private:
     QStringList m_iconDirectories;
     QStringList m_categories;
     QStringList m_blacklistedApplications;
-    QFileSystemWatcher m_fileSystemWatcher;
-    QSettings m_launcherSettings;
+    LauncherOrderStore m_launcherOrder;
     QSettings m_globalSettings;
     LauncherMonitor m_launcherMonitor;
     QString m_scope;
     QString m_launcherOrderPrefix;
+    LauncherIconIndex m_iconIndex;
+    QSize m_preloadIconSize;
 
     QDBusServiceWatcher m_dbusWatcher;
     QMap<QString, QString> m_packageNameToDBusService;
     QList<LauncherItem *> m_temporaryLaunchers;
     QList<LauncherItem *> m_hiddenLaunchers;
     bool m_initialized;
+    bool m_reordering;
 
     friend class Ut_LauncherModel;
 };
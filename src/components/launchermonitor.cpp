@@ -24,9 +24,11 @@
  * Timeout (in milliseconds) to hold back sending updates, so that we can
  * combine multiple updates to icons and desktop file in one go. Also to
  * avoid doing extraneous updates in case files get added/changed/removed
- * in quick succession.
+ * in quick succession. Benchmarks may override it at build time.
  **/
+#ifndef LAUNCHER_MONITOR_HOLDBACK_TIMEOUT_MS
 #define LAUNCHER_MONITOR_HOLDBACK_TIMEOUT_MS 2000
+#endif
 
 LauncherMonitor::LauncherMonitor()
     : QObject()
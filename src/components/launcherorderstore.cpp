@@ -0,0 +1,247 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#include "launcherorderstore.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSettings>
+
+class LauncherOrderWriter : public QRunnable
+{
+public:
+    explicit LauncherOrderWriter(LauncherOrderStore *store)
+        : m_store(store)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        const QHash<QString, QVariant> changes = m_store->takePendingChanges();
+
+        // QSettings merges the changed keys with the current file content
+        // and replaces the file through a temporary file and a rename
+        QSettings settings(m_store->m_fileName, QSettings::IniFormat);
+        for (QHash<QString, QVariant>::const_iterator it = changes.constBegin(); it != changes.constEnd(); ++it) {
+            if (it.value().isValid()) {
+                settings.setValue(it.key(), it.value());
+            } else {
+                settings.remove(it.key());
+            }
+        }
+        settings.sync();
+
+        if (settings.status() != QSettings::NoError) {
+            qWarning() << "Failed to save launcher order to" << m_store->m_fileName;
+        }
+
+        const QFileInfo info(m_store->m_fileName);
+        QMetaObject::invokeMethod(m_store, "writeFinished", Qt::QueuedConnection,
+                                  Q_ARG(QDateTime, info.lastModified()),
+                                  Q_ARG(qint64, info.size()));
+    }
+
+private:
+    LauncherOrderStore * const m_store;
+};
+
+LauncherOrderStore::LauncherOrderStore(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+    , m_writeScheduled(false)
+    , m_writesInFlight(0)
+    , m_changedWhileWriting(false)
+{
+    // Writes must be applied in the order they were requested
+    m_writerPool.setMaxThreadCount(1);
+
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &LauncherOrderStore::fileChanged);
+    watchFile();
+}
+
+LauncherOrderStore::~LauncherOrderStore()
+{
+    waitForWritten();
+}
+
+QString LauncherOrderStore::fileName() const
+{
+    return m_fileName;
+}
+
+QString LauncherOrderStore::group() const
+{
+    return m_group;
+}
+
+void LauncherOrderStore::setGroup(const QString &group)
+{
+    if (m_group != group) {
+        m_group = group;
+        reload();
+    }
+}
+
+QVariant LauncherOrderStore::position(const QString &path) const
+{
+    QHash<QString, int>::const_iterator it = m_positions.constFind(path);
+    return it != m_positions.constEnd() ? QVariant(*it) : QVariant();
+}
+
+bool LauncherOrderStore::setPositions(const QStringList &paths)
+{
+    const QString prefix = m_group + QLatin1Char('/');
+    QHash<QString, QVariant> changes;
+    QHash<QString, int> positions;
+    positions.reserve(paths.count());
+
+    for (int i = 0; i < paths.count(); ++i) {
+        const QString &path = paths.at(i);
+        positions.insert(path, i);
+
+        QHash<QString, int>::const_iterator it = m_positions.constFind(path);
+        if (it == m_positions.constEnd() || *it != i) {
+            changes.insert(prefix + path, i);
+        }
+    }
+
+    for (QHash<QString, int>::const_iterator it = m_positions.constBegin(); it != m_positions.constEnd(); ++it) {
+        if (!positions.contains(it.key())) {
+            changes.insert(prefix + it.key(), QVariant());
+        }
+    }
+
+    m_positions.swap(positions);
+
+    if (changes.isEmpty()) {
+        return false;
+    }
+
+    scheduleWrite(changes);
+    return true;
+}
+
+void LauncherOrderStore::reload()
+{
+    m_positions.clear();
+
+    QSettings settings(m_fileName, QSettings::IniFormat);
+    settings.beginGroup(m_group);
+    // Item paths are absolute, QSettings strips the leading slash as a group separator
+    for (const QString &key : settings.allKeys()) {
+        m_positions.insert(QLatin1Char('/') + key, settings.value(key).toInt());
+    }
+    settings.endGroup();
+
+    // Changes that have not reached the disk yet still take precedence
+    const QString prefix = m_group + QLatin1String("//");
+    QMutexLocker locker(&m_pendingMutex);
+    for (QHash<QString, QVariant>::const_iterator it = m_pending.constBegin(); it != m_pending.constEnd(); ++it) {
+        if (!it.key().startsWith(prefix)) {
+            continue;
+        }
+
+        const QString path = it.key().mid(prefix.length() - 1);
+        if (it.value().isValid()) {
+            m_positions.insert(path, it.value().toInt());
+        } else {
+            m_positions.remove(path);
+        }
+    }
+}
+
+void LauncherOrderStore::waitForWritten()
+{
+    m_writerPool.waitForDone();
+}
+
+void LauncherOrderStore::scheduleWrite(const QHash<QString, QVariant> &changes)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    for (QHash<QString, QVariant>::const_iterator it = changes.constBegin(); it != changes.constEnd(); ++it) {
+        m_pending.insert(it.key(), it.value());
+    }
+
+    // A writer that has not started yet will pick up these changes as well
+    if (!m_writeScheduled) {
+        m_writeScheduled = true;
+        ++m_writesInFlight;
+        m_writerPool.start(new LauncherOrderWriter(this));
+    }
+}
+
+QHash<QString, QVariant> LauncherOrderStore::takePendingChanges()
+{
+    QMutexLocker locker(&m_pendingMutex);
+    QHash<QString, QVariant> changes;
+    changes.swap(m_pending);
+    m_writeScheduled = false;
+    return changes;
+}
+
+LauncherOrderStore::FileStamp LauncherOrderStore::currentStamp() const
+{
+    const QFileInfo info(m_fileName);
+    FileStamp stamp;
+    if (info.exists()) {
+        stamp.modified = info.lastModified();
+        stamp.size = info.size();
+    }
+    return stamp;
+}
+
+void LauncherOrderStore::watchFile()
+{
+    // The file is replaced on every write, which drops it from the watcher
+    if (!m_watcher.files().contains(m_fileName) && QFile::exists(m_fileName)) {
+        m_watcher.addPath(m_fileName);
+    }
+}
+
+void LauncherOrderStore::fileChanged(const QString &path)
+{
+    Q_UNUSED(path);
+
+    watchFile();
+
+    if (m_writesInFlight > 0) {
+        // Decide once our own write has finished whether this was it
+        m_changedWhileWriting = true;
+    } else if (!(currentStamp() == m_writtenStamp)) {
+        reload();
+        emit changed();
+    }
+}
+
+void LauncherOrderStore::writeFinished(const QDateTime &modified, qint64 size)
+{
+    --m_writesInFlight;
+    m_writtenStamp.modified = modified;
+    m_writtenStamp.size = size;
+
+    watchFile();
+
+    if (m_writesInFlight == 0 && m_changedWhileWriting) {
+        m_changedWhileWriting = false;
+        if (!(currentStamp() == m_writtenStamp)) {
+            reload();
+            emit changed();
+        }
+    }
+}
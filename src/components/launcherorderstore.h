@@ -0,0 +1,99 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#ifndef LAUNCHERORDERSTORE_H
+#define LAUNCHERORDERSTORE_H
+
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVariant>
+
+/**
+ * Persists launcher item positions in the lipstick settings file.
+ *
+ * Positions are kept in memory and only entries that actually changed are
+ * handed to a background thread, which merges them into the settings file and
+ * replaces it atomically. Writes requested while a previous one is still
+ * pending are coalesced. Changes made to the file by other processes are
+ * reported with changed(), while the store's own writes are not.
+ */
+class LauncherOrderStore : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(LauncherOrderStore)
+
+public:
+    explicit LauncherOrderStore(const QString &fileName, QObject *parent = 0);
+    ~LauncherOrderStore();
+
+    QString fileName() const;
+
+    QString group() const;
+    void setGroup(const QString &group);
+
+    QVariant position(const QString &path) const;
+    bool setPositions(const QStringList &paths);
+
+    void reload();
+    void waitForWritten();
+
+signals:
+    void changed();
+
+private slots:
+    void fileChanged(const QString &path);
+    void writeFinished(const QDateTime &modified, qint64 size);
+
+private:
+    struct FileStamp
+    {
+        QDateTime modified;
+        qint64 size = -1;
+
+        bool operator==(const FileStamp &other) const
+        {
+            return modified == other.modified && size == other.size;
+        }
+    };
+
+    friend class LauncherOrderWriter;
+
+    FileStamp currentStamp() const;
+    void watchFile();
+    void scheduleWrite(const QHash<QString, QVariant> &changes);
+    QHash<QString, QVariant> takePendingChanges();
+
+    const QString m_fileName;
+    QString m_group;
+    QHash<QString, int> m_positions;
+    QFileSystemWatcher m_watcher;
+
+    // Changes not yet picked up by the writer; an invalid value removes the key
+    QMutex m_pendingMutex;
+    QHash<QString, QVariant> m_pending;
+    bool m_writeScheduled;
+
+    int m_writesInFlight;
+    bool m_changedWhileWriting;
+    FileStamp m_writtenStamp;
+    QThreadPool m_writerPool;
+};
+
+#endif // LAUNCHERORDERSTORE_H
@@ -0,0 +1,320 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#include "launchersearchindex.h"
+
+#include <QSet>
+#include <QStringList>
+
+#include <algorithm>
+
+// Match qualities, multiplied by the weight of the field that matched
+enum {
+    SubstringMatch = 1,
+    WordPrefixMatch = 3,
+    WordMatch = 4,
+    FieldPrefixMatch = 5
+};
+
+// Terms shorter than this only match the beginning of words
+static const int TrigramLength = 3;
+
+LauncherSearchIndex::LauncherSearchIndex()
+{
+}
+
+QString LauncherSearchIndex::normalize(const QString &text)
+{
+    // Decompose so that diacritics become separate marks which can be dropped
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD);
+
+    QString folded;
+    folded.reserve(decomposed.length());
+    for (const QChar c : decomposed) {
+        if (c.category() != QChar::Mark_NonSpacing) {
+            folded.append(c);
+        }
+    }
+
+    return folded.toCaseFolded();
+}
+
+QStringList LauncherSearchIndex::words(const QString &text)
+{
+    QStringList result;
+    int start = -1;
+    for (int i = 0; i <= text.length(); ++i) {
+        const bool inWord = i < text.length() && text.at(i).isLetterOrNumber();
+        if (inWord && start < 0) {
+            start = i;
+        } else if (!inWord && start >= 0) {
+            result.append(text.mid(start, i - start));
+            start = -1;
+        }
+    }
+    return result;
+}
+
+QVector<LauncherSearchIndex::Trigram> LauncherSearchIndex::trigrams(const QString &text)
+{
+    QVector<Trigram> result;
+    if (text.length() < TrigramLength) {
+        return result;
+    }
+
+    result.reserve(text.length() - TrigramLength + 1);
+    for (int i = 0; i + TrigramLength <= text.length(); ++i) {
+        result.append((Trigram(text.at(i).unicode()) << 32)
+                      | (Trigram(text.at(i + 1).unicode()) << 16)
+                      | Trigram(text.at(i + 2).unicode()));
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+bool LauncherSearchIndex::update(QObject *item, const QVector<Field> &fields)
+{
+    Entry entry;
+    entry.fields.reserve(fields.count());
+    for (const Field &field : fields) {
+        if (!field.text.isEmpty()) {
+            entry.fields.append(Field(normalize(field.text), field.weight));
+        }
+    }
+    entry.sortKey = !entry.fields.isEmpty() ? entry.fields.first().text : QString();
+
+    QHash<QObject *, Entry>::iterator it = m_entries.find(item);
+    if (it != m_entries.end()) {
+        if (it->fields == entry.fields) {
+            return false;
+        }
+        removeEntry(item, *it);
+        *it = entry;
+    } else {
+        m_entries.insert(item, entry);
+    }
+
+    insertEntry(item, entry);
+    return true;
+}
+
+void LauncherSearchIndex::remove(QObject *item)
+{
+    QHash<QObject *, Entry>::iterator it = m_entries.find(item);
+    if (it != m_entries.end()) {
+        removeEntry(item, *it);
+        m_entries.erase(it);
+    }
+}
+
+void LauncherSearchIndex::clear()
+{
+    m_entries.clear();
+    m_words.clear();
+    m_trigrams.clear();
+}
+
+bool LauncherSearchIndex::contains(QObject *item) const
+{
+    return m_entries.contains(item);
+}
+
+int LauncherSearchIndex::count() const
+{
+    return m_entries.count();
+}
+
+void LauncherSearchIndex::insertEntry(QObject *item, const Entry &entry)
+{
+    QSet<QString> seenWords;
+    QSet<Trigram> seenTrigrams;
+
+    for (const Field &field : entry.fields) {
+        for (const QString &word : words(field.text)) {
+            if (!seenWords.contains(word)) {
+                seenWords.insert(word);
+                m_words[word].append(item);
+            }
+        }
+        for (Trigram trigram : trigrams(field.text)) {
+            if (!seenTrigrams.contains(trigram)) {
+                seenTrigrams.insert(trigram);
+                m_trigrams[trigram].append(item);
+            }
+        }
+    }
+}
+
+void LauncherSearchIndex::removeEntry(QObject *item, const Entry &entry)
+{
+    for (const Field &field : entry.fields) {
+        for (const QString &word : words(field.text)) {
+            QMap<QString, QVector<QObject *> >::iterator it = m_words.find(word);
+            if (it != m_words.end()) {
+                it->removeAll(item);
+                if (it->isEmpty()) {
+                    m_words.erase(it);
+                }
+            }
+        }
+        for (Trigram trigram : trigrams(field.text)) {
+            QHash<Trigram, QVector<QObject *> >::iterator it = m_trigrams.find(trigram);
+            if (it != m_trigrams.end()) {
+                it->removeAll(item);
+                if (it->isEmpty()) {
+                    m_trigrams.erase(it);
+                }
+            }
+        }
+    }
+}
+
+QVector<QObject *> LauncherSearchIndex::candidates(const QString &term) const
+{
+    QSet<QObject *> result;
+
+    for (QMap<QString, QVector<QObject *> >::const_iterator it = m_words.lowerBound(term);
+            it != m_words.constEnd() && it.key().startsWith(term); ++it) {
+        for (QObject *item : *it) {
+            result.insert(item);
+        }
+    }
+
+    if (term.length() >= TrigramLength) {
+        // Items containing every trigram of the term, verified later by score()
+        const QVector<Trigram> termTrigrams = trigrams(term);
+        QHash<QObject *, int> hits;
+        bool complete = true;
+        for (Trigram trigram : termTrigrams) {
+            QHash<Trigram, QVector<QObject *> >::const_iterator it = m_trigrams.constFind(trigram);
+            if (it == m_trigrams.constEnd()) {
+                complete = false;
+                break;
+            }
+            for (QObject *item : *it) {
+                ++hits[item];
+            }
+        }
+
+        if (complete) {
+            for (QHash<QObject *, int>::const_iterator it = hits.constBegin(); it != hits.constEnd(); ++it) {
+                if (it.value() == termTrigrams.count()) {
+                    result.insert(it.key());
+                }
+            }
+        }
+    }
+
+    QVector<QObject *> items;
+    items.reserve(result.count());
+    for (QObject *item : result) {
+        items.append(item);
+    }
+    return items;
+}
+
+int LauncherSearchIndex::score(const Entry &entry, const QString &term)
+{
+    int best = 0;
+
+    for (const Field &field : entry.fields) {
+        int match = 0;
+        if (field.text.startsWith(term)) {
+            match = FieldPrefixMatch;
+        } else {
+            for (int pos = field.text.indexOf(term); pos >= 0 && match < WordMatch;
+                    pos = field.text.indexOf(term, pos + 1)) {
+                const int end = pos + term.length();
+                if (pos == 0 || !field.text.at(pos - 1).isLetterOrNumber()) {
+                    match = (end == field.text.length() || !field.text.at(end).isLetterOrNumber())
+                            ? WordMatch
+                            : qMax(match, int(WordPrefixMatch));
+                } else if (term.length() >= TrigramLength) {
+                    match = qMax(match, int(SubstringMatch));
+                }
+            }
+        }
+
+        best = qMax(best, match * field.weight);
+    }
+
+    return best;
+}
+
+QVector<QObject *> LauncherSearchIndex::search(const QString &pattern, int limit) const
+{
+    const QStringList terms = words(normalize(pattern));
+    if (terms.isEmpty()) {
+        return QVector<QObject *>();
+    }
+
+    // Every term has to match, so the longest one gives the fewest candidates
+    const QString *longest = &terms.first();
+    for (const QString &term : terms) {
+        if (term.length() > longest->length()) {
+            longest = &term;
+        }
+    }
+
+    struct Result {
+        QObject *item;
+        const QString *sortKey;
+        int score;
+    };
+
+    QVector<Result> results;
+    for (QObject *item : candidates(*longest)) {
+        // Results point at the sort key stored in the index, not at a copy
+        const QHash<QObject *, Entry>::const_iterator it = m_entries.constFind(item);
+        if (it == m_entries.constEnd()) {
+            continue;
+        }
+
+        const Entry &entry = it.value();
+        int total = 0;
+        for (const QString &term : terms) {
+            const int termScore = score(entry, term);
+            if (termScore == 0) {
+                total = 0;
+                break;
+            }
+            total += termScore;
+        }
+
+        if (total > 0) {
+            results.append({ item, &entry.sortKey, total });
+        }
+    }
+
+    std::sort(results.begin(), results.end(), [](const Result &lhs, const Result &rhs) {
+        if (lhs.score != rhs.score) {
+            return lhs.score > rhs.score;
+        }
+        return *lhs.sortKey < *rhs.sortKey;
+    });
+
+    if (limit >= 0 && results.count() > limit) {
+        results.resize(limit);
+    }
+
+    QVector<QObject *> items;
+    items.reserve(results.count());
+    for (const Result &result : results) {
+        items.append(result.item);
+    }
+    return items;
+}
@@ -0,0 +1,84 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#ifndef LAUNCHERSEARCHINDEX_H
+#define LAUNCHERSEARCHINDEX_H
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include "lipstickglobal.h"
+
+/**
+ * Prefix and trigram index over the searchable text of launcher items.
+ *
+ * All text is folded to lower case without diacritics before it is indexed
+ * or matched. Search terms match words by prefix, and terms of three or more
+ * characters also match anywhere inside a field through the trigram index.
+ * Every term of a pattern must match for an item to be included.
+ */
+class LIPSTICK_EXPORT LauncherSearchIndex
+{
+public:
+    struct Field
+    {
+        Field() : weight(0) {}
+        Field(const QString &text, int weight) : text(text), weight(weight) {}
+
+        bool operator==(const Field &other) const { return weight == other.weight && text == other.text; }
+
+        QString text;
+        int weight;
+    };
+
+    LauncherSearchIndex();
+
+    bool update(QObject *item, const QVector<Field> &fields);
+    void remove(QObject *item);
+    void clear();
+
+    bool contains(QObject *item) const;
+    int count() const;
+
+    QVector<QObject *> search(const QString &pattern, int limit = -1) const;
+
+    static QString normalize(const QString &text);
+
+private:
+    typedef quint64 Trigram;
+
+    struct Entry
+    {
+        QVector<Field> fields; // Normalized
+        QString sortKey;
+    };
+
+    void insertEntry(QObject *item, const Entry &entry);
+    void removeEntry(QObject *item, const Entry &entry);
+    QVector<QObject *> candidates(const QString &term) const;
+    static int score(const Entry &entry, const QString &term);
+
+    static QStringList words(const QString &text);
+    static QVector<Trigram> trigrams(const QString &text);
+
+    QHash<QObject *, Entry> m_entries;
+    QMap<QString, QVector<QObject *> > m_words;
+    QHash<Trigram, QVector<QObject *> > m_trigrams;
+};
+
+#endif // LAUNCHERSEARCHINDEX_H
@@ -0,0 +1,181 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#include "launchersearchmodel.h"
+#include "launcheritem.h"
+#include "launchermodel.h"
+
+// Relative importance of the fields an item can be found by
+enum {
+    CategoryWeight = 1,
+    KeywordWeight = 2,
+    ExecutableWeight = 2,
+    UnlocalizedTitleWeight = 3,
+    TitleWeight = 4
+};
+
+static QString executableName(const QString &exec)
+{
+    // Wrappers such as invoker and sailjail take the real binary as an
+    // absolute path argument, plain commands are found through PATH
+    const QStringList tokens = exec.split(QLatin1Char(' '), QString::SkipEmptyParts);
+    QString executable = !tokens.isEmpty() ? tokens.first() : QString();
+    for (int i = tokens.count() - 1; i > 0; --i) {
+        const QString &token = tokens.at(i);
+        if (token.startsWith(QLatin1Char('/')) && !token.endsWith(QLatin1String(".desktop"))) {
+            executable = token;
+            break;
+        }
+    }
+
+    return executable.mid(executable.lastIndexOf(QLatin1Char('/')) + 1);
+}
+
+LauncherSearchModel::LauncherSearchModel(QObject *parent)
+    : QObjectListModel(parent)
+    , m_limit(-1)
+{
+}
+
+LauncherSearchModel::~LauncherSearchModel()
+{
+}
+
+LauncherModel *LauncherSearchModel::model() const
+{
+    return m_model;
+}
+
+void LauncherSearchModel::setModel(LauncherModel *model)
+{
+    if (m_model == model) {
+        return;
+    }
+
+    if (m_model) {
+        disconnect(m_model, 0, this, 0);
+        for (LauncherItem *item : *m_model->getList<LauncherItem>()) {
+            disconnect(item, 0, this, 0);
+        }
+    }
+    m_index.clear();
+
+    m_model = model;
+
+    if (m_model) {
+        connect(m_model, &QObjectListModel::itemAdded, this, &LauncherSearchModel::sourceItemAdded);
+        connect(m_model, &QObjectListModel::itemRemoved, this, &LauncherSearchModel::sourceItemRemoved);
+        connect(m_model, &QObject::destroyed, this, &LauncherSearchModel::sourceModelDestroyed);
+        for (LauncherItem *item : *m_model->getList<LauncherItem>()) {
+            indexItem(item);
+            connect(item, &LauncherItem::itemChanged, this, &LauncherSearchModel::sourceItemChanged);
+        }
+    }
+
+    updateResults();
+    emit modelChanged();
+}
+
+QString LauncherSearchModel::pattern() const
+{
+    return m_pattern;
+}
+
+void LauncherSearchModel::setPattern(const QString &pattern)
+{
+    if (m_pattern != pattern) {
+        m_pattern = pattern;
+        updateResults();
+        emit patternChanged();
+    }
+}
+
+int LauncherSearchModel::limit() const
+{
+    return m_limit;
+}
+
+void LauncherSearchModel::setLimit(int limit)
+{
+    if (m_limit != limit) {
+        m_limit = limit;
+        updateResults();
+        emit limitChanged();
+    }
+}
+
+void LauncherSearchModel::sourceItemAdded(QObject *object)
+{
+    if (LauncherItem *item = qobject_cast<LauncherItem *>(object)) {
+        connect(item, &LauncherItem::itemChanged, this, &LauncherSearchModel::sourceItemChanged);
+        if (indexItem(item)) {
+            updateResults();
+        }
+    }
+}
+
+void LauncherSearchModel::sourceItemRemoved(QObject *object)
+{
+    disconnect(object, 0, this, 0);
+    if (m_index.contains(object)) {
+        m_index.remove(object);
+        updateResults();
+    }
+}
+
+void LauncherSearchModel::sourceItemChanged()
+{
+    if (LauncherItem *item = qobject_cast<LauncherItem *>(sender())) {
+        if (indexItem(item)) {
+            updateResults();
+        }
+    }
+}
+
+void LauncherSearchModel::sourceModelDestroyed()
+{
+    m_index.clear();
+    updateResults();
+    emit modelChanged();
+}
+
+bool LauncherSearchModel::indexItem(LauncherItem *item)
+{
+    QVector<LauncherSearchIndex::Field> fields;
+    fields.append(LauncherSearchIndex::Field(item->title(), TitleWeight));
+    fields.append(LauncherSearchIndex::Field(item->titleUnlocalized(), UnlocalizedTitleWeight));
+    for (const QString &keyword : item->keywords()) {
+        fields.append(LauncherSearchIndex::Field(keyword, KeywordWeight));
+    }
+    fields.append(LauncherSearchIndex::Field(executableName(item->exec()), ExecutableWeight));
+    for (const QString &category : item->desktopCategories()) {
+        fields.append(LauncherSearchIndex::Field(category, CategoryWeight));
+    }
+
+    return m_index.update(item, fields);
+}
+
+void LauncherSearchModel::updateResults()
+{
+    if (m_pattern.trimmed().isEmpty()) {
+        if (itemCount() > 0) {
+            synchronizeList(QList<QObject *>());
+        }
+        return;
+    }
+
+    const QVector<QObject *> results = m_index.search(m_pattern, m_limit);
+    synchronizeList(results.toList());
+}
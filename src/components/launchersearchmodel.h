@@ -0,0 +1,79 @@
+// This file is part of lipstick, a QML desktop library
+//
+// Copyright (c) 2026 Jolla Ltd.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License version 2.1 as published by the Free Software Foundation
+// and appearing in the file LICENSE.LGPL included in the packaging
+// of this file.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+
+#ifndef LAUNCHERSEARCHMODEL_H
+#define LAUNCHERSEARCHMODEL_H
+
+#include <QPointer>
+
+#include "qobjectlistmodel.h"
+#include "lipstickglobal.h"
+#include "launchersearchindex.h"
+
+class LauncherItem;
+class LauncherModel;
+
+/**
+ * Lists the items of a LauncherModel matching a search pattern, best match
+ * first.
+ *
+ * The titles, keywords, categories and executable names of the source model
+ * items are indexed once and kept up to date as items are added, changed and
+ * removed, so changing the pattern does not need to visit every item.
+ */
+class LIPSTICK_EXPORT LauncherSearchModel : public QObjectListModel
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(LauncherSearchModel)
+
+    Q_PROPERTY(LauncherModel *model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(QString pattern READ pattern WRITE setPattern NOTIFY patternChanged)
+    Q_PROPERTY(int limit READ limit WRITE setLimit NOTIFY limitChanged)
+
+public:
+    explicit LauncherSearchModel(QObject *parent = 0);
+    virtual ~LauncherSearchModel();
+
+    LauncherModel *model() const;
+    void setModel(LauncherModel *model);
+
+    QString pattern() const;
+    void setPattern(const QString &pattern);
+
+    int limit() const;
+    void setLimit(int limit);
+
+signals:
+    void modelChanged();
+    void patternChanged();
+    void limitChanged();
+
+private slots:
+    void sourceItemAdded(QObject *item);
+    void sourceItemRemoved(QObject *item);
+    void sourceItemChanged();
+    void sourceModelDestroyed();
+
+private:
+    bool indexItem(LauncherItem *item);
+    void updateResults();
+
+    QPointer<LauncherModel> m_model;
+    QString m_pattern;
+    int m_limit;
+    LauncherSearchIndex m_index;
+};
+
+#endif // LAUNCHERSEARCHMODEL_H
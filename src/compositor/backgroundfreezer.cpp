@@ -0,0 +1,371 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QFileInfo>
+#include <QTimerEvent>
+#include <MGConfItem>
+#include <mdesktopentry.h>
+
+#include "lipstickcompositor.h"
+#include "lipstickcompositorwindow.h"
+#include "framecallbackdispatcher.h"
+#include "cgroupfreezer.h"
+#include "backgroundfreezer.h"
+#include "notifications/notificationmanager.h"
+#include "notifications/lipsticknotification.h"
+#include "processinfocache.h"
+#include "logging.h"
+
+static const char *CgroupRoot = "/sys/fs/cgroup";
+static const int DefaultGracePeriod = 30;
+// Under the cgroup lipstick runs in unless configured otherwise
+static const char *DefaultGroup = "apps";
+static const char *DesktopEntryPath = "/usr/share/applications/";
+
+static QString processName(qint64 processId)
+{
+    return ProcessInfoCache::instance()->info(processId).name();
+}
+
+// Name of the binary an application's desktop entry launches, skipping over
+// the launchers wrapping it: "invoker --type=qt5 /usr/bin/app" -> "app"
+static QString desktopEntryBinary(const QString &desktopEntryName)
+{
+    MDesktopEntry entry(QLatin1String(DesktopEntryPath) + desktopEntryName + QLatin1String(".desktop"));
+    if (!entry.isValid())
+        return QString();
+
+    const QStringList arguments = entry.exec().split(QLatin1Char(' '), QString::SkipEmptyParts);
+    for (const QString &argument : arguments) {
+        if (!argument.startsWith(QLatin1Char('/')))
+            continue;
+        const QString binary = QFileInfo(argument).fileName();
+        if (binary != QLatin1String("invoker") && binary != QLatin1String("sailjail"))
+            return binary;
+    }
+    return QString();
+}
+
+BackgroundFreezer::BackgroundFreezer(LipstickCompositor *compositor)
+    : QObject(compositor)
+    , m_compositor(compositor)
+    , m_enabledConf(new MGConfItem("/lipstick/freezer_enabled", this))
+    , m_gracePeriodConf(new MGConfItem("/lipstick/freezer_grace_period", this))
+    , m_whitelistConf(new MGConfItem("/lipstick/freezer_whitelist", this))
+    , m_cgroupConf(new MGConfItem("/lipstick/freezer_cgroup", this))
+    , m_freezer(nullptr)
+    , m_gracePeriod(DefaultGracePeriod * 1000)
+{
+    m_clock.start();
+
+    connect(m_enabledConf, SIGNAL(valueChanged()), this, SLOT(updateSettings()));
+    connect(m_gracePeriodConf, SIGNAL(valueChanged()), this, SLOT(updateSettings()));
+    connect(m_whitelistConf, SIGNAL(valueChanged()), this, SLOT(updateSettings()));
+    connect(m_cgroupConf, SIGNAL(valueChanged()), this, SLOT(updateSettings()));
+
+    connect(compositor, SIGNAL(windowAdded(QObject*)), this, SLOT(scheduleCheck()));
+    connect(compositor, SIGNAL(windowRemoved(QObject*)), this, SLOT(scheduleCheck()));
+    connect(compositor, SIGNAL(windowRaised(QObject*)), this, SLOT(scheduleCheck()));
+    connect(compositor, SIGNAL(topmostWindowIdChanged()), this, SLOT(scheduleCheck()));
+    connect(compositor, SIGNAL(displayOn()), this, SLOT(scheduleCheck()));
+    connect(compositor, SIGNAL(displayOff()), this, SLOT(scheduleCheck()));
+    connect(compositor, SIGNAL(frameSwapped()), this, SLOT(frameSwapped()));
+
+    NotificationManager *notifications = NotificationManager::instance();
+    connect(notifications, &NotificationManager::ActionInvoked,
+            this, &BackgroundFreezer::notificationActionInvoked);
+    connect(notifications, &NotificationManager::remoteActionActivated,
+            this, &BackgroundFreezer::remoteActionActivated);
+
+    updateSettings();
+}
+
+BackgroundFreezer::~BackgroundFreezer()
+{
+    // Nothing is left frozen behind
+    releaseAll();
+}
+
+bool BackgroundFreezer::isEnabled() const
+{
+    return m_freezer != nullptr;
+}
+
+QList<qint64> BackgroundFreezer::frozenProcesses() const
+{
+    QList<qint64> processes;
+    if (m_freezer) {
+        for (qint64 processId : m_freezer->processes()) {
+            if (m_freezer->isFrozen(processId))
+                processes.append(processId);
+        }
+    }
+    return processes;
+}
+
+bool BackgroundFreezer::isExempt(qint64 processId) const
+{
+    return !m_exemptions.value(processId).isEmpty();
+}
+
+void BackgroundFreezer::setExemption(qint64 processId, const QString &reason, bool exempt)
+{
+    if (processId <= 0)
+        return;
+
+    if (exempt) {
+        m_exemptions[processId].insert(reason);
+        thaw(processId);
+    } else if (m_exemptions.contains(processId)) {
+        QSet<QString> &reasons = m_exemptions[processId];
+        reasons.remove(reason);
+        if (reasons.isEmpty())
+            m_exemptions.remove(processId);
+        // The grace period starts when the exemption ends
+        m_hiddenSince.remove(processId);
+        scheduleCheck();
+    }
+}
+
+void BackgroundFreezer::thaw(qint64 processId)
+{
+    m_hiddenSince.remove(processId);
+    if (m_freezer && m_freezer->isFrozen(processId)) {
+        qCDebug(lcLipstickCoreLog) << "Thawing process" << processId;
+        m_freezer->thaw(processId);
+    }
+    scheduleCheck();
+}
+
+void BackgroundFreezer::thawProcessName(const QString &name)
+{
+    for (qint64 processId : frozenProcesses()) {
+        if (processName(processId) == name)
+            thaw(processId);
+    }
+}
+
+void BackgroundFreezer::scheduleCheck()
+{
+    if (m_freezer)
+        m_checkTimer.start(0, this);
+}
+
+void BackgroundFreezer::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_checkTimer.timerId()) {
+        check();
+    } else {
+        QObject::timerEvent(event);
+    }
+}
+
+void BackgroundFreezer::updateSettings()
+{
+    bool ok = false;
+    const int gracePeriod = m_gracePeriodConf->value(DefaultGracePeriod).toInt(&ok);
+    m_gracePeriod = (ok && gracePeriod >= 0 ? gracePeriod : DefaultGracePeriod) * 1000;
+
+    m_whitelist = m_whitelistConf->value().toStringList();
+    m_whitelisted.clear();
+
+    QString group = m_cgroupConf->value().toString();
+    if (group.isEmpty()) {
+        const QString own = CgroupFreezer::processCgroup(QStringLiteral("/proc"), QCoreApplication::applicationPid());
+        if (!own.isEmpty())
+            group = own + QLatin1Char('/') + QLatin1String(DefaultGroup);
+    }
+
+    const bool enabled = m_enabledConf->value(false).toBool() && !group.isEmpty();
+    if (m_freezer && (!enabled || group != m_group))
+        releaseAll();
+
+    if (enabled && !m_freezer) {
+        m_group = group;
+        m_freezer = new CgroupFreezer(QLatin1String(CgroupRoot), group);
+        if (!m_freezer->isAvailable()) {
+            qCWarning(lcLipstickCoreLog) << "The cgroup v2 freezer is not available";
+            delete m_freezer;
+            m_freezer = nullptr;
+        }
+    }
+
+    scheduleCheck();
+}
+
+void BackgroundFreezer::releaseAll()
+{
+    if (!m_freezer)
+        return;
+
+    for (qint64 processId : m_freezer->processes())
+        m_freezer->release(processId);
+
+    delete m_freezer;
+    m_freezer = nullptr;
+    m_checkTimer.stop();
+    m_hiddenSince.clear();
+}
+
+void BackgroundFreezer::frameSwapped()
+{
+    // A frozen process shown through a cover is thawed right away
+    if (!m_freezer || !m_freezer->hasFrozen())
+        return;
+
+    for (LipstickCompositorWindow *window : m_compositor->m_windows) {
+        if (m_freezer->isFrozen(window->processId()) && isWindowShown(window))
+            thaw(window->processId());
+    }
+}
+
+void BackgroundFreezer::notificationActionInvoked(uint id)
+{
+    LipstickNotification *notification = NotificationManager::instance()->notification(id);
+    if (!notification)
+        return;
+
+    if (notification->clientPid() > 0) {
+        thaw(notification->clientPid());
+        return;
+    }
+
+    // Without a known sender, as when restored from the database, go by the application
+    const QString owner = notification->owner();
+    const QString binary = desktopEntryBinary(!owner.isEmpty() ? owner : notification->appName());
+    if (!binary.isEmpty())
+        thawProcessName(binary);
+}
+
+void BackgroundFreezer::remoteActionActivated(const QString &remoteAction)
+{
+    if (!m_freezer)
+        return;
+
+    // "service path interface method arguments..."
+    const QString service = remoteAction.section(QLatin1Char(' '), 0, 0);
+    if (service.isEmpty())
+        return;
+
+    // Resolved without blocking, a service that is not running has nothing to thaw
+    QDBusMessage method = QDBusMessage::createMethodCall(
+                QStringLiteral("org.freedesktop.DBus"),
+                QStringLiteral("/org/freedesktop/DBus"),
+                QStringLiteral("org.freedesktop.DBus"),
+                QStringLiteral("GetConnectionUnixProcessID"));
+    method.setArguments({ service });
+
+    QDBusPendingCall call = QDBusConnection::sessionBus().asyncCall(method);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *call) {
+        QDBusPendingReply<quint32> reply = *call;
+        if (reply.isValid() && reply.value() > 0)
+            thaw(reply.value());
+        call->deleteLater();
+    });
+}
+
+bool BackgroundFreezer::isWindowShown(LipstickCompositorWindow *window) const
+{
+    QWaylandSurface *surface = window->surface();
+    return window->m_mapped && surface && m_compositor->m_frameCallbacks->isSurfaceShown(surface);
+}
+
+bool BackgroundFreezer::isWhitelisted(qint64 processId)
+{
+    QHash<qint64, bool>::iterator it = m_whitelisted.find(processId);
+    if (it == m_whitelisted.end())
+        it = m_whitelisted.insert(processId, m_whitelist.contains(processName(processId)));
+    return *it;
+}
+
+void BackgroundFreezer::check()
+{
+    m_checkTimer.stop();
+    if (!m_freezer)
+        return;
+
+    const qint64 ownProcessId = QCoreApplication::applicationPid();
+    const qint64 topmostProcessId = m_compositor->privateTopmostWindowProcessId();
+
+    QHash<qint64, bool> shown;
+    for (LipstickCompositorWindow *window : m_compositor->m_windows) {
+        const qint64 processId = window->processId();
+        // Alien applications are paused through their surface states instead
+        if (processId <= 0 || processId == ownProcessId || window->isInProcess() || window->isAlien())
+            continue;
+
+        bool &processShown = shown[processId];
+        processShown = processShown || processId == topmostProcessId || isWindowShown(window);
+    }
+
+    const qint64 now = m_clock.elapsed();
+    qint64 next = -1;
+    for (QHash<qint64, bool>::const_iterator it = shown.constBegin(); it != shown.constEnd(); ++it) {
+        const qint64 processId = it.key();
+        if (it.value() || isExempt(processId)) {
+            m_hiddenSince.remove(processId);
+            if (m_freezer->isFrozen(processId)) {
+                qCDebug(lcLipstickCoreLog) << "Thawing process" << processId;
+                m_freezer->thaw(processId);
+            }
+            continue;
+        }
+
+        if (m_freezer->isFrozen(processId) || isWhitelisted(processId))
+            continue;
+
+        const qint64 since = m_hiddenSince.value(processId, now);
+        m_hiddenSince.insert(processId, since);
+
+        const qint64 remaining = since + m_gracePeriod - now;
+        if (remaining > 0) {
+            next = next < 0 ? remaining : qMin(next, remaining);
+        } else if (m_freezer->freeze(processId)) {
+            qCDebug(lcLipstickCoreLog) << "Froze process" << processId << "hidden for" << now - since << "ms";
+        }
+    }
+
+    // Processes without windows are of no concern anymore
+    for (qint64 processId : m_freezer->processes()) {
+        if (!shown.contains(processId))
+            m_freezer->release(processId);
+    }
+    for (QHash<qint64, qint64>::iterator it = m_hiddenSince.begin(); it != m_hiddenSince.end();) {
+        if (!shown.contains(it.key()))
+            it = m_hiddenSince.erase(it);
+        else
+            ++it;
+    }
+    for (QHash<qint64, bool>::iterator it = m_whitelisted.begin(); it != m_whitelisted.end();) {
+        if (!shown.contains(it.key()))
+            it = m_whitelisted.erase(it);
+        else
+            ++it;
+    }
+    for (QHash<qint64, QSet<QString> >::iterator it = m_exemptions.begin(); it != m_exemptions.end();) {
+        if (!shown.contains(it.key()) && !QFileInfo::exists(QStringLiteral("/proc/%1").arg(it.key())))
+            it = m_exemptions.erase(it);
+        else
+            ++it;
+    }
+
+    if (next >= 0)
+        m_checkTimer.start(int(next), this);
+}
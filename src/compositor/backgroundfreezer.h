@@ -0,0 +1,98 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef BACKGROUNDFREEZER_H
+#define BACKGROUNDFREEZER_H
+
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+
+class CgroupFreezer;
+class LipstickCompositor;
+class LipstickCompositorWindow;
+class MGConfItem;
+
+/*
+ * Freezes the processes of applications that have stayed hidden.
+ *
+ * Freezing is opt-in, enabled with /lipstick/freezer_enabled. A process is
+ * hidden when none of its windows is shown on screen, either directly or
+ * through a cover, and it does not own the topmost window. Once it has been
+ * hidden for /lipstick/freezer_grace_period seconds it is frozen with
+ * CgroupFreezer, in the cgroup given by /lipstick/freezer_cgroup. Processes
+ * whose name is in /lipstick/freezer_whitelist are never frozen, and neither
+ * are processes that have an exemption set, for instance by the audio policy
+ * while they play audio or by a VoIP service during a call.
+ *
+ * A frozen process is thawed as soon as one of its windows is shown again or
+ * raised, when it is asked to over D-Bus, and when an action is invoked on
+ * one of its notifications. It is frozen again only after a new grace period.
+ */
+class BackgroundFreezer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BackgroundFreezer(LipstickCompositor *compositor);
+    ~BackgroundFreezer();
+
+    bool isEnabled() const;
+    QList<qint64> frozenProcesses() const;
+
+    bool isExempt(qint64 processId) const;
+    void setExemption(qint64 processId, const QString &reason, bool exempt);
+
+    // Thaws the process and restarts its grace period
+    void thaw(qint64 processId);
+    void thawProcessName(const QString &name);
+
+public slots:
+    void scheduleCheck();
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private slots:
+    void updateSettings();
+    void frameSwapped();
+    void notificationActionInvoked(uint id);
+    void remoteActionActivated(const QString &remoteAction);
+
+private:
+    void check();
+    void releaseAll();
+    bool isWindowShown(LipstickCompositorWindow *window) const;
+    bool isWhitelisted(qint64 processId);
+
+    LipstickCompositor *m_compositor;
+    MGConfItem *m_enabledConf;
+    MGConfItem *m_gracePeriodConf;
+    MGConfItem *m_whitelistConf;
+    MGConfItem *m_cgroupConf;
+    CgroupFreezer *m_freezer;
+    QString m_group;
+    int m_gracePeriod; // Milliseconds
+    QStringList m_whitelist;
+    QElapsedTimer m_clock;
+    QBasicTimer m_checkTimer;
+    QHash<qint64, qint64> m_hiddenSince;
+    QHash<qint64, bool> m_whitelisted;
+    QHash<qint64, QSet<QString> > m_exemptions;
+};
+
+#endif // BACKGROUNDFREEZER_H
@@ -0,0 +1,148 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "cgroupfreezer.h"
+
+static bool writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+        qWarning() << "Cannot write" << path << ":" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+CgroupFreezer::CgroupFreezer(const QString &cgroupRoot, const QString &group, const QString &procRoot)
+    : m_cgroupRoot(cgroupRoot)
+    , m_group(group)
+    , m_procRoot(procRoot)
+{
+}
+
+QString CgroupFreezer::groupPath() const
+{
+    return QDir::cleanPath(m_cgroupRoot + QLatin1Char('/') + m_group);
+}
+
+bool CgroupFreezer::isAvailable() const
+{
+    return !m_group.isEmpty() && QFileInfo(m_cgroupRoot).isDir();
+}
+
+QString CgroupFreezer::appPath(qint64 processId) const
+{
+    return groupPath() + QStringLiteral("/app-%1").arg(processId);
+}
+
+QString CgroupFreezer::processCgroup(const QString &procRoot, qint64 processId)
+{
+    QFile file(QStringLiteral("%1/%2/cgroup").arg(procRoot).arg(processId));
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+
+    // The unified hierarchy is the one with id 0 and no controllers, "0::/path"
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        if (line.startsWith("0::"))
+            return QString::fromUtf8(line.mid(3).trimmed());
+    }
+    return QString();
+}
+
+bool CgroupFreezer::freeze(qint64 processId)
+{
+    if (processId <= 0 || !isAvailable())
+        return false;
+
+    if (!m_processes.contains(processId)) {
+        Process process;
+        process.originalCgroup = processCgroup(m_procRoot, processId);
+        if (process.originalCgroup.isEmpty())
+            return false;
+
+        const QString path = appPath(processId);
+        if (!QDir().mkpath(path)) {
+            qWarning() << "Cannot create cgroup" << path;
+            return false;
+        }
+        if (!writeFile(path + QStringLiteral("/cgroup.procs"), QByteArray::number(processId))) {
+            QDir().rmdir(path);
+            return false;
+        }
+
+        m_processes.insert(processId, process);
+    }
+
+    return setFrozen(processId, true);
+}
+
+bool CgroupFreezer::thaw(qint64 processId)
+{
+    return m_processes.contains(processId) && setFrozen(processId, false);
+}
+
+bool CgroupFreezer::setFrozen(qint64 processId, bool frozen)
+{
+    Process &process = m_processes[processId];
+    if (process.frozen == frozen)
+        return true;
+
+    if (!writeFile(appPath(processId) + QStringLiteral("/cgroup.freeze"), frozen ? "1" : "0"))
+        return false;
+
+    process.frozen = frozen;
+    return true;
+}
+
+void CgroupFreezer::release(qint64 processId)
+{
+    if (!m_processes.contains(processId))
+        return;
+
+    setFrozen(processId, false);
+
+    // A process that has exited has left the cgroup already
+    const Process process = m_processes.take(processId);
+    if (QFileInfo(QStringLiteral("%1/%2").arg(m_procRoot).arg(processId)).exists()) {
+        writeFile(QDir::cleanPath(m_cgroupRoot + QLatin1Char('/') + process.originalCgroup)
+                  + QStringLiteral("/cgroup.procs"), QByteArray::number(processId));
+    }
+
+    // Fails if the process could not be moved back
+    QDir().rmdir(appPath(processId));
+}
+
+bool CgroupFreezer::isFrozen(qint64 processId) const
+{
+    return m_processes.value(processId).frozen;
+}
+
+bool CgroupFreezer::hasFrozen() const
+{
+    for (const Process &process : m_processes) {
+        if (process.frozen)
+            return true;
+    }
+    return false;
+}
+
+QList<qint64> CgroupFreezer::processes() const
+{
+    return m_processes.keys();
+}
@@ -0,0 +1,70 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef CGROUPFREEZER_H
+#define CGROUPFREEZER_H
+
+#include <QHash>
+#include <QString>
+
+/*
+ * Freezes processes with the cgroup v2 freezer.
+ *
+ * A process is moved into a cgroup of its own, app-<pid>, created under the
+ * given group, and frozen and thawed through the cgroup.freeze file of that
+ * cgroup. The group must be writable by lipstick, which for a group under the
+ * cgroup lipstick runs in means the service needs cgroup delegation. Once
+ * released, the process is moved back to the cgroup it came from.
+ *
+ * The cgroup and proc file systems are given as paths, so that the freezer
+ * can be pointed at a plain directory tree.
+ */
+class CgroupFreezer
+{
+public:
+    // The group is relative to the cgroup file system
+    CgroupFreezer(const QString &cgroupRoot, const QString &group, const QString &procRoot = QStringLiteral("/proc"));
+
+    QString groupPath() const;
+    bool isAvailable() const;
+
+    bool freeze(qint64 processId);
+    bool thaw(qint64 processId);
+    // Thaws the process and moves it back to its original cgroup
+    void release(qint64 processId);
+
+    bool isFrozen(qint64 processId) const;
+    bool hasFrozen() const;
+    QList<qint64> processes() const;
+
+    // The cgroup of a process relative to the cgroup file system, from /proc/<pid>/cgroup
+    static QString processCgroup(const QString &procRoot, qint64 processId);
+
+private:
+    struct Process
+    {
+        QString originalCgroup;
+        bool frozen = false;
+    };
+
+    QString appPath(qint64 processId) const;
+    bool setFrozen(qint64 processId, bool frozen);
+
+    QString m_cgroupRoot;
+    QString m_group;
+    QString m_procRoot;
+    QHash<qint64, Process> m_processes;
+};
+
+#endif // CGROUPFREEZER_H
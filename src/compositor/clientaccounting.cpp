@@ -0,0 +1,282 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QDebug>
+#include <QRegion>
+#include <QSize>
+#include <QTimerEvent>
+#include <QVector>
+
+#include <algorithm>
+
+#include "clientaccounting.h"
+
+QVariantMap ClientUsage::toVariantMap() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("applicationId"), applicationId);
+    map.insert(QStringLiteral("commits"), commits);
+    map.insert(QStringLiteral("bufferBytes"), bufferBytes);
+    map.insert(QStringLiteral("damageArea"), damageArea);
+    map.insert(QStringLiteral("frameCallbacksRequested"), frameCallbacksRequested);
+    map.insert(QStringLiteral("frameCallbacksSent"), frameCallbacksSent);
+    map.insert(QStringLiteral("frameCallbacksThrottled"), frameCallbacksThrottled);
+    map.insert(QStringLiteral("inputEvents"), inputEvents);
+    map.insert(QStringLiteral("touchMotionsCoalesced"), touchMotionsCoalesced);
+    map.insert(QStringLiteral("touchDispatchLatency"), touchDispatchLatency);
+    map.insert(QStringLiteral("touchDispatchLatencyMax"), touchDispatchLatencyMax);
+    map.insert(QStringLiteral("commitRate"), commitRate);
+    return map;
+}
+
+ClientAccounting::ClientAccounting(QObject *parent)
+    : QObject(parent)
+    , m_logInterval(0)
+{
+    m_clock.start();
+}
+
+ClientAccounting::Client &ClientAccounting::client(qint64 processId)
+{
+    return m_clients[processId];
+}
+
+qint64 ClientAccounting::time(qint64 now) const
+{
+    return now >= 0 ? now : m_clock.elapsed();
+}
+
+void ClientAccounting::setApplicationId(qint64 processId, const QString &applicationId)
+{
+    client(processId).usage.applicationId = applicationId;
+}
+
+void ClientAccounting::advance(Client &client, qint64 second)
+{
+    if (second <= client.second)
+        return;
+
+    if (second - client.second >= RateWindow) {
+        std::fill(client.commits, client.commits + RateWindow, 0);
+    } else {
+        for (qint64 s = client.second + 1; s <= second; ++s)
+            client.commits[s % RateWindow] = 0;
+    }
+    client.second = second;
+}
+
+qreal ClientAccounting::commitRate(const Client &client, qint64 second)
+{
+    quint64 commits = 0;
+    for (int i = 0; i < RateWindow; ++i) {
+        const qint64 bucket = client.second - i;
+        if (bucket >= 0 && bucket > second - RateWindow && bucket <= second)
+            commits += client.commits[bucket % RateWindow];
+    }
+    return qreal(commits) / RateWindow;
+}
+
+void ClientAccounting::bufferCommitted(qint64 processId, const QSize &size, qint64 now)
+{
+    Client &c = client(processId);
+    const qint64 second = time(now) / 1000;
+    advance(c, second);
+    ++c.commits[second % RateWindow];
+
+    c.gone = false;
+    c.usage.commits += 1;
+    c.usage.bufferBytes += quint64(qMax(0, size.width())) * qMax(0, size.height()) * 4;
+}
+
+void ClientAccounting::damaged(qint64 processId, const QRegion &damage)
+{
+    client(processId).usage.damageArea += regionArea(damage);
+}
+
+void ClientAccounting::frameCallbackRequested(qint64 processId)
+{
+    client(processId).usage.frameCallbacksRequested += 1;
+}
+
+void ClientAccounting::frameCallbackSent(qint64 processId)
+{
+    client(processId).usage.frameCallbacksSent += 1;
+}
+
+void ClientAccounting::frameCallbackThrottled(qint64 processId)
+{
+    client(processId).usage.frameCallbacksThrottled += 1;
+}
+
+void ClientAccounting::inputEventDelivered(qint64 processId)
+{
+    client(processId).usage.inputEvents += 1;
+}
+
+void ClientAccounting::touchEventDispatched(qint64 processId, qint64 latency, int coalesced)
+{
+    ClientUsage &usage = client(processId).usage;
+    usage.touchMotionsCoalesced += quint64(qMax(0, coalesced));
+    usage.touchDispatchLatency += quint64(qMax<qint64>(0, latency));
+    usage.touchDispatchLatencyMax = qMax(usage.touchDispatchLatencyMax, quint64(qMax<qint64>(0, latency)));
+}
+
+void ClientAccounting::clientGone(qint64 processId)
+{
+    QHash<qint64, Client>::iterator it = m_clients.find(processId);
+    if (it == m_clients.end())
+        return;
+
+    if (m_logInterval > 0)
+        it->gone = true;
+    else
+        m_clients.erase(it);
+}
+
+ClientUsage ClientAccounting::usage(qint64 processId, qint64 now) const
+{
+    QHash<qint64, Client>::const_iterator it = m_clients.constFind(processId);
+    if (it == m_clients.constEnd())
+        return ClientUsage();
+
+    ClientUsage usage = it->usage;
+    usage.commitRate = commitRate(*it, time(now) / 1000);
+    return usage;
+}
+
+QHash<qint64, ClientUsage> ClientAccounting::usage(qint64 now) const
+{
+    const qint64 second = time(now) / 1000;
+
+    QHash<qint64, ClientUsage> clients;
+    for (QHash<qint64, Client>::const_iterator it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        ClientUsage usage = it->usage;
+        usage.commitRate = commitRate(*it, second);
+        clients.insert(it.key(), usage);
+    }
+    return clients;
+}
+
+QVariantMap ClientAccounting::toVariantMap() const
+{
+    QVariantMap map;
+    const QHash<qint64, ClientUsage> clients = usage();
+    for (QHash<qint64, ClientUsage>::const_iterator it = clients.constBegin(); it != clients.constEnd(); ++it)
+        map.insert(QString::number(it.key()), it->toVariantMap());
+    return map;
+}
+
+int ClientAccounting::logInterval() const
+{
+    return m_logInterval;
+}
+
+void ClientAccounting::setLogInterval(int seconds)
+{
+    m_logInterval = qMax(0, seconds);
+    if (m_logInterval > 0) {
+        m_logTimer.start(m_logInterval * 1000, this);
+    } else {
+        m_logTimer.stop();
+        for (QHash<qint64, Client>::iterator it = m_clients.begin(); it != m_clients.end();) {
+            if (it->gone)
+                it = m_clients.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+QStringList ClientAccounting::logLines()
+{
+    struct Delta
+    {
+        qint64 processId;
+        ClientUsage usage;
+    };
+
+    const qint64 second = m_clock.elapsed() / 1000;
+    QVector<Delta> deltas;
+    for (QHash<qint64, Client>::const_iterator it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        const ClientUsage &usage = it->usage;
+        const ClientUsage &logged = it->logged;
+
+        Delta delta;
+        delta.processId = it.key();
+        delta.usage.applicationId = usage.applicationId;
+        delta.usage.commits = usage.commits - logged.commits;
+        delta.usage.bufferBytes = usage.bufferBytes - logged.bufferBytes;
+        delta.usage.damageArea = usage.damageArea - logged.damageArea;
+        delta.usage.frameCallbacksRequested = usage.frameCallbacksRequested - logged.frameCallbacksRequested;
+        delta.usage.frameCallbacksSent = usage.frameCallbacksSent - logged.frameCallbacksSent;
+        delta.usage.frameCallbacksThrottled = usage.frameCallbacksThrottled - logged.frameCallbacksThrottled;
+        delta.usage.inputEvents = usage.inputEvents - logged.inputEvents;
+        delta.usage.commitRate = commitRate(*it, second);
+
+        if (delta.usage.commits > 0 || delta.usage.frameCallbacksSent > 0 || delta.usage.inputEvents > 0)
+            deltas.append(delta);
+    }
+
+    std::sort(deltas.begin(), deltas.end(), [](const Delta &lhs, const Delta &rhs) {
+        return lhs.usage.bufferBytes != rhs.usage.bufferBytes
+                ? lhs.usage.bufferBytes > rhs.usage.bufferBytes
+                : lhs.processId < rhs.processId;
+    });
+
+    QStringList lines;
+    for (int i = 0; i < deltas.count() && i < LoggedClients; ++i) {
+        const Delta &delta = deltas.at(i);
+        lines.append(QStringLiteral("Client %1 (%2): %3 commits/s, %4 commits, %5 kB of buffers, %6 px damaged, "
+                                    "%7/%8 frame callbacks sent, %9 throttled, %10 input events")
+                     .arg(delta.processId)
+                     .arg(delta.usage.applicationId.isEmpty() ? QStringLiteral("none") : delta.usage.applicationId)
+                     .arg(delta.usage.commitRate, 0, 'f', 1)
+                     .arg(delta.usage.commits)
+                     .arg(delta.usage.bufferBytes / 1024)
+                     .arg(delta.usage.damageArea)
+                     .arg(delta.usage.frameCallbacksSent)
+                     .arg(delta.usage.frameCallbacksRequested)
+                     .arg(delta.usage.frameCallbacksThrottled)
+                     .arg(delta.usage.inputEvents));
+    }
+
+    for (QHash<qint64, Client>::iterator it = m_clients.begin(); it != m_clients.end();) {
+        if (it->gone) {
+            it = m_clients.erase(it);
+        } else {
+            it->logged = it->usage;
+            ++it;
+        }
+    }
+
+    return lines;
+}
+
+quint64 ClientAccounting::regionArea(const QRegion &region)
+{
+    quint64 area = 0;
+    for (const QRect &rect : region.rects())
+        area += quint64(rect.width()) * rect.height();
+    return area;
+}
+
+void ClientAccounting::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_logTimer.timerId()) {
+        for (const QString &line : logLines())
+            qInfo().noquote() << line;
+    } else {
+        QObject::timerEvent(event);
+    }
+}
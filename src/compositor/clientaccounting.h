@@ -0,0 +1,120 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef CLIENTACCOUNTING_H
+#define CLIENTACCOUNTING_H
+
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+
+class QRegion;
+class QSize;
+
+struct ClientUsage
+{
+    QString applicationId;          // Policy application id of the client's windows
+    quint64 commits = 0;            // Buffers committed
+    quint64 bufferBytes = 0;        // Size of the committed buffers
+    quint64 damageArea = 0;         // Pixels damaged by the commits
+    quint64 frameCallbacksRequested = 0; // Committed frames waiting for a frame callback
+    quint64 frameCallbacksSent = 0;
+    quint64 frameCallbacksThrottled = 0; // Frames of hidden surfaces held back
+    quint64 inputEvents = 0;        // Input events delivered to the client
+    quint64 touchMotionsCoalesced = 0; // Touch motion events merged into later ones
+    quint64 touchDispatchLatency = 0;  // Milliseconds touch events were held back in total
+    quint64 touchDispatchLatencyMax = 0;
+    qreal commitRate = 0;           // Commits per second over the last RateWindow seconds
+
+    QVariantMap toVariantMap() const;
+};
+
+/*
+ * Keeps account of what each client of the compositor costs, keyed by the
+ * process id of the client.
+ *
+ * The compositor reports the commits, damage, frame callbacks and input
+ * events of every client as they happen, which only bumps counters. With a
+ * log interval set, the clients that were active since the previous log are
+ * written to the log every interval, the ones with the most buffer traffic
+ * first.
+ *
+ * Clients that are gone are kept until they have been logged once, or
+ * dropped right away when logging is off.
+ */
+class ClientAccounting : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum {
+        RateWindow = 10,    // Seconds
+        LoggedClients = 10
+    };
+
+    explicit ClientAccounting(QObject *parent = nullptr);
+
+    void setApplicationId(qint64 processId, const QString &applicationId);
+    // Times are in milliseconds on the clock of the accounting, -1 being now
+    void bufferCommitted(qint64 processId, const QSize &size, qint64 now = -1);
+    void damaged(qint64 processId, const QRegion &damage);
+    void frameCallbackRequested(qint64 processId);
+    void frameCallbackSent(qint64 processId);
+    void frameCallbackThrottled(qint64 processId);
+    void inputEventDelivered(qint64 processId);
+    // A touch event reached the client after being held for latency ms
+    void touchEventDispatched(qint64 processId, qint64 latency, int coalesced = 0);
+    void clientGone(qint64 processId);
+
+    ClientUsage usage(qint64 processId, qint64 now = -1) const;
+    QHash<qint64, ClientUsage> usage(qint64 now = -1) const;
+    // Usage of every client, keyed by process id
+    QVariantMap toVariantMap() const;
+
+    // Seconds, zero when not logging
+    int logInterval() const;
+    void setLogInterval(int seconds);
+    // Usage of the busiest clients since the previous call
+    QStringList logLines();
+
+    static quint64 regionArea(const QRegion &region);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    struct Client
+    {
+        ClientUsage usage;
+        ClientUsage logged;     // Usage as of the previous log
+        quint32 commits[RateWindow] = {};
+        qint64 second = 0;      // Second of the newest commit bucket
+        bool gone = false;
+    };
+
+    Client &client(qint64 processId);
+    qint64 time(qint64 now) const;
+    static void advance(Client &client, qint64 second);
+    static qreal commitRate(const Client &client, qint64 second);
+
+    QElapsedTimer m_clock;
+    QHash<qint64, Client> m_clients;
+    QBasicTimer m_logTimer;
+    int m_logInterval;
+};
+
+#endif // CLIENTACCOUNTING_H
@@ -12,10 +12,28 @@ PUBLICHEADERS += \
     $$PWD/lipstickkeymap.h \
     $$PWD/windowmodel.h \
     $$PWD/lipsticksurfaceinterface.h \
+    $$PWD/regionhittest.h \
+    $$PWD/touchmotioncompressor.h \
 
 HEADERS += \
     $$PWD/windowpixmapitem.h \
-    $$PWD/windowproperty.h
+    $$PWD/windowproperty.h \
+    $$PWD/framecallbackdispatcher.h \
+    $$PWD/framecallbackpolicy.h \
+    $$PWD/frametimings.h \
+    $$PWD/frametimingrecorder.h \
+    $$PWD/framereadback.h \
+    $$PWD/snapshotpool.h \
+    $$PWD/texturedownscaler.h \
+    $$PWD/windowocclusion.h \
+    $$PWD/keymapupdater.h \
+    $$PWD/oomscorepolicy.h \
+    $$PWD/oomscoremanager.h \
+    $$PWD/cgroupfreezer.h \
+    $$PWD/backgroundfreezer.h \
+    $$PWD/clientaccounting.h \
+    $$PWD/windowregistry.h \
+    $$PWD/windowpropertydispatcher.h
 
 SOURCES += \
     $$PWD/lipstickcompositor.cpp \
@@ -28,7 +46,25 @@ SOURCES += \
     $$PWD/windowpixmapitem.cpp \
     $$PWD/windowproperty.cpp \
     $$PWD/lipsticksurfaceinterface.cpp \
-    $$PWD/lipstickrecorder.cpp
+    $$PWD/regionhittest.cpp \
+    $$PWD/touchmotioncompressor.cpp \
+    $$PWD/lipstickrecorder.cpp \
+    $$PWD/framecallbackdispatcher.cpp \
+    $$PWD/framecallbackpolicy.cpp \
+    $$PWD/frametimings.cpp \
+    $$PWD/frametimingrecorder.cpp \
+    $$PWD/framereadback.cpp \
+    $$PWD/snapshotpool.cpp \
+    $$PWD/texturedownscaler.cpp \
+    $$PWD/windowocclusion.cpp \
+    $$PWD/keymapupdater.cpp \
+    $$PWD/oomscorepolicy.cpp \
+    $$PWD/oomscoremanager.cpp \
+    $$PWD/cgroupfreezer.cpp \
+    $$PWD/backgroundfreezer.cpp \
+    $$PWD/clientaccounting.cpp \
+    $$PWD/windowregistry.cpp \
+    $$PWD/windowpropertydispatcher.cpp
 
 DEFINES += QT_COMPOSITOR_QUICK
 
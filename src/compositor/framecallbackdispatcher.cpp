@@ -0,0 +1,297 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QTimerEvent>
+#include <QWaylandSurface>
+#include <QtCompositorVersion>
+#if QTCOMPOSITOR_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+#include <QWaylandClient>
+#endif
+#include <MGConfItem>
+
+#include "lipstickcompositor.h"
+#include "lipstickcompositorwindow.h"
+#include "framecallbackdispatcher.h"
+#include "clientaccounting.h"
+#include "windowocclusion.h"
+
+// Frame callbacks per second for surfaces that are not shown
+static const qreal DefaultHiddenSurfaceRate = 1.0;
+
+FrameCallbackDispatcher::FrameCallbackDispatcher(LipstickCompositor *compositor)
+    : QObject(compositor)
+    , m_compositor(compositor)
+    , m_hiddenRateConf(new MGConfItem("/lipstick/hidden_surface_frame_rate", this))
+    , m_displayOffRatesConf(new MGConfItem("/lipstick/display_off_frame_rates", this))
+    , m_displayOffMaximumIntervalConf(new MGConfItem("/lipstick/display_off_frame_interval_max", this))
+    , m_hiddenInterval(-1)
+{
+    m_clock.start();
+
+    connect(m_hiddenRateConf, SIGNAL(valueChanged()), this, SLOT(updateHiddenSurfaceRate()));
+    connect(m_displayOffRatesConf, SIGNAL(valueChanged()), this, SLOT(updateDisplayOffPolicy()));
+    connect(m_displayOffMaximumIntervalConf, SIGNAL(valueChanged()), this, SLOT(updateDisplayOffPolicy()));
+    updateHiddenSurfaceRate();
+    updateDisplayOffPolicy();
+}
+
+FrameCallbackDispatcher::~FrameCallbackDispatcher()
+{
+}
+
+qreal FrameCallbackDispatcher::hiddenSurfaceRate() const
+{
+    return m_hiddenInterval > 0 ? 1000.0 / m_hiddenInterval : 0;
+}
+
+void FrameCallbackDispatcher::setHiddenSurfaceRate(qreal rate)
+{
+    const int interval = rate > 0 ? qMax(1, qRound(1000 / rate)) : -1;
+    if (m_hiddenInterval != interval) {
+        m_hiddenInterval = interval;
+        scheduleHidden(m_clock.elapsed());
+    }
+}
+
+void FrameCallbackDispatcher::updateHiddenSurfaceRate()
+{
+    bool ok = false;
+    const qreal rate = m_hiddenRateConf->value(DefaultHiddenSurfaceRate).toReal(&ok);
+    setHiddenSurfaceRate(ok ? rate : DefaultHiddenSurfaceRate);
+}
+
+void FrameCallbackDispatcher::updateDisplayOffPolicy()
+{
+    // Entries are "category=rate", an entry without a category sets the default
+    m_displayOffPolicy.setRates(m_displayOffRatesConf->value().toStringList());
+
+    const int maximumInterval = m_displayOffMaximumIntervalConf->value().toInt();
+    if (maximumInterval > 0) {
+        m_displayOffPolicy.setMaximumInterval(maximumInterval);
+    }
+
+    scheduleHidden(m_clock.elapsed());
+}
+
+void FrameCallbackDispatcher::surfaceCreated(QWaylandSurface *surface)
+{
+    connect(surface, &QObject::destroyed, this, &FrameCallbackDispatcher::surfaceDestroyed);
+}
+
+void FrameCallbackDispatcher::surfaceDestroyed(QObject *object)
+{
+    QWaylandSurface *surface = static_cast<QWaylandSurface *>(object);
+    m_lastSent.remove(surface);
+    m_committed.remove(surface);
+    m_throttled.remove(surface);
+    m_idleCallbacks.remove(surface);
+}
+
+void FrameCallbackDispatcher::surfaceCommitted(QWaylandSurface *surface)
+{
+    m_committed.insert(surface);
+    m_compositor->m_clientAccounting->frameCallbackRequested(clientProcessId(surface));
+
+    // Shown surfaces get their callbacks once the compositor has rendered
+    if (!isSurfaceShown(surface)) {
+        scheduleHidden(m_clock.elapsed());
+    }
+}
+
+void FrameCallbackDispatcher::frameRendered()
+{
+    const qint64 now = m_clock.elapsed();
+
+    // The display is on again, back off from scratch next time it goes off
+    m_idleCallbacks.clear();
+
+    QList<QWaylandSurface *> surfaces;
+    for (QWaylandSurface *surface : m_compositor->surfaces()) {
+        if (isSurfaceShown(surface) || (m_committed.contains(surface) && isDue(surface, now))) {
+            surfaces.append(surface);
+        } else if (m_committed.contains(surface) && !m_throttled.contains(surface)) {
+            m_throttled.insert(surface);
+            m_compositor->m_clientAccounting->frameCallbackThrottled(clientProcessId(surface));
+        }
+    }
+
+    send(surfaces, now);
+    scheduleHidden(now);
+}
+
+void FrameCallbackDispatcher::sendToAll()
+{
+    send(m_compositor->surfaces(), m_clock.elapsed());
+}
+
+void FrameCallbackDispatcher::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_hiddenTimer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    m_hiddenTimer.stop();
+
+    const qint64 now = m_clock.elapsed();
+    QList<QWaylandSurface *> surfaces;
+    for (QWaylandSurface *surface : m_committed) {
+        if (isDue(surface, now) && !isSurfaceShown(surface)) {
+            surfaces.append(surface);
+        }
+    }
+
+    if (!surfaces.isEmpty()) {
+        m_compositor->frameStarted();
+        send(surfaces, now);
+
+        if (!m_compositor->isVisible()) {
+            for (QWaylandSurface *surface : surfaces) {
+                ++m_idleCallbacks[surface];
+            }
+        }
+    }
+    scheduleHidden(now);
+}
+
+bool FrameCallbackDispatcher::isSurfaceShown(QWaylandSurface *surface) const
+{
+    if (!m_compositor->isVisible()) {
+        return false;
+    }
+
+    const QList<QWaylandSurfaceView *> views = surface->views();
+    LipstickCompositorWindow *window = !views.isEmpty()
+            ? static_cast<LipstickCompositorWindow *>(views.first())
+            : nullptr;
+
+    // Only throttle surfaces the compositor knows how to show
+    if (!window || !window->m_mapped) {
+        return true;
+    }
+
+    // Covered by opaque windows above it, but it can still be shown through a cover
+    if (!m_compositor->m_occlusion->isOccluded(window) && isItemShown(window)) {
+        return true;
+    }
+
+    for (QQuickItem *item : window->m_refs) {
+        if (isItemShown(item)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool FrameCallbackDispatcher::isItemShown(QQuickItem *item) const
+{
+    QQuickWindow *window = item->window();
+    if (!window || !window->isVisible() || !item->isVisible()) {
+        return false;
+    }
+
+    for (QQuickItem *ancestor = item; ancestor; ancestor = ancestor->parentItem()) {
+        if (qFuzzyIsNull(ancestor->opacity())) {
+            return false;
+        }
+    }
+
+    const QRectF bounds = item->mapRectToScene(QRectF(0, 0, item->width(), item->height()));
+    return bounds.intersects(QRectF(0, 0, window->width(), window->height()));
+}
+
+int FrameCallbackDispatcher::throttleInterval(QWaylandSurface *surface) const
+{
+    if (m_compositor->isVisible()) {
+        return m_hiddenInterval;
+    }
+
+    const QVariantMap properties = surface->windowProperties();
+    const QList<QWaylandSurfaceView *> views = surface->views();
+    const QString category = !views.isEmpty()
+            ? static_cast<LipstickCompositorWindow *>(views.first())->category()
+            : properties.value(QStringLiteral("CATEGORY")).toString();
+
+    return m_displayOffPolicy.displayOffInterval(category,
+                                                 properties.value(QStringLiteral("WAKE_LOCK")).toBool(),
+                                                 m_idleCallbacks.value(surface));
+}
+
+bool FrameCallbackDispatcher::isDue(QWaylandSurface *surface, qint64 now) const
+{
+    const int interval = throttleInterval(surface);
+    if (interval < 0) {
+        return false;
+    }
+
+    QHash<QWaylandSurface *, qint64>::const_iterator it = m_lastSent.constFind(surface);
+    return it == m_lastSent.constEnd() || now - *it >= interval;
+}
+
+void FrameCallbackDispatcher::send(const QList<QWaylandSurface *> &surfaces, qint64 now)
+{
+    if (surfaces.isEmpty()) {
+        return;
+    }
+
+    m_compositor->sendFrameCallbacks(surfaces);
+
+    for (QWaylandSurface *surface : surfaces) {
+        m_lastSent.insert(surface, now);
+        m_throttled.remove(surface);
+        if (m_committed.remove(surface)) {
+            m_compositor->m_clientAccounting->frameCallbackSent(clientProcessId(surface));
+
+            // Touch motion held back until the client has drawn is due now
+            const QList<QWaylandSurfaceView *> views = surface->views();
+            if (!views.isEmpty()) {
+                static_cast<LipstickCompositorWindow *>(views.first())->frameCallbackSent();
+            }
+        }
+    }
+}
+
+void FrameCallbackDispatcher::scheduleHidden(qint64 now)
+{
+    qint64 next = -1;
+    for (QWaylandSurface *surface : m_committed) {
+        const int interval = throttleInterval(surface);
+        if (interval < 0 || isSurfaceShown(surface)) {
+            continue;
+        }
+
+        const qint64 due = m_lastSent.contains(surface)
+                ? m_lastSent.value(surface) + interval
+                : now;
+        if (next < 0 || due < next) {
+            next = due;
+        }
+    }
+
+    if (next < 0) {
+        m_hiddenTimer.stop();
+    } else {
+        m_hiddenTimer.start(int(qMax<qint64>(0, next - now)), this);
+    }
+}
+
+qint64 FrameCallbackDispatcher::clientProcessId(QWaylandSurface *surface) const
+{
+#if QTCOMPOSITOR_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+    return surface->client() ? surface->client()->processId() : 0;
+#else
+    return surface->processId();
+#endif
+}
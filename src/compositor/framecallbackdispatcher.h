@@ -0,0 +1,96 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef FRAMECALLBACKDISPATCHER_H
+#define FRAMECALLBACKDISPATCHER_H
+
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+
+#include "framecallbackpolicy.h"
+
+class LipstickCompositor;
+class MGConfItem;
+class QQuickItem;
+class QWaylandSurface;
+
+/*
+ * Decides which surfaces receive frame callbacks.
+ *
+ * Surfaces that are shown on screen, either through their window item or a
+ * WindowPixmapItem, get their callbacks after every rendered frame. Surfaces
+ * that are not shown are throttled to the rate configured in
+ * /lipstick/hidden_surface_frame_rate, so that background clients do not
+ * render at full frame rate for nothing. A rate of zero suspends them.
+ *
+ * While the compositor is not visible, i.e. the display is off, no surface is
+ * shown and FrameCallbackPolicy decides the pacing from the window category,
+ * its wake lock and how long it has kept committing with the display off.
+ */
+class FrameCallbackDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameCallbackDispatcher(LipstickCompositor *compositor);
+    ~FrameCallbackDispatcher();
+
+    qreal hiddenSurfaceRate() const;
+    void setHiddenSurfaceRate(qreal rate);
+
+    void surfaceCreated(QWaylandSurface *surface);
+    void surfaceCommitted(QWaylandSurface *surface);
+
+    // Sends callbacks to the shown surfaces and to hidden ones that are due
+    void frameRendered();
+    // Sends callbacks to every surface, flushing pending ones as the display turns off
+    void sendToAll();
+
+    // Shown through its window item or a cover while the display is on
+    bool isSurfaceShown(QWaylandSurface *surface) const;
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private slots:
+    void surfaceDestroyed(QObject *surface);
+    void updateHiddenSurfaceRate();
+    void updateDisplayOffPolicy();
+
+private:
+    bool isItemShown(QQuickItem *item) const;
+    int throttleInterval(QWaylandSurface *surface) const;
+    bool isDue(QWaylandSurface *surface, qint64 now) const;
+    void send(const QList<QWaylandSurface *> &surfaces, qint64 now);
+    void scheduleHidden(qint64 now);
+    qint64 clientProcessId(QWaylandSurface *surface) const;
+
+    LipstickCompositor *m_compositor;
+    MGConfItem *m_hiddenRateConf;
+    MGConfItem *m_displayOffRatesConf;
+    MGConfItem *m_displayOffMaximumIntervalConf;
+    int m_hiddenInterval; // Milliseconds, negative when suspended
+    FrameCallbackPolicy m_displayOffPolicy;
+    QHash<QWaylandSurface *, int> m_idleCallbacks; // Sent while the display is off
+    QElapsedTimer m_clock;
+    QHash<QWaylandSurface *, qint64> m_lastSent;
+    QSet<QWaylandSurface *> m_committed;
+    QSet<QWaylandSurface *> m_throttled;
+    QBasicTimer m_hiddenTimer;
+};
+
+#endif // FRAMECALLBACKDISPATCHER_H
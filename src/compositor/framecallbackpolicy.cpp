@@ -0,0 +1,85 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QDebug>
+
+#include "framecallbackpolicy.h"
+
+// Matches the pacing used before there was a policy
+static const qreal DefaultDisplayOffRate = 1.0;
+static const int DefaultMaximumInterval = 60000;
+
+FrameCallbackPolicy::FrameCallbackPolicy()
+    : m_defaultRate(DefaultDisplayOffRate)
+    , m_maximumInterval(DefaultMaximumInterval)
+{
+}
+
+qreal FrameCallbackPolicy::defaultRate() const
+{
+    return m_defaultRate;
+}
+
+qreal FrameCallbackPolicy::categoryRate(const QString &category) const
+{
+    return m_categoryRates.value(category, m_defaultRate);
+}
+
+int FrameCallbackPolicy::maximumInterval() const
+{
+    return m_maximumInterval;
+}
+
+void FrameCallbackPolicy::setMaximumInterval(int milliseconds)
+{
+    m_maximumInterval = milliseconds;
+}
+
+int FrameCallbackPolicy::displayOffInterval(const QString &category, bool wakeLock, int idleCallbacks) const
+{
+    const qreal rate = categoryRate(category);
+    if (!wakeLock || rate <= 0) {
+        return -1;
+    }
+
+    const qint64 interval = qMax(1, qRound(1000 / rate));
+    const qint64 backedOff = interval << qBound(0, idleCallbacks, 20);
+    return int(qMin(backedOff, qMax<qint64>(interval, m_maximumInterval)));
+}
+
+void FrameCallbackPolicy::setRates(const QStringList &entries)
+{
+    qreal defaultRate = DefaultDisplayOffRate;
+    QHash<QString, qreal> rates;
+
+    for (const QString &entry : entries) {
+        const int separator = entry.lastIndexOf(QLatin1Char('='));
+        bool ok = false;
+        const qreal rate = entry.mid(separator + 1).toDouble(&ok);
+        if (!ok) {
+            qWarning() << "Ignoring invalid frame rate" << entry;
+            continue;
+        }
+
+        const QString category = separator > 0 ? entry.left(separator).trimmed() : QString();
+        if (category.isEmpty()) {
+            defaultRate = rate;
+        } else {
+            rates.insert(category, rate);
+        }
+    }
+
+    m_defaultRate = defaultRate;
+    m_categoryRates = rates;
+}
@@ -0,0 +1,53 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef FRAMECALLBACKPOLICY_H
+#define FRAMECALLBACKPOLICY_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+/*
+ * Frame callback pacing for surfaces while the display is off.
+ *
+ * Only windows holding a wake lock, set with the WAKE_LOCK window property,
+ * get frame callbacks at all. They are paced at the rate configured for their
+ * category, and the interval doubles for every callback a surface consumes
+ * while the display stays off, up to the maximum interval.
+ */
+class FrameCallbackPolicy
+{
+public:
+    FrameCallbackPolicy();
+
+    qreal defaultRate() const;
+    qreal categoryRate(const QString &category) const;
+
+    int maximumInterval() const;
+    void setMaximumInterval(int milliseconds);
+
+    // Milliseconds until the next callback, or -1 when callbacks are suspended
+    int displayOffInterval(const QString &category, bool wakeLock, int idleCallbacks) const;
+
+    // Parses "category=rate" entries, an entry without a category sets the default
+    void setRates(const QStringList &entries);
+
+private:
+    qreal m_defaultRate;
+    QHash<QString, qreal> m_categoryRates;
+    int m_maximumInterval;
+};
+
+#endif // FRAMECALLBACKPOLICY_H
@@ -0,0 +1,318 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+#include <string.h>
+
+#include "framereadback.h"
+
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#endif
+
+static bool supportsAsynchronousReadback(QOpenGLContext *context)
+{
+    const QSurfaceFormat format = context->format();
+    if (context->isOpenGLES()) {
+        return format.majorVersion() >= 3;
+    }
+    // Fences are core since OpenGL 3.2
+    return format.version() >= qMakePair(3, 2);
+}
+
+FrameReadback::FrameReadback(QOpenGLContext *context, bool asynchronous)
+    : m_context(context)
+    , m_asynchronous(asynchronous && supportsAsynchronousReadback(context))
+    , m_next(0)
+    , m_pending(-1)
+{
+}
+
+FrameReadback::~FrameReadback()
+{
+    if (!m_asynchronous) {
+        return;
+    }
+
+    QOpenGLExtraFunctions *gl = m_context->extraFunctions();
+    for (Slot &slot : m_slots) {
+        if (slot.fence) {
+            gl->glDeleteSync(slot.fence);
+        }
+        if (slot.buffer) {
+            gl->glDeleteBuffers(1, &slot.buffer);
+        }
+    }
+}
+
+bool FrameReadback::isReady()
+{
+    if (m_pending < 0) {
+        return true;
+    }
+
+    Slot &slot = m_slots[m_pending];
+    if (!slot.fence) {
+        return true;
+    }
+
+    QOpenGLExtraFunctions *gl = m_context->extraFunctions();
+    if (gl->glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+
+    // Signaled, or waiting failed in which case mapping reports the error
+    gl->glDeleteSync(slot.fence);
+    slot.fence = 0;
+    return true;
+}
+
+CapturedFramePointer FrameReadback::readNow(const QRect &rect, quint32 time)
+{
+    QSharedPointer<CapturedFrame> frame(new CapturedFrame);
+    frame->origin = rect.topLeft();
+    frame->size = rect.size();
+    frame->time = time;
+    frame->pixels.resize(frame->stride() * rect.height());
+
+    QOpenGLFunctions *gl = m_context->functions();
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    gl->glReadPixels(rect.x(), rect.y(), rect.width(), rect.height(), GL_RGBA, GL_UNSIGNED_BYTE, frame->pixels.data());
+    return frame;
+}
+
+CapturedFramePointer FrameReadback::read(const QRect &rect, quint32 time)
+{
+    if (!m_asynchronous) {
+        return readNow(rect, time);
+    }
+
+    QOpenGLExtraFunctions *gl = m_context->extraFunctions();
+    Slot &slot = m_slots[m_next];
+    const int bytes = rect.width() * 4 * rect.height();
+
+    if (!slot.buffer) {
+        gl->glGenBuffers(1, &slot.buffer);
+    }
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    if (slot.capacity < bytes) {
+        gl->glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        slot.capacity = bytes;
+    }
+    slot.rect = rect;
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    gl->glReadPixels(rect.x(), rect.y(), rect.width(), rect.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.time = time;
+
+    // Complete the previous read only after queuing this one to keep the GPU busy
+    CapturedFramePointer previous;
+    if (m_pending >= 0) {
+        previous = complete(m_slots[m_pending]);
+    }
+
+    m_pending = m_next;
+    m_next = 1 - m_next;
+    return previous;
+}
+
+CapturedFramePointer FrameReadback::finish()
+{
+    if (m_pending < 0) {
+        return CapturedFramePointer();
+    }
+
+    CapturedFramePointer frame = complete(m_slots[m_pending]);
+    m_pending = -1;
+    return frame;
+}
+
+CapturedFramePointer FrameReadback::complete(Slot &slot)
+{
+    QOpenGLExtraFunctions *gl = m_context->extraFunctions();
+
+    // Only waits when the caller did not check isReady() first
+    if (slot.fence) {
+        gl->glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        gl->glDeleteSync(slot.fence);
+        slot.fence = 0;
+    }
+
+    QSharedPointer<CapturedFrame> frame(new CapturedFrame);
+    frame->origin = slot.rect.topLeft();
+    frame->size = slot.rect.size();
+    frame->time = slot.time;
+
+    const int bytes = frame->stride() * frame->size.height();
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void *mapped = gl->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+    if (mapped) {
+        // Copy straight into the pixels of an earlier frame of this slot when
+        // nobody holds on to it anymore, rather than into a new allocation
+        if (!slot.pixels.isDetached() || slot.pixels.size() != bytes) {
+            slot.pixels = QByteArray(bytes, Qt::Uninitialized);
+        }
+        memcpy(slot.pixels.data(), mapped, bytes);
+        frame->pixels = slot.pixels;
+        gl->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        qWarning("FrameReadback: failed to map the pixel buffer");
+        frame.clear();
+    }
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return frame;
+}
+
+QVector<QRect> FrameReadback::damage(const CapturedFrame &previous, const CapturedFrame &current, int tileSize)
+{
+    QVector<QRect> rects;
+    if (previous.origin != current.origin || previous.size != current.size
+            || previous.pixels.size() != current.pixels.size()) {
+        rects.append(QRect(QPoint(0, 0), current.size));
+        return rects;
+    }
+
+    const int width = current.size.width();
+    const int height = current.size.height();
+    const int stride = current.stride();
+    const char * const before = previous.pixels.constData();
+    const char * const after = current.pixels.constData();
+
+    // Spans of changed tiles in the previous tile row, extended downwards while they repeat
+    QVector<QRect> open;
+    for (int y = 0; y < height; y += tileSize) {
+        const int rows = qMin(tileSize, height - y);
+        QVector<QRect> spans;
+
+        for (int x = 0; x < width; x += tileSize) {
+            const int columns = qMin(tileSize, width - x);
+            bool changed = false;
+            for (int row = y; row < y + rows && !changed; ++row) {
+                const int offset = row * stride + x * 4;
+                changed = memcmp(before + offset, after + offset, columns * 4) != 0;
+            }
+
+            if (!changed) {
+                continue;
+            }
+            if (!spans.isEmpty() && spans.last().right() + 1 == x) {
+                spans.last().setRight(x + columns - 1);
+            } else {
+                spans.append(QRect(x, y, columns, rows));
+            }
+        }
+
+        QVector<QRect> next;
+        for (QRect span : spans) {
+            for (int i = 0; i < open.count(); ++i) {
+                if (open.at(i).left() == span.left() && open.at(i).right() == span.right()) {
+                    span.setTop(open.at(i).top());
+                    open.remove(i);
+                    break;
+                }
+            }
+            next.append(span);
+        }
+        rects += open;
+        open = next;
+    }
+    rects += open;
+
+    return rects;
+}
+
+// Per byte average of two RGBA pixels, computed on all four channels at once
+static inline quint32 average(quint32 a, quint32 b)
+{
+    return (a & b) + (((a ^ b) & 0xfefefefe) >> 1);
+}
+
+// Averages 2x2 blocks of in, whose dimensions are at least twice the given size
+static void halve(const char *in, int inStride, char *out, int outStride, const QSize &size)
+{
+    for (int y = 0; y < size.height(); ++y) {
+        const quint32 *top = reinterpret_cast<const quint32 *>(in + 2 * y * inStride);
+        const quint32 *bottom = reinterpret_cast<const quint32 *>(in + (2 * y + 1) * inStride);
+        quint32 *row = reinterpret_cast<quint32 *>(out + y * outStride);
+        for (int x = 0; x < size.width(); ++x) {
+            row[x] = average(average(top[2 * x], top[2 * x + 1]), average(bottom[2 * x], bottom[2 * x + 1]));
+        }
+    }
+}
+
+CapturedFramePointer FrameReadback::extract(const CapturedFramePointer &frame, const QRect &rect, int scale)
+{
+    const QRect frameRect(frame->origin, frame->size);
+    const QRect source = rect.intersected(frameRect);
+    if (source == frameRect && scale == 1) {
+        return frame;
+    }
+
+    const char *in = frame->pixels.constData()
+            + (source.y() - frame->origin.y()) * frame->stride()
+            + (source.x() - frame->origin.x()) * 4;
+    int inStride = frame->stride();
+    QSize size = source.size();
+
+    QSharedPointer<CapturedFrame> result(new CapturedFrame);
+    result->origin = QPoint(source.x() / scale, source.y() / scale);
+    result->size = QSize(size.width() / scale, size.height() / scale);
+    result->time = frame->time;
+
+    if (scale == 1) {
+        result->pixels.resize(result->stride() * result->size.height());
+        for (int y = 0; y < size.height(); ++y) {
+            memcpy(result->pixels.data() + y * result->stride(), in + y * inStride, size.width() * 4);
+        }
+        return result;
+    }
+
+    // A power of two scale is a series of halvings, each of which is a 2x2 box filter
+    QByteArray intermediate;
+    for (; scale > 1; scale /= 2) {
+        size = QSize(size.width() / 2, size.height() / 2);
+        QByteArray out(size.width() * 4 * size.height(), Qt::Uninitialized);
+        halve(in, inStride, out.data(), size.width() * 4, size);
+
+        intermediate = out;
+        in = intermediate.constData();
+        inStride = size.width() * 4;
+    }
+    result->pixels = intermediate;
+
+    return result;
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef FRAMEREADBACK_H
+#define FRAMEREADBACK_H
+
+#include <QByteArray>
+#include <QRect>
+#include <QSharedPointer>
+#include <QVector>
+#include <qopengl.h>
+
+class QOpenGLContext;
+
+// RGBA pixels of a window frame, bottom row first as read from OpenGL
+struct CapturedFrame
+{
+    QByteArray pixels;
+    QPoint origin;  // Bottom left corner within the window
+    QSize size;
+    quint32 time = 0;
+
+    int stride() const { return size.width() * 4; }
+};
+
+typedef QSharedPointer<const CapturedFrame> CapturedFramePointer;
+
+/*
+ * Reads frames back from the current framebuffer of a render thread context.
+ *
+ * When the context supports pixel buffer objects and fences the readback is
+ * asynchronous: read() only queues the copy into one of two buffers and hands
+ * back the frame queued by the previous call. Callers check isReady() before
+ * reading again, so that the render thread does not wait for the GPU, and try
+ * again with a later frame otherwise. Without asynchronous readback read()
+ * returns the frame it just read.
+ *
+ * All functions must be called with the context current.
+ */
+class FrameReadback
+{
+public:
+    explicit FrameReadback(QOpenGLContext *context, bool asynchronous = true);
+    ~FrameReadback();
+
+    QOpenGLContext *context() const { return m_context; }
+    bool isAsynchronous() const { return m_asynchronous; }
+    bool isPending() const { return m_pending >= 0; }
+    // Polls whether a queued read can be completed without waiting
+    bool isReady();
+
+    // The rectangle is in framebuffer coordinates, with the origin at the bottom left
+    CapturedFramePointer read(const QRect &rect, quint32 time);
+    // Waits for a queued read to complete
+    CapturedFramePointer finish();
+
+    // Rectangles of tileSize granularity where the frames differ
+    static QVector<QRect> damage(const CapturedFrame &previous, const CapturedFrame &current, int tileSize = 64);
+    // Crops the frame to rect, in framebuffer coordinates, and divides its
+    // size by scale, which must be a power of two
+    static CapturedFramePointer extract(const CapturedFramePointer &frame, const QRect &rect, int scale);
+
+private:
+    struct Slot
+    {
+        GLuint buffer = 0;
+        GLsync fence = 0;
+        QByteArray pixels; // Reused once the frames sharing it are released
+        QRect rect;
+        int capacity = 0;
+        quint32 time = 0;
+    };
+
+    Q_DISABLE_COPY(FrameReadback)
+
+    CapturedFramePointer readNow(const QRect &rect, quint32 time);
+    CapturedFramePointer complete(Slot &slot);
+
+    QOpenGLContext * const m_context;
+    const bool m_asynchronous;
+    Slot m_slots[2];
+    int m_next;
+    int m_pending;
+};
+
+#endif // FRAMEREADBACK_H
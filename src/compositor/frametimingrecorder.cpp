@@ -0,0 +1,136 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QDebug>
+#include <QQuickWindow>
+#include <QScreen>
+#include <QTextStream>
+#include <QTimerEvent>
+
+#include "frametimingrecorder.h"
+
+static const int TraceWriteInterval = 1000;
+
+FrameTimingRecorder::FrameTimingRecorder(QQuickWindow *window)
+    : QObject(window)
+    , m_window(window)
+    , m_callbacksSent(0)
+    , m_traceSequence(0)
+{
+    m_clock.start();
+
+    connect(window, &QQuickWindow::beforeSynchronizing, this, &FrameTimingRecorder::frameStarted, Qt::DirectConnection);
+    connect(window, &QQuickWindow::beforeRendering, this, &FrameTimingRecorder::beforeRendering, Qt::DirectConnection);
+    connect(window, &QQuickWindow::afterRendering, this, &FrameTimingRecorder::afterRendering, Qt::DirectConnection);
+    connect(window, &QQuickWindow::frameSwapped, this, &FrameTimingRecorder::frameSwapped, Qt::DirectConnection);
+
+    const QByteArray traceFile = qgetenv("LIPSTICK_FRAME_TRACE");
+    if (!traceFile.isEmpty()) {
+        m_traceFile.setFileName(QString::fromLocal8Bit(traceFile));
+        if (m_traceFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            QTextStream(&m_traceFile) << "# started beforeRendering afterRendering swapped callbacksSent (ns)\n";
+            m_traceTimer.start(TraceWriteInterval, this);
+        } else {
+            qWarning() << "Cannot open frame trace file" << m_traceFile.fileName() << m_traceFile.errorString();
+        }
+    }
+}
+
+FrameTimingRecorder::~FrameTimingRecorder()
+{
+    if (m_traceFile.isOpen()) {
+        writeTrace();
+    }
+}
+
+void FrameTimingRecorder::frameCallbacksSent()
+{
+    m_callbacksSent.storeRelease(m_clock.nsecsElapsed());
+}
+
+FrameTimingSummary FrameTimingRecorder::summary() const
+{
+    return FrameTimingSummary::summarize(m_timings.snapshot(), refreshInterval());
+}
+
+void FrameTimingRecorder::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_traceTimer.timerId()) {
+        writeTrace();
+    } else {
+        QObject::timerEvent(event);
+    }
+}
+
+void FrameTimingRecorder::frameStarted()
+{
+    const qint64 now = m_clock.nsecsElapsed();
+
+    if (m_current.started > 0) {
+        // Callbacks sent after this frame was swapped belong to it
+        const qint64 callbacksSent = m_callbacksSent.loadAcquire();
+        if (callbacksSent >= m_current.swapped && m_current.swapped > 0) {
+            m_current.callbacksSent = callbacksSent;
+        }
+        m_timings.push(m_current);
+    }
+
+    m_current = FrameTiming();
+    m_current.started = now;
+}
+
+void FrameTimingRecorder::beforeRendering()
+{
+    m_current.beforeRendering = m_clock.nsecsElapsed();
+}
+
+void FrameTimingRecorder::afterRendering()
+{
+    m_current.afterRendering = m_clock.nsecsElapsed();
+}
+
+void FrameTimingRecorder::frameSwapped()
+{
+    m_current.swapped = m_clock.nsecsElapsed();
+}
+
+qint64 FrameTimingRecorder::refreshInterval() const
+{
+    const QScreen *screen = m_window->screen();
+    const qreal refreshRate = screen ? screen->refreshRate() : 0;
+    return refreshRate > 0 ? qint64(1000000000 / refreshRate) : 16666667;
+}
+
+void FrameTimingRecorder::writeTrace()
+{
+    quint32 lost = 0;
+    const QVector<FrameTiming> timings = m_timings.readSince(&m_traceSequence, &lost);
+    if (timings.isEmpty() && lost == 0) {
+        return;
+    }
+
+    QTextStream stream(&m_traceFile);
+    if (lost > 0) {
+        stream << "# " << lost << " frames lost\n";
+    }
+    for (const FrameTiming &timing : timings) {
+        stream << timing.started << ' '
+               << timing.beforeRendering << ' '
+               << timing.afterRendering << ' '
+               << timing.swapped << ' '
+               << timing.callbacksSent << '\n';
+    }
+    stream.flush();
+    m_traceFile.flush();
+}
@@ -0,0 +1,74 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef FRAMETIMINGRECORDER_H
+#define FRAMETIMINGRECORDER_H
+
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+
+#include "frametimings.h"
+
+class QQuickWindow;
+
+/*
+ * Collects the timestamps of every frame rendered by the compositor window.
+ *
+ * The scene graph signals are received directly on the render thread and
+ * only ever touch the ring buffer, so collecting is cheap enough to be always
+ * on. A frame is completed when the next one starts, which is also when the
+ * time its frame callbacks were sent is known.
+ *
+ * Setting LIPSTICK_FRAME_TRACE to a file name additionally appends every
+ * frame to that file from the main thread.
+ */
+class FrameTimingRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FrameTimingRecorder(QQuickWindow *window);
+    ~FrameTimingRecorder();
+
+    // Called on the main thread once the frame callbacks of a frame are sent
+    void frameCallbacksSent();
+
+    FrameTimingSummary summary() const;
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    // Render thread
+    void frameStarted();
+    void beforeRendering();
+    void afterRendering();
+    void frameSwapped();
+
+    qint64 refreshInterval() const;
+    void writeTrace();
+
+    QQuickWindow * const m_window;
+    QElapsedTimer m_clock;
+    FrameTimingBuffer m_timings;
+    FrameTiming m_current;
+    QAtomicInteger<qint64> m_callbacksSent;
+
+    QFile m_traceFile;
+    QBasicTimer m_traceTimer;
+    quint32 m_traceSequence;
+};
+
+#endif // FRAMETIMINGRECORDER_H
@@ -0,0 +1,166 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "frametimings.h"
+
+static quint32 roundUpToPowerOfTwo(int value)
+{
+    quint32 result = 1;
+    while (result < quint32(qMax(1, value))) {
+        result <<= 1;
+    }
+    return result;
+}
+
+FrameTimingBuffer::FrameTimingBuffer(int capacity)
+    : m_entries(2 * roundUpToPowerOfTwo(capacity))
+    , m_mask(m_entries.count() - 1)
+    , m_capacity(roundUpToPowerOfTwo(capacity))
+    , m_written(0)
+{
+}
+
+int FrameTimingBuffer::capacity() const
+{
+    return m_capacity;
+}
+
+void FrameTimingBuffer::push(const FrameTiming &timing)
+{
+    const quint32 sequence = m_written.loadAcquire();
+    m_entries[sequence & m_mask] = timing;
+    m_written.storeRelease(sequence + 1);
+}
+
+QVector<FrameTiming> FrameTimingBuffer::copy(quint32 first, quint32 end) const
+{
+    QVector<FrameTiming> result;
+    result.reserve(end - first);
+    for (quint32 sequence = first; sequence != end; ++sequence) {
+        result.append(m_entries.at(sequence & m_mask));
+    }
+
+    // The writer may have wrapped around onto the oldest entries while copying.
+    // The slot of the entry being pushed right now counts as overwritten too.
+    const quint32 written = m_written.loadAcquire();
+    const quint32 overwritten = written + 1 - first > quint32(m_entries.count())
+            ? written + 1 - first - m_entries.count()
+            : 0;
+    result.remove(0, qMin<int>(overwritten, result.count()));
+    return result;
+}
+
+QVector<FrameTiming> FrameTimingBuffer::snapshot() const
+{
+    const quint32 end = m_written.loadAcquire();
+    const quint32 available = qMin<quint32>(end, capacity());
+    return copy(end - available, end);
+}
+
+QVector<FrameTiming> FrameTimingBuffer::readSince(quint32 *sequence, quint32 *lost) const
+{
+    const quint32 end = m_written.loadAcquire();
+    quint32 first = *sequence;
+    quint32 skipped = 0;
+    if (end - first > quint32(capacity())) {
+        skipped = end - first - capacity();
+        first = end - capacity();
+    }
+
+    const QVector<FrameTiming> result = copy(first, end);
+    skipped += (end - first) - result.count();
+
+    *sequence = end;
+    if (lost) {
+        *lost = skipped;
+    }
+    return result;
+}
+
+static void percentiles(QVector<qint64> &values, qreal *p50, qreal *p95, qreal *p99)
+{
+    if (values.isEmpty()) {
+        return;
+    }
+
+    std::sort(values.begin(), values.end());
+    const auto at = [&values](qreal fraction) {
+        const int index = qMin(values.count() - 1, int(std::ceil(fraction * values.count())) - 1);
+        return values.at(qMax(0, index)) / 1000000.0;
+    };
+    *p50 = at(0.50);
+    *p95 = at(0.95);
+    *p99 = at(0.99);
+}
+
+FrameTimingSummary FrameTimingSummary::summarize(const QVector<FrameTiming> &timings, qint64 refreshInterval)
+{
+    FrameTimingSummary summary;
+
+    QVector<qint64> frameTimes;
+    QVector<qint64> renderTimes;
+    QVector<qint64> callbackDelays;
+    frameTimes.reserve(timings.count());
+    renderTimes.reserve(timings.count());
+    callbackDelays.reserve(timings.count());
+
+    for (const FrameTiming &timing : timings) {
+        if (timing.started <= 0 || timing.swapped < timing.started) {
+            continue;
+        }
+
+        ++summary.frames;
+
+        const qint64 frameTime = timing.swapped - timing.started;
+        frameTimes.append(frameTime);
+
+        // Swapping waits for the vertical blank, so only count clear misses
+        if (refreshInterval > 0 && 2 * frameTime > 3 * refreshInterval) {
+            summary.droppedFrames += int((frameTime + refreshInterval / 2) / refreshInterval) - 1;
+        }
+
+        if (timing.beforeRendering > 0 && timing.afterRendering >= timing.beforeRendering) {
+            renderTimes.append(timing.afterRendering - timing.beforeRendering);
+        }
+        if (timing.callbacksSent >= timing.started) {
+            callbackDelays.append(timing.callbacksSent - timing.started);
+        }
+    }
+
+    percentiles(frameTimes, &summary.frameTimeP50, &summary.frameTimeP95, &summary.frameTimeP99);
+    percentiles(renderTimes, &summary.renderTimeP50, &summary.renderTimeP95, &summary.renderTimeP99);
+    percentiles(callbackDelays, &summary.callbackDelayP50, &summary.callbackDelayP95, &summary.callbackDelayP99);
+
+    return summary;
+}
+
+QVariantMap FrameTimingSummary::toVariantMap() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("frames"), frames);
+    map.insert(QStringLiteral("droppedFrames"), droppedFrames);
+    map.insert(QStringLiteral("frameTimeP50"), frameTimeP50);
+    map.insert(QStringLiteral("frameTimeP95"), frameTimeP95);
+    map.insert(QStringLiteral("frameTimeP99"), frameTimeP99);
+    map.insert(QStringLiteral("renderTimeP50"), renderTimeP50);
+    map.insert(QStringLiteral("renderTimeP95"), renderTimeP95);
+    map.insert(QStringLiteral("renderTimeP99"), renderTimeP99);
+    map.insert(QStringLiteral("callbackDelayP50"), callbackDelayP50);
+    map.insert(QStringLiteral("callbackDelayP95"), callbackDelayP95);
+    map.insert(QStringLiteral("callbackDelayP99"), callbackDelayP99);
+    return map;
+}
@@ -0,0 +1,83 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef FRAMETIMINGS_H
+#define FRAMETIMINGS_H
+
+#include <QAtomicInteger>
+#include <QVariantMap>
+#include <QVector>
+
+// Timestamps of one compositor frame in nanoseconds, zero when not reached
+struct FrameTiming
+{
+    qint64 started = 0;          // Scene graph synchronization began
+    qint64 beforeRendering = 0;
+    qint64 afterRendering = 0;
+    qint64 swapped = 0;
+    qint64 callbacksSent = 0;    // Frame callbacks were sent to clients
+};
+
+/*
+ * Fixed size ring buffer of frame timings.
+ *
+ * There must be only one writer, typically the render thread, but any thread
+ * may read without blocking it. Readers copy the entries and drop the ones
+ * the writer may have overwritten meanwhile. Twice the capacity is allocated
+ * so that a reader of the most recent entries does not race with a push.
+ */
+class FrameTimingBuffer
+{
+public:
+    explicit FrameTimingBuffer(int capacity = 1024);
+
+    int capacity() const;
+
+    void push(const FrameTiming &timing);
+
+    // The most recent entries, oldest first
+    QVector<FrameTiming> snapshot() const;
+    // Entries pushed since sequence, which is advanced past the returned ones.
+    // Entries that were already overwritten are counted in lost.
+    QVector<FrameTiming> readSince(quint32 *sequence, quint32 *lost = nullptr) const;
+
+private:
+    QVector<FrameTiming> copy(quint32 first, quint32 end) const;
+
+    QVector<FrameTiming> m_entries;
+    const quint32 m_mask;
+    const int m_capacity;
+    QAtomicInteger<quint32> m_written;
+};
+
+struct FrameTimingSummary
+{
+    int frames = 0;
+    int droppedFrames = 0;      // Vertical blanks missed while a frame was in progress
+    qreal frameTimeP50 = 0;     // Milliseconds from synchronization to swap
+    qreal frameTimeP95 = 0;
+    qreal frameTimeP99 = 0;
+    qreal renderTimeP50 = 0;    // Milliseconds spent rendering
+    qreal renderTimeP95 = 0;
+    qreal renderTimeP99 = 0;
+    qreal callbackDelayP50 = 0; // Milliseconds from synchronization to frame callbacks
+    qreal callbackDelayP95 = 0;
+    qreal callbackDelayP99 = 0;
+
+    static FrameTimingSummary summarize(const QVector<FrameTiming> &timings, qint64 refreshInterval);
+
+    QVariantMap toVariantMap() const;
+};
+
+#endif // FRAMETIMINGS_H
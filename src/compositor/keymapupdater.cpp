@@ -0,0 +1,90 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QTimerEvent>
+
+#include "lipstickkeymap.h"
+#include "keymapupdater.h"
+
+KeymapUpdater::KeymapUpdater(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LipstickKeymap *KeymapUpdater::keymap() const
+{
+    return m_keymap;
+}
+
+void KeymapUpdater::setKeymap(LipstickKeymap *keymap)
+{
+    if (m_keymap == keymap)
+        return;
+
+    if (m_keymap)
+        disconnect(m_keymap, 0, this, 0);
+
+    m_keymap = keymap;
+
+    if (m_keymap) {
+        connect(m_keymap, &LipstickKeymap::rulesChanged, this, &KeymapUpdater::scheduleUpdate);
+        connect(m_keymap, &LipstickKeymap::modelChanged, this, &KeymapUpdater::scheduleUpdate);
+        connect(m_keymap, &LipstickKeymap::layoutChanged, this, &KeymapUpdater::scheduleUpdate);
+        connect(m_keymap, &LipstickKeymap::variantChanged, this, &KeymapUpdater::scheduleUpdate);
+        connect(m_keymap, &LipstickKeymap::optionsChanged, this, &KeymapUpdater::scheduleUpdate);
+        connect(m_keymap, &QObject::destroyed, this, &KeymapUpdater::scheduleUpdate);
+    }
+
+    scheduleUpdate();
+}
+
+QWaylandKeymap KeymapUpdater::appliedKeymap() const
+{
+    return m_appliedKeymap;
+}
+
+bool KeymapUpdater::isPending() const
+{
+    return m_updateTimer.isActive();
+}
+
+void KeymapUpdater::scheduleUpdate()
+{
+    m_updateTimer.start(0, this);
+}
+
+void KeymapUpdater::update()
+{
+    m_updateTimer.stop();
+
+    const QWaylandKeymap keymap = m_keymap ? m_keymap->waylandKeymap() : QWaylandKeymap();
+    const QStringList names = QStringList()
+            << keymap.rules() << keymap.model() << keymap.layout() << keymap.variant() << keymap.options();
+
+    if (names == m_appliedNames)
+        return;
+
+    m_appliedNames = names;
+    m_appliedKeymap = keymap;
+    emit keymapApplied();
+}
+
+void KeymapUpdater::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_updateTimer.timerId()) {
+        update();
+    } else {
+        QObject::timerEvent(event);
+    }
+}
@@ -0,0 +1,67 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef KEYMAPUPDATER_H
+#define KEYMAPUPDATER_H
+
+#include <QBasicTimer>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QWaylandInputDevice>
+
+class LipstickKeymap;
+
+/*
+ * Decides when the keymap of the compositor needs to be applied.
+ *
+ * Changes to the properties of the LipstickKeymap are collected until the
+ * event loop runs again, so that setting several of them in a row compiles
+ * the keymap only once. A keymap equal to the one last applied is not applied
+ * again, as it would be compiled and sent to every client for nothing.
+ */
+class KeymapUpdater : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit KeymapUpdater(QObject *parent = nullptr);
+
+    LipstickKeymap *keymap() const;
+    void setKeymap(LipstickKeymap *keymap);
+
+    // The keymap last applied, the default one until keymapApplied() is emitted
+    QWaylandKeymap appliedKeymap() const;
+
+    bool isPending() const;
+    // Applies a pending change right away
+    void update();
+
+signals:
+    void keymapApplied();
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private slots:
+    void scheduleUpdate();
+
+private:
+    QPointer<LipstickKeymap> m_keymap;
+    QBasicTimer m_updateTimer;
+    QWaylandKeymap m_appliedKeymap;
+    QStringList m_appliedNames;     // Rules, model, layout, variant and options in use
+};
+
+#endif // KEYMAPUPDATER_H
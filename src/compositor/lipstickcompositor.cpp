@@ -15,6 +15,10 @@
 
 
 #include <QWaylandInputDevice>
+#include <QtCompositorVersion>
+#if QTCOMPOSITOR_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+#include <QWaylandClient>
+#endif
 #include <QDesktopServices>
 #include <QtSensors/QOrientationSensor>
 #include <QClipboard>
@@ -22,6 +26,7 @@
 #include <QtGui/qpa/qplatformnativeinterface.h>
 #include <qpa/qwindowsysteminterface.h>
 #include <private/qguiapplication_p.h>
+#include <QtCompositor/private/qwlsurface_p.h>
 #include <QtGui/qpa/qplatformintegration.h>
 
 #include <qmcenameowner.h>
@@ -39,10 +44,22 @@
 #include "lipstickcompositoradaptor.h"
 #include "fileserviceadaptor.h"
 #include "lipstickkeymap.h"
+#include "keymapupdater.h"
 #include "lipsticksettings.h"
 #include "lipstickrecorder.h"
 #include "alienmanager/alienmanager.h"
 #include "logging.h"
+#include "framecallbackdispatcher.h"
+#include "clientaccounting.h"
+#include "frametimingrecorder.h"
+#include "snapshotpool.h"
+#include "windowocclusion.h"
+#include "windowregistry.h"
+#include "windowpropertydispatcher.h"
+#include "oomscoremanager.h"
+#include "backgroundfreezer.h"
+#include "processinfocache.h"
+#include "inputlatencyrecorder.h"
 
 LipstickCompositor *LipstickCompositor::m_instance = 0;
 
@@ -55,6 +72,8 @@ LipstickCompositor::LipstickCompositor()
 #endif
     , m_totalWindowCount(0)
     , m_nextWindowId(1)
+    , m_windowRegistry(nullptr)
+    , m_windowProperties(nullptr)
     , m_homeActive(true)
     , m_topmostWindowId(0)
     , m_topmostWindowProcessId(0)
@@ -65,8 +84,13 @@ LipstickCompositor::LipstickCompositor()
     , m_updatesEnabled(true)
     , m_completed(false)
     , m_onUpdatesDisabledUnfocusedWindowId(0)
-    , m_keymap(0)
-    , m_fakeRepaintTimerId(0)
+    , m_keymapUpdater(nullptr)
+    , m_clientAccounting(nullptr)
+    , m_frameCallbacks(nullptr)
+    , m_frameTimings(nullptr)
+    , m_occlusion(nullptr)
+    , m_oomScores(nullptr)
+    , m_freezer(nullptr)
     , m_queuedSetUpdatesEnabledCalls()
     , m_mceNameOwner(new QMceNameOwner(this))
     , m_sessionActivationTries(0)
@@ -78,13 +102,38 @@ LipstickCompositor::LipstickCompositor()
     if (m_instance) qFatal("LipstickCompositor: Only one compositor instance per process is supported");
     m_instance = this;
 
+    m_windowRegistry = new WindowRegistry(this);
+    m_windowProperties = new WindowPropertyDispatcher(this);
+    m_clientAccounting = new ClientAccounting(this);
+    m_frameCallbacks = new FrameCallbackDispatcher(this);
+    m_frameTimings = new FrameTimingRecorder(this);
+    m_occlusion = new WindowOcclusion(this);
+    m_oomScores = new OomScoreManager(this);
+    m_keymapUpdater = new KeymapUpdater(this);
+    connect(m_keymapUpdater, &KeymapUpdater::keymapApplied, this, &LipstickCompositor::applyKeymap);
+    m_freezer = new BackgroundFreezer(this);
+    InputLatencyRecorder::instance()->setWindow(this);
+
     m_orientationLock = new MGConfItem("/lipstick/orientationLock", this);
     connect(m_orientationLock, SIGNAL(valueChanged()), SIGNAL(orientationLockChanged()));
 
+    m_snapshotPoolBudget = new MGConfItem("/lipstick/snapshot_pool_budget", this);
+    connect(m_snapshotPoolBudget, SIGNAL(valueChanged()), SLOT(updateSnapshotPoolBudget()));
+    updateSnapshotPoolBudget();
+
+    m_clientAccountingLogInterval = new MGConfItem("/lipstick/client_accounting_log_interval", this);
+    connect(m_clientAccountingLogInterval, SIGNAL(valueChanged()), SLOT(updateClientAccountingLogInterval()));
+    updateClientAccountingLogInterval();
+
+    m_touchMotionCompression = new MGConfItem("/lipstick/touch_motion_compression", this);
+    connect(m_touchMotionCompression, SIGNAL(valueChanged()), SLOT(updateTouchMotionCompression()));
+    updateTouchMotionCompression();
+
     connect(this, SIGNAL(visibleChanged(bool)), this, SLOT(onVisibleChanged(bool)));
     QObject::connect(this, SIGNAL(afterRendering()), this, SLOT(windowSwapped()));
     QObject::connect(HomeApplication::instance(), SIGNAL(aboutToDestroy()), this, SLOT(homeApplicationAboutToDestroy()));
     connect(this, &QQuickWindow::afterRendering, this, &LipstickCompositor::readContent, Qt::DirectConnection);
+    connect(this, &QQuickWindow::sceneGraphInvalidated, this, &LipstickCompositor::releaseContentReader, Qt::DirectConnection);
 
     m_orientationSensor = new QOrientationSensor(this);
     QObject::connect(m_orientationSensor, SIGNAL(readingChanged()), this, SLOT(setScreenOrientationFromSensor()));
@@ -168,7 +217,7 @@ void LipstickCompositor::classBegin()
 void LipstickCompositor::onVisibleChanged(bool visible)
 {
     if (!visible) {
-        sendFrameCallbacks(surfaces());
+        m_frameCallbacks->sendToAll();
     }
 }
 
@@ -184,6 +233,15 @@ void LipstickCompositor::componentComplete()
 #endif
 }
 
+static qint64 surfaceProcessId(QWaylandSurface *surface)
+{
+#if QTCOMPOSITOR_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+    return surface->client() ? surface->client()->processId() : 0;
+#else
+    return surface->processId();
+#endif
+}
+
 void LipstickCompositor::surfaceCreated(QWaylandSurface *surface)
 {
     connect(surface, SIGNAL(mapped()), this, SLOT(surfaceMapped()));
@@ -193,8 +251,11 @@ void LipstickCompositor::surfaceCreated(QWaylandSurface *surface)
     connect(surface, SIGNAL(windowPropertyChanged(QString,QVariant)), this, SLOT(windowPropertyChanged(QString)));
     connect(surface, SIGNAL(raiseRequested()), this, SLOT(surfaceRaised()));
     connect(surface, SIGNAL(lowerRequested()), this, SLOT(surfaceLowered()));
-    connect(surface, SIGNAL(damaged(QRegion)), this, SLOT(surfaceDamaged(QRegion)));
     connect(surface, &QWaylandSurface::redraw, this, &LipstickCompositor::surfaceCommitted);
+    connect(surface, &QWaylandSurface::damaged, this, [this, surface](const QRegion &damage) {
+        m_clientAccounting->damaged(surfaceProcessId(surface), damage);
+    });
+    m_frameCallbacks->surfaceCreated(surface);
 }
 
 bool LipstickCompositor::openUrl(WaylandClient *client, const QUrl &url)
@@ -287,19 +348,7 @@ bool LipstickCompositor::completed()
 
 int LipstickCompositor::windowIdForLink(int siblingId, uint link) const
 {
-    if (LipstickCompositorWindow *sibling = m_windows.value(siblingId)) {
-        for (LipstickCompositorWindow *window : m_windows) {
-            QWaylandSurface *windowSurface  = window->surface();
-
-            if (windowSurface
-                    && sibling->processId() == window->processId()
-                    && windowSurface->windowProperties().value("WINID", uint(0)).toUInt() == link) {
-                return window->windowId();
-            }
-        }
-    }
-
-    return 0;
+    return m_windowProperties->windowIdForLink(siblingId, link);
 }
 
 void LipstickCompositor::clearKeyboardFocus()
@@ -312,15 +361,6 @@ void LipstickCompositor::setDisplayOff()
     HomeApplication::instance()->setDisplayOff();
 }
 
-void LipstickCompositor::surfaceDamaged(const QRegion &)
-{
-    if (!isVisible()) {
-        // If the compositor is not visible, do not throttle.
-        // make it conditional to QT_WAYLAND_COMPOSITOR_NO_THROTTLE?
-        sendFrameCallbacks(surfaces());
-    }
-}
-
 QObject *LipstickCompositor::clipboard() const
 {
     return QGuiApplication::clipboard();
@@ -348,6 +388,8 @@ void LipstickCompositor::setTopmostWindowId(int id)
             m_topmostWindowPolicyApplicationId = applicationId;
             emit privateTopmostWindowPolicyApplicationIdChanged(m_topmostWindowPolicyApplicationId);
         }
+
+        m_oomScores->windowFocused(window);
     }
 }
 
@@ -361,6 +403,10 @@ QWaylandSurfaceView *LipstickCompositor::createView(QWaylandSurface *surface)
     item->setParent(this);
     QObject::connect(item, SIGNAL(destroyed(QObject*)), this, SLOT(windowDestroyed()));
     m_windows.insert(item->windowId(), item);
+    m_windowProperties->windowAdded(item);
+    m_clientAccounting->setApplicationId(item->processId(), item->policyApplicationId());
+    item->setTouchMotionCompression(compressesTouchMotion(item->processId()));
+    connect(item, &QQuickItem::visibleChanged, m_oomScores, &OomScoreManager::scheduleUpdate);
     return item;
 }
 
@@ -369,6 +415,17 @@ static LipstickCompositorWindow *surfaceWindow(QWaylandSurface *surface)
     return surface->views().isEmpty() ? 0 : static_cast<LipstickCompositorWindow *>(surface->views().first());
 }
 
+static QRegion windowOpaqueRegion(LipstickCompositorWindow *window)
+{
+    QWaylandSurface *surface = window->surface();
+
+    // Overlays are drawn translucent over applications, whatever they claim
+    if (!surface || !surface->isMapped() || window->category() == QLatin1String("overlay"))
+        return QRegion();
+
+    return surface->handle()->opaqueRegion();
+}
+
 void LipstickCompositor::activateLogindSession()
 {
     m_sessionActivationTries++;
@@ -475,6 +532,7 @@ void LipstickCompositor::windowDestroyed(LipstickCompositorWindow *item)
     int id = item->windowId();
 
     m_windows.remove(id);
+    m_windowProperties->windowRemoved(item);
     surfaceUnmapped(item);
 }
 
@@ -516,6 +574,11 @@ void LipstickCompositor::surfaceMapped()
     m_totalWindowCount++;
     m_mappedSurfaces.insert(item->windowId(), item);
 
+    m_occlusion->addWindow(item);
+    m_occlusion->setOpaqueRegion(item, windowOpaqueRegion(item));
+
+    m_oomScores->scheduleUpdate();
+
     item->setTouchEventsEnabled(true);
 
     emit windowCountChanged();
@@ -545,14 +608,8 @@ void LipstickCompositor::surfaceTitleChanged()
     QWaylandSurface *surface = qobject_cast<QWaylandSurface *>(sender());
     LipstickCompositorWindow *window = surfaceWindow(surface);
 
-    if (window) {
+    if (window)
         emit window->titleChanged();
-
-        int windowId = window->windowId();
-
-        for (int ii = 0; ii < m_windowModels.count(); ++ii)
-            m_windowModels.at(ii)->titleChanged(windowId);
-    }
 }
 
 void LipstickCompositor::surfaceRaised()
@@ -577,14 +634,24 @@ void LipstickCompositor::surfaceLowered()
 
 void LipstickCompositor::windowSwapped()
 {
-    sendFrameCallbacks(surfaces());
+    m_frameCallbacks->frameRendered();
+    m_frameTimings->frameCallbacksSent();
 }
 
 void LipstickCompositor::windowDestroyed()
 {
+    LipstickCompositorWindow *window = static_cast<LipstickCompositorWindow *>(sender());
+    const qint64 processId = window->processId();
+
     m_totalWindowCount--;
-    m_windows.remove(static_cast<LipstickCompositorWindow *>(sender())->windowId());
+    m_windows.remove(window->windowId());
     emit ghostWindowCountChanged();
+
+    for (LipstickCompositorWindow *other : m_windows) {
+        if (other->processId() == processId)
+            return;
+    }
+    m_clientAccounting->clientGone(processId);
 }
 
 void LipstickCompositor::windowPropertyChanged(const QString &property)
@@ -594,33 +661,41 @@ void LipstickCompositor::windowPropertyChanged(const QString &property)
     if (debug())
         qDebug() << "Window properties changed:" << surface << surface->windowProperties();
 
-    if (property == QLatin1String("MOUSE_REGION")) {
-        LipstickCompositorWindow *window = surfaceWindow(surface);
-        if (window)
-            window->refreshMouseRegion();
-    } else if (property == QLatin1String("GRABBED_KEYS")) {
-        LipstickCompositorWindow *window = surfaceWindow(surface);
-        if (window)
-            window->refreshGrabbedKeys();
-    }
+    LipstickCompositorWindow *window = surfaceWindow(surface);
+    if (!window)
+        return;
+
+    if (property == QLatin1String("MOUSE_REGION"))
+        window->refreshMouseRegion();
+    else if (property == QLatin1String("GRABBED_KEYS"))
+        window->refreshGrabbedKeys();
+
+    m_windowProperties->propertyChanged(window, property);
 }
 
 void LipstickCompositor::surfaceUnmapped(QWaylandSurface *surface)
 {
     LipstickCompositorWindow *window = surfaceWindow(surface);
-    if (window)
+    if (window) {
+        // Nothing is drawn for the window until it is mapped again
+        m_occlusion->setOpaqueRegion(window, QRegion());
         emit windowHidden(window);
+    }
 }
 
 void LipstickCompositor::surfaceUnmapped(LipstickCompositorWindow *item)
 {
     int id = item->windowId();
 
+    m_occlusion->removeWindow(item);
+
     int gc = ghostWindowCount();
     if (m_mappedSurfaces.remove(item->windowId()) == 0)
         // It was unmapped already so nothing to do
         return;
 
+    m_oomScores->scheduleUpdate();
+
     emit windowCountChanged();
     emit windowRemoved(item);
 
@@ -634,14 +709,12 @@ void LipstickCompositor::surfaceUnmapped(LipstickCompositorWindow *item)
 
 void LipstickCompositor::windowAdded(int id)
 {
-    for (int ii = 0; ii < m_windowModels.count(); ++ii)
-        m_windowModels.at(ii)->addItem(id);
+    m_windowRegistry->windowAdded(id);
 }
 
 void LipstickCompositor::windowRemoved(int id)
 {
-    for (int ii = 0; ii < m_windowModels.count(); ++ii)
-        m_windowModels.at(ii)->remItem(id);
+    m_windowRegistry->windowRemoved(id);
 }
 
 void LipstickCompositor::setTopmostWindowOrientation(Qt::ScreenOrientation topmostWindowOrientation)
@@ -674,44 +747,22 @@ bool LipstickCompositor::displayDimmed() const
 
 LipstickKeymap *LipstickCompositor::keymap() const
 {
-    return m_keymap;
+    return m_keymapUpdater->keymap();
 }
 
 void LipstickCompositor::setKeymap(LipstickKeymap *keymap)
 {
-    if (m_keymap == keymap)
+    if (m_keymapUpdater->keymap() == keymap)
         return;
 
-    bool update = true;
-
-    if (m_keymap && keymap)
-        update = (*m_keymap != *keymap);
-
-    if (m_keymap)
-        disconnect(m_keymap, 0, this, 0);
-
-    m_keymap = keymap;
-
-    if (m_keymap) {
-        connect(m_keymap, &LipstickKeymap::rulesChanged, this, &LipstickCompositor::updateKeymap);
-        connect(m_keymap, &LipstickKeymap::modelChanged, this, &LipstickCompositor::updateKeymap);
-        connect(m_keymap, &LipstickKeymap::layoutChanged, this, &LipstickCompositor::updateKeymap);
-        connect(m_keymap, &LipstickKeymap::variantChanged, this, &LipstickCompositor::updateKeymap);
-        connect(m_keymap, &LipstickKeymap::optionsChanged, this, &LipstickCompositor::updateKeymap);
-    }
-
-    if (update)
-        updateKeymap();
+    m_keymapUpdater->setKeymap(keymap);
 
     emit keymapChanged();
 }
 
-void LipstickCompositor::updateKeymap()
+void LipstickCompositor::applyKeymap()
 {
-    if (m_keymap)
-        defaultInputDevice()->setKeymap(m_keymap->waylandKeymap());
-    else
-        defaultInputDevice()->setKeymap(QWaylandKeymap());
+    defaultInputDevice()->setKeymap(m_keymapUpdater->appliedKeymap());
 }
 
 void LipstickCompositor::reactOnDisplayStateChanges(TouchScreen::DisplayState oldState, TouchScreen::DisplayState newState)
@@ -797,7 +848,7 @@ void LipstickCompositor::setUpdatesEnabledNow(bool enabled)
                 QGuiApplication::platformNativeInterface()->nativeResourceForIntegration("DisplayOff");
             }
             // trigger frame callbacks which are pending already at this time
-            surfaceCommitted();
+            m_frameCallbacks->sendToAll();
         } else {
             if (QWindow::handle()) {
                 QGuiApplication::platformNativeInterface()->nativeResourceForIntegration("DisplayOn");
@@ -856,29 +907,123 @@ void LipstickCompositor::processQueuedSetUpdatesEnabledCalls()
     }
 }
 
+QVariantMap LipstickCompositor::frameCallbackCounters() const
+{
+    QVariantMap counters;
+    const QHash<qint64, ClientUsage> clients = m_clientAccounting->usage();
+    for (auto it = clients.constBegin(); it != clients.constEnd(); ++it) {
+        QVariantMap client;
+        client.insert(QStringLiteral("sent"), it->frameCallbacksSent);
+        client.insert(QStringLiteral("throttled"), it->frameCallbacksThrottled);
+        counters.insert(QString::number(it.key()), client);
+    }
+    return counters;
+}
+
+QVariantMap LipstickCompositor::clientUsage() const
+{
+    return m_clientAccounting->toVariantMap();
+}
+
+QVariantMap LipstickCompositor::inputLatency() const
+{
+    return InputLatencyRecorder::instance()->toVariantMap();
+}
+
+QVariantMap LipstickCompositor::frameTimings() const
+{
+    return m_frameTimings->summary().toVariantMap();
+}
+
+QVariantMap LipstickCompositor::snapshotPoolStatistics() const
+{
+    return SnapshotPool::instance()->statistics().toVariantMap();
+}
+
+bool LipstickCompositor::isPrivileged()
+{
+    if (!calledFromDBus()) {
+        return true;
+    }
+
+    uint pid = connection().interface()->servicePid(message().service()).value();
+    if (!ProcessInfoCache::instance()->info(pid).isPrivileged()) {
+        QString errorString = QString("PID %1 is not in privileged group").arg(pid);
+        sendErrorReply(QDBusError::AccessDenied, errorString);
+        return false;
+    }
+    return true;
+}
+
+void LipstickCompositor::thawProcess(int pid)
+{
+    if (!isPrivileged())
+        return;
+
+    m_freezer->thaw(pid);
+}
+
+void LipstickCompositor::setFreezeExemption(int pid, const QString &reason, bool exempt)
+{
+    if (!isPrivileged())
+        return;
+
+    m_freezer->setExemption(pid, reason, exempt);
+}
+
+void LipstickCompositor::updateSnapshotPoolBudget()
+{
+    // In megabytes, shared by the snapshots of all window pixmap items
+    const QVariant budget = m_snapshotPoolBudget->value();
+    SnapshotPool::instance()->setBudget(budget.isValid()
+            ? budget.toLongLong() * 1024 * 1024
+            : qint64(SnapshotPool::DefaultBudget));
+}
+
+void LipstickCompositor::updateClientAccountingLogInterval()
+{
+    // In seconds, zero turns the periodic log off
+    m_clientAccounting->setLogInterval(m_clientAccountingLogInterval->value(0).toInt());
+}
+
+void LipstickCompositor::updateTouchMotionCompression()
+{
+    // Names of the client binaries whose touch motion is coalesced, "*" for every client
+    m_touchMotionCompressionClients = m_touchMotionCompression->value().toStringList();
+    for (LipstickCompositorWindow *window : m_windows)
+        window->setTouchMotionCompression(compressesTouchMotion(window->processId()));
+}
+
+bool LipstickCompositor::compressesTouchMotion(qint64 processId) const
+{
+    if (m_touchMotionCompressionClients.isEmpty() || processId <= 0)
+        return false;
+
+    return m_touchMotionCompressionClients.contains(QStringLiteral("*"))
+            || m_touchMotionCompressionClients.contains(ProcessInfoCache::instance()->info(processId).name());
+}
+
 void LipstickCompositor::readContent()
 {
     m_recorder->recordFrame(this);
 }
 
-void LipstickCompositor::surfaceCommitted()
+void LipstickCompositor::releaseContentReader()
 {
-    if (!isVisible() && m_fakeRepaintTimerId == 0) {
-        m_fakeRepaintTimerId = startTimer(1000);
-    } else if (isVisible() && m_fakeRepaintTimerId > 0) {
-        killTimer(m_fakeRepaintTimerId);
-        m_fakeRepaintTimerId = 0;
-    }
+    m_recorder->releaseResources();
 }
 
-void LipstickCompositor::timerEvent(QTimerEvent *e)
+void LipstickCompositor::surfaceCommitted()
 {
-    if (e->timerId() == m_fakeRepaintTimerId) {
-        frameStarted();
-        sendFrameCallbacks(surfaces());
-        killTimer(e->timerId());
-        m_fakeRepaintTimerId = 0;
-    }
+    QWaylandSurface *surface = static_cast<QWaylandSurface *>(sender());
+
+    m_frameCallbacks->surfaceCommitted(surface);
+
+    if (surface->isMapped())
+        m_clientAccounting->bufferCommitted(surfaceProcessId(surface), surface->size());
+
+    if (LipstickCompositorWindow *window = surfaceWindow(surface))
+        m_occlusion->setOpaqueRegion(window, windowOpaqueRegion(window));
 }
 
 bool LipstickCompositor::event(QEvent *event)
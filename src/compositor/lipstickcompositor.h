@@ -44,7 +44,16 @@ class LipstickCompositorProcWindow;
 class QOrientationSensor;
 class LipstickRecorderManager;
 class LipstickKeymap;
+class KeymapUpdater;
 class QMceNameOwner;
+class FrameCallbackDispatcher;
+class FrameTimingRecorder;
+class WindowOcclusion;
+class OomScoreManager;
+class BackgroundFreezer;
+class ClientAccounting;
+class WindowRegistry;
+class WindowPropertyDispatcher;
 
 struct QueuedSetUpdatesEnabledCall
 {
@@ -153,10 +162,17 @@ public:
 
     void setUpdatesEnabledNow(bool enabled);
     void setUpdatesEnabled(bool enabled);
+
+    QVariantMap frameCallbackCounters() const;
+    QVariantMap frameTimings() const;
+    QVariantMap snapshotPoolStatistics() const;
+    QVariantMap clientUsage() const;
+    QVariantMap inputLatency() const;
+    void thawProcess(int pid);
+    void setFreezeExemption(int pid, const QString &reason, bool exempt);
     QWaylandSurfaceView *createView(QWaylandSurface *surf) Q_DECL_OVERRIDE;
 
 protected:
-    void timerEvent(QTimerEvent *e) Q_DECL_OVERRIDE;
     bool event(QEvent *e) Q_DECL_OVERRIDE;
     void sendKeyEvent(QEvent::Type type, Qt::Key key, quint32 nativeScanCode);
 
@@ -202,7 +218,6 @@ private slots:
     void surfaceTitleChanged();
     void surfaceRaised();
     void surfaceLowered();
-    void surfaceDamaged(const QRegion &);
     void windowSwapped();
     void windowDestroyed();
     void windowPropertyChanged(const QString &);
@@ -211,7 +226,10 @@ private slots:
     void setScreenOrientationFromSensor();
     void clipboardDataChanged();
     void onVisibleChanged(bool visible);
-    void updateKeymap();
+    void applyKeymap();
+    void updateSnapshotPoolBudget();
+    void updateClientAccountingLogInterval();
+    void updateTouchMotionCompression();
     void initialize();
     void processQueuedSetUpdatesEnabledCalls();
 
@@ -219,10 +237,20 @@ private:
     friend class LipstickCompositorWindow;
     friend class LipstickCompositorProcWindow;
     friend class WindowModel;
+    friend class WindowRegistry;
     friend class WindowPixmapItem;
     friend class WindowProperty;
+    friend class WindowPropertyDispatcher;
+    friend class FrameCallbackDispatcher;
+    friend class OomScoreManager;
+    friend class BackgroundFreezer;
+#ifdef UNIT_TEST
+    friend class Ut_WindowPropertyDispatcher;
+    friend class Ut_WindowRegistry;
+#endif
 
     void surfaceUnmapped(LipstickCompositorWindow *item);
+    bool isPrivileged();
 
     int windowIdForLink(int, uint) const;
 
@@ -232,9 +260,11 @@ private:
     void windowRemoved(int);
     void windowDestroyed(LipstickCompositorWindow *item);
     void readContent();
+    void releaseContentReader();
     void surfaceCommitted();
 
     void activateLogindSession();
+    bool compressesTouchMotion(qint64 processId) const;
 
     static LipstickCompositor *m_instance;
 
@@ -249,7 +279,8 @@ private:
     QHash<int, LipstickCompositorWindow *> m_windows;
 
     int m_nextWindowId;
-    QList<WindowModel *> m_windowModels;
+    WindowRegistry *m_windowRegistry;
+    WindowPropertyDispatcher *m_windowProperties;
 
     bool m_homeActive;
 
@@ -262,12 +293,21 @@ private:
     QOrientationSensor* m_orientationSensor;
     QPointer<QMimeData> m_retainedSelection;
     MGConfItem *m_orientationLock;
+    MGConfItem *m_snapshotPoolBudget;
+    MGConfItem *m_clientAccountingLogInterval;
+    MGConfItem *m_touchMotionCompression;
+    QStringList m_touchMotionCompressionClients;
     bool m_updatesEnabled;
     bool m_completed;
     int m_onUpdatesDisabledUnfocusedWindowId;
     LipstickRecorderManager *m_recorder;
-    LipstickKeymap *m_keymap;
-    int m_fakeRepaintTimerId;
+    KeymapUpdater *m_keymapUpdater;
+    ClientAccounting *m_clientAccounting;
+    FrameCallbackDispatcher *m_frameCallbacks;
+    FrameTimingRecorder *m_frameTimings;
+    WindowOcclusion *m_occlusion;
+    OomScoreManager *m_oomScores;
+    BackgroundFreezer *m_freezer;
 
     QList<QueuedSetUpdatesEnabledCall> m_queuedSetUpdatesEnabledCalls;
     QMceNameOwner *m_mceNameOwner;
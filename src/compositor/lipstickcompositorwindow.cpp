@@ -21,12 +21,24 @@
 #if QTCOMPOSITOR_VERSION >= QT_VERSION_CHECK(5, 6, 0)
 #include <QWaylandClient>
 #endif
+#include <QElapsedTimer>
 #include <QTimer>
+#include <QTimerEvent>
 #include <sys/types.h>
 #include <signal.h>
 #include "lipstickcompositor.h"
 #include "lipstickcompositorwindow.h"
+#include "clientaccounting.h"
+#include "processinfocache.h"
+#include "inputlatencyrecorder.h"
 
+static qint64 touchClock()
+{
+    static QElapsedTimer clock;
+    if (!clock.isValid())
+        clock.start();
+    return clock.elapsed();
+}
 
 LipstickCompositorWindow::LipstickCompositorWindow(int windowId, const QString &category,
                                                    QWaylandQuickSurface *surface, QQuickItem *parent)
@@ -76,34 +88,14 @@ void LipstickCompositorWindow::updatePolicyApplicationId()
         return;
     }
 
-    QString statFile = QString::fromLatin1("/proc/%1/stat").arg(m_processId);
-    QFile f(statFile);
-    if (!f.open(QIODevice::ReadOnly)) {
-        qWarning() << Q_FUNC_INFO << "Cannot open proc stat for" << statFile;
-        return;
-    }
-
-    // stat line values are split by ' ' in /proc/*/stat
-    QByteArray data = f.readAll();
-    QList<QByteArray> statFields = data.split(' ');
-
-    // starttime is field 22, format %lld in stat, see man page for details.
-    if (statFields.count() < 22) {
-        qWarning() << Q_FUNC_INFO << "fields count < 22";
-        return;
-    }
-
-    QString starttime = QString::fromUtf8(statFields.at(21));
-    bool ok;
-    qint64 value = starttime.toLongLong(&ok, 10);
-
-    if (!ok) {
-        qWarning() << Q_FUNC_INFO << "toLongLong not ok:" << starttime;
+    const ProcessInfo info = ProcessInfoCache::instance()->info(m_processId);
+    if (!info.isValid()) {
+        qWarning() << Q_FUNC_INFO << "Cannot read the start time of process" << m_processId;
         return;
     }
 
     // format value as hex
-    m_policyApplicationId = QString("%1").arg(value, 0, 16);
+    m_policyApplicationId = QString("%1").arg(info.startTime, 0, 16);
 }
 
 QVariant LipstickCompositorWindow::userData() const
@@ -200,7 +192,7 @@ void LipstickCompositorWindow::tryRemove()
 QRect LipstickCompositorWindow::mouseRegionBounds() const
 {
     if (m_mouseRegionValid)
-        return m_mouseRegion.boundingRect();
+        return m_mouseHitTest.boundingRect();
     else
         return QRect(0, 0, width(), height());
 }
@@ -212,10 +204,13 @@ void LipstickCompositorWindow::refreshMouseRegion()
         QVariantMap properties = s->windowProperties();
         if (properties.contains(QLatin1String("MOUSE_REGION"))) {
             m_mouseRegion = s->windowProperties().value("MOUSE_REGION").value<QRegion>();
+            m_mouseHitTest = RegionHitTest(m_mouseRegion);
             m_mouseRegionValid = true;
             if (LipstickCompositor::instance()->debug())
                 qDebug() << "Window" << windowId() << "mouse region set:" << m_mouseRegion;
         } else {
+            m_mouseRegion = QRegion();
+            m_mouseHitTest = RegionHitTest();
             m_mouseRegionValid = false;
             if (LipstickCompositor::instance()->debug())
                 qDebug() << "Window" << windowId() << "mouse region cleared";
@@ -286,6 +281,7 @@ bool LipstickCompositorWindow::eventFilter(QObject *obj, QEvent *event)
                 m_pressedGrabbedKeys.keys << ke->key();
             }
             inputDevice->sendFullKeyEvent(ke);
+            inputEventDelivered(ke);
             if (event->type() == QEvent::KeyRelease) {
                 m_pressedGrabbedKeys.keys.removeOne(ke->key());
                 if (m_pressedGrabbedKeys.keys.isEmpty()) {
@@ -326,7 +322,7 @@ bool LipstickCompositorWindow::event(QEvent *e)
 void LipstickCompositorWindow::mousePressEvent(QMouseEvent *event)
 {
     QWaylandSurface *m_surface = surface();
-    if (m_surface && (!m_mouseRegionValid || m_mouseRegion.contains(event->pos())) &&
+    if (m_surface && (!m_mouseRegionValid || m_mouseHitTest.contains(event->pos())) &&
         m_surface->inputRegionContains(event->pos()) && event->source() != Qt::MouseEventSynthesizedByQt) {
         QWaylandInputDevice *inputDevice = m_surface->compositor()->defaultInputDevice();
         if (inputDevice->mouseFocus() != this) {
@@ -336,6 +332,7 @@ void LipstickCompositorWindow::mousePressEvent(QMouseEvent *event)
             }
         }
         inputDevice->sendMousePressEvent(event->button(), event->pos(), event->globalPos());
+        inputEventDelivered(event);
     } else {
         event->ignore();
     }
@@ -347,6 +344,7 @@ void LipstickCompositorWindow::mouseMoveEvent(QMouseEvent *event)
     if (m_surface && event->source() != Qt::MouseEventSynthesizedByQt) {
         QWaylandInputDevice *inputDevice = m_surface->compositor()->defaultInputDevice();
         inputDevice->sendMouseMoveEvent(this, event->pos(), event->globalPos());
+        inputEventDelivered(event);
     } else {
         event->ignore();
     }
@@ -358,6 +356,7 @@ void LipstickCompositorWindow::mouseReleaseEvent(QMouseEvent *event)
     if (m_surface && event->source() != Qt::MouseEventSynthesizedByQt) {
         QWaylandInputDevice *inputDevice = m_surface->compositor()->defaultInputDevice();
         inputDevice->sendMouseReleaseEvent(event->button(), event->pos(), event->globalPos());
+        inputEventDelivered(event);
     } else {
         event->ignore();
     }
@@ -369,11 +368,26 @@ void LipstickCompositorWindow::wheelEvent(QWheelEvent *event)
     if (m_surface) {
         QWaylandInputDevice *inputDevice = m_surface->compositor()->defaultInputDevice();
         inputDevice->sendMouseWheelEvent(event->orientation(), event->delta());
+        inputEventDelivered(event);
     } else {
         event->ignore();
     }
 }
 
+void LipstickCompositorWindow::keyPressEvent(QKeyEvent *event)
+{
+    QWaylandSurfaceItem::keyPressEvent(event);
+    if (event->isAccepted())
+        inputEventDelivered(event);
+}
+
+void LipstickCompositorWindow::keyReleaseEvent(QKeyEvent *event)
+{
+    QWaylandSurfaceItem::keyReleaseEvent(event);
+    if (event->isAccepted())
+        inputEventDelivered(event);
+}
+
 void LipstickCompositorWindow::touchEvent(QTouchEvent *event)
 {
     if (touchEventsEnabled() && surface()) {
@@ -404,7 +418,7 @@ void LipstickCompositorWindow::handleTouchEvent(QTouchEvent *event)
 
     if (event->touchPointStates() & Qt::TouchPointPressed) {
         foreach (const QTouchEvent::TouchPoint &p, points) {
-            if ((m_mouseRegionValid && !m_mouseRegion.contains(p.pos().toPoint())) ||
+            if ((m_mouseRegionValid && !m_mouseHitTest.contains(p.pos().toPoint())) ||
                 !m_surface->inputRegionContains(p.pos().toPoint())) {
                 event->ignore();
                 return;
@@ -425,7 +439,83 @@ void LipstickCompositorWindow::handleTouchEvent(QTouchEvent *event)
             takeFocus();
         }
     }
+
+    const qint64 now = touchClock();
+    if (m_touchMotion.hold(event, now)) {
+        // Goes out after MaximumHold even if the client never draws and no touch event follows
+        if (!m_touchMotionTimer.isActive())
+            m_touchMotionTimer.start(m_touchMotion.dueIn(now), this);
+        return;
+    }
+
+    // Held motion goes first, so that presses and releases arrive in order
+    sendHeldTouchMotion(now);
     inputDevice->sendFullTouchEvent(event);
+    inputEventDelivered(event);
+    if (LipstickCompositor *compositor = LipstickCompositor::instance())
+        compositor->m_clientAccounting->touchEventDispatched(m_processId, 0);
+
+    if (event->type() == QEvent::TouchEnd || event->type() == QEvent::TouchCancel)
+        m_touchMotion.reset();
+}
+
+void LipstickCompositorWindow::setTouchMotionCompression(bool enabled)
+{
+    if (m_touchMotion.isEnabled() != enabled) {
+        sendHeldTouchMotion(touchClock());
+        m_touchMotion.setEnabled(enabled);
+    }
+}
+
+void LipstickCompositorWindow::sendHeldTouchMotion(qint64 now)
+{
+    m_touchMotionTimer.stop();
+    if (!m_touchMotion.hasPending())
+        return;
+
+    const int coalesced = m_touchMotion.pendingCount() - 1;
+    const qint64 latency = m_touchMotion.pendingAge(now);
+    QTouchEvent event = m_touchMotion.takePending(now);
+
+    // Motion held for a surface that has lost the touch focus meanwhile is stale
+    QWaylandSurface *m_surface = surface();
+    if (!m_surface)
+        return;
+    QWaylandInputDevice *inputDevice = m_surface->compositor()->defaultInputDevice();
+    if (inputDevice->mouseFocus() != this)
+        return;
+
+    inputDevice->sendFullTouchEvent(&event);
+    inputEventDelivered(&event);
+    if (LipstickCompositor *compositor = LipstickCompositor::instance())
+        compositor->m_clientAccounting->touchEventDispatched(m_processId, latency, coalesced);
+}
+
+void LipstickCompositorWindow::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_touchMotionTimer.timerId()) {
+        const qint64 now = touchClock();
+        const qint64 dueIn = m_touchMotion.dueIn(now);
+        if (dueIn > 0)
+            m_touchMotionTimer.start(dueIn, this);
+        else
+            sendHeldTouchMotion(now);
+    } else {
+        QWaylandSurfaceItem::timerEvent(event);
+    }
+}
+
+void LipstickCompositorWindow::frameCallbackSent()
+{
+    if (m_touchMotion.frameSent())
+        sendHeldTouchMotion(touchClock());
+}
+
+void LipstickCompositorWindow::inputEventDelivered(const QInputEvent *event)
+{
+    InputLatencyRecorder::instance()->eventDispatched(event);
+    if (LipstickCompositor *compositor = LipstickCompositor::instance())
+        compositor->m_clientAccounting->inputEventDelivered(m_processId);
 }
 
 void LipstickCompositorWindow::handleTouchCancel()
@@ -439,6 +529,8 @@ void LipstickCompositorWindow::handleTouchCancel()
         inputDevice->sendTouchCancelEvent();
         inputDevice->setMouseFocus(0, QPointF());
     }
+    m_touchMotion.reset();
+    m_touchMotionTimer.stop();
     if (QWindow *w = window())
         w->removeEventFilter(this);
     m_interceptingTouch = false;
@@ -17,8 +17,11 @@
 
 #include <QWaylandSurfaceItem>
 #include <QWaylandBufferRef>
+#include <QBasicTimer>
 #include <QPointer>
 #include "lipstickglobal.h"
+#include "regionhittest.h"
+#include "touchmotioncompressor.h"
 
 class LipstickCompositorWindowHwcNode;
 
@@ -80,6 +83,9 @@ protected:
     virtual void mouseReleaseEvent(QMouseEvent *event);
     virtual void wheelEvent(QWheelEvent *event);
     virtual void touchEvent(QTouchEvent *event);
+    virtual void keyPressEvent(QKeyEvent *event);
+    virtual void keyReleaseEvent(QKeyEvent *event);
+    virtual void timerEvent(QTimerEvent *event);
 
 signals:
     void userDataChanged();
@@ -97,6 +103,7 @@ private slots:
 private:
     friend class LipstickCompositor;
     friend class WindowPixmapItem;
+    friend class FrameCallbackDispatcher;
     void imageAddref(QQuickItem *item);
     void imageRelease(QQuickItem *item);
 
@@ -105,6 +112,10 @@ private:
     void refreshMouseRegion();
     void refreshGrabbedKeys();
     void handleTouchEvent(QTouchEvent *e);
+    void inputEventDelivered(const QInputEvent *event);
+    void setTouchMotionCompression(bool enabled);
+    void sendHeldTouchMotion(qint64 now);
+    void frameCallbackSent();
 
     void updatePolicyApplicationId();
 
@@ -122,6 +133,9 @@ private:
     bool m_focusOnTouch : 1;
     QVariant m_data;
     QRegion m_mouseRegion;
+    RegionHitTest m_mouseHitTest;
+    TouchMotionCompressor m_touchMotion;
+    QBasicTimer m_touchMotionTimer;
     QList<int> m_grabbedKeys;
     struct {
         QPointer<QWaylandSurface> oldFocus;
@@ -14,8 +14,11 @@
 
 #include <sys/time.h>
 #include <grp.h>
+#include <string.h>
 
 #include <QMutexLocker>
+#include <QOpenGLContext>
+#include <QTimerEvent>
 
 #include "lipstickrecorder.h"
 #include "lipstickcompositor.h"
@@ -27,32 +30,51 @@ static uint32_t getTime()
     return tv.tv_sec * 1000 + tv.tv_usec / 1000;
 }
 
+// Converts from window coordinates to OpenGL framebuffer coordinates
+static QRect toFramebuffer(const QRect &rect, int windowHeight)
+{
+    return QRect(rect.x(), windowHeight - rect.y() - rect.height(), rect.width(), rect.height());
+}
+
 static const QEvent::Type FrameEventType = (QEvent::Type)QEvent::registerEventType();
 static const QEvent::Type FailedEventType = (QEvent::Type)QEvent::registerEventType();
 
 class FrameEvent : public QEvent
 {
 public:
-    FrameEvent(uint32_t t)
+    FrameEvent(const CapturedFramePointer &f, quint32 s)
         : QEvent(FrameEventType)
-        , time(t)
+        , frame(f)
+        , serial(s)
     { }
-    uint32_t time;
+    CapturedFramePointer frame;
+    quint32 serial;
 };
 
 class FailedEvent : public QEvent
 {
 public:
-    FailedEvent(int r)
+    FailedEvent(int r, quint32 s)
         : QEvent(FailedEventType)
         , result(r)
+        , serial(s)
     { }
     int result;
+    quint32 serial;
 };
 
 LipstickRecorderManager::LipstickRecorderManager()
                        : QWaylandGlobalInterface()
+                       , m_readback(Q_NULLPTR)
+                       , m_renderedFrames(0)
+{
+}
+
+LipstickRecorderManager::~LipstickRecorderManager()
 {
+    // The readback is released with the scene graph, without a context there is nothing to free
+    if (m_readback && QOpenGLContext::currentContext() == m_readback->context())
+        delete m_readback;
 }
 
 const wl_interface* LipstickRecorderManager::interface() const
@@ -62,43 +84,89 @@ const wl_interface* LipstickRecorderManager::interface() const
 
 void LipstickRecorderManager::recordFrame(QWindow *window)
 {
+    m_renderedFrames.fetchAndAddRelease(1);
+
     QMutexLocker lock(&m_mutex);
-    if (m_requests.isEmpty())
+    if (m_requests.isEmpty() && m_pending.isEmpty())
         return;
 
-    uchar *pixels;
-    uint32_t time = getTime();
-    foreach (LipstickRecorder *recorder, m_requests.values(window)) {
-        wl_shm_buffer *buffer = recorder->buffer();
-        pixels = static_cast<uchar *>(wl_shm_buffer_get_data(buffer));
-        int width = wl_shm_buffer_get_width(buffer);
-        int height = wl_shm_buffer_get_height(buffer);
-        int stride = wl_shm_buffer_get_stride(buffer);
-        int bpp = 4;
-
-        if (width < window->width() || height < window->height() || stride < window->width() * bpp) {
-            qApp->postEvent(recorder, new FailedEvent(QtWaylandServer::lipstick_recorder::result_bad_buffer));
-            continue;
-        }
+    if (!m_readback)
+        m_readback = new FrameReadback(QOpenGLContext::currentContext());
+
+    // Don't stall the render thread on the GPU, requests are served with a later frame
+    if (m_readback->isPending() && !m_readback->isReady()) {
+        QMetaObject::invokeMethod(window, "update", Qt::QueuedConnection);
+        return;
+    }
+
+    const QList<LipstickRecorder *> requested = m_requests.values(window);
+    m_requests.remove(window);
 
-        glPixelStorei(GL_PACK_ALIGNMENT, 1);
-        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-        qApp->postEvent(recorder, new FrameEvent(time));
+    // Read only as much as the recorders need
+    QRect region;
+    foreach (LipstickRecorder *recorder, requested)
+        region |= m_regions.take(recorder);
+    region &= QRect(QPoint(0, 0), window->size());
 
-        m_requests.remove(window, recorder);
+    // Only the GPU side copy happens here, recorders write into their buffers on the main thread
+    CapturedFramePointer frame;
+    QList<LipstickRecorder *> recorders;
+    if (!requested.isEmpty()) {
+        frame = m_readback->read(toFramebuffer(region, window->height()), getTime());
+        if (m_readback->isAsynchronous()) {
+            recorders = m_pending;
+            m_pending = requested;
+        } else {
+            recorders = requested;
+        }
+    } else {
+        frame = m_readback->finish();
+        recorders = m_pending;
+        m_pending.clear();
+    }
+
+    foreach (LipstickRecorder *recorder, recorders) {
+        const quint32 serial = m_serials.take(recorder);
+        if (frame)
+            qApp->postEvent(recorder, new FrameEvent(frame, serial));
+        else
+            qApp->postEvent(recorder, new FailedEvent(QtWaylandServer::lipstick_recorder::result_readback_failed, serial));
     }
+
+    // Draw another frame to complete the read even if nothing else changes
+    if (m_readback->isPending())
+        QMetaObject::invokeMethod(window, "update", Qt::QueuedConnection);
 }
 
-void LipstickRecorderManager::requestFrame(QWindow *window, LipstickRecorder *recorder)
+void LipstickRecorderManager::releaseResources()
 {
     QMutexLocker lock(&m_mutex);
+    delete m_readback;
+    m_readback = Q_NULLPTR;
+
+    foreach (LipstickRecorder *recorder, m_pending)
+        qApp->postEvent(recorder, new FailedEvent(QtWaylandServer::lipstick_recorder::result_readback_failed, m_serials.take(recorder)));
+    m_pending.clear();
+}
+
+void LipstickRecorderManager::requestFrame(QWindow *window, LipstickRecorder *recorder, const QRect &region, quint32 serial)
+{
+    QMutexLocker lock(&m_mutex);
+    // A new request cancels the one still being read
+    m_pending.removeAll(recorder);
+    m_requests.remove(window, recorder);
     m_requests.insert(window, recorder);
+    m_regions.insert(recorder, region);
+    m_serials.insert(recorder, serial);
 }
 
 void LipstickRecorderManager::remove(QWindow *window, LipstickRecorder *recorder)
 {
     QMutexLocker lock(&m_mutex);
     m_requests.remove(window, recorder);
+    m_regions.remove(recorder);
+    m_serials.remove(recorder);
+    m_pending.removeAll(recorder);
 }
 
 void LipstickRecorderManager::bind(wl_client *client, quint32 version, quint32 id)
@@ -122,23 +190,36 @@ void LipstickRecorderManager::lipstick_recorder_manager_create_recorder(Resource
     // a way to do that in qtcompositor yet. Just ignore it for now and use the one window we have.
     Q_UNUSED(output)
 
-    new LipstickRecorder(this, resource->client(), id, LipstickCompositor::instance());
+    new LipstickRecorder(this, resource->client(), id, resource->version(), LipstickCompositor::instance());
 }
 
 
-LipstickRecorder::LipstickRecorder(LipstickRecorderManager *manager, wl_client *client, quint32 id, QQuickWindow *window)
-                : QtWaylandServer::lipstick_recorder(client, id, 1)
+LipstickRecorder::LipstickRecorder(LipstickRecorderManager *manager, wl_client *client, quint32 id, int version, QQuickWindow *window)
+                : QtWaylandServer::lipstick_recorder(client, id, version)
                 , m_manager(manager)
                 , m_bufferResource(Q_NULLPTR)
+                , m_buffer(Q_NULLPTR)
+                , m_bufferSerial(0)
                 , m_client(client)
                 , m_window(window)
+                , m_scale(1)
+                , m_frameInterval(0)
+                , m_renderedFrames(0)
+                , m_repaintRequested(false)
+                , m_damageTracking(false)
+                , m_lastBuffer(Q_NULLPTR)
 {
-    send_setup(window->width(), window->height(), window->width() * 4, WL_SHM_FORMAT_RGBA8888);
+    m_lastBufferListener.listener.notify = lastBufferDestroyed;
+    m_lastBufferListener.recorder = this;
+    wl_list_init(&m_lastBufferListener.listener.link);
+
+    sendSetup();
 }
 
 LipstickRecorder::~LipstickRecorder()
 {
     m_manager->remove(m_window, this);
+    setLastBuffer(Q_NULLPTR);
 }
 
 void LipstickRecorder::lipstick_recorder_destroy_resource(Resource *resource)
@@ -156,12 +237,19 @@ void LipstickRecorder::lipstick_recorder_record_frame(Resource *resource, ::wl_r
 {
     Q_UNUSED(resource)
     if (m_bufferResource) {
-        send_cancelled(buffer);
+        send_cancelled(m_bufferResource);
     }
     m_bufferResource = buffer;
     m_buffer = wl_shm_buffer_get(buffer);
+    ++m_bufferSerial;
     if (m_buffer) {
-        m_manager->requestFrame(m_window, this);
+        const qint64 elapsed = m_lastRecorded.isValid() ? m_lastRecorded.elapsed() : m_frameInterval;
+        if (elapsed < m_frameInterval) {
+            m_manager->remove(m_window, this);
+            m_holdTimer.start(m_frameInterval - elapsed, this);
+        } else {
+            m_manager->requestFrame(m_window, this, captureRegion(), m_bufferSerial);
+        }
     } else {
         m_bufferResource = Q_NULLPTR;
         send_failed(result_bad_buffer, buffer);
@@ -171,18 +259,163 @@ void LipstickRecorder::lipstick_recorder_record_frame(Resource *resource, ::wl_r
 void LipstickRecorder::lipstick_recorder_repaint(Resource *resource)
 {
     Q_UNUSED(resource)
-    if (m_bufferResource) {
+    if (m_holdTimer.isActive()) {
+        m_repaintRequested = true;
+    } else if (m_bufferResource) {
         m_window->update();
     }
 }
 
+void LipstickRecorder::lipstick_recorder_set_frame_rate(Resource *resource, uint32_t rate)
+{
+    Q_UNUSED(resource)
+    m_frameInterval = rate > 0 ? qMax<int>(1, 1000 / rate) : 0;
+}
+
+void LipstickRecorder::lipstick_recorder_set_scale(Resource *resource, uint32_t scale)
+{
+    if (scale == 0 || scale > 16 || (scale & (scale - 1)) != 0) {
+        wl_resource_post_error(resource->handle, error_invalid_scale, "Invalid scale %u", scale);
+        return;
+    }
+
+    if (m_scale != int(scale)) {
+        m_scale = scale;
+        reconfigure();
+    }
+}
+
+void LipstickRecorder::lipstick_recorder_set_region(Resource *resource, int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    Q_UNUSED(resource)
+    const QRect region = width > 0 && height > 0 ? QRect(x, y, width, height) : QRect();
+    if (m_region != region) {
+        m_region = region;
+        reconfigure();
+    }
+}
+
+QRect LipstickRecorder::captureRegion() const
+{
+    const QRect windowRect(0, 0, m_window->width(), m_window->height());
+    return m_region.isValid() ? m_region & windowRect : windowRect;
+}
+
+void LipstickRecorder::sendSetup()
+{
+    const QRect region = captureRegion();
+    const QSize size(region.width() / m_scale, region.height() / m_scale);
+    send_setup(size.width(), size.height(), size.width() * 4, WL_SHM_FORMAT_RGBA8888);
+}
+
+void LipstickRecorder::reconfigure()
+{
+    // Setup cancels pending frames, which would no longer match the buffer
+    m_manager->remove(m_window, this);
+    m_holdTimer.stop();
+    m_repaintRequested = false;
+    if (m_bufferResource) {
+        send_cancelled(m_bufferResource);
+        m_bufferResource = Q_NULLPTR;
+    }
+    m_lastFrame.clear();
+    setLastBuffer(Q_NULLPTR);
+
+    sendSetup();
+}
+
+void LipstickRecorder::lipstick_recorder_set_damage_tracking(Resource *resource, uint32_t enabled)
+{
+    Q_UNUSED(resource)
+    m_damageTracking = enabled;
+    if (!m_damageTracking) {
+        m_lastFrame.clear();
+        setLastBuffer(Q_NULLPTR);
+    }
+}
+
+void LipstickRecorder::setLastBuffer(wl_resource *buffer)
+{
+    if (m_lastBuffer == buffer)
+        return;
+
+    wl_list_remove(&m_lastBufferListener.listener.link);
+    wl_list_init(&m_lastBufferListener.listener.link);
+    m_lastBuffer = buffer;
+    if (m_lastBuffer)
+        wl_resource_add_destroy_listener(m_lastBuffer, &m_lastBufferListener.listener);
+}
+
+void LipstickRecorder::lastBufferDestroyed(wl_listener *listener, void *data)
+{
+    Q_UNUSED(data)
+    BufferListener *bufferListener = wl_container_of(listener, bufferListener, listener);
+    LipstickRecorder *recorder = bufferListener->recorder;
+
+    wl_list_remove(&listener->link);
+    wl_list_init(&listener->link);
+    recorder->m_lastBuffer = Q_NULLPTR;
+    recorder->m_lastFrame.clear();
+}
+
+bool LipstickRecorder::writeFrame(const CapturedFramePointer &capturedFrame)
+{
+    const CapturedFramePointer frame = FrameReadback::extract(
+                capturedFrame, toFramebuffer(captureRegion(), m_window->height()), m_scale);
+
+    const int width = wl_shm_buffer_get_width(m_buffer);
+    const int height = wl_shm_buffer_get_height(m_buffer);
+    const int stride = wl_shm_buffer_get_stride(m_buffer);
+
+    if (width < frame->size.width() || height < frame->size.height() || stride < frame->stride())
+        return false;
+
+    QVector<QRect> damage;
+    if (m_damageTracking && m_lastFrame && m_lastBuffer == m_bufferResource)
+        damage = FrameReadback::damage(*m_lastFrame, *frame);
+    else
+        damage.append(QRect(QPoint(0, 0), frame->size));
+
+    wl_shm_buffer_begin_access(m_buffer);
+    uchar *pixels = static_cast<uchar *>(wl_shm_buffer_get_data(m_buffer));
+    const char *source = frame->pixels.constData();
+    foreach (const QRect &rect, damage) {
+        for (int y = rect.top(); y <= rect.bottom(); ++y) {
+            memcpy(pixels + y * stride + rect.left() * 4,
+                   source + y * frame->stride() + rect.left() * 4,
+                   rect.width() * 4);
+        }
+    }
+    wl_shm_buffer_end_access(m_buffer);
+
+    if (m_damageTracking) {
+        foreach (const QRect &rect, damage)
+            send_damage(m_bufferResource, rect.x(), rect.y(), rect.width(), rect.height());
+        m_lastFrame = frame;
+        setLastBuffer(m_bufferResource);
+    }
+
+    return true;
+}
+
 bool LipstickRecorder::event(QEvent *e)
 {
     if (e->type() == FrameEventType) {
         FrameEvent *fe = static_cast<FrameEvent *>(e);
-        send_frame(m_bufferResource, fe->time, QtWaylandServer::lipstick_recorder::transform_y_inverted);
+        // Posted for a buffer that has been cancelled or replaced since
+        if (!m_bufferResource || fe->serial != m_bufferSerial)
+            return true;
+        if (writeFrame(fe->frame)) {
+            send_frame(m_bufferResource, fe->frame->time, QtWaylandServer::lipstick_recorder::transform_y_inverted);
+            m_lastRecorded.start();
+            m_renderedFrames = m_manager->renderedFrames();
+        } else {
+            send_failed(result_bad_buffer, m_bufferResource);
+        }
     } else if (e->type() == FailedEventType) {
         FailedEvent *fe = static_cast<FailedEvent *>(e);
+        if (!m_bufferResource || fe->serial != m_bufferSerial)
+            return true;
         send_failed(fe->result, m_bufferResource);
     } else {
         return QObject::event(e);
@@ -192,3 +425,20 @@ bool LipstickRecorder::event(QEvent *e)
     wl_client_flush(client());
     return true;
 }
+
+void LipstickRecorder::timerEvent(QTimerEvent *e)
+{
+    if (e->timerId() != m_holdTimer.timerId()) {
+        QObject::timerEvent(e);
+        return;
+    }
+
+    m_holdTimer.stop();
+    if (m_bufferResource) {
+        m_manager->requestFrame(m_window, this, captureRegion(), m_bufferSerial);
+        // Record what was drawn while the request was held without waiting for more changes
+        if (m_repaintRequested || m_manager->renderedFrames() != m_renderedFrames)
+            m_window->update();
+    }
+    m_repaintRequested = false;
+}
@@ -15,12 +15,17 @@
 #ifndef LIPSTICKCOMPOSITORRECORDER_H
 #define LIPSTICKCOMPOSITORRECORDER_H
 
+#include <QAtomicInteger>
+#include <QBasicTimer>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QMultiHash>
 #include <QMutex>
+#include <QRect>
 #include <QWaylandGlobalInterface>
 
 #include "qwayland-server-lipstick-recorder.h"
+#include "framereadback.h"
 
 struct wl_shm_buffer;
 struct wl_client;
@@ -34,26 +39,39 @@ class LipstickRecorderManager : public QWaylandGlobalInterface, public QtWayland
 {
 public:
     LipstickRecorderManager();
+    ~LipstickRecorderManager();
 
     const wl_interface* interface() const Q_DECL_OVERRIDE;
 
+    // Render thread
     void recordFrame(QWindow *window);
-    void requestFrame(QWindow *window, LipstickRecorder *recorder);
+    void releaseResources();
+
+    // Region is in window coordinates, the serial identifies the buffer the frame is for
+    void requestFrame(QWindow *window, LipstickRecorder *recorder, const QRect &region, quint32 serial);
     void remove(QWindow *window, LipstickRecorder *recorder);
 
+    quint32 renderedFrames() const { return m_renderedFrames.loadAcquire(); }
+
 protected:
     void bind(wl_client *client, quint32 version, quint32 id) Q_DECL_OVERRIDE;
     void lipstick_recorder_manager_create_recorder(Resource *resource, uint32_t id, ::wl_resource *output) Q_DECL_OVERRIDE;
 
 private:
     QMultiHash<QWindow *, LipstickRecorder *> m_requests;
+    QHash<LipstickRecorder *, QRect> m_regions;
+    QHash<LipstickRecorder *, quint32> m_serials;
+    // Recorders waiting for the read queued on the previous frame
+    QList<LipstickRecorder *> m_pending;
+    FrameReadback *m_readback;
     QMutex m_mutex;
+    QAtomicInteger<quint32> m_renderedFrames;
 };
 
 class LipstickRecorder : public QObject, public QtWaylandServer::lipstick_recorder
 {
 public:
-    LipstickRecorder(LipstickRecorderManager *manager, wl_client *client, quint32 id, QQuickWindow *window);
+    LipstickRecorder(LipstickRecorderManager *manager, wl_client *client, quint32 id, int version, QQuickWindow *window);
     ~LipstickRecorder();
 
     wl_shm_buffer *buffer() const { return m_buffer; }
@@ -61,17 +79,52 @@ public:
 
 protected:
     bool event(QEvent *e) Q_DECL_OVERRIDE;
+    void timerEvent(QTimerEvent *e) Q_DECL_OVERRIDE;
     void lipstick_recorder_destroy_resource(Resource *resource) Q_DECL_OVERRIDE;
     void lipstick_recorder_destroy(Resource *resource) Q_DECL_OVERRIDE;
     void lipstick_recorder_record_frame(Resource *resource, ::wl_resource *buffer) Q_DECL_OVERRIDE;
     void lipstick_recorder_repaint(Resource *resource) Q_DECL_OVERRIDE;
+    void lipstick_recorder_set_damage_tracking(Resource *resource, uint32_t enabled) Q_DECL_OVERRIDE;
+    void lipstick_recorder_set_frame_rate(Resource *resource, uint32_t rate) Q_DECL_OVERRIDE;
+    void lipstick_recorder_set_scale(Resource *resource, uint32_t scale) Q_DECL_OVERRIDE;
+    void lipstick_recorder_set_region(Resource *resource, int32_t x, int32_t y, int32_t width, int32_t height) Q_DECL_OVERRIDE;
 
 private:
+    struct BufferListener
+    {
+        wl_listener listener;
+        LipstickRecorder *recorder;
+    };
+
+    QRect captureRegion() const;
+    void sendSetup();
+    void reconfigure();
+    bool writeFrame(const CapturedFramePointer &capturedFrame);
+    void setLastBuffer(wl_resource *buffer);
+    static void lastBufferDestroyed(wl_listener *listener, void *data);
+
     LipstickRecorderManager *m_manager;
     wl_resource *m_bufferResource;
     wl_shm_buffer *m_buffer;
+    quint32 m_bufferSerial;     // Counts the buffers given to record into
     wl_client *m_client;
     QQuickWindow *m_window;
+
+    QRect m_region;
+    int m_scale;
+
+    // A request is held back while the frame rate would be exceeded
+    int m_frameInterval;
+    QElapsedTimer m_lastRecorded;
+    QBasicTimer m_holdTimer;
+    quint32 m_renderedFrames;
+    bool m_repaintRequested;
+
+    // The frame last written into m_lastBuffer, kept for damage tracking
+    bool m_damageTracking;
+    CapturedFramePointer m_lastFrame;
+    wl_resource *m_lastBuffer;
+    BufferListener m_lastBufferListener;
 };
 
 #endif
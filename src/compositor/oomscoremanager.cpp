@@ -0,0 +1,222 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QSocketNotifier>
+#include <QTimerEvent>
+#include <QWaylandSurface>
+#include <MGConfItem>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "lipstickcompositor.h"
+#include "lipstickcompositorwindow.h"
+#include "lipsticksurfaceinterface.h"
+#include "logging.h"
+#include "oomscoremanager.h"
+
+static const char *PressureFile = "/proc/pressure/memory";
+// Triggers when tasks stall on memory for 150 ms within two seconds
+static const char PressureTrigger[] = "some 150000 2000000";
+static const int PressurePollInterval = 2000;
+
+// Window changes are collected for a moment before rescoring
+static const int BatchDelay = 200;
+static const int MinimumUpdateInterval = 1000;
+
+OomScoreManager::OomScoreManager(LipstickCompositor *compositor)
+    : QObject(compositor)
+    , m_compositor(compositor)
+    , m_categoryScoresConf(new MGConfItem("/lipstick/oom_category_scores", this))
+    , m_pressure(OomScorePolicy::NoPressure)
+    , m_pressureFd(-1)
+    , m_pressureNotifier(nullptr)
+    , m_focusSerial(0)
+{
+    connect(m_categoryScoresConf, SIGNAL(valueChanged()), this, SLOT(updateCategoryScores()));
+    m_policy.setCategoryScores(m_categoryScoresConf->value().toStringList());
+
+    m_pressureFd = ::open(PressureFile, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (m_pressureFd >= 0 && ::write(m_pressureFd, PressureTrigger, sizeof(PressureTrigger)) < 0) {
+        qCWarning(lcLipstickCoreLog) << "Cannot set memory pressure trigger:" << strerror(errno);
+        ::close(m_pressureFd);
+        m_pressureFd = -1;
+    }
+
+    if (m_pressureFd >= 0) {
+        // The trigger is signalled as priority data
+        m_pressureNotifier = new QSocketNotifier(m_pressureFd, QSocketNotifier::Exception, this);
+        connect(m_pressureNotifier, &QSocketNotifier::activated, this, &OomScoreManager::pressureTriggered);
+    } else {
+        qCDebug(lcLipstickCoreLog) << "Memory pressure information is not available";
+    }
+}
+
+OomScoreManager::~OomScoreManager()
+{
+    delete m_pressureNotifier;
+    if (m_pressureFd >= 0)
+        ::close(m_pressureFd);
+}
+
+OomScorePolicy::Pressure OomScoreManager::pressure() const
+{
+    return m_pressure;
+}
+
+QHash<qint64, int> OomScoreManager::scores() const
+{
+    return m_scores;
+}
+
+void OomScoreManager::windowFocused(LipstickCompositorWindow *window)
+{
+    if (window && window->processId() > 0)
+        m_lastFocused.insert(window->processId(), ++m_focusSerial);
+
+    scheduleUpdate();
+}
+
+void OomScoreManager::scheduleUpdate()
+{
+    schedule(BatchDelay);
+}
+
+void OomScoreManager::schedule(int delay)
+{
+    if (m_lastUpdate.isValid())
+        delay = qMax<qint64>(delay, MinimumUpdateInterval - m_lastUpdate.elapsed());
+
+    // An earlier update stays scheduled as it is
+    if (!m_updateTimer.isActive())
+        m_updateTimer.start(qMax(0, delay), this);
+}
+
+void OomScoreManager::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_updateTimer.timerId()) {
+        m_updateTimer.stop();
+        update();
+    } else if (event->timerId() == m_pressureTimer.timerId()) {
+        readPressure();
+    } else {
+        QObject::timerEvent(event);
+    }
+}
+
+void OomScoreManager::updateCategoryScores()
+{
+    // Entries are "category=score"
+    m_policy.setCategoryScores(m_categoryScoresConf->value().toStringList());
+    scheduleUpdate();
+}
+
+void OomScoreManager::pressureTriggered()
+{
+    readPressure();
+}
+
+void OomScoreManager::readPressure()
+{
+    QFile file(QString::fromLatin1(PressureFile));
+    const OomScorePolicy::Pressure pressure = file.open(QIODevice::ReadOnly)
+            ? OomScorePolicy::parsePressure(file.readAll())
+            : OomScorePolicy::NoPressure;
+
+    if (pressure != OomScorePolicy::NoPressure)
+        m_pressureTimer.start(PressurePollInterval, this);
+    else
+        m_pressureTimer.stop();
+
+    if (pressure == m_pressure)
+        return;
+
+    qCDebug(lcLipstickCoreLog) << "Memory pressure changed to" << pressure;
+
+    // Rising pressure is acted on right away, easing pressure can wait
+    const bool rising = pressure > m_pressure;
+    m_pressure = pressure;
+    schedule(rising ? 0 : BatchDelay);
+}
+
+void OomScoreManager::update()
+{
+    m_lastUpdate.start();
+
+    const qint64 ownProcessId = QCoreApplication::applicationPid();
+    const qint64 topmostProcessId = m_compositor->privateTopmostWindowProcessId();
+
+    QHash<qint64, OomScorePolicy::Client> clients;
+    QHash<qint64, LipstickCompositorWindow *> windows;
+    for (LipstickCompositorWindow *window : m_compositor->m_mappedSurfaces) {
+        const qint64 processId = window->processId();
+        if (processId <= 0 || processId == ownProcessId || window->isInProcess())
+            continue;
+
+        OomScorePolicy::Client &client = clients[processId];
+        client.processId = processId;
+        client.lastFocused = m_lastFocused.value(processId);
+        client.focused = client.focused || processId == topmostProcessId;
+        client.visible = client.visible || window->isVisible();
+        if (!window->category().isEmpty())
+            client.categories.append(window->category());
+
+        // Alien clients are reached through any of their surfaces
+        if (!windows.contains(processId) || window->isAlien())
+            windows.insert(processId, window);
+    }
+
+    // Only scores that were written are remembered, the rest are tried again on the next update
+    const QHash<qint64, int> scores = m_policy.scores(clients.values().toVector(), m_pressure);
+    QHash<qint64, int> applied;
+    for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) {
+        auto previous = m_scores.constFind(it.key());
+        if (previous != m_scores.constEnd() && *previous == it.value())
+            applied.insert(it.key(), it.value());
+        else if (applyScore(windows.value(it.key()), it.value()))
+            applied.insert(it.key(), it.value());
+    }
+
+    m_scores = applied;
+    for (auto it = m_lastFocused.begin(); it != m_lastFocused.end();) {
+        if (!clients.contains(it.key()))
+            it = m_lastFocused.erase(it);
+        else
+            ++it;
+    }
+}
+
+bool OomScoreManager::applyScore(LipstickCompositorWindow *window, int score)
+{
+    if (window->isAlien()) {
+        QWaylandSurface *surface = window->surface();
+        LipstickOomScoreOp op(score);
+        return surface && surface->sendInterfaceOp(op);
+    }
+
+    QFile file(QString::fromLatin1("/proc/%1/oom_score_adj").arg(window->processId()));
+    if (!file.open(QIODevice::WriteOnly) || file.write(QByteArray::number(score)) < 0) {
+        // The process may be gone already
+        if (file.error() != QFileDevice::OpenError || QFile::exists(file.fileName())) {
+            qCWarning(lcLipstickCoreLog) << "Cannot set OOM score of" << window->processId()
+                                         << ":" << file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef OOMSCOREMANAGER_H
+#define OOMSCOREMANAGER_H
+
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+
+#include "oomscorepolicy.h"
+
+class LipstickCompositor;
+class LipstickCompositorWindow;
+class MGConfItem;
+class QSocketNotifier;
+
+/*
+ * Keeps the OOM scores of the compositor's clients up to date.
+ *
+ * Scores come from OomScorePolicy and are written to /proc/<pid>/oom_score_adj
+ * for native clients, alien clients get a LipstickOomScoreOp instead. Changes
+ * are batched and written at most once a second, and only the scores that
+ * changed are written. Category caps are read from /lipstick/oom_category_scores.
+ *
+ * Memory pressure is followed through a PSI trigger on /proc/pressure/memory.
+ * A rise in pressure rescores the clients right away, and while there is
+ * pressure it is polled until it has gone away again.
+ */
+class OomScoreManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OomScoreManager(LipstickCompositor *compositor);
+    ~OomScoreManager();
+
+    OomScorePolicy::Pressure pressure() const;
+    // Scores last applied, by process id
+    QHash<qint64, int> scores() const;
+
+    void windowFocused(LipstickCompositorWindow *window);
+    void scheduleUpdate();
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private slots:
+    void updateCategoryScores();
+    void pressureTriggered();
+
+private:
+    void schedule(int delay);
+    void update();
+    void readPressure();
+    bool applyScore(LipstickCompositorWindow *window, int score);
+
+    LipstickCompositor *m_compositor;
+    MGConfItem *m_categoryScoresConf;
+    OomScorePolicy m_policy;
+    OomScorePolicy::Pressure m_pressure;
+    int m_pressureFd;
+    QSocketNotifier *m_pressureNotifier;
+    QBasicTimer m_updateTimer;
+    QBasicTimer m_pressureTimer;
+    QElapsedTimer m_lastUpdate;
+    qint64 m_focusSerial;
+    QHash<qint64, qint64> m_lastFocused;
+    QHash<qint64, int> m_scores;
+};
+
+#endif // OOMSCOREMANAGER_H
@@ -0,0 +1,118 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QDebug>
+
+#include <algorithm>
+
+#include "oomscorepolicy.h"
+
+// Background scores start above the visible ones and grow per rank
+static const int BackgroundBase[] = { 200, 300, 500 };
+static const int BackgroundStep[] = { 50, 100, 100 };
+
+// Percentage of the last ten seconds that tasks stalled on memory
+static const qreal SomePressureThreshold = 10.0;
+static const qreal FullPressureThreshold = 2.0;
+
+OomScorePolicy::OomScorePolicy()
+{
+}
+
+int OomScorePolicy::categoryScore(const QString &category) const
+{
+    return m_categoryScores.value(category, MaximumScore);
+}
+
+void OomScorePolicy::setCategoryScores(const QStringList &entries)
+{
+    QHash<QString, int> scores;
+
+    for (const QString &entry : entries) {
+        const int separator = entry.lastIndexOf(QLatin1Char('='));
+        const QString category = entry.left(separator).trimmed();
+        bool ok = false;
+        const int score = entry.mid(separator + 1).trimmed().toInt(&ok);
+        if (separator <= 0 || category.isEmpty() || !ok || score < -MaximumScore || score > MaximumScore) {
+            qWarning() << "Ignoring invalid OOM score" << entry;
+            continue;
+        }
+
+        scores.insert(category, score);
+    }
+
+    m_categoryScores = scores;
+}
+
+int OomScorePolicy::backgroundScore(int rank, Pressure pressure) const
+{
+    const qint64 score = BackgroundBase[pressure] + qint64(qMax(0, rank)) * BackgroundStep[pressure];
+    return int(qMin<qint64>(score, MaximumScore));
+}
+
+QHash<qint64, int> OomScorePolicy::scores(const QVector<Client> &clients, Pressure pressure) const
+{
+    QVector<const Client *> background;
+    for (const Client &client : clients) {
+        if (!client.focused && !client.visible)
+            background.append(&client);
+    }
+
+    // Most recently focused first, ties broken by the older process
+    std::sort(background.begin(), background.end(), [](const Client *lhs, const Client *rhs) {
+        return lhs->lastFocused != rhs->lastFocused
+                ? lhs->lastFocused > rhs->lastFocused
+                : lhs->processId < rhs->processId;
+    });
+
+    QHash<qint64, int> ranks;
+    for (int i = 0; i < background.count(); ++i)
+        ranks.insert(background.at(i)->processId, i);
+
+    QHash<qint64, int> scores;
+    for (const Client &client : clients) {
+        int score = client.focused
+                ? int(ForegroundScore)
+                : client.visible ? int(VisibleScore) : backgroundScore(ranks.value(client.processId), pressure);
+        for (const QString &category : client.categories)
+            score = qMin(score, categoryScore(category));
+        scores.insert(client.processId, score);
+    }
+    return scores;
+}
+
+OomScorePolicy::Pressure OomScorePolicy::parsePressure(const QByteArray &data)
+{
+    // Lines look like "some avg10=0.00 avg60=0.00 avg300=0.00 total=0"
+    qreal some = 0;
+    qreal full = 0;
+    for (const QByteArray &line : data.split('\n')) {
+        const QList<QByteArray> fields = line.simplified().split(' ');
+        for (const QByteArray &field : fields) {
+            if (field.startsWith("avg10=")) {
+                const qreal value = field.mid(6).toDouble();
+                if (fields.first() == "some")
+                    some = value;
+                else if (fields.first() == "full")
+                    full = value;
+            }
+        }
+    }
+
+    if (full >= FullPressureThreshold)
+        return FullPressure;
+    else if (some >= SomePressureThreshold)
+        return SomePressure;
+    return NoPressure;
+}
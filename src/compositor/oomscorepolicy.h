@@ -0,0 +1,76 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef OOMSCOREPOLICY_H
+#define OOMSCOREPOLICY_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*
+ * Out of memory scores for the clients of the compositor.
+ *
+ * The client owning the topmost window is the least likely to be killed,
+ * followed by clients with a visible window. The rest are ranked by how
+ * recently they were last focused, the least recently used getting the
+ * highest score. Under memory pressure the background scores are raised and
+ * spread further apart, so that the kernel and low memory killers pick the
+ * oldest background clients first.
+ *
+ * A score configured for a window category caps the score of every client
+ * with a window of that category.
+ */
+class OomScorePolicy
+{
+public:
+    enum Pressure {
+        NoPressure,
+        SomePressure,   // Some tasks stall on memory
+        FullPressure    // All non-idle tasks stall on memory at once
+    };
+
+    enum {
+        ForegroundScore = 0,
+        VisibleScore = 100,
+        MaximumScore = 1000
+    };
+
+    struct Client
+    {
+        qint64 processId = 0;
+        qint64 lastFocused = 0;     // Increases with every focus change, 0 if never focused
+        bool focused = false;
+        bool visible = false;
+        QStringList categories;
+    };
+
+    OomScorePolicy();
+
+    int categoryScore(const QString &category) const;
+    // Parses "category=score" entries
+    void setCategoryScores(const QStringList &entries);
+
+    int backgroundScore(int rank, Pressure pressure) const;
+    QHash<qint64, int> scores(const QVector<Client> &clients, Pressure pressure) const;
+
+    // Parses the contents of /proc/pressure/memory
+    static Pressure parsePressure(const QByteArray &data);
+
+private:
+    QHash<QString, int> m_categoryScores;
+};
+
+#endif // OOMSCOREPOLICY_H
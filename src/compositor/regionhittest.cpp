@@ -0,0 +1,134 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QRegion>
+
+#include <algorithm>
+
+#include "regionhittest.h"
+
+RegionHitTest::RegionHitTest()
+{
+}
+
+RegionHitTest::RegionHitTest(const QRegion &region)
+    : m_bounds(region.boundingRect())
+{
+    const QVector<QRect> rects = region.rects();
+
+    QVector<int> edges;
+    edges.reserve(rects.count() * 2);
+    for (const QRect &rect : rects) {
+        edges.append(rect.y());
+        edges.append(rect.y() + rect.height());
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    QVector<Span> spans;
+    for (int i = 0; i + 1 < edges.count(); ++i) {
+        const int top = edges.at(i);
+        const int bottom = edges.at(i + 1);
+
+        spans.clear();
+        for (const QRect &rect : rects) {
+            if (rect.y() <= top && rect.y() + rect.height() >= bottom)
+                spans.append({ rect.x(), rect.x() + rect.width() });
+        }
+        if (spans.isEmpty())
+            continue;
+
+        std::sort(spans.begin(), spans.end(), [](const Span &lhs, const Span &rhs) {
+            return lhs.left < rhs.left;
+        });
+
+        // Merge overlapping and touching spans
+        int merged = 0;
+        for (int j = 1; j < spans.count(); ++j) {
+            if (spans.at(j).left <= spans.at(merged).right) {
+                spans[merged].right = qMax(spans.at(merged).right, spans.at(j).right);
+            } else {
+                spans[++merged] = spans.at(j);
+            }
+        }
+        spans.resize(merged + 1);
+
+        // Bands covering the same spans one after another are joined
+        if (!m_bands.isEmpty()) {
+            Band &previous = m_bands.last();
+            if (previous.bottom == top && previous.spanCount == spans.count()
+                    && std::equal(spans.constBegin(), spans.constEnd(), m_spans.constBegin() + previous.firstSpan,
+                                  [](const Span &lhs, const Span &rhs) {
+                                      return lhs.left == rhs.left && lhs.right == rhs.right;
+                                  })) {
+                previous.bottom = bottom;
+                continue;
+            }
+        }
+
+        m_bands.append({ top, bottom, m_spans.count(), spans.count() });
+        m_spans += spans;
+    }
+
+    m_bands.squeeze();
+    m_spans.squeeze();
+}
+
+bool RegionHitTest::isEmpty() const
+{
+    return m_bands.isEmpty();
+}
+
+QRect RegionHitTest::boundingRect() const
+{
+    return m_bounds;
+}
+
+int RegionHitTest::bandCount() const
+{
+    return m_bands.count();
+}
+
+int RegionHitTest::spanCount() const
+{
+    return m_spans.count();
+}
+
+bool RegionHitTest::contains(const QPoint &point) const
+{
+    if (!m_bounds.contains(point))
+        return false;
+
+    // The last band starting at or above the point
+    QVector<Band>::const_iterator band = std::upper_bound(m_bands.constBegin(), m_bands.constEnd(), point.y(),
+                                                          [](int y, const Band &candidate) {
+                                                              return y < candidate.top;
+                                                          });
+    if (band == m_bands.constBegin())
+        return false;
+    --band;
+    if (point.y() >= band->bottom)
+        return false;
+
+    QVector<Span>::const_iterator first = m_spans.constBegin() + band->firstSpan;
+    QVector<Span>::const_iterator last = first + band->spanCount;
+    QVector<Span>::const_iterator span = std::upper_bound(first, last, point.x(),
+                                                          [](int x, const Span &candidate) {
+                                                              return x < candidate.left;
+                                                          });
+    if (span == first)
+        return false;
+    --span;
+    return point.x() < span->right;
+}
@@ -0,0 +1,65 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef REGIONHITTEST_H
+#define REGIONHITTEST_H
+
+#include <QRect>
+#include <QVector>
+
+class QRegion;
+
+/*
+ * A region compiled for point hit tests.
+ *
+ * The region is split into horizontal bands, each holding the sorted,
+ * disjoint spans the region covers within it. A hit test is a bounds check
+ * followed by a binary search for the band and one for the span, so it stays
+ * cheap for regions made of many rectangles, like the mouse regions of
+ * overlay windows, which are tested for every touch.
+ */
+class RegionHitTest
+{
+public:
+    RegionHitTest();
+    explicit RegionHitTest(const QRegion &region);
+
+    bool isEmpty() const;
+    QRect boundingRect() const;
+    int bandCount() const;
+    int spanCount() const;
+
+    bool contains(const QPoint &point) const;
+
+private:
+    struct Band
+    {
+        int top;
+        int bottom;     // Exclusive
+        int firstSpan;
+        int spanCount;
+    };
+
+    struct Span
+    {
+        int left;
+        int right;      // Exclusive
+    };
+
+    QRect m_bounds;
+    QVector<Band> m_bands;
+    QVector<Span> m_spans;
+};
+
+#endif // REGIONHITTEST_H
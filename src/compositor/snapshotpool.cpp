@@ -0,0 +1,196 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QMutexLocker>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+
+#include "snapshotpool.h"
+
+Q_GLOBAL_STATIC(SnapshotPool, snapshotPool)
+
+QVariantMap SnapshotPoolStatistics::toVariantMap() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("buffers"), buffers);
+    map.insert(QStringLiteral("idleBuffers"), idleBuffers);
+    map.insert(QStringLiteral("bytes"), bytes);
+    map.insert(QStringLiteral("idleBytes"), idleBytes);
+    map.insert(QStringLiteral("budget"), budget);
+    map.insert(QStringLiteral("hits"), hits);
+    map.insert(QStringLiteral("misses"), misses);
+    map.insert(QStringLiteral("evictions"), evictions);
+    return map;
+}
+
+SnapshotPool::SnapshotPool()
+{
+    m_statistics.budget = DefaultBudget;
+}
+
+SnapshotPool::~SnapshotPool()
+{
+    qDeleteAll(m_idle);
+}
+
+SnapshotPool *SnapshotPool::instance()
+{
+    return snapshotPool();
+}
+
+QSize SnapshotPool::bucketSize(const QSize &size)
+{
+    const int mask = BucketGranularity - 1;
+    return QSize((qMax(size.width(), 1) + mask) & ~mask, (qMax(size.height(), 1) + mask) & ~mask);
+}
+
+qint64 SnapshotPool::bufferBytes(const QSize &size)
+{
+    // RGBA without depth or stencil attachments
+    return qint64(size.width()) * size.height() * 4;
+}
+
+QOpenGLFramebufferObject *SnapshotPool::acquire(const QSize &size)
+{
+    const QSize bucket = bucketSize(size);
+
+    QMutexLocker locker(&m_mutex);
+
+    for (int i = m_idle.count() - 1; i >= 0; --i) {
+        if (m_idle.at(i)->size() == bucket) {
+            QOpenGLFramebufferObject *buffer = m_idle.takeAt(i);
+            m_statistics.idleBuffers -= 1;
+            m_statistics.idleBytes -= bufferBytes(bucket);
+            m_statistics.hits += 1;
+            return buffer;
+        }
+    }
+
+    QOpenGLFramebufferObject *buffer = new QOpenGLFramebufferObject(bucket);
+    m_statistics.buffers += 1;
+    m_statistics.bytes += bufferBytes(bucket);
+    m_statistics.misses += 1;
+
+    evict(m_statistics.budget, true);
+
+    return buffer;
+}
+
+void SnapshotPool::release(QOpenGLFramebufferObject *buffer)
+{
+    if (!buffer)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    m_idle.append(buffer);
+    m_statistics.idleBuffers += 1;
+    m_statistics.idleBytes += bufferBytes(buffer->size());
+
+    evict(m_statistics.budget, true);
+}
+
+void SnapshotPool::releaseResources()
+{
+    QMutexLocker locker(&m_mutex);
+
+    evict(0, false);
+}
+
+qint64 SnapshotPool::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_statistics.budget;
+}
+
+void SnapshotPool::setBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Buffers can only be deleted with the render thread's context current,
+    // so a smaller budget takes effect on the next acquire or release.
+    m_statistics.budget = qMax<qint64>(bytes, 0);
+}
+
+SnapshotPoolStatistics SnapshotPool::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_statistics;
+}
+
+void SnapshotPool::evict(qint64 budget, bool overBudget)
+{
+    while (m_statistics.bytes > budget && !m_idle.isEmpty()) {
+        QOpenGLFramebufferObject *buffer = m_idle.takeFirst();
+        const qint64 bytes = bufferBytes(buffer->size());
+
+        m_statistics.buffers -= 1;
+        m_statistics.bytes -= bytes;
+        m_statistics.idleBuffers -= 1;
+        m_statistics.idleBytes -= bytes;
+        if (overBudget)
+            m_statistics.evictions += 1;
+
+        delete buffer;
+    }
+}
+
+SnapshotTexture::SnapshotTexture(const QSize &size, SnapshotPool *pool)
+    : m_pool(pool)
+    , m_buffer(pool->acquire(size))
+    , m_size(size)
+{
+}
+
+SnapshotTexture::~SnapshotTexture()
+{
+    m_pool->release(m_buffer);
+}
+
+int SnapshotTexture::textureId() const
+{
+    return m_buffer->texture();
+}
+
+QSize SnapshotTexture::textureSize() const
+{
+    return m_size;
+}
+
+bool SnapshotTexture::hasAlphaChannel() const
+{
+    return true;
+}
+
+bool SnapshotTexture::hasMipmaps() const
+{
+    return false;
+}
+
+QRectF SnapshotTexture::normalizedTextureSubRect() const
+{
+    const QSize bucket = m_buffer->size();
+    return QRectF(0, 0, qreal(m_size.width()) / bucket.width(), qreal(m_size.height()) / bucket.height());
+}
+
+void SnapshotTexture::bind()
+{
+    QOpenGLContext::currentContext()->functions()->glBindTexture(GL_TEXTURE_2D, m_buffer->texture());
+
+    updateBindOptions(m_bindOptionsDirty);
+    m_bindOptionsDirty = false;
+}
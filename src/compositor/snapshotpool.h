@@ -0,0 +1,116 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef SNAPSHOTPOOL_H
+#define SNAPSHOTPOOL_H
+
+#include <QList>
+#include <QMutex>
+#include <QSGTexture>
+#include <QSize>
+#include <QVariantMap>
+
+class QOpenGLFramebufferObject;
+
+struct SnapshotPoolStatistics
+{
+    int buffers = 0;        // Allocated framebuffers, leased or idle
+    int idleBuffers = 0;
+    qint64 bytes = 0;       // Estimated video memory of all buffers
+    qint64 idleBytes = 0;
+    qint64 budget = 0;
+    quint64 hits = 0;       // Acquisitions served from an idle buffer
+    quint64 misses = 0;     // Acquisitions which allocated a new buffer
+    quint64 evictions = 0;  // Idle buffers deleted to stay within the budget
+
+    QVariantMap toVariantMap() const;
+};
+
+/*
+ * Framebuffers for window snapshots, shared by all WindowPixmapItems.
+ *
+ * Requested sizes are rounded up to buckets so that snapshots of slightly
+ * different sizes can reuse each other's buffers. Released buffers are kept
+ * idle until the total size of all buffers exceeds the budget, at which point
+ * the least recently released ones are deleted. Leased buffers are never
+ * deleted by the pool, so the budget can be exceeded while they are in use.
+ *
+ * Buffers are acquired and released on the render thread with its context
+ * current. The budget and the statistics can be accessed from any thread.
+ */
+class SnapshotPool
+{
+public:
+    enum { BucketGranularity = 64 };
+    static const qint64 DefaultBudget = 24 * 1024 * 1024;
+
+    SnapshotPool();
+    ~SnapshotPool();
+
+    static SnapshotPool *instance();
+
+    QOpenGLFramebufferObject *acquire(const QSize &size);
+    void release(QOpenGLFramebufferObject *buffer);
+
+    // Deletes all idle buffers, called before the context is destroyed
+    void releaseResources();
+
+    qint64 budget() const;
+    void setBudget(qint64 bytes);
+
+    SnapshotPoolStatistics statistics() const;
+
+    static QSize bucketSize(const QSize &size);
+    static qint64 bufferBytes(const QSize &size);
+
+private:
+    Q_DISABLE_COPY(SnapshotPool)
+
+    void evict(qint64 budget, bool overBudget);
+
+    mutable QMutex m_mutex;
+    QList<QOpenGLFramebufferObject *> m_idle;  // Least recently released first
+    SnapshotPoolStatistics m_statistics;
+};
+
+/*
+ * Texture of a snapshot in a pooled framebuffer.
+ *
+ * Only the bottom left corner of the framebuffer, the size of the snapshot,
+ * is exposed through normalizedTextureSubRect(). The framebuffer is returned
+ * to the pool when the texture is deleted.
+ */
+class SnapshotTexture : public QSGTexture
+{
+public:
+    explicit SnapshotTexture(const QSize &size, SnapshotPool *pool = SnapshotPool::instance());
+    ~SnapshotTexture();
+
+    QOpenGLFramebufferObject *framebufferObject() const { return m_buffer; }
+
+    int textureId() const override;
+    QSize textureSize() const override;
+    bool hasAlphaChannel() const override;
+    bool hasMipmaps() const override;
+    QRectF normalizedTextureSubRect() const override;
+    void bind() override;
+
+private:
+    SnapshotPool * const m_pool;
+    QOpenGLFramebufferObject * const m_buffer;
+    const QSize m_size;
+    bool m_bindOptionsDirty = true;
+};
+
+#endif // SNAPSHOTPOOL_H
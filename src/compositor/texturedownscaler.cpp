@@ -0,0 +1,137 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+
+#include "texturedownscaler.h"
+
+static quint64 textureBytes(const QSize &size)
+{
+    return quint64(size.width()) * size.height() * 4;
+}
+
+TextureDownscaler::TextureDownscaler(SnapshotPool *pool)
+    : m_pool(pool)
+{
+    m_program.addShaderFromSourceCode(QOpenGLShader::Vertex,
+        "attribute highp vec4 vertex;\n"
+        "uniform highp vec4 sourceRect;\n"
+        "varying highp vec2 texPos;\n"
+        "void main(void) {\n"
+        "   texPos = sourceRect.xy + vertex.xy * sourceRect.zw;\n"
+        "   gl_Position = vec4(vertex.xy * 2.0 - 1.0, 0, 1);\n"
+        "}");
+    // Clamping to the centers of the edge texels keeps filtering from reading
+    // past the source, which can be a part of a larger pooled buffer.
+    m_program.addShaderFromSourceCode(QOpenGLShader::Fragment,
+        "uniform sampler2D texture;\n"
+        "uniform highp vec4 bounds;\n"
+        "varying highp vec2 texPos;\n"
+        "void main(void) {\n"
+        "   gl_FragColor = texture2D(texture, clamp(texPos, bounds.xy, bounds.zw));\n"
+        "}");
+    if (!m_program.link())
+        qWarning() << "Failed to link the texture downscaling program" << m_program.log();
+
+    m_vertexLocation = m_program.attributeLocation("vertex");
+    m_sourceRectLocation = m_program.uniformLocation("sourceRect");
+    m_boundsLocation = m_program.uniformLocation("bounds");
+}
+
+QList<QSize> TextureDownscaler::passSizes(const QSize &source, const QSize &target)
+{
+    QList<QSize> sizes;
+    QSize size = source;
+    while (size.width() > 2 * target.width() || size.height() > 2 * target.height()) {
+        size = QSize(qMax((size.width() + 1) / 2, target.width()),
+                     qMax((size.height() + 1) / 2, target.height()));
+        sizes.append(size);
+    }
+    sizes.append(target);
+    return sizes;
+}
+
+bool TextureDownscaler::downscale(QSGTexture *source, SnapshotTexture *target)
+{
+    if (!m_program.isLinked() || source->textureSize().isEmpty())
+        return false;
+
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+
+    static GLfloat const triangleVertices[] = {
+        1.f, 0.f,
+        1.f, 1.f,
+        0.f, 0.f,
+        0.f, 1.f,
+    };
+
+    m_program.bind();
+    m_program.enableAttributeArray(m_vertexLocation);
+    m_program.setAttributeArray(m_vertexLocation, triangleVertices, 2);
+    gl->glDisable(GL_BLEND);
+    gl->glActiveTexture(GL_TEXTURE0);
+
+    const QList<QSize> sizes = passSizes(source->textureSize(), target->textureSize());
+    QSGTexture *input = source;
+    for (int i = 0; i < sizes.count(); ++i) {
+        const QSize size = sizes.at(i);
+        SnapshotTexture *output = i == sizes.count() - 1 ? target : new SnapshotTexture(size, m_pool);
+        output->setFiltering(QSGTexture::Linear);
+        output->framebufferObject()->bind();
+
+        const QSize inputSize = input->textureSize();
+        const QRectF rect = input->normalizedTextureSubRect();
+        const qreal halfTexelWidth = rect.width() / inputSize.width() / 2;
+        const qreal halfTexelHeight = rect.height() / inputSize.height() / 2;
+        m_program.setUniformValue(m_sourceRectLocation,
+                GLfloat(rect.x()), GLfloat(rect.y()), GLfloat(rect.width()), GLfloat(rect.height()));
+        m_program.setUniformValue(m_boundsLocation,
+                GLfloat(rect.left() + halfTexelWidth), GLfloat(rect.top() + halfTexelHeight),
+                GLfloat(rect.right() - halfTexelWidth), GLfloat(rect.bottom() - halfTexelHeight));
+
+        // The window's own filtering is restored on its next bind
+        const QSGTexture::Filtering filtering = input->filtering();
+        input->setFiltering(QSGTexture::Linear);
+        input->bind();
+        input->setFiltering(filtering);
+
+        gl->glViewport(0, 0, size.width(), size.height());
+        gl->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        m_statistics.passes += 1;
+        m_statistics.bytesRead += textureBytes(inputSize);
+        m_statistics.bytesWritten += textureBytes(size);
+
+        // Returns the buffer to the pool, the draw reading it is already queued
+        if (input != source)
+            delete input;
+        input = output;
+    }
+
+    m_program.disableAttributeArray(m_vertexLocation);
+    m_program.release();
+    target->framebufferObject()->release();
+
+    m_statistics.updates += 1;
+
+    return true;
+}
+
+TextureDownscaler::Statistics TextureDownscaler::statistics() const
+{
+    return m_statistics;
+}
@@ -0,0 +1,66 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef TEXTUREDOWNSCALER_H
+#define TEXTUREDOWNSCALER_H
+
+#include <QList>
+#include <QOpenGLShaderProgram>
+#include <QSize>
+
+#include "snapshotpool.h"
+
+/*
+ * Renders downscaled copies of window textures into pooled snapshot textures.
+ *
+ * The size is halved with linear filtering until it is within a factor of
+ * two of the target, so that every source texel contributes to the result
+ * instead of only the ones nearest to a single sample. Intermediate textures
+ * are taken from the snapshot pool and returned right after use.
+ *
+ * The statistics count the texels read and written by the passes, which is
+ * the memory bandwidth paid for each update of a copy.
+ */
+class TextureDownscaler
+{
+public:
+    struct Statistics
+    {
+        quint64 updates = 0;
+        quint64 passes = 0;
+        quint64 bytesRead = 0;
+        quint64 bytesWritten = 0;
+    };
+
+    explicit TextureDownscaler(SnapshotPool *pool = SnapshotPool::instance());
+
+    // Called on the render thread with its context current
+    bool downscale(QSGTexture *source, SnapshotTexture *target);
+
+    Statistics statistics() const;
+
+    static QList<QSize> passSizes(const QSize &source, const QSize &target);
+
+private:
+    Q_DISABLE_COPY(TextureDownscaler)
+
+    SnapshotPool * const m_pool;
+    QOpenGLShaderProgram m_program;
+    int m_vertexLocation;
+    int m_sourceRectLocation;
+    int m_boundsLocation;
+    Statistics m_statistics;
+};
+
+#endif // TEXTUREDOWNSCALER_H
@@ -0,0 +1,151 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include "touchmotioncompressor.h"
+
+TouchMotionCompressor::TouchMotionCompressor()
+    : m_window(nullptr)
+    , m_device(nullptr)
+    , m_timestamp(0)
+    , m_heldSince(0)
+    , m_deliveredAt(0)
+    , m_pendingCount(0)
+    , m_enabled(false)
+    , m_awaitingFrame(false)
+{
+}
+
+bool TouchMotionCompressor::isEnabled() const
+{
+    return m_enabled;
+}
+
+void TouchMotionCompressor::setEnabled(bool enabled)
+{
+    if (m_enabled != enabled) {
+        m_enabled = enabled;
+        reset();
+    }
+}
+
+bool TouchMotionCompressor::isMotion(const QTouchEvent *event)
+{
+    return event->type() == QEvent::TouchUpdate
+            && !(event->touchPointStates() & ~(Qt::TouchPointMoved | Qt::TouchPointStationary));
+}
+
+bool TouchMotionCompressor::hold(const QTouchEvent *event, qint64 now)
+{
+    if (!m_enabled || !isMotion(event))
+        return false;
+
+    if (!m_awaitingFrame || now - m_deliveredAt >= MaximumHold) {
+        // Delivered right away, the next motion waits for the frame it causes
+        m_awaitingFrame = true;
+        m_deliveredAt = now;
+        return false;
+    }
+
+    if (m_pendingCount == 0) {
+        m_points = event->touchPoints();
+        m_heldSince = now;
+    } else {
+        QList<QTouchEvent::TouchPoint> points = event->touchPoints();
+        for (QTouchEvent::TouchPoint &point : points) {
+            for (int i = 0; i < m_points.count(); ++i) {
+                const QTouchEvent::TouchPoint &held = m_points.at(i);
+                if (held.id() != point.id())
+                    continue;
+
+                // The merged point moved from where the held one started
+                point.setLastPos(held.lastPos());
+                point.setLastScenePos(held.lastScenePos());
+                point.setLastScreenPos(held.lastScreenPos());
+                point.setLastNormalizedPos(held.lastNormalizedPos());
+                if (held.state() == Qt::TouchPointMoved)
+                    point.setState(Qt::TouchPointMoved);
+                m_points.removeAt(i);
+                break;
+            }
+        }
+        // Points the new event does not mention keep their held position
+        points.append(m_points);
+        m_points = points;
+    }
+
+    m_window = event->window();
+    m_device = event->device();
+    m_modifiers = event->modifiers();
+    m_timestamp = event->timestamp();
+    ++m_pendingCount;
+    return true;
+}
+
+bool TouchMotionCompressor::frameSent()
+{
+    if (m_pendingCount > 0)
+        return true;
+
+    m_awaitingFrame = false;
+    return false;
+}
+
+bool TouchMotionCompressor::hasPending() const
+{
+    return m_pendingCount > 0;
+}
+
+int TouchMotionCompressor::pendingCount() const
+{
+    return m_pendingCount;
+}
+
+qint64 TouchMotionCompressor::pendingAge(qint64 now) const
+{
+    return m_pendingCount > 0 ? now - m_heldSince : 0;
+}
+
+qint64 TouchMotionCompressor::dueIn(qint64 now) const
+{
+    if (m_pendingCount == 0)
+        return -1;
+    return qMax(qint64(0), m_deliveredAt + MaximumHold - now);
+}
+
+QTouchEvent TouchMotionCompressor::takePending(qint64 now)
+{
+    Qt::TouchPointStates states = 0;
+    for (const QTouchEvent::TouchPoint &point : m_points)
+        states |= point.state();
+
+    QTouchEvent event(QEvent::TouchUpdate, m_device, m_modifiers, states, m_points);
+    event.setWindow(m_window);
+    event.setTimestamp(m_timestamp);
+
+    // The motion being delivered now waits for a frame as well
+    m_points.clear();
+    m_pendingCount = 0;
+    m_awaitingFrame = true;
+    m_deliveredAt = now;
+    return event;
+}
+
+void TouchMotionCompressor::reset()
+{
+    m_points.clear();
+    m_window = nullptr;
+    m_device = nullptr;
+    m_pendingCount = 0;
+    m_awaitingFrame = false;
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef TOUCHMOTIONCOMPRESSOR_H
+#define TOUCHMOTIONCOMPRESSOR_H
+
+#include <QList>
+#include <QTouchEvent>
+
+/*
+ * Coalesces the touch motion sent to a client between its frame callbacks.
+ *
+ * Touch panels report motion far more often than most clients draw, and a
+ * client that is slow to draw would otherwise have all of it queued up. Once
+ * a motion event has been delivered, further motion is held back and merged
+ * into one event, each touch point at its latest position, until the client
+ * is sent its next frame callback. A client that does not draw in response
+ * gets the held motion MaximumHold after the motion delivered before it,
+ * with the next touch event or when dueIn() runs out, whichever comes first.
+ *
+ * Only events made of moved and stationary points are held back. Presses
+ * and releases are always delivered, after any motion held before them, so
+ * the client sees every transition in order.
+ */
+class TouchMotionCompressor
+{
+public:
+    enum {
+        MaximumHold = 100   // Milliseconds
+    };
+
+    TouchMotionCompressor();
+
+    bool isEnabled() const;
+    // Disabling drops motion held back, flush it first
+    void setEnabled(bool enabled);
+
+    // Times are in milliseconds on any monotonic clock
+    // True when the event is held back and must not be delivered now
+    bool hold(const QTouchEvent *event, qint64 now);
+
+    // The client was sent a frame callback, true when held motion is due
+    bool frameSent();
+
+    bool hasPending() const;
+    // Number of motion events merged into the held one
+    int pendingCount() const;
+    // How long the oldest of the held motion has waited
+    qint64 pendingAge(qint64 now) const;
+    // Time left until the held motion must be delivered without a frame, -1 if none is held
+    qint64 dueIn(qint64 now) const;
+    // The held motion as a single event, which is then no longer held
+    QTouchEvent takePending(qint64 now);
+
+    // Drops held motion, the touch sequence is over
+    void reset();
+
+    static bool isMotion(const QTouchEvent *event);
+
+private:
+    QList<QTouchEvent::TouchPoint> m_points;
+    QWindow *m_window;
+    QTouchDevice *m_device;
+    Qt::KeyboardModifiers m_modifiers;
+    ulong m_timestamp;
+    qint64 m_heldSince;
+    qint64 m_deliveredAt;   // Of the latest motion
+    int m_pendingCount;
+    bool m_enabled;
+    bool m_awaitingFrame;
+};
+
+#endif // TOUCHMOTIONCOMPRESSOR_H
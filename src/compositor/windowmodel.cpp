@@ -14,10 +14,11 @@
 
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
-#include <QFileInfo>
 #include "lipstickcompositorwindow.h"
 #include "lipstickcompositor.h"
 #include "windowmodel.h"
+#include "windowregistry.h"
+#include "processinfocache.h"
 
 WindowModel::WindowModel()
 : m_complete(false)
@@ -26,7 +27,7 @@ WindowModel::WindowModel()
     if (!c) {
         qWarning("WindowModel: Compositor must be created before WindowModel");
     } else {
-        c->m_windowModels.append(this);
+        c->m_windowRegistry->addModel(this);
     }
 
     QDBusConnection dbus = QDBusConnection::sessionBus();
@@ -38,7 +39,7 @@ WindowModel::WindowModel()
 WindowModel::~WindowModel()
 {
     LipstickCompositor *c = LipstickCompositor::instance();
-    if (c) c->m_windowModels.removeAll(this);
+    if (c) c->m_windowRegistry->removeModel(this);
 }
 
 int WindowModel::itemCount() const
@@ -68,12 +69,9 @@ QVariant WindowModel::data(const QModelIndex &index, int role) const
     if (role == Qt::UserRole + 1) {
         return m_items.at(idx);
     } else if (role == Qt::UserRole + 2) {
-        LipstickCompositorWindow *w = static_cast<LipstickCompositorWindow *>(c->windowForId(m_items.at(idx)));
-
-        return w ? w->processId() : 0;
+        return c->m_windowRegistry->processId(m_items.at(idx));
     } else if (role == Qt::UserRole + 3) {
-        LipstickCompositorWindow *w = static_cast<LipstickCompositorWindow *>(c->windowForId(m_items.at(idx)));
-        return w->title();
+        return c->m_windowRegistry->title(m_items.at(idx));
     } else {
         return QVariant();
     }
@@ -107,21 +105,23 @@ bool WindowModel::approveWindow(LipstickCompositorWindow *window)
         window->category() != QLatin1String("overlay");
 }
 
-void WindowModel::addItem(int id)
+bool WindowModel::addItem(int id)
 {
-    if (!m_complete)
-        return;
+    if (!m_complete || m_rows.contains(id))
+        return false;
 
     LipstickCompositor *c = LipstickCompositor::instance();
     LipstickCompositorWindow *window = static_cast<LipstickCompositorWindow *>(c->windowForId(id));
     if (!approveWindow(window))
-        return;
+        return false;
 
     beginInsertRows(QModelIndex(), m_items.count(), m_items.count());
+    m_rows.insert(id, m_items.count());
     m_items.append(id);
     endInsertRows();
     emit itemAdded(m_items.count() - 1);
     emit itemCountChanged();
+    return true;
 }
 
 void WindowModel::remItem(int id)
@@ -129,12 +129,15 @@ void WindowModel::remItem(int id)
     if (!m_complete)
         return;
 
-    int idx = m_items.indexOf(id);
+    int idx = m_rows.value(id, -1);
     if (idx == -1)
         return;
 
     beginRemoveRows(QModelIndex(), idx, idx);
+    m_rows.remove(id);
     m_items.removeAt(idx);
+    for (int ii = idx; ii < m_items.count(); ++ii)
+        m_rows.insert(m_items.at(ii), ii);
     endRemoveRows();
     emit itemCountChanged();
 }
@@ -144,11 +147,11 @@ void WindowModel::titleChanged(int id)
     if (!m_complete)
         return;
 
-    int idx = m_items.indexOf(id);
+    int idx = m_rows.value(id, -1);
     if (idx == -1)
         return;
 
-    emit dataChanged(index(idx, 0), index(idx, 0));
+    emit dataChanged(index(idx, 0), index(idx, 0), QVector<int>() << Qt::UserRole + 3);
 }
 
 void WindowModel::refresh()
@@ -160,14 +163,19 @@ void WindowModel::refresh()
     beginResetModel();
 
     m_items.clear();
+    m_rows.clear();
 
     for (QHash<int, LipstickCompositorWindow *>::ConstIterator iter = c->m_mappedSurfaces.begin();
          iter != c->m_mappedSurfaces.end(); ++iter) {
 
-        if (approveWindow(iter.value()))
+        if (approveWindow(iter.value())) {
+            m_rows.insert(iter.key(), m_items.count());
             m_items.append(iter.key());
+        }
     }
 
+    c->m_windowRegistry->modelReset(this, m_items);
+
     endResetModel();
 }
 
@@ -178,8 +186,7 @@ bool WindowModel::isPrivileged() const
     }
 
     uint pid = connection().interface()->servicePid(message().service()).value();
-    QFileInfo info(QString("/proc/%1").arg(pid));
-    if (info.group() != QLatin1String("privileged") && info.owner() != QLatin1String("root")) {
+    if (!ProcessInfoCache::instance()->info(pid).isPrivileged()) {
         QString errorString = QString("PID %1 is not in privileged group").arg(pid);
         sendErrorReply(QDBusError::AccessDenied, errorString);
         return false;
@@ -196,47 +203,18 @@ void WindowModel::launchProcess(const QString &binaryName)
 
     QStringList binaryParts = binaryName.split(QRegExp(QRegExp("\\s+")));
 
+    // All parts of binaryName must be contained in this order in the
+    // process command line to match the given process. The processes of
+    // windows are known to the cache since the windows were created.
+    const QList<qint64> processes = ProcessInfoCache::instance()->processes(binaryParts);
+    if (processes.isEmpty())
+        return;
+
     for (QHash<int, LipstickCompositorWindow *>::ConstIterator iter = c->m_mappedSurfaces.begin();
         iter != c->m_mappedSurfaces.end(); ++iter) {
 
         LipstickCompositorWindow *win = iter.value();
-        if (!approveWindow(win))
-            continue;
-
-        QString pidFile = QString::fromLatin1("/proc/%1/cmdline").arg(win->processId());
-        QFile f(pidFile);
-        if (!f.open(QIODevice::ReadOnly)) {
-            qWarning() << Q_FUNC_INFO << "Cannot open cmdline for " << pidFile;
-            continue;
-        }
-
-        // Command line arguments are split by '\0' in /proc/*/cmdline
-        QStringList proc;
-        QByteArray data = f.readAll();
-        Q_FOREACH (const QByteArray &array, data.split('\0')) {
-            QString part = QString::fromUtf8(array);
-            if (part.size() > 0) {
-                proc << part;
-            }
-        }
-
-        // Cannot match, as the cmdline has less arguments than then binary part
-        if (binaryParts.size() > proc.size()) {
-            continue;
-        }
-
-        bool match = true;
-
-        // All parts of binaryName must be contained in this order in the
-        // process command line to match the given process
-        for (int i=0; i<binaryParts.count(); i++) {
-            if (proc[i] != binaryParts[i]) {
-                match = false;
-                break;
-            }
-        }
-
-        if (match) {
+        if (approveWindow(win) && processes.contains(win->processId())) {
             win->surface()->raiseRequested();
             break;
         }
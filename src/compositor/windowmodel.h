@@ -58,9 +58,13 @@ public slots:
 
 private:
     friend class LipstickCompositor;
+    friend class WindowRegistry;
+#ifdef UNIT_TEST
+    friend class Ut_WindowRegistry;
+#endif
     void setCompositor(LipstickCompositor *);
 
-    void addItem(int);
+    bool addItem(int);
     void remItem(int);
     void titleChanged(int);
 
@@ -69,6 +73,7 @@ private:
 
     bool m_complete:1;
     QList<int> m_items;
+    QHash<int, int> m_rows;
 };
 
 #endif // WINDOWMODEL_H
@@ -0,0 +1,222 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtCore/qmath.h>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <private/qquickitem_p.h>
+
+#include <algorithm>
+
+#include "windowocclusion.h"
+
+static QList<QQuickItem *> ancestry(QQuickItem *item)
+{
+    QList<QQuickItem *> items;
+    for (; item; item = item->parentItem())
+        items.prepend(item);
+    return items;
+}
+
+// The pixels completely inside a rectangle with fractional edges
+static QRect innerRect(const QRectF &rect)
+{
+    return QRect(QPoint(qCeil(rect.left()), qCeil(rect.top())),
+                 QPoint(qFloor(rect.right()) - 1, qFloor(rect.bottom()) - 1));
+}
+
+WindowOcclusion::WindowOcclusion(QQuickWindow *window)
+    : QObject(window)
+    , m_window(window)
+    , m_updatedCount(0)
+{
+    connect(window, &QQuickWindow::afterAnimating, this, &WindowOcclusion::update);
+}
+
+void WindowOcclusion::addWindow(QQuickItem *item)
+{
+    if (m_opaqueRegions.contains(item))
+        return;
+
+    m_opaqueRegions.insert(item, QRegion());
+    connect(item, &QObject::destroyed, this, &WindowOcclusion::windowDestroyed);
+
+    m_window->update();
+}
+
+void WindowOcclusion::removeWindow(QQuickItem *item)
+{
+    if (!m_opaqueRegions.remove(item))
+        return;
+
+    disconnect(item, &QObject::destroyed, this, &WindowOcclusion::windowDestroyed);
+    if (m_occluded.remove(item))
+        setCulled(item, false);
+
+    m_window->update();
+}
+
+void WindowOcclusion::windowDestroyed(QObject *item)
+{
+    // Not a QQuickItem anymore, only forget about it
+    m_opaqueRegions.remove(static_cast<QQuickItem *>(item));
+    m_occluded.remove(static_cast<QQuickItem *>(item));
+}
+
+void WindowOcclusion::setOpaqueRegion(QQuickItem *item, const QRegion &region)
+{
+    QHash<QQuickItem *, QRegion>::iterator it = m_opaqueRegions.find(item);
+    if (it != m_opaqueRegions.end() && *it != region) {
+        *it = region;
+        m_window->update();
+    }
+}
+
+bool WindowOcclusion::isOccluded(QQuickItem *item) const
+{
+    return m_occluded.contains(item);
+}
+
+int WindowOcclusion::occludedCount() const
+{
+    return m_occluded.count();
+}
+
+int WindowOcclusion::updatedCount() const
+{
+    return m_updatedCount;
+}
+
+bool WindowOcclusion::isAbove(QQuickItem *a, QQuickItem *b)
+{
+    const QList<QQuickItem *> pathA = ancestry(a);
+    const QList<QQuickItem *> pathB = ancestry(b);
+
+    int i = 0;
+    while (i < pathA.count() && i < pathB.count() && pathA.at(i) == pathB.at(i))
+        ++i;
+
+    if (i == 0 || (i == pathA.count() && i == pathB.count())) {
+        // Different scenes, or the same item
+        return false;
+    } else if (i == pathA.count()) {
+        // Children are painted on top of their parent, except those with a negative z
+        return pathB.at(i)->z() < 0;
+    } else if (i == pathB.count()) {
+        return pathA.at(i)->z() >= 0;
+    }
+
+    const QList<QQuickItem *> order = QQuickItemPrivate::get(pathA.at(i - 1))->paintOrderChildItems();
+    return order.indexOf(pathA.at(i)) > order.indexOf(pathB.at(i));
+}
+
+WindowOcclusion::Layer WindowOcclusion::layer(QQuickItem *item) const
+{
+    Layer layer;
+    layer.item = item;
+
+    if (item->window() != m_window || !item->isVisible())
+        return layer;
+
+    QRectF clip(0, 0, m_window->width(), m_window->height());
+    qreal opacity = 1;
+    for (QQuickItem *ancestor = item; ancestor; ancestor = ancestor->parentItem()) {
+        opacity *= ancestor->opacity();
+        if (ancestor != item && ancestor->clip())
+            clip &= ancestor->mapRectToScene(QRectF(0, 0, ancestor->width(), ancestor->height()));
+    }
+
+    const QRectF rect(0, 0, item->width(), item->height());
+    layer.bounds = (item->mapRectToScene(rect) & clip).toAlignedRect();
+    layer.visible = !qFuzzyIsNull(opacity) && !layer.bounds.isEmpty();
+    if (!layer.visible || opacity < 1)
+        return layer;
+
+    // Only an integer translation keeps the opaque pixels of the window opaque on screen
+    const QPointF origin = item->mapToScene(QPointF(0, 0));
+    if (item->mapToScene(QPointF(rect.width(), 0)) - origin != QPointF(rect.width(), 0)
+            || item->mapToScene(QPointF(0, rect.height())) - origin != QPointF(0, rect.height())
+            || origin != QPointF(origin.toPoint())) {
+        return layer;
+    }
+
+    const QRegion opaque = m_opaqueRegions.value(item) & rect.toRect();
+    layer.opaque = opaque.translated(origin.toPoint()) & innerRect(clip);
+
+    return layer;
+}
+
+void WindowOcclusion::update()
+{
+    QVector<Layer> layers;
+    layers.reserve(m_opaqueRegions.count());
+    for (QHash<QQuickItem *, QRegion>::const_iterator it = m_opaqueRegions.constBegin();
+            it != m_opaqueRegions.constEnd(); ++it) {
+        layers.append(layer(it.key()));
+    }
+
+    std::stable_sort(layers.begin(), layers.end(), [](const Layer &lhs, const Layer &rhs) {
+        return isAbove(lhs.item, rhs.item);
+    });
+
+    // Windows above the first change keep the coverage of the previous pass
+    int first = 0;
+    while (first < layers.count() && first < m_layers.count() && layers.at(first) == m_layers.at(first)) {
+        layers[first].above = m_layers.at(first).above;
+        layers[first].occluded = m_layers.at(first).occluded;
+        ++first;
+    }
+
+    m_updatedCount = layers.count() - first;
+    if (m_updatedCount == 0 && layers.count() == m_layers.count())
+        return;
+
+    QRegion above = first > 0 ? layers.at(first - 1).above + layers.at(first - 1).opaque : QRegion();
+    for (int i = first; i < layers.count(); ++i) {
+        Layer &layer = layers[i];
+        layer.above = above;
+        layer.occluded = layer.visible && (QRegion(layer.bounds) - above).isEmpty();
+        if (layer.visible)
+            above += layer.opaque;
+    }
+
+    QSet<QQuickItem *> occluded;
+    for (const Layer &layer : layers) {
+        if (layer.occluded)
+            occluded.insert(layer.item);
+    }
+    for (const Layer &layer : layers) {
+        if (layer.visible && !layer.occluded) {
+            for (QQuickItem *ancestor = layer.item->parentItem(); ancestor; ancestor = ancestor->parentItem())
+                occluded.remove(ancestor);
+        }
+    }
+
+    for (QQuickItem *item : m_occluded) {
+        if (!occluded.contains(item))
+            setCulled(item, false);
+    }
+    for (QQuickItem *item : occluded) {
+        if (!m_occluded.contains(item))
+            setCulled(item, true);
+    }
+
+    m_occluded = occluded;
+    m_layers = layers;
+}
+
+void WindowOcclusion::setCulled(QQuickItem *item, bool culled)
+{
+    QQuickItemPrivate::get(item)->setCulled(culled);
+}
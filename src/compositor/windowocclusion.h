@@ -0,0 +1,95 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef WINDOWOCCLUSION_H
+#define WINDOWOCCLUSION_H
+
+#include <QHash>
+#include <QObject>
+#include <QRegion>
+#include <QSet>
+#include <QVector>
+
+class QQuickItem;
+class QQuickWindow;
+
+/*
+ * Culls window items which are completely covered by opaque windows above
+ * them.
+ *
+ * Every tracked window has an opaque region, normally the one set by the
+ * client for its surface. Windows are processed from the top of the stacking
+ * order down, each one occluded if the opaque regions of the windows above it
+ * cover all of its visible area. Only windows drawn fully opaque, unscaled
+ * and unrotated cover others, and a window is never culled while one of its
+ * child windows is shown, as culling hides the whole subtree.
+ *
+ * The pass runs on the gui thread before each frame is synchronized. It reads
+ * the stacking order and scene geometry of the tracked windows, which is
+ * cheap for the handful of windows there are, and only recomputes coverage
+ * from the topmost window that changed since the previous pass downwards.
+ */
+class WindowOcclusion : public QObject
+{
+    Q_OBJECT
+public:
+    explicit WindowOcclusion(QQuickWindow *window);
+
+    void addWindow(QQuickItem *item);
+    void removeWindow(QQuickItem *item);
+    // The region is in the item's coordinates
+    void setOpaqueRegion(QQuickItem *item, const QRegion &region);
+
+    bool isOccluded(QQuickItem *item) const;
+    int occludedCount() const;
+    // Number of windows whose coverage the last pass recomputed
+    int updatedCount() const;
+
+    void update();
+
+    // True if a is painted on top of b
+    static bool isAbove(QQuickItem *a, QQuickItem *b);
+
+private slots:
+    void windowDestroyed(QObject *item);
+
+private:
+    struct Layer
+    {
+        QQuickItem *item = nullptr;
+        QRect bounds;       // Scene coordinates
+        QRegion opaque;     // Scene coordinates, empty unless the window covers others
+        bool visible = false;
+
+        QRegion above;      // Opaque region of the windows above this one
+        bool occluded = false;
+
+        bool operator==(const Layer &other) const
+        {
+            return item == other.item && visible == other.visible
+                    && bounds == other.bounds && opaque == other.opaque;
+        }
+    };
+
+    Layer layer(QQuickItem *item) const;
+    void setCulled(QQuickItem *item, bool culled);
+
+    QQuickWindow * const m_window;
+    QHash<QQuickItem *, QRegion> m_opaqueRegions;
+    QVector<Layer> m_layers;    // Topmost first, as of the last pass
+    QSet<QQuickItem *> m_occluded;
+    int m_updatedCount;
+};
+
+#endif // WINDOWOCCLUSION_H
@@ -23,6 +23,8 @@
 #include <QWaylandSurfaceItem>
 #include "lipstickcompositorwindow.h"
 #include "lipstickcompositor.h"
+#include "snapshotpool.h"
+#include "texturedownscaler.h"
 #include "windowpixmapitem.h"
 
 namespace {
@@ -631,36 +633,37 @@ void SurfaceNode::providerDestroyed()
 }
 
 SnapshotProgram *WindowPixmapItem::s_snapshotProgram = 0;
+TextureDownscaler *WindowPixmapItem::s_downscaler = 0;
 
 struct SnapshotProgram
 {
     QOpenGLShaderProgram program;
     int vertexLocation;
     int textureLocation;
+    int textureScaleLocation;
 };
 
 class SnapshotTextureProvider : public QSGTextureProvider
 {
 public:
-    SnapshotTextureProvider() : t(0), fbo(0) {}
+    SnapshotTextureProvider() : t(0) {}
     ~SnapshotTextureProvider()
     {
-        delete fbo;
         delete t;
     }
     QSGTexture *texture() const Q_DECL_OVERRIDE
     {
         return t;
     }
-    QSGTexture *t;
-    QOpenGLFramebufferObject *fbo;
+    SnapshotTexture *t;
 };
 
 
 WindowPixmapItem::WindowPixmapItem()
 : m_item(0), m_id(0), m_opaque(false), m_radius(0), m_xOffset(0), m_yOffset(0)
 , m_xScale(1), m_yScale(1), m_unmapLock(0), m_hasBuffer(false), m_hasPixmap(false), m_surfaceDestroyed(false), m_haveSnapshot(false)
-, m_textureProvider(0)
+, m_textureProvider(0), m_snapshotScale(1), m_downscaled(false), m_downscaleDirty(false)
+, m_downscaleInterval(100), m_downscaleSource(0)
 {
     setFlag(ItemHasContents);
 }
@@ -696,6 +699,10 @@ void WindowPixmapItem::setWindowId(int id)
         m_unmapLock = 0;
     }
 
+    disconnect(m_downscaleSourceConnection);
+    m_downscaleSource = 0;
+    m_downscaleDirty = true;
+
     m_surfaceDestroyed = false;
     m_hasBuffer = false;
     m_id = id;
@@ -816,6 +823,55 @@ void WindowPixmapItem::setYScale(qreal yScale)
     emit yScaleChanged();
 }
 
+qreal WindowPixmapItem::snapshotScale() const
+{
+    return m_snapshotScale;
+}
+
+void WindowPixmapItem::setSnapshotScale(qreal scale)
+{
+    scale = qBound<qreal>(0.0625, scale, 1);
+    if (m_snapshotScale == scale)
+        return;
+
+    // Applies to the next snapshot, an existing one is kept as it is
+    m_snapshotScale = scale;
+
+    emit snapshotScaleChanged();
+}
+
+bool WindowPixmapItem::downscaled() const
+{
+    return m_downscaled;
+}
+
+void WindowPixmapItem::setDownscaled(bool downscaled)
+{
+    if (m_downscaled == downscaled)
+        return;
+
+    m_downscaled = downscaled;
+    m_downscaleDirty = true;
+    if (m_item) update();
+
+    emit downscaledChanged();
+}
+
+int WindowPixmapItem::downscaleInterval() const
+{
+    return m_downscaleInterval;
+}
+
+void WindowPixmapItem::setDownscaleInterval(int interval)
+{
+    if (m_downscaleInterval == interval)
+        return;
+
+    m_downscaleInterval = interval;
+
+    emit downscaleIntervalChanged();
+}
+
 QSize WindowPixmapItem::windowSize() const
 {
     return m_windowSize;
@@ -871,50 +927,71 @@ QSGNode *WindowPixmapItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData
     }
 
     if (!m_hasBuffer && texture) {
-        if (!m_textureProvider) {
-            SnapshotTextureProvider *prov = new SnapshotTextureProvider;
-            m_textureProvider = prov;
-
-            if (!s_snapshotProgram) {
-                s_snapshotProgram = new SnapshotProgram;
-                s_snapshotProgram->program.addShaderFromSourceCode(QOpenGLShader::Vertex,
-                    "attribute highp vec4 vertex;\n"
-                    "varying highp vec2 texPos;\n"
-                    "void main(void) {\n"
-                    "   texPos = vertex.xy;\n"
-                    "   gl_Position = vec4(vertex.xy * 2.0 - 1.0, 0, 1);\n"
-                    "}");
-                s_snapshotProgram->program.addShaderFromSourceCode(QOpenGLShader::Fragment,
-                    "uniform sampler2D texture;\n"
-                    "varying highp vec2 texPos;\n"
-                    "void main(void) {\n"
-                    "   gl_FragColor = texture2D(texture, texPos);\n"
-                    "}");
-                if (!s_snapshotProgram->program.link())
-                    qDebug() << s_snapshotProgram->program.log();
-
-                s_snapshotProgram->vertexLocation = s_snapshotProgram->program.attributeLocation("vertex");
-                s_snapshotProgram->textureLocation = s_snapshotProgram->program.uniformLocation("texture");
-
-                connect(window(), &QQuickWindow::sceneGraphInvalidated, this, &WindowPixmapItem::cleanupOpenGL);
-            }
+        if (!m_textureProvider)
+            m_textureProvider = new SnapshotTextureProvider;
+
+        if (!s_snapshotProgram) {
+            s_snapshotProgram = new SnapshotProgram;
+            s_snapshotProgram->program.addShaderFromSourceCode(QOpenGLShader::Vertex,
+                "attribute highp vec4 vertex;\n"
+                "uniform highp vec2 textureScale;\n"
+                "varying highp vec2 texPos;\n"
+                "void main(void) {\n"
+                "   texPos = vertex.xy * textureScale;\n"
+                "   gl_Position = vec4(vertex.xy * 2.0 - 1.0, 0, 1);\n"
+                "}");
+            s_snapshotProgram->program.addShaderFromSourceCode(QOpenGLShader::Fragment,
+                "uniform sampler2D texture;\n"
+                "varying highp vec2 texPos;\n"
+                "void main(void) {\n"
+                "   gl_FragColor = texture2D(texture, texPos);\n"
+                "}");
+            if (!s_snapshotProgram->program.link())
+                qDebug() << s_snapshotProgram->program.log();
+
+            s_snapshotProgram->vertexLocation = s_snapshotProgram->program.attributeLocation("vertex");
+            s_snapshotProgram->textureLocation = s_snapshotProgram->program.uniformLocation("texture");
+            s_snapshotProgram->textureScaleLocation = s_snapshotProgram->program.uniformLocation("textureScale");
+
+            if (!s_downscaler)
+                connect(window(), &QQuickWindow::sceneGraphInvalidated, this, &WindowPixmapItem::cleanupOpenGL, Qt::DirectConnection);
         }
         provider = m_textureProvider;
 
         if (m_unmapLock) {
             SnapshotTextureProvider *prov = static_cast<SnapshotTextureProvider *>(provider);
 
-            if (!prov->fbo || prov->fbo->size() != QSize(width(), height())) {
-                delete prov->fbo;
+            const QSize snapshotSize(qMax(qCeil(width() * m_snapshotScale), 1),
+                                     qMax(qCeil(height() * m_snapshotScale), 1));
+            bool textureChanged = false;
+            if (!prov->t || prov->t->textureSize() != snapshotSize) {
+                // Return the old buffer first so that it can be reused for the new size
                 delete prov->t;
-                prov->t = 0;
-                prov->fbo = new QOpenGLFramebufferObject(width(), height());
+                prov->t = new SnapshotTexture(snapshotSize);
+                prov->t->setFiltering(m_snapshotScale < 1 ? QSGTexture::Linear : QSGTexture::Nearest);
+                textureChanged = true;
             }
 
-            prov->fbo->bind();
+            QOpenGLFramebufferObject *fbo = prov->t->framebufferObject();
+            fbo->bind();
             s_snapshotProgram->program.bind();
 
+            // Downscaling samples the window with linear filtering, without
+            // leaving the changed filtering behind for the window's own node.
+            const QSGTexture::Filtering filtering = texture->filtering();
+            if (m_snapshotScale < 1)
+                texture->setFiltering(QSGTexture::Linear);
             texture->bind();
+            texture->setFiltering(filtering);
+
+            // The pooled buffer can be larger than the snapshot. Draw an extra
+            // row and column, clamped to the window's edge, so that filtering
+            // along the snapshot's edges does not pick up stale content.
+            const QSize viewport(qMin(snapshotSize.width() + 1, fbo->width()),
+                                 qMin(snapshotSize.height() + 1, fbo->height()));
+            s_snapshotProgram->program.setUniformValue(s_snapshotProgram->textureScaleLocation,
+                    GLfloat(viewport.width()) / snapshotSize.width(),
+                    GLfloat(viewport.height()) / snapshotSize.height());
 
             static GLfloat const triangleVertices[] = {
                 1.f, 0.f,
@@ -925,23 +1002,63 @@ QSGNode *WindowPixmapItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData
             s_snapshotProgram->program.enableAttributeArray(s_snapshotProgram->vertexLocation);
             s_snapshotProgram->program.setAttributeArray(s_snapshotProgram->vertexLocation, triangleVertices, 2);
 
-            glViewport(0, 0, width(), height());
+            glViewport(0, 0, viewport.width(), viewport.height());
             glDisable(GL_BLEND);
             glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
             s_snapshotProgram->program.release();
 
-            if (!prov->t) {
-                prov->t = window()->createTextureFromId(prov->fbo->texture(), prov->fbo->size(), 0);
+            if (textureChanged)
                 emit prov->textureChanged();
-            }
-            prov->fbo->release();
+            fbo->release();
             delete m_unmapLock;
             m_unmapLock = 0;
             s_snapshotProgram->program.disableAttributeArray(s_snapshotProgram->vertexLocation);
 
             m_haveSnapshot = true;
         }
+    } else if (m_downscaled && texture) {
+        if (!s_downscaler) {
+            if (!s_snapshotProgram)
+                connect(window(), &QQuickWindow::sceneGraphInvalidated, this, &WindowPixmapItem::cleanupOpenGL, Qt::DirectConnection);
+            s_downscaler = new TextureDownscaler;
+        }
+        if (!m_textureProvider)
+            m_textureProvider = new SnapshotTextureProvider;
+        SnapshotTextureProvider *prov = static_cast<SnapshotTextureProvider *>(m_textureProvider);
+
+        // New buffers of the window are reported back to the gui thread,
+        // which decides when the copy is updated next.
+        if (m_downscaleSource != provider) {
+            disconnect(m_downscaleSourceConnection);
+            m_downscaleSource = provider;
+            m_downscaleSourceConnection = connect(provider, &QSGTextureProvider::textureChanged,
+                    this, &WindowPixmapItem::sourceTextureChanged, Qt::QueuedConnection);
+        }
+
+        // Large enough for the part of the window shown by the item
+        const QSize sourceSize = texture->textureSize();
+        const QSize size(
+                m_xScale > 0 ? qBound(1, qCeil(width() / m_xScale), sourceSize.width()) : sourceSize.width(),
+                m_yScale > 0 ? qBound(1, qCeil(height() / m_yScale), sourceSize.height()) : sourceSize.height());
+
+        bool textureChanged = false;
+        if (!prov->t || prov->t->textureSize() != size) {
+            delete prov->t;
+            prov->t = new SnapshotTexture(size);
+            textureChanged = true;
+        }
+
+        if (textureChanged || m_downscaleDirty) {
+            s_downscaler->downscale(texture, prov->t);
+            m_downscaleDirty = false;
+            m_downscaleTime.start();
+        }
+
+        if (textureChanged)
+            emit prov->textureChanged();
+
+        provider = m_textureProvider;
     } else if (!m_hasBuffer && m_textureProvider) {
         provider = m_textureProvider;
     } else if (!provider) {
@@ -1027,6 +1144,7 @@ void WindowPixmapItem::configure(bool hasBuffer)
 {
     if (hasBuffer != m_hasBuffer) {
         m_hasBuffer = hasBuffer;
+        m_downscaleDirty = true;
         if (m_hasBuffer && !m_unmapLock)
             m_unmapLock = new QWaylandUnmapLock(m_item->surface());
 
@@ -1034,11 +1152,40 @@ void WindowPixmapItem::configure(bool hasBuffer)
     }
 }
 
+void WindowPixmapItem::sourceTextureChanged()
+{
+    if (!m_downscaled || m_downscaleDirty || m_downscaleTimer.isActive())
+        return;
+
+    const qint64 elapsed = m_downscaleTime.isValid() ? m_downscaleTime.elapsed() : m_downscaleInterval;
+    if (elapsed >= m_downscaleInterval) {
+        m_downscaleDirty = true;
+        update();
+    } else {
+        m_downscaleTimer.start(m_downscaleInterval - elapsed, this);
+    }
+}
+
+void WindowPixmapItem::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_downscaleTimer.timerId()) {
+        m_downscaleTimer.stop();
+        m_downscaleDirty = true;
+        update();
+    } else {
+        QQuickItem::timerEvent(event);
+    }
+}
+
+// Render thread, with the context of the scene graph being invalidated still current
 void WindowPixmapItem::cleanupOpenGL()
 {
     disconnect(window(), &QQuickWindow::sceneGraphInvalidated, this, &WindowPixmapItem::cleanupOpenGL);
     delete s_snapshotProgram;
     s_snapshotProgram = 0;
+    delete s_downscaler;
+    s_downscaler = 0;
+    SnapshotPool::instance()->releaseResources();
 }
 
 #include "windowpixmapitem.moc"
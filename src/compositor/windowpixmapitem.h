@@ -15,11 +15,15 @@
 #ifndef WINDOWPIXMAPITEM_H
 #define WINDOWPIXMAPITEM_H
 
+#include <QBasicTimer>
+#include <QElapsedTimer>
 #include <QQuickItem>
 #include <QPointer>
 #include "lipstickglobal.h"
 
+class QSGTextureProvider;
 class QWaylandUnmapLock;
+class TextureDownscaler;
 
 class LipstickCompositor;
 class LipstickCompositorWindow;
@@ -35,6 +39,9 @@ class LIPSTICK_EXPORT WindowPixmapItem : public QQuickItem
     Q_PROPERTY(qreal yOffset READ yOffset WRITE setYOffset NOTIFY yOffsetChanged)
     Q_PROPERTY(qreal xScale READ xScale WRITE setXScale NOTIFY xScaleChanged)
     Q_PROPERTY(qreal yScale READ yScale WRITE setYScale NOTIFY yScaleChanged)
+    Q_PROPERTY(qreal snapshotScale READ snapshotScale WRITE setSnapshotScale NOTIFY snapshotScaleChanged)
+    Q_PROPERTY(bool downscaled READ downscaled WRITE setDownscaled NOTIFY downscaledChanged)
+    Q_PROPERTY(int downscaleInterval READ downscaleInterval WRITE setDownscaleInterval NOTIFY downscaleIntervalChanged)
 
 public:
     WindowPixmapItem();
@@ -66,8 +73,18 @@ public:
     qreal yScale() const;
     void setYScale(qreal);
 
+    qreal snapshotScale() const;
+    void setSnapshotScale(qreal);
+
+    bool downscaled() const;
+    void setDownscaled(bool);
+
+    int downscaleInterval() const;
+    void setDownscaleInterval(int);
+
 protected:
     QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *);
+    void timerEvent(QTimerEvent *event);
 
 signals:
     void windowIdChanged();
@@ -79,10 +96,14 @@ signals:
     void yOffsetChanged();
     void xScaleChanged();
     void yScaleChanged();
+    void snapshotScaleChanged();
+    void downscaledChanged();
+    void downscaleIntervalChanged();
 
 private slots:
     void handleWindowSizeChanged();
     void itemDestroyed(QObject *);
+    void sourceTextureChanged();
 
 private:
     void updateItem();
@@ -105,8 +126,19 @@ private:
     bool m_surfaceDestroyed;
     bool m_haveSnapshot;
     QSGTextureProvider *m_textureProvider;
+    qreal m_snapshotScale;
+
+    // Downscaled copy of the window, updated on the render thread
+    bool m_downscaled;
+    bool m_downscaleDirty;
+    int m_downscaleInterval;
+    QElapsedTimer m_downscaleTime;
+    QBasicTimer m_downscaleTimer;
+    QSGTextureProvider *m_downscaleSource;
+    QMetaObject::Connection m_downscaleSourceConnection;
 
     static struct SnapshotProgram *s_snapshotProgram;
+    static TextureDownscaler *s_downscaler;
 };
 
 #endif // WINDOWPIXMAPITEM_H
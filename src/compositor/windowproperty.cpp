@@ -15,15 +15,24 @@
 #include "windowproperty.h"
 
 #include "lipstickcompositor.h"
+#include "windowpropertydispatcher.h"
 
 WindowProperty::WindowProperty()
-: m_windowId(0), m_waitingRefProperty(false)
+: m_windowId(0)
 {
     LipstickCompositor *c = LipstickCompositor::instance();
     if (!c)
         qWarning("WindowProperty: Compositor must be created before WindowProperty");
 }
 
+WindowProperty::~WindowProperty()
+{
+    unsubscribe();
+
+    LipstickCompositor *c = LipstickCompositor::instance();
+    if (c) c->m_windowProperties->unwatchLink(this);
+}
+
 int WindowProperty::windowId() const
 {
     return m_windowId;
@@ -34,11 +43,10 @@ void WindowProperty::setWindowId(int window)
     if (m_windowId == window)
         return;
 
+    unsubscribe();
     m_windowId = window;
 
     if (m_surface) {
-        QObject::disconnect(m_surface, SIGNAL(windowPropertyChanged(QString,QVariant)), 
-                            this, SLOT(windowPropertyChanged(QString)));
         QObject::disconnect(m_surface, SIGNAL(destroyed(QObject *)),
                             this, SIGNAL(valueChanged()));
         m_surface = 0;
@@ -48,21 +56,27 @@ void WindowProperty::setWindowId(int window)
     if (c) m_surface = c->surfaceForId(window);
 
     if (m_surface) {
-        // this must use a queued connection in order to avoid QTBUG-32859
-        QObject::connect(m_surface, SIGNAL(windowPropertyChanged(QString,QVariant)), 
-                         this, SLOT(windowPropertyChanged(QString)), Qt::QueuedConnection);
         QObject::connect(m_surface, SIGNAL(destroyed(QObject *)),
                          this, SIGNAL(valueChanged()));
     }
 
+    subscribe();
+
     emit windowIdChanged();
     emit valueChanged();
 }
 
-void WindowProperty::windowPropertyChanged(const QString &name)
+void WindowProperty::subscribe()
 {
-    if (name == m_property)
-        emit valueChanged();
+    // Changes are delivered from the event loop, which avoids QTBUG-32859
+    LipstickCompositor *c = LipstickCompositor::instance();
+    if (c) c->m_windowProperties->subscribe(this, m_windowId, m_property);
+}
+
+void WindowProperty::unsubscribe()
+{
+    LipstickCompositor *c = LipstickCompositor::instance();
+    if (c) c->m_windowProperties->unsubscribe(this, m_windowId, m_property);
 }
 
 QString WindowProperty::property() const
@@ -75,45 +89,29 @@ void WindowProperty::setProperty(const QString &p)
     if (m_property == p)
         return;
     
+    unsubscribe();
     m_property = p;
+    subscribe();
+
     emit propertyChanged();
     emit valueChanged();
 }
 
-void WindowProperty::connectRef()
-{
-    LipstickCompositor *c = LipstickCompositor::instance();
-    if (c && !m_waitingRefProperty) {
-        m_waitingRefProperty = true;
-        QObject::connect(c, SIGNAL(availableWinIdsChanged()), this, SLOT(availableWinIdsChanged()));
-    }
-}
-
 QVariant WindowProperty::value()
 {
-    if (!m_surface)
+    LipstickCompositor *c = LipstickCompositor::instance();
+    if (!m_surface || !c)
         return QVariant();
 
-
     QVariant rv = m_surface->windowProperties().value(m_property);
     if (rv.type() == QVariant::String && rv.toString().startsWith("__winref:")) {
         QString refId = rv.toString().mid(9);
         uint id = refId.toUInt();
-        connectRef();
-
-        if (id) {
-            int win = LipstickCompositor::instance()->windowIdForLink(m_windowId, id);
-            return QVariant(win);
-        } else {
-            return QVariant(0);
-        }
+
+        // Notified again when the window the link refers to changes
+        return QVariant(c->m_windowProperties->resolveLink(this, m_windowId, id));
     } else {
+        c->m_windowProperties->unwatchLink(this);
         return rv;
     }
 }
-
-void WindowProperty::availableWinIdsChanged()
-{
-    if (value().isValid())
-        emit valueChanged();
-}
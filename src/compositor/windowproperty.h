@@ -30,6 +30,7 @@ class LIPSTICK_EXPORT WindowProperty : public QObject
     Q_PROPERTY(QVariant value READ value NOTIFY valueChanged)
 public:
     WindowProperty();
+    ~WindowProperty();
 
     int windowId() const;
     void setWindowId(int);
@@ -44,14 +45,11 @@ signals:
     void propertyChanged();
     void valueChanged();
 
-private slots:
-    void availableWinIdsChanged();
-    void windowPropertyChanged(const QString &);
-
 private:
+    void subscribe();
+    void unsubscribe();
+
     int m_windowId;
-    bool m_waitingRefProperty;
-    void connectRef();
     QString m_property;
     QPointer<QWaylandSurface> m_surface;
 };
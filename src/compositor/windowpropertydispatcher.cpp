@@ -0,0 +1,210 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QPointer>
+#include <QTimerEvent>
+#include <QWaylandSurface>
+
+#include "lipstickcompositor.h"
+#include "lipstickcompositorwindow.h"
+#include "windowproperty.h"
+#include "windowpropertydispatcher.h"
+
+static uint windowLink(LipstickCompositorWindow *window)
+{
+    QWaylandSurface *surface = window->surface();
+    return surface ? surface->windowProperties().value(QStringLiteral("WINID"), uint(0)).toUInt() : 0;
+}
+
+WindowPropertyDispatcher::WindowPropertyDispatcher(LipstickCompositor *compositor)
+    : QObject(compositor)
+    , m_compositor(compositor)
+{
+}
+
+void WindowPropertyDispatcher::subscribe(WindowProperty *property, int windowId, const QString &name)
+{
+    if (windowId <= 0 || name.isEmpty())
+        return;
+
+    QVector<WindowProperty *> &subscribers = m_subscribers[Key(windowId, name)];
+    if (!subscribers.contains(property))
+        subscribers.append(property);
+}
+
+void WindowPropertyDispatcher::unsubscribe(WindowProperty *property, int windowId, const QString &name)
+{
+    QHash<Key, QVector<WindowProperty *> >::iterator it = m_subscribers.find(Key(windowId, name));
+    if (it == m_subscribers.end())
+        return;
+
+    it->removeAll(property);
+    if (it->isEmpty()) {
+        m_changed.remove(it.key());
+        m_subscribers.erase(it);
+    }
+}
+
+int WindowPropertyDispatcher::resolveLink(WindowProperty *property, int siblingId, uint link)
+{
+    LipstickCompositorWindow *sibling = m_compositor->m_windows.value(siblingId);
+    if (!sibling || link == 0) {
+        unwatchLink(property);
+        return 0;
+    }
+
+    const Link key(sibling->processId(), link);
+    QHash<WindowProperty *, Link>::const_iterator it = m_watchedLinks.constFind(property);
+    if (it == m_watchedLinks.constEnd() || *it != key) {
+        unwatchLink(property);
+        m_watchedLinks.insert(property, key);
+        m_linkWatchers[key].append(property);
+    }
+
+    return m_links.value(key);
+}
+
+void WindowPropertyDispatcher::unwatchLink(WindowProperty *property)
+{
+    QHash<WindowProperty *, Link>::iterator it = m_watchedLinks.find(property);
+    if (it == m_watchedLinks.end())
+        return;
+
+    QHash<Link, QVector<WindowProperty *> >::iterator watchers = m_linkWatchers.find(*it);
+    if (watchers != m_linkWatchers.end()) {
+        watchers->removeAll(property);
+        if (watchers->isEmpty()) {
+            m_changedLinks.remove(watchers.key());
+            m_linkWatchers.erase(watchers);
+        }
+    }
+    m_watchedLinks.erase(it);
+}
+
+int WindowPropertyDispatcher::windowIdForLink(int siblingId, uint link) const
+{
+    LipstickCompositorWindow *sibling = m_compositor->m_windows.value(siblingId);
+    return sibling && link ? m_links.value(Link(sibling->processId(), link)) : 0;
+}
+
+void WindowPropertyDispatcher::windowAdded(LipstickCompositorWindow *window)
+{
+    updateLink(window, windowLink(window));
+}
+
+void WindowPropertyDispatcher::windowRemoved(LipstickCompositorWindow *window)
+{
+    updateLink(window, 0);
+}
+
+void WindowPropertyDispatcher::propertyChanged(LipstickCompositorWindow *window, const QString &name)
+{
+    if (name == QLatin1String("WINID"))
+        updateLink(window, windowLink(window));
+
+    const Key key(window->windowId(), name);
+    if (m_subscribers.contains(key)) {
+        m_changed.insert(key);
+        schedule();
+    }
+}
+
+void WindowPropertyDispatcher::updateLink(LipstickCompositorWindow *window, uint link)
+{
+    const int windowId = window->windowId();
+    const Link key(window->processId(), link);
+
+    QHash<int, Link>::iterator it = m_windowLinks.find(windowId);
+    if (it != m_windowLinks.end()) {
+        if (link && *it == key)
+            return;
+
+        const Link previous = *it;
+        m_windowLinks.erase(it);
+
+        if (m_links.value(previous) == windowId) {
+            // Another window of the client may have the same WINID
+            int replacement = 0;
+            for (QHash<int, Link>::const_iterator other = m_windowLinks.constBegin(); other != m_windowLinks.constEnd(); ++other) {
+                if (*other == previous) {
+                    replacement = other.key();
+                    break;
+                }
+            }
+            setLinkedWindow(previous, replacement);
+        }
+    }
+
+    if (link) {
+        m_windowLinks.insert(windowId, key);
+        if (!m_links.contains(key))
+            setLinkedWindow(key, windowId);
+    }
+}
+
+void WindowPropertyDispatcher::setLinkedWindow(const Link &link, int windowId)
+{
+    if (windowId)
+        m_links.insert(link, windowId);
+    else
+        m_links.remove(link);
+
+    if (m_linkWatchers.contains(link)) {
+        m_changedLinks.insert(link);
+        schedule();
+    }
+}
+
+void WindowPropertyDispatcher::schedule()
+{
+    if (!m_dispatchTimer.isActive())
+        m_dispatchTimer.start(0, this);
+}
+
+void WindowPropertyDispatcher::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_dispatchTimer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    m_dispatchTimer.stop();
+
+    QSet<WindowProperty *> seen;
+    QVector<QPointer<WindowProperty> > properties;
+    for (const Key &key : m_changed) {
+        for (WindowProperty *property : m_subscribers.value(key)) {
+            if (!seen.contains(property)) {
+                seen.insert(property);
+                properties.append(property);
+            }
+        }
+    }
+    for (const Link &link : m_changedLinks) {
+        for (WindowProperty *property : m_linkWatchers.value(link)) {
+            if (!seen.contains(property)) {
+                seen.insert(property);
+                properties.append(property);
+            }
+        }
+    }
+    m_changed.clear();
+    m_changedLinks.clear();
+
+    // Handlers may destroy the other properties
+    for (const QPointer<WindowProperty> &property : properties) {
+        if (property)
+            emit property->valueChanged();
+    }
+}
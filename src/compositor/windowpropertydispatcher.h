@@ -0,0 +1,89 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef WINDOWPROPERTYDISPATCHER_H
+#define WINDOWPROPERTYDISPATCHER_H
+
+#include <QBasicTimer>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QVector>
+
+class LipstickCompositor;
+class LipstickCompositorWindow;
+class WindowProperty;
+
+/*
+ * Passes window property changes on to the WindowProperty items that
+ * observe them.
+ *
+ * Items subscribe to a window id and property name, and only the items
+ * subscribed to a changed property are told about the change. Changes are
+ * delivered from the event loop rather than from within the Wayland event
+ * dispatch, to avoid QTBUG-32859, and each item is told once however many
+ * times its property changed in between.
+ *
+ * A property may refer to another window of the same client by its WINID
+ * property, as "__winref:<WINID>". Those links are resolved through an index
+ * of the WINID of each window, and the items that resolved a link are told
+ * when the window it refers to changes.
+ */
+class WindowPropertyDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WindowPropertyDispatcher(LipstickCompositor *compositor);
+
+    void subscribe(WindowProperty *property, int windowId, const QString &name);
+    void unsubscribe(WindowProperty *property, int windowId, const QString &name);
+
+    // Resolves the link for the property and tells it when the linked window changes
+    int resolveLink(WindowProperty *property, int siblingId, uint link);
+    void unwatchLink(WindowProperty *property);
+    int windowIdForLink(int siblingId, uint link) const;
+
+    void windowAdded(LipstickCompositorWindow *window);
+    void windowRemoved(LipstickCompositorWindow *window);
+    void propertyChanged(LipstickCompositorWindow *window, const QString &name);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+#ifdef UNIT_TEST
+    friend class Ut_WindowPropertyDispatcher;
+#endif
+
+    typedef QPair<int, QString> Key;        // Window id, property name
+    typedef QPair<qint64, uint> Link;       // Process id, WINID
+
+    void updateLink(LipstickCompositorWindow *window, uint link);
+    void setLinkedWindow(const Link &link, int windowId);
+    void schedule();
+
+    LipstickCompositor *m_compositor;
+    QHash<Key, QVector<WindowProperty *> > m_subscribers;
+    QHash<Link, int> m_links;
+    QHash<int, Link> m_windowLinks;
+    QHash<Link, QVector<WindowProperty *> > m_linkWatchers;
+    QHash<WindowProperty *, Link> m_watchedLinks;
+    QSet<Key> m_changed;
+    QSet<Link> m_changedLinks;
+    QBasicTimer m_dispatchTimer;
+};
+
+#endif // WINDOWPROPERTYDISPATCHER_H
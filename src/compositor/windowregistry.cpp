@@ -0,0 +1,139 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QTimerEvent>
+
+#include "lipstickcompositor.h"
+#include "lipstickcompositorwindow.h"
+#include "windowmodel.h"
+#include "windowregistry.h"
+
+WindowRegistry::WindowRegistry(LipstickCompositor *compositor)
+    : QObject(compositor)
+    , m_compositor(compositor)
+{
+}
+
+void WindowRegistry::addModel(WindowModel *model)
+{
+    if (!m_models.contains(model))
+        m_models.append(model);
+}
+
+void WindowRegistry::removeModel(WindowModel *model)
+{
+    m_models.removeAll(model);
+    for (Window &window : m_windows)
+        window.models.removeAll(model);
+}
+
+void WindowRegistry::modelReset(WindowModel *model, const QList<int> &windowIds)
+{
+    for (Window &window : m_windows)
+        window.models.removeAll(model);
+
+    for (int windowId : windowIds) {
+        QHash<int, Window>::iterator it = m_windows.find(windowId);
+        if (it != m_windows.end())
+            it->models.append(model);
+    }
+}
+
+void WindowRegistry::windowAdded(int windowId)
+{
+    LipstickCompositorWindow *window = m_compositor->m_windows.value(windowId);
+    if (!window)
+        return;
+
+    Window &entry = m_windows[windowId];
+    entry.processId = window->processId();
+    entry.title = window->title();
+    entry.models.clear();
+
+    connect(window, &LipstickCompositorWindow::titleChanged,
+            this, &WindowRegistry::windowTitleChanged, Qt::UniqueConnection);
+
+    for (WindowModel *model : m_models) {
+        if (model->addItem(windowId))
+            entry.models.append(model);
+    }
+}
+
+void WindowRegistry::windowRemoved(int windowId)
+{
+    QHash<int, Window>::iterator it = m_windows.find(windowId);
+    if (it == m_windows.end())
+        return;
+
+    const QVector<WindowModel *> models = it->models;
+    m_windows.erase(it);
+    m_changedTitles.remove(windowId);
+
+    for (WindowModel *model : models)
+        model->remItem(windowId);
+}
+
+qint64 WindowRegistry::processId(int windowId) const
+{
+    return m_windows.value(windowId).processId;
+}
+
+QString WindowRegistry::title(int windowId) const
+{
+    return m_windows.value(windowId).title;
+}
+
+void WindowRegistry::windowTitleChanged()
+{
+    LipstickCompositorWindow *window = static_cast<LipstickCompositorWindow *>(sender());
+    QHash<int, Window>::iterator it = m_windows.find(window->windowId());
+    if (it == m_windows.end())
+        return;
+
+    // The surface and the window both announce a change of the surface title
+    const QString title = window->title();
+    if (it->title == title)
+        return;
+
+    it->title = title;
+    if (!it->models.isEmpty()) {
+        m_changedTitles.insert(window->windowId());
+        if (!m_titleTimer.isActive())
+            m_titleTimer.start(0, this);
+    }
+}
+
+void WindowRegistry::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_titleTimer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    m_titleTimer.stop();
+
+    const QSet<int> changed = m_changedTitles;
+    m_changedTitles.clear();
+
+    for (int windowId : changed) {
+        QHash<int, Window>::const_iterator it = m_windows.constFind(windowId);
+        if (it == m_windows.constEnd())
+            continue;
+
+        // Handlers of the models may map and unmap windows
+        const QVector<WindowModel *> models = it->models;
+        for (WindowModel *model : models)
+            model->titleChanged(windowId);
+    }
+}
@@ -0,0 +1,77 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef WINDOWREGISTRY_H
+#define WINDOWREGISTRY_H
+
+#include <QBasicTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+class LipstickCompositor;
+class LipstickCompositorWindow;
+class WindowModel;
+
+/*
+ * The mapped windows as seen by the window models.
+ *
+ * Caches the title and process id of every mapped window, so that models do
+ * not look windows up for each role they are asked for, and remembers which
+ * models list each window. A removed window is only taken out of the models
+ * that list it, and title changes are collected and passed on once per event
+ * loop iteration to the models that list the window, however many times the
+ * title changed in between.
+ */
+class WindowRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WindowRegistry(LipstickCompositor *compositor);
+
+    void addModel(WindowModel *model);
+    void removeModel(WindowModel *model);
+    // The model was refreshed to list the given windows
+    void modelReset(WindowModel *model, const QList<int> &windowIds);
+
+    void windowAdded(int windowId);
+    void windowRemoved(int windowId);
+
+    qint64 processId(int windowId) const;
+    QString title(int windowId) const;
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private slots:
+    void windowTitleChanged();
+
+private:
+    struct Window
+    {
+        qint64 processId = 0;
+        QString title;
+        QVector<WindowModel *> models;
+    };
+
+    LipstickCompositor *m_compositor;
+    QHash<int, Window> m_windows;
+    QVector<WindowModel *> m_models;
+    QSet<int> m_changedTitles;
+    QBasicTimer m_titleTimer;
+};
+
+#endif // WINDOWREGISTRY_H
@@ -42,6 +42,17 @@ ScreenshotResult *LipstickApi::takeScreenshot(const QString &path)
     return ScreenshotService::saveScreenshot(path);
 }
 
+ScreenshotResult *LipstickApi::takeScreenshot(const QString &path, const QVariantMap &options)
+{
+    return ScreenshotService::saveScreenshot(path, ScreenshotOptions::fromVariantMap(options));
+}
+
+ScreenshotBurst *LipstickApi::takeScreenshots(const QString &path, int count, int interval, const QVariantMap &options)
+{
+    return ScreenshotService::captureBurst(path, count, interval, options.value(QStringLiteral("archive")).toBool(),
+                                           ScreenshotOptions::fromVariantMap(options));
+}
+
 QString LipstickApi::notificationSystemApplicationName() const
 {
     return NotificationManager::instance(false)->systemApplicationName();
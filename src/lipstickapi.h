@@ -17,6 +17,7 @@
 
 #include <QObject>
 #include "screenshotservice.h"
+#include "screenshotburst.h"
 
 class LIPSTICK_EXPORT LipstickApi : public QObject
 {
@@ -32,6 +33,11 @@ public:
     QObject *compositor() const;
 
     Q_INVOKABLE ScreenshotResult *takeScreenshot(const QString &path = QString());
+    // Options are format ("png", "jpeg", "webp" or "raw"), quality, compression and scale
+    Q_INVOKABLE ScreenshotResult *takeScreenshot(const QString &path, const QVariantMap &options);
+    // Also takes the archive option to write a tar archive instead of numbered files
+    Q_INVOKABLE ScreenshotBurst *takeScreenshots(const QString &path, int count, int interval,
+                                                 const QVariantMap &options = QVariantMap());
 
     QString notificationSystemApplicationName() const;
 
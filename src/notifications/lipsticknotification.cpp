@@ -95,6 +95,7 @@ LipstickNotification::LipstickNotification(const LipstickNotification &notificat
       m_id(notification.m_id),
       m_appIcon(notification.m_appIcon),
       m_appIconOrigin(notification.m_appIconOrigin),
+      m_clientPid(notification.m_clientPid),
       m_summary(notification.m_summary),
       m_body(notification.m_body),
       m_actions(notification.m_actions),
@@ -479,6 +480,16 @@ void LipstickNotification::restartProgressTimer()
     }
 }
 
+int LipstickNotification::clientPid() const
+{
+    return m_clientPid;
+}
+
+void LipstickNotification::setClientPid(int pid)
+{
+    m_clientPid = pid;
+}
+
 void LipstickNotification::updateHintValues()
 {
     m_hintValues.clear();
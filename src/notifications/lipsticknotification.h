@@ -273,6 +273,10 @@ public:
     //! \internal
     void restartProgressTimer();
 
+    //! \internal Process ID of the client that last sent the notification, or 0 if not known
+    int clientPid() const;
+    void setClientPid(int pid);
+
     /*!
      * Creates a copy of an existing representation of a notification.
      * This constructor should only be used for populating the notification
@@ -360,6 +364,8 @@ private:
     QString m_appIcon;
     int m_appIconOrigin = ExplicitValue;
 
+    int m_clientPid = 0;
+
     //! Summary text for the notification
     QString m_summary;
 
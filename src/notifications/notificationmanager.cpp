@@ -38,6 +38,7 @@
 #include "categorydefinitionstore.h"
 #include "notificationmanageradaptor.h"
 #include "notificationmanager.h"
+#include "processinfocache.h"
 
 // Define this if you'd like to see debug messages from the notification manager
 #ifdef DEBUG_NOTIFICATIONS
@@ -78,54 +79,12 @@ bool processIsPrivileged(int pid)
         // Internal operations are considered privileged
         isPrivileged = true;
     } else if (pid > 0) {
-        QFileInfo info(QString("/proc/%1").arg(pid));
-        isPrivileged = info.group() == QLatin1String("privileged") || info.owner() == QLatin1String("root");
+        isPrivileged = ProcessInfoCache::instance()->info(pid).isPrivileged();
     }
     NOTIFICATIONS_DEBUG("pid" << pid << "-> isPrivileged" << isPrivileged);
     return isPrivileged;
 }
 
-QString getProcessCmdline(int pid)
-{
-    QString cmdline;
-    if (pid > 0) {
-        const QString path(QString::fromLatin1("/proc/%1/cmdline").arg(QString::number(pid)));
-        QFile file(path);
-        if (file.open(QIODevice::ReadOnly)) {
-            const QByteArray data = file.readAll();
-            cmdline = QString::fromUtf8(data.left(data.indexOf('\0')));
-        }
-    }
-    NOTIFICATIONS_DEBUG("pid" << pid << "-> cmdline" << cmdline);
-    return cmdline;
-}
-
-QString getProcessComm(int pid)
-{
-    QString comm;
-    if (pid > 0) {
-        const QString path(QString::fromLatin1("/proc/%1/comm").arg(QString::number(pid)));
-        QFile file(path);
-        if (file.open(QIODevice::ReadOnly)) {
-            const QByteArray data = file.readAll();
-            comm = QFile::decodeName(data.left(data.indexOf('\n')));
-        }
-    }
-    NOTIFICATIONS_DEBUG("pid" << pid << "-> comm" << comm);
-    return comm;
-}
-
-QString getProcessExe(int pid)
-{
-    QString exe;
-    if (pid > 0) {
-        const QString path(QString::fromLatin1("/proc/%1/exe").arg(QString::number(pid)));
-        exe = QFile::symLinkTarget(path);
-    }
-    NOTIFICATIONS_DEBUG("pid" << pid << "-> exe" << exe);
-    return exe;
-}
-
 bool processIsDBusProxy(int pid)
 {
     bool isDBusProxy = false;
@@ -138,11 +97,11 @@ bool processIsDBusProxy(int pid)
          *       falling back to using comm / cmdline is acceptable. */
         static const char proxyPath[] = "/usr/bin/xdg-dbus-proxy";
         static const char proxyName[] = "xdg-dbus-proxy";
-        const QString exe(getProcessExe(pid));
-        if (!exe.isEmpty())
-            isDBusProxy = exe == proxyPath;
+        const ProcessInfo info = ProcessInfoCache::instance()->info(pid);
+        if (!info.exe.isEmpty())
+            isDBusProxy = info.exe == proxyPath;
         else
-            isDBusProxy = getProcessComm(pid) == proxyName || getProcessCmdline(pid) == proxyPath;
+            isDBusProxy = info.comm == proxyName || info.arguments.value(0) == proxyPath;
     }
     NOTIFICATIONS_DEBUG("pid" << pid << "-> isDBusProxy" << isDBusProxy);
     return isDBusProxy;
@@ -150,7 +109,7 @@ bool processIsDBusProxy(int pid)
 
 QString getProcessName(int pid)
 {
-    QString processName = QFileInfo(getProcessCmdline(pid)).fileName();
+    QString processName = ProcessInfoCache::instance()->info(pid).name();
     NOTIFICATIONS_DEBUG("pid" << pid << "-> processName" << processName);
     return processName;
 }
@@ -544,6 +503,7 @@ uint NotificationManager::handleNotify(int clientPid, const QString &appName, ui
         m_notifications.insert(id, notification);
     }
 
+    notification->setClientPid(clientPid > 0 ? clientPid : 0);
     notification->restartProgressTimer();
 
     const QString previewSummary(hints_.value(LipstickNotification::HINT_PREVIEW_SUMMARY).toString());
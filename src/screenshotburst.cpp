@@ -0,0 +1,434 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QOpenGLContext>
+#include <QQuickWindow>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QThread>
+
+#include <string.h>
+
+#include "screenshotburst.h"
+
+// Frames read back but not yet encoded before capturing pauses
+static const int MaxQueuedFrames = 4;
+static const int TarBlockSize = 512;
+
+class ScreenshotBurstEncoder : public QRunnable
+{
+public:
+    ScreenshotBurstEncoder(ScreenshotBurst *burst, int index, const CapturedFramePointer &frame)
+        : m_burst(burst)
+        , m_index(index)
+        , m_frame(frame)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        if (!m_frame) {
+            // Later frames are appended to the archive only after this one is accounted for
+            if (m_burst->m_output == ScreenshotBurst::Archive) {
+                m_burst->writeArchived(m_index, QByteArray());
+            }
+            QMetaObject::invokeMethod(m_burst, "encoded", Qt::QueuedConnection, Q_ARG(int, m_index), Q_ARG(bool, false));
+            return;
+        }
+
+        // The frame is bottom up, mirroring also detaches the image from the frame data
+        const QImage captured(reinterpret_cast<const uchar *>(m_frame->pixels.constData()),
+                              m_frame->size.width(), m_frame->size.height(), m_frame->stride(),
+                              QImage::Format_RGBX8888);
+        const QImage image = ScreenshotService::transformed(captured.mirrored(), m_burst->m_rotation, m_burst->m_options);
+        m_frame.clear();
+
+        bool ok;
+        if (m_burst->m_output == ScreenshotBurst::Archive) {
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+            ok = ScreenshotService::write(&buffer, image, m_burst->m_format, m_burst->m_options);
+            ok = m_burst->writeArchived(m_index, ok ? buffer.data() : QByteArray()) && ok;
+        } else {
+            QSaveFile file(m_burst->fileName(m_index));
+            ok = file.open(QIODevice::WriteOnly)
+                    && ScreenshotService::write(&file, image, m_burst->m_format, m_burst->m_options)
+                    && file.commit();
+        }
+
+        QMetaObject::invokeMethod(m_burst, "encoded", Qt::QueuedConnection, Q_ARG(int, m_index), Q_ARG(bool, ok));
+    }
+
+private:
+    ScreenshotBurst * const m_burst;
+    const int m_index;
+    CapturedFramePointer m_frame;
+};
+
+class ScreenshotBurstCleanup : public QRunnable
+{
+public:
+    explicit ScreenshotBurstCleanup(FrameReadback *readback) : m_readback(readback) {}
+    void run() override { delete m_readback; }
+
+private:
+    FrameReadback * const m_readback;
+};
+
+static QString suffix(ScreenshotOptions::Format format)
+{
+    switch (format) {
+    case ScreenshotOptions::Jpeg:
+        return QStringLiteral("jpg");
+    case ScreenshotOptions::WebP:
+        return QStringLiteral("webp");
+    case ScreenshotOptions::Raw:
+        return QStringLiteral("raw");
+    default:
+        return QStringLiteral("png");
+    }
+}
+
+ScreenshotBurst::ScreenshotBurst(QObject *parent)
+    : QObject(parent)
+    , m_window(nullptr)
+    , m_count(0)
+    , m_interval(0)
+    , m_output(Sequence)
+    , m_format(ScreenshotOptions::Png)
+    , m_rotation(0)
+    , m_due(0)
+    , m_queued(0)
+    , m_captured(0)
+    , m_readback(nullptr)
+    , m_nextArchived(0)
+    , m_processed(0)
+    , m_written(0)
+    , m_failed(false)
+    , m_status(Error)
+{
+}
+
+ScreenshotBurst::ScreenshotBurst(QQuickWindow *window, const QString &path, int count, int interval,
+                                 Output output, const ScreenshotOptions &options, int rotation, QObject *parent)
+    : QObject(parent)
+    , m_window(window)
+    , m_path(path)
+    , m_count(count)
+    , m_interval(interval)
+    , m_output(output)
+    , m_options(options)
+    , m_format(ScreenshotService::format(options, output == Archive ? QString() : path))
+    , m_suffix(suffix(m_format))
+    , m_rotation(rotation)
+    , m_due(0)
+    , m_queued(0)
+    , m_captured(0)
+    , m_readback(nullptr)
+    , m_nextArchived(0)
+    , m_latencies(count, 0)
+    , m_processed(0)
+    , m_written(0)
+    , m_failed(false)
+    , m_status(Capturing)
+{
+    m_clock.start();
+    m_encoders.setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, 2));
+
+    if (m_output == Archive) {
+        m_archive.setFileName(m_path);
+        if (!m_archive.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "Screenshot archive could not be opened" << m_path << m_archive.errorString();
+            QTimer::singleShot(0, this, [this] { setStatus(Error); });
+            return;
+        }
+    }
+
+    connect(window, &QQuickWindow::afterRendering, this, &ScreenshotBurst::frameRendered, Qt::DirectConnection);
+    connect(window, &QQuickWindow::sceneGraphInvalidated, this, &ScreenshotBurst::releaseResources, Qt::DirectConnection);
+    connect(window, &QObject::destroyed, this, [this] { setStatus(Error); });
+
+    // Nothing else ends a burst whose window stops rendering
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(qMax(0, m_count - 1) * m_interval + TimeoutMs);
+    connect(&m_timeout, &QTimer::timeout, this, &ScreenshotBurst::timedOut);
+    m_timeout.start();
+
+    if (m_interval > 0) {
+        m_timer.setInterval(m_interval);
+        connect(&m_timer, &QTimer::timeout, this, &ScreenshotBurst::frameDue);
+        m_timer.start();
+    }
+    frameDue();
+}
+
+ScreenshotBurst::~ScreenshotBurst()
+{
+    if (m_window) {
+        disconnect(m_window, nullptr, this, nullptr);
+    }
+
+    {
+        // Wait for the render thread to leave frameRendered()
+        QMutexLocker lock(&m_mutex);
+        // A destroyed window took the readback resources with its scene graph
+        if (m_readback && m_window) {
+            m_window->scheduleRenderJob(new ScreenshotBurstCleanup(m_readback), QQuickWindow::NoStage);
+        }
+        m_readback = nullptr;
+    }
+
+    m_encoders.waitForDone();
+}
+
+ScreenshotBurst::Status ScreenshotBurst::status() const
+{
+    return m_status;
+}
+
+int ScreenshotBurst::count() const
+{
+    return m_count;
+}
+
+int ScreenshotBurst::framesWritten() const
+{
+    return m_written;
+}
+
+QVariantList ScreenshotBurst::captureLatencies() const
+{
+    QMutexLocker lock(&m_mutex);
+    QVariantList latencies;
+    for (int i = 0; i < m_captured; ++i) {
+        latencies.append(m_latencies.at(i));
+    }
+    return latencies;
+}
+
+QString ScreenshotBurst::fileName(int index) const
+{
+    const QString number = QString::number(index + 1).rightJustified(4, QLatin1Char('0'));
+    if (m_output == Archive) {
+        return QStringLiteral("frame-%1.%2").arg(number, m_suffix);
+    } else if (m_path.contains(QLatin1String("%1"))) {
+        return QString(m_path).replace(QLatin1String("%1"), number);
+    }
+
+    const QFileInfo info(m_path);
+    return info.path() + QLatin1Char('/') + info.completeBaseName() + QLatin1Char('-') + number
+            + QLatin1Char('.') + (info.suffix().isEmpty() ? m_suffix : info.suffix());
+}
+
+void ScreenshotBurst::frameDue()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_captured + m_due >= m_count) {
+            m_timer.stop();
+            return;
+        }
+        ++m_due;
+        m_dueTimes.enqueue(m_clock.nsecsElapsed());
+    }
+
+    if (m_window) {
+        m_window->update();
+    }
+}
+
+void ScreenshotBurst::frameRendered()
+{
+    QMutexLocker lock(&m_mutex);
+
+    const bool capture = m_due > 0 && m_queued + m_reading.count() < MaxQueuedFrames;
+    if (!capture && (!m_readback || !m_readback->isPending())) {
+        return;
+    }
+
+    if (!m_readback) {
+        m_readback = new FrameReadback(QOpenGLContext::currentContext());
+    }
+
+    // Due frames are captured later rather than stalling the render thread on the GPU
+    if (m_readback->isPending() && !m_readback->isReady()) {
+        QMetaObject::invokeMethod(m_window, "update", Qt::QueuedConnection);
+        return;
+    }
+
+    if (capture) {
+        const qint64 now = m_clock.nsecsElapsed();
+        const int index = m_captured++;
+        --m_due;
+        m_latencies[index] = (now - m_dueTimes.dequeue()) / 1000000.0;
+        m_reading.enqueue(index);
+
+        const bool pending = m_readback->isPending();
+        const CapturedFramePointer frame = m_readback->read(QRect(0, 0, m_window->width(), m_window->height()), 0);
+        if (pending || !m_readback->isAsynchronous()) {
+            deliver(frame);
+        }
+
+        // Without an interval the next frame is due as soon as this one is read
+        if (m_interval == 0 && m_captured + m_due < m_count) {
+            ++m_due;
+            m_dueTimes.enqueue(now);
+        }
+    }
+
+    if (m_readback->isPending() && (!capture || m_captured == m_count)) {
+        deliver(m_readback->finish());
+    }
+
+    if (m_captured == m_count && !m_readback->isPending()) {
+        delete m_readback;
+        m_readback = nullptr;
+    } else if (m_readback->isPending() || (m_due > 0 && m_queued < MaxQueuedFrames)) {
+        QMetaObject::invokeMethod(m_window, "update", Qt::QueuedConnection);
+    }
+}
+
+void ScreenshotBurst::releaseResources()
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_readback && m_readback->isPending()) {
+        deliver(m_readback->finish());
+    }
+    delete m_readback;
+    m_readback = nullptr;
+}
+
+void ScreenshotBurst::deliver(const CapturedFramePointer &frame)
+{
+    const int index = m_reading.dequeue();
+    ++m_queued;
+    // Frames that could not be read back fail in order like the rest
+    m_encoders.start(new ScreenshotBurstEncoder(this, index, frame));
+}
+
+static void writeOctal(char *field, int size, qint64 value)
+{
+    qsnprintf(field, size, "%0*llo", size - 1, static_cast<unsigned long long>(value));
+}
+
+bool ScreenshotBurst::writeArchived(int index, const QByteArray &data)
+{
+    QMutexLocker lock(&m_archiveMutex);
+    m_archiveQueue.insert(index, data);
+
+    // Entries are appended in frame order whichever encoder finishes first
+    bool ok = true;
+    while (m_archiveQueue.contains(m_nextArchived)) {
+        const int entry = m_nextArchived++;
+        const QByteArray content = m_archiveQueue.take(entry);
+        if (content.isNull()) {
+            continue;
+        }
+
+        char header[TarBlockSize];
+        memset(header, 0, sizeof(header));
+        const QByteArray name = fileName(entry).toUtf8();
+        memcpy(header, name.constData(), qMin(name.size(), 99));
+        writeOctal(header + 100, 8, 0644);
+        writeOctal(header + 108, 8, 0);
+        writeOctal(header + 116, 8, 0);
+        writeOctal(header + 124, 12, content.size());
+        writeOctal(header + 136, 12, QDateTime::currentMSecsSinceEpoch() / 1000);
+        header[156] = '0';
+        memcpy(header + 257, "ustar", 6);
+        memcpy(header + 263, "00", 2);
+
+        memset(header + 148, ' ', 8);
+        unsigned int checksum = 0;
+        for (int i = 0; i < TarBlockSize; ++i) {
+            checksum += static_cast<unsigned char>(header[i]);
+        }
+        writeOctal(header + 148, 7, checksum);
+
+        const int padding = (TarBlockSize - content.size() % TarBlockSize) % TarBlockSize;
+        ok = m_archive.write(header, TarBlockSize) == TarBlockSize
+                && m_archive.write(content) == content.size()
+                && m_archive.write(QByteArray(padding, '\0')) == padding
+                && ok;
+    }
+
+    if (m_nextArchived == m_count && m_archive.isOpen()) {
+        // The archive ends with two empty blocks
+        ok = m_archive.write(QByteArray(2 * TarBlockSize, '\0')) == 2 * TarBlockSize && ok;
+        m_archive.close();
+    }
+
+    return ok;
+}
+
+void ScreenshotBurst::encoded(int index, bool ok)
+{
+    qreal latency;
+    bool resume;
+    {
+        QMutexLocker lock(&m_mutex);
+        --m_queued;
+        latency = m_latencies.at(index);
+        resume = m_due > 0;
+    }
+
+    ++m_processed;
+    if (ok) {
+        ++m_written;
+        emit frameWritten(index, latency);
+    } else {
+        m_failed = true;
+    }
+
+    if (m_processed == m_count) {
+        setStatus(m_failed ? Error : Finished);
+    } else if (resume && m_window) {
+        // Capturing was held back while the encoders were busy
+        m_window->update();
+    }
+}
+
+void ScreenshotBurst::timedOut()
+{
+    if (m_status == Capturing) {
+        qWarning() << "Screenshot burst did not complete," << m_processed << "of" << m_count << "frames processed";
+        setStatus(Error);
+    }
+}
+
+void ScreenshotBurst::setStatus(Status status)
+{
+    // The burst ends only once, frames encoded after a timeout change nothing
+    if (m_status != Capturing || status == Capturing) {
+        return;
+    }
+
+    m_timeout.stop();
+
+    m_status = status;
+    emit statusChanged();
+
+    if (m_status == Finished) {
+        emit finished();
+    } else if (m_status == Error) {
+        emit error();
+    }
+
+    deleteLater();
+}
@@ -0,0 +1,148 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef SCREENSHOTBURST_H
+#define SCREENSHOTBURST_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVariantList>
+
+#include "screenshotservice.h"
+#include "framereadback.h"
+
+class QQuickWindow;
+
+/*
+ * Captures a series of screenshots from consecutive rendered frames.
+ *
+ * A frame becomes due every interval milliseconds, or right after the
+ * previous one when the interval is zero, and is read back from the next
+ * frame the compositor renders. Frames are encoded on a small pool of worker
+ * threads. While too many frames are waiting to be encoded no new frames are
+ * captured, which delays rather than drops the rest of the burst.
+ *
+ * The frames are written either as a numbered sequence of files or into a
+ * single uncompressed tar archive.
+ *
+ * A burst that has not finished TimeoutMs after its last frame was due, for
+ * instance because the window stopped rendering, ends in Error.
+ */
+class LIPSTICK_EXPORT ScreenshotBurst : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(Status status READ status NOTIFY statusChanged)
+    Q_PROPERTY(int count READ count CONSTANT)
+    Q_PROPERTY(int framesWritten READ framesWritten NOTIFY frameWritten)
+    Q_PROPERTY(QVariantList captureLatencies READ captureLatencies NOTIFY frameWritten)
+public:
+    enum Status {
+        Capturing,
+        Finished,
+        Error
+    };
+    Q_ENUM(Status)
+
+    enum {
+        TimeoutMs = 5000
+    };
+
+    enum Output {
+        Sequence,   // %1 in the path is replaced by the frame number
+        Archive     // The path is a tar archive of the frames
+    };
+    Q_ENUM(Output)
+
+    explicit ScreenshotBurst(QObject *parent = nullptr); // For the benefit of qmlRegisterUncreatableType().
+    ScreenshotBurst(QQuickWindow *window, const QString &path, int count, int interval,
+                    Output output, const ScreenshotOptions &options, int rotation, QObject *parent = nullptr);
+    ~ScreenshotBurst();
+
+    Status status() const;
+    int count() const;
+    int framesWritten() const;
+    // Milliseconds from each frame becoming due to it being read back
+    QVariantList captureLatencies() const;
+
+    QString fileName(int index) const;
+
+signals:
+    void frameWritten(int index, qreal captureLatency);
+    void statusChanged();
+    void finished();
+    void error();
+
+private slots:
+    void frameDue();
+    void encoded(int index, bool ok);
+    void timedOut();
+
+private:
+    friend class ScreenshotBurstEncoder;
+#ifdef UNIT_TEST
+    friend class Ut_ScreenshotBurst;
+#endif
+
+    // Render thread
+    void frameRendered();
+    void releaseResources();
+
+    void deliver(const CapturedFramePointer &frame);
+    bool writeArchived(int index, const QByteArray &data);
+    void setStatus(Status status);
+
+    const QPointer<QQuickWindow> m_window;
+    const QString m_path;
+    const int m_count;
+    const int m_interval;
+    const Output m_output;
+    const ScreenshotOptions m_options;
+    const ScreenshotOptions::Format m_format;
+    const QString m_suffix;
+    const int m_rotation;
+
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    QTimer m_timeout;
+    QThreadPool m_encoders;
+
+    // Shared with the render thread
+    mutable QMutex m_mutex;
+    int m_due;          // Frames due but not yet read
+    int m_queued;       // Frames read but not yet encoded
+    int m_captured;
+    QQueue<qint64> m_dueTimes;
+    QQueue<int> m_reading;
+    FrameReadback *m_readback;
+
+    // Shared with the encoders
+    QMutex m_archiveMutex;
+    QFile m_archive;
+    QMap<int, QByteArray> m_archiveQueue;
+    int m_nextArchived;
+
+    QVector<qreal> m_latencies;
+    int m_processed;
+    int m_written;
+    bool m_failed;
+    Status m_status;
+};
+
+#endif // SCREENSHOTBURST_H
@@ -13,12 +13,18 @@
 ****************************************************************************/
 #include "lipstickcompositor.h"
 #include "screenshotservice.h"
+#include "screenshotburst.h"
 
+#include <QFile>
+#include <QFileInfo>
 #include <QGuiApplication>
 #include <QImage>
+#include <QImageWriter>
+#include <QSaveFile>
 #include <QScreen>
 #include <QTransform>
 #include <QThreadPool>
+#include <QTimer>
 #include <private/qquickwindow_p.h>
 #include <QSharedPointer>
 #include <QQuickItemGrabResult>
@@ -27,6 +33,9 @@
 #include <sys/eventfd.h>
 #include <sys/select.h>
 
+// A screenshot that has not been grabbed by then is given up
+static const int GrabTimeoutMs = 5000;
+
 ScreenshotResult::ScreenshotResult(QObject *parent)
     : QObject(parent)
     , m_notifier(0, QSocketNotifier::Read)
@@ -102,10 +111,107 @@ void ScreenshotResult::waitForFinished()
     deleteLater();
 }
 
+ScreenshotOptions ScreenshotOptions::fromVariantMap(const QVariantMap &options)
+{
+    ScreenshotOptions result;
+
+    const QString format = options.value(QStringLiteral("format")).toString().toLower();
+    if (format == QLatin1String("png")) {
+        result.format = Png;
+    } else if (format == QLatin1String("jpeg") || format == QLatin1String("jpg")) {
+        result.format = Jpeg;
+    } else if (format == QLatin1String("webp")) {
+        result.format = WebP;
+    } else if (format == QLatin1String("raw")) {
+        result.format = Raw;
+    } else if (!format.isEmpty()) {
+        qWarning() << "Unknown screenshot format" << format;
+    }
+
+    result.quality = options.value(QStringLiteral("quality"), result.quality).toInt();
+    result.compression = options.value(QStringLiteral("compression"), result.compression).toInt();
+    result.scale = qBound<qreal>(0.01, options.value(QStringLiteral("scale"), result.scale).toReal(), 1.0);
+
+    return result;
+}
+
+ScreenshotOptions::Format ScreenshotService::format(const ScreenshotOptions &options, const QString &path)
+{
+    if (options.format != ScreenshotOptions::Automatic) {
+        return options.format;
+    }
+
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == QLatin1String("jpg") || suffix == QLatin1String("jpeg")) {
+        return ScreenshotOptions::Jpeg;
+    } else if (suffix == QLatin1String("webp")) {
+        return ScreenshotOptions::WebP;
+    } else if (suffix == QLatin1String("raw")) {
+        return ScreenshotOptions::Raw;
+    } else {
+        return ScreenshotOptions::Png;
+    }
+}
+
+QImage ScreenshotService::transformed(const QImage &image, int rotation, const ScreenshotOptions &options)
+{
+    QImage result = image;
+
+    // Scale before rotating so that there are fewer pixels to move
+    if (options.scale < 1.0) {
+        result = result.scaled(result.size() * options.scale, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    // Quarter turns without filtering are plain pixel transposes in QImage
+    rotation = ((rotation % 360) + 360) % 360;
+    if (rotation != 0) {
+        QTransform xform;
+        xform.rotate(rotation / 90 * 90);
+        result = result.transformed(xform, Qt::FastTransformation);
+    }
+
+    return result;
+}
+
+bool ScreenshotService::write(QIODevice *device, const QImage &image, ScreenshotOptions::Format format,
+                              const ScreenshotOptions &options)
+{
+    if (format == ScreenshotOptions::Raw) {
+        const QImage rgba = image.convertToFormat(QImage::Format_RGBA8888);
+        for (int y = 0; y < rgba.height(); ++y) {
+            const qint64 bytes = rgba.width() * 4;
+            if (device->write(reinterpret_cast<const char *>(rgba.constScanLine(y)), bytes) != bytes) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    QImageWriter writer(device, format == ScreenshotOptions::Jpeg
+                        ? "jpeg"
+                        : format == ScreenshotOptions::WebP ? "webp" : "png");
+    if (format == ScreenshotOptions::Png) {
+        if (options.compression >= 0) {
+            // The PNG handler derives its zlib level from the quality, (100 - quality) * 9 / 91
+            const int level = qMin(options.compression, 9);
+            writer.setQuality(100 - (level * 91 + 8) / 9);
+        }
+    } else if (options.quality >= 0) {
+        writer.setQuality(qMin(options.quality, 100));
+    }
+
+    if (!writer.write(image)) {
+        qWarning() << "Screenshot could not be written" << writer.errorString();
+        return false;
+    }
+    return true;
+}
+
 class ScreenshotWriter : public QRunnable
 {
 public:
-    ScreenshotWriter(int notifierId, const QImage &image, const QString &path, int rotation);
+    ScreenshotWriter(int notifierId, const QImage &image, const QString &path, int fd,
+                     int rotation, const ScreenshotOptions &options);
     ~ScreenshotWriter();
 
     void run() override;
@@ -113,46 +219,111 @@ public:
 private:
     QImage m_image;
     const QString m_path;
+    int m_fd;
     const int m_notifierId;
     const int m_rotation;
+    const ScreenshotOptions m_options;
 };
 
-ScreenshotWriter::ScreenshotWriter(int notifierId, const QImage &image, const QString &path, int rotation)
+ScreenshotWriter::ScreenshotWriter(int notifierId, const QImage &image, const QString &path, int fd,
+                                   int rotation, const ScreenshotOptions &options)
     : m_image(image)
     , m_path(path)
+    , m_fd(fd)
     , m_notifierId(::dup(notifierId))
     , m_rotation(rotation)
+    , m_options(options)
 {
     setAutoDelete(true);
 }
 
 ScreenshotWriter::~ScreenshotWriter()
 {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
     ::close(m_notifierId);
 }
 
 void ScreenshotWriter::run()
 {
-    if (m_rotation != 0) {
-        QTransform xform;
-        xform.rotate(m_rotation);
-        m_image = m_image.transformed(xform, Qt::SmoothTransformation);
+    const QImage image = ScreenshotService::transformed(m_image, m_rotation, m_options);
+    const ScreenshotOptions::Format format = ScreenshotService::format(m_options, m_path);
+
+    bool written;
+    if (m_fd >= 0) {
+        // The file closes the descriptor only if it could be opened
+        QFile file;
+        written = file.open(m_fd, QIODevice::WriteOnly, QFileDevice::AutoCloseHandle);
+        if (written) {
+            m_fd = -1;
+            written = ScreenshotService::write(&file, image, format, m_options) && file.flush();
+        }
+    } else {
+        QSaveFile file(m_path);
+        written = file.open(QIODevice::WriteOnly)
+                && ScreenshotService::write(&file, image, format, m_options)
+                && file.commit();
+
+        const QByteArray path = m_path.toUtf8();
+        if (written && chown(path.constData(), getuid(), getgid()) != 0) {
+            qWarning() << "Screenshot owner/group could not be set" << strerror(errno);
+        }
     }
 
-    const quint64 status = m_image.save(m_path)
+    const quint64 status = written
             ? ScreenshotResult::Finished
             : ScreenshotResult::Error;
-    const QByteArray path = m_path.toUtf8();
-    int r = chown(path.constData(), getuid(), getgid());
-    if (r != 0) {
-        qWarning() << "Screenshot owner/group could not be set" << strerror(errno);
-    }
 
     ssize_t unused = ::write(m_notifierId, &status, sizeof(status));
     Q_UNUSED(unused);
 }
 
-ScreenshotResult *ScreenshotService::saveScreenshot(const QString &path)
+// Owns the duplicated output descriptor until a writer takes over the request
+struct ScreenshotRequest
+{
+    ~ScreenshotRequest()
+    {
+        closeFd();
+    }
+
+    int takeFd()
+    {
+        const int result = fd;
+        fd = -1;
+        return result;
+    }
+
+    void closeFd()
+    {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    int fd = -1;
+    bool handled = false;
+};
+
+static void reportError(int notifierId)
+{
+    const quint64 status = ScreenshotResult::Error;
+    ssize_t unused = ::write(notifierId, &status, sizeof(status));
+    Q_UNUSED(unused);
+}
+
+ScreenshotResult *ScreenshotService::saveScreenshot(const QString &path, const ScreenshotOptions &options)
+{
+    return saveScreenshot(path, -1, options);
+}
+
+ScreenshotResult *ScreenshotService::saveScreenshot(int fd, const ScreenshotOptions &options)
+{
+    return saveScreenshot(QString(), fd, options);
+}
+
+ScreenshotResult *ScreenshotService::saveScreenshot(const QString &path, int fd, const ScreenshotOptions &options)
 {
     LipstickCompositor *compositor = LipstickCompositor::instance();
     if (!compositor) {
@@ -166,25 +337,77 @@ ScreenshotResult *ScreenshotService::saveScreenshot(const QString &path)
 
     ScreenshotResult * const result = new ScreenshotResult(notifierId, path, compositor);
 
-    if (path.isEmpty()) {
+    int outputId = -1;
+    if (fd >= 0) {
+        outputId = ::dup(fd);
+        if (outputId == -1) {
+            qWarning() << "Screenshot file descriptor could not be duplicated" << strerror(errno);
+        }
+    } else if (path.isEmpty()) {
         qWarning() << "Screenshot path is empty.";
+    }
 
-        const quint64 status = ScreenshotResult::Error;
-        ssize_t unused = ::write(notifierId, &status, sizeof(status));
-        Q_UNUSED(unused);
-
+    if (fd >= 0 ? outputId == -1 : path.isEmpty()) {
+        reportError(notifierId);
         return result;
     }
 
+    QSharedPointer<ScreenshotRequest> request(new ScreenshotRequest);
+    request->fd = outputId;
+
     auto grabResult = compositor->contentItem()->grabToImage();
+    if (!grabResult) {
+        reportError(notifierId);
+        return result;
+    }
 
     const int rotation(QGuiApplication::primaryScreen()->angleBetween(
                 Qt::PrimaryOrientation, compositor->topmostWindowOrientation()));
 
+    // Should the result go away first, the request closes the descriptor with the connections
     connect(grabResult.data(), &QQuickItemGrabResult::ready, result, [=]() {
+        if (request->handled) {
+            return;
+        }
+        request->handled = true;
+
         QImage grab = grabResult->image();
-        QThreadPool::globalInstance()->start(new ScreenshotWriter(notifierId, grab, path, rotation));
+        QThreadPool::globalInstance()->start(
+                    new ScreenshotWriter(notifierId, grab, path, request->takeFd(), rotation, options));
+    });
+
+    // Nothing is rendered while the screen is off, for example
+    QTimer::singleShot(GrabTimeoutMs, result, [=]() {
+        if (request->handled) {
+            return;
+        }
+        request->handled = true;
+
+        qWarning() << "Screenshot was not grabbed in time";
+        request->closeFd();
+        reportError(notifierId);
     });
 
     return result;
 }
+
+ScreenshotBurst *ScreenshotService::captureBurst(const QString &path, int count, int interval, bool archive,
+                                                 const ScreenshotOptions &options)
+{
+    LipstickCompositor *compositor = LipstickCompositor::instance();
+    if (!compositor) {
+        return nullptr;
+    }
+
+    if (path.isEmpty() || count <= 0 || interval < 0) {
+        qWarning() << "Invalid screenshot burst" << path << count << interval;
+        return nullptr;
+    }
+
+    const int rotation(QGuiApplication::primaryScreen()->angleBetween(
+                Qt::PrimaryOrientation, compositor->topmostWindowOrientation()));
+
+    return new ScreenshotBurst(compositor, path, count, interval,
+                               archive ? ScreenshotBurst::Archive : ScreenshotBurst::Sequence,
+                               options, rotation, compositor);
+}
@@ -14,12 +14,17 @@
 #ifndef SCREENSHOTSERVICE_H
 #define SCREENSHOTSERVICE_H
 
+#include <QImage>
 #include <QObject>
 #include <QSocketNotifier>
 #include <QUrl>
+#include <QVariantMap>
 
 #include "lipstickglobal.h"
 
+class QIODevice;
+class ScreenshotBurst;
+
 class LIPSTICK_EXPORT ScreenshotResult : public QObject
 {
     Q_OBJECT
@@ -55,11 +60,43 @@ private:
     Status m_status = Writing;
 };
 
+struct LIPSTICK_EXPORT ScreenshotOptions
+{
+    enum Format {
+        Automatic,  // From the file name suffix, PNG if there is none
+        Png,
+        Jpeg,
+        WebP,
+        Raw         // Unencoded RGBA8888 rows, top first
+    };
+
+    Format format = Automatic;
+    int quality = -1;       // JPEG and WebP, 0-100
+    int compression = -1;   // PNG, 0-9
+    qreal scale = 1.0;      // Downscale factor, 0-1
+
+    static ScreenshotOptions fromVariantMap(const QVariantMap &options);
+};
+
 class ScreenshotService : public QObject
 {
     Q_OBJECT
 public:
-    static ScreenshotResult *saveScreenshot(const QString &path);
+    static ScreenshotResult *saveScreenshot(const QString &path, const ScreenshotOptions &options = ScreenshotOptions());
+    // Writes to a duplicate of fd, which the caller remains responsible for
+    static ScreenshotResult *saveScreenshot(int fd, const ScreenshotOptions &options);
+    // Captures count frames, one every interval milliseconds or every rendered frame if zero
+    static ScreenshotBurst *captureBurst(const QString &path, int count, int interval, bool archive,
+                                         const ScreenshotOptions &options = ScreenshotOptions());
+
+    static ScreenshotOptions::Format format(const ScreenshotOptions &options, const QString &path);
+    // Applies the scale of the options and rotates by a multiple of 90 degrees
+    static QImage transformed(const QImage &image, int rotation, const ScreenshotOptions &options);
+    static bool write(QIODevice *device, const QImage &image, ScreenshotOptions::Format format,
+                      const ScreenshotOptions &options);
+
+private:
+    static ScreenshotResult *saveScreenshot(const QString &path, int fd, const ScreenshotOptions &options);
 };
 
 #endif // SCREENSHOTSERVICE_H
@@ -43,6 +43,11 @@ PUBLICHEADERS += \
     components/launchermonitor.h \
     components/launcherdbus.h \
     components/launcherfoldermodel.h \
+    components/launchericonindex.h \
+    components/launchericonprovider.h \
+    components/launcherorderstore.h \
+    components/launchersearchindex.h \
+    components/launchersearchmodel.h \
     notifications/notificationmanager.h \
     notifications/lipsticknotification.h \
     notifications/notificationlistmodel.h \
@@ -79,12 +84,15 @@ HEADERS += \
     lipstickqmlpath.h \
     shutdownscreenadaptor.h \
     screenshotservice.h \
+    screenshotburst.h \
     qdbusxml2cpp_dbus_types.h \
     connmanvpnagent.h \
     connmanvpnproxy.h \
     connmanmanagerproxy.h \
     connmanserviceproxy.h \
     notifications/thermalnotifier.h \
+    utilities/processinfocache.h \
+    utilities/inputlatencyrecorder.h \
     devicestate/devicestate_p.h \
     devicestate/displaystate_p.h \
     devicestate/ipcinterface_p.h \
@@ -99,12 +107,19 @@ SOURCES += \
     lipstickqmlpath.cpp \
     utilities/qobjectlistmodel.cpp \
     utilities/closeeventeater.cpp \
+    utilities/processinfocache.cpp \
+    utilities/inputlatencyrecorder.cpp \
     components/launcheritem.cpp \
     components/launchermodel.cpp \
     components/launcherwatchermodel.cpp \
     components/launchermonitor.cpp \
     components/launcherdbus.cpp \
     components/launcherfoldermodel.cpp \
+    components/launchericonindex.cpp \
+    components/launchericonprovider.cpp \
+    components/launcherorderstore.cpp \
+    components/launchersearchindex.cpp \
+    components/launchersearchmodel.cpp \
     notifications/notificationmanager.cpp \
     notifications/notificationmanageradaptor.cpp \
     notifications/lipsticknotification.cpp \
@@ -130,6 +145,7 @@ SOURCES += \
     connmanserviceproxy.cpp \
     lipstickapi.cpp \
     screenshotservice.cpp \
+    screenshotburst.cpp \
     notifications/thermalnotifier.cpp \
     devicestate/displaystate.cpp \
     devicestate/devicestate.cpp \
@@ -15,6 +15,7 @@
 
 #include "touchscreen.h"
 #include "touchscreen_p.h"
+#include "inputlatencyrecorder.h"
 
 #include <QTimerEvent>
 #include <QDBusConnection>
@@ -222,6 +223,8 @@ bool TouchScreen::eventFilter(QObject *, QEvent *event)
                                 event->type() == QEvent::TouchEnd);
     if (eat) {
         setEnabled(true);
+    } else if (InputLatencyRecorder::isTraced(event->type())) {
+        InputLatencyRecorder::instance()->eventFiltered(event);
     }
 
     return eat;
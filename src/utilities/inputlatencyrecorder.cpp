@@ -0,0 +1,338 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QInputEvent>
+#include <QQuickWindow>
+#include <QTextStream>
+#include <QTimerEvent>
+
+#include <cmath>
+#include <time.h>
+
+#include "inputlatencyrecorder.h"
+
+static const int TraceWriteInterval = 1000;
+static const qint64 NsecsPerMsec = 1000000;
+
+static const char *const StageNames[InputLatencyRecorder::StageCount] = {
+    "kernelToFilter",
+    "filterToDispatch",
+    "dispatchToSwap",
+    "endToEnd"
+};
+
+// Drops the latencies that reached the given stage a timeout ago or more
+static void dropExpired(QVector<InputLatency> &latencies, qint64 InputLatency::*stage, qint64 now)
+{
+    for (int i = 0; i < latencies.count();) {
+        if (now - latencies.at(i).*stage >= InputLatencyRecorder::Timeout * NsecsPerMsec)
+            latencies.remove(i);
+        else
+            ++i;
+    }
+}
+
+void LatencyHistogram::add(qint64 latency)
+{
+    latency = qMax<qint64>(0, latency);
+
+    int index = 0;
+    while (index < BucketCount - 1 && latency > bucketBound(index) * 1000)
+        ++index;
+
+    ++m_buckets[index];
+    ++m_count;
+    m_maximum = qMax(m_maximum, latency);
+}
+
+void LatencyHistogram::clear()
+{
+    *this = LatencyHistogram();
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return m_count;
+}
+
+quint64 LatencyHistogram::bucket(int index) const
+{
+    return index >= 0 && index < BucketCount ? m_buckets[index] : 0;
+}
+
+qint64 LatencyHistogram::bucketBound(int index)
+{
+    return index < BucketCount - 1 ? qint64(250) << index : -1;
+}
+
+qreal LatencyHistogram::percentile(qreal fraction) const
+{
+    if (m_count == 0)
+        return 0;
+
+    const quint64 rank = qMax<quint64>(1, quint64(std::ceil(fraction * m_count)));
+    quint64 seen = 0;
+    for (int index = 0; index < BucketCount - 1; ++index) {
+        seen += m_buckets[index];
+        if (seen >= rank)
+            return qMin(maximum(), bucketBound(index) / 1000.0);
+    }
+    return maximum();
+}
+
+qreal LatencyHistogram::maximum() const
+{
+    return m_maximum / qreal(NsecsPerMsec);
+}
+
+QVariantMap LatencyHistogram::toVariantMap() const
+{
+    QVariantList bounds;
+    QVariantList buckets;
+    for (int index = 0; index < BucketCount; ++index) {
+        bounds.append(bucketBound(index));
+        buckets.append(m_buckets[index]);
+    }
+
+    QVariantMap map;
+    map.insert(QStringLiteral("count"), m_count);
+    map.insert(QStringLiteral("bounds"), bounds);
+    map.insert(QStringLiteral("buckets"), buckets);
+    map.insert(QStringLiteral("p50"), percentile(0.50));
+    map.insert(QStringLiteral("p95"), percentile(0.95));
+    map.insert(QStringLiteral("p99"), percentile(0.99));
+    map.insert(QStringLiteral("maximum"), maximum());
+    return map;
+}
+
+InputLatencyRecorder::InputLatencyRecorder(QObject *parent)
+    : QObject(parent)
+    , m_swapped(0)
+{
+    const QByteArray traceFile = qgetenv("LIPSTICK_INPUT_TRACE");
+    if (!traceFile.isEmpty()) {
+        m_traceFile.setFileName(QString::fromLocal8Bit(traceFile));
+        if (m_traceFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            QTextStream(&m_traceFile) << "# type timestamp (ms) eventTime filtered dispatched swapped (ns)\n";
+            m_traceTimer.start(TraceWriteInterval, this);
+        } else {
+            qWarning() << "Cannot open input trace file" << m_traceFile.fileName() << m_traceFile.errorString();
+        }
+    }
+}
+
+InputLatencyRecorder::~InputLatencyRecorder()
+{
+    if (m_traceFile.isOpen())
+        writeTrace();
+}
+
+InputLatencyRecorder *InputLatencyRecorder::instance()
+{
+    static QPointer<InputLatencyRecorder> recorder;
+    if (!recorder)
+        recorder = new InputLatencyRecorder(qApp);
+    return recorder;
+}
+
+void InputLatencyRecorder::setWindow(QQuickWindow *window)
+{
+    if (m_window)
+        disconnect(m_window, nullptr, this, nullptr);
+
+    m_window = window;
+    if (window) {
+        // Swaps happen on the render thread, the events are completed on this one
+        connect(window, &QQuickWindow::frameSwapped, this, [this]() {
+            m_swapped.storeRelease(monotonicTime());
+            QMetaObject::invokeMethod(this, "windowFrameSwapped", Qt::QueuedConnection);
+        }, Qt::DirectConnection);
+    }
+}
+
+bool InputLatencyRecorder::isTraced(QEvent::Type type)
+{
+    switch (type) {
+    case QEvent::TouchBegin:
+    case QEvent::TouchUpdate:
+    case QEvent::TouchEnd:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+        return true;
+    default:
+        return false;
+    }
+}
+
+qint64 InputLatencyRecorder::monotonicTime()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void InputLatencyRecorder::eventFiltered(const QEvent *event, qint64 now)
+{
+    if (!isTraced(event->type()))
+        return;
+
+    const ulong timestamp = static_cast<const QInputEvent *>(event)->timestamp();
+    if (timestamp == 0)
+        return;
+
+    if (now < 0)
+        now = monotonicTime();
+
+    dropExpired(m_pending, &InputLatency::filtered, now);
+    dropExpired(m_dispatched, &InputLatency::dispatched, now);
+
+    // The same event delivered on to items is skipped
+    for (const InputLatency &pending : m_pending) {
+        if (pending.timestamp == timestamp)
+            return;
+    }
+    for (const InputLatency &dispatched : m_dispatched) {
+        if (dispatched.timestamp == timestamp)
+            return;
+    }
+    if (m_pending.count() >= MaximumPending)
+        m_pending.remove(0);
+
+    InputLatency latency;
+    latency.type = event->type();
+    latency.timestamp = timestamp;
+    latency.filtered = now;
+
+    const qint64 eventTime = qint64(timestamp) * NsecsPerMsec;
+    if (eventTime <= now && now - eventTime < Timeout * NsecsPerMsec)
+        latency.eventTime = eventTime;
+
+    m_pending.append(latency);
+}
+
+void InputLatencyRecorder::eventDispatched(const QInputEvent *event, qint64 now)
+{
+    const ulong timestamp = event->timestamp();
+    for (int i = 0; i < m_pending.count(); ++i) {
+        if (m_pending.at(i).timestamp != timestamp)
+            continue;
+
+        InputLatency latency = m_pending.takeAt(i);
+        latency.dispatched = now < 0 ? monotonicTime() : now;
+
+        // Without a window swapping frames nothing would ever complete these
+        dropExpired(m_dispatched, &InputLatency::dispatched, latency.dispatched);
+        if (m_dispatched.count() >= MaximumPending)
+            m_dispatched.remove(0);
+
+        m_dispatched.append(latency);
+        return;
+    }
+}
+
+void InputLatencyRecorder::frameSwapped(qint64 now)
+{
+    if (now < 0)
+        now = monotonicTime();
+
+    // A frame that comes that late did not show these events
+    dropExpired(m_dispatched, &InputLatency::dispatched, now);
+
+    for (int i = 0; i < m_dispatched.count();) {
+        if (m_dispatched.at(i).dispatched <= now) {
+            InputLatency latency = m_dispatched.takeAt(i);
+            latency.swapped = now;
+            complete(latency);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void InputLatencyRecorder::windowFrameSwapped()
+{
+    frameSwapped(m_swapped.loadAcquire());
+}
+
+void InputLatencyRecorder::complete(const InputLatency &latency)
+{
+    if (latency.eventTime > 0)
+        m_histograms[KernelToFilter].add(latency.filtered - latency.eventTime);
+    m_histograms[FilterToDispatch].add(latency.dispatched - latency.filtered);
+    m_histograms[DispatchToSwap].add(latency.swapped - latency.dispatched);
+    m_histograms[EndToEnd].add(latency.swapped - (latency.eventTime > 0 ? latency.eventTime : latency.filtered));
+
+    if (m_traceFile.isOpen())
+        m_trace.append(latency);
+}
+
+const LatencyHistogram &InputLatencyRecorder::histogram(Stage stage) const
+{
+    return m_histograms[stage];
+}
+
+int InputLatencyRecorder::pendingCount() const
+{
+    return m_pending.count() + m_dispatched.count();
+}
+
+void InputLatencyRecorder::clear()
+{
+    m_pending.clear();
+    m_dispatched.clear();
+    for (LatencyHistogram &histogram : m_histograms)
+        histogram.clear();
+}
+
+QVariantMap InputLatencyRecorder::toVariantMap() const
+{
+    QVariantMap map;
+    for (int stage = 0; stage < StageCount; ++stage)
+        map.insert(QLatin1String(StageNames[stage]), m_histograms[stage].toVariantMap());
+    return map;
+}
+
+void InputLatencyRecorder::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_traceTimer.timerId()) {
+        writeTrace();
+    } else {
+        QObject::timerEvent(event);
+    }
+}
+
+void InputLatencyRecorder::writeTrace()
+{
+    if (m_trace.isEmpty())
+        return;
+
+    QTextStream stream(&m_traceFile);
+    for (const InputLatency &latency : m_trace) {
+        stream << int(latency.type) << ' '
+               << quint64(latency.timestamp) << ' '
+               << latency.eventTime << ' '
+               << latency.filtered << ' '
+               << latency.dispatched << ' '
+               << latency.swapped << '\n';
+    }
+    stream.flush();
+    m_traceFile.flush();
+    m_trace.clear();
+}
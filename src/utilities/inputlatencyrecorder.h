@@ -0,0 +1,151 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef INPUTLATENCYRECORDER_H
+#define INPUTLATENCYRECORDER_H
+
+#include <QAtomicInteger>
+#include <QBasicTimer>
+#include <QEvent>
+#include <QFile>
+#include <QObject>
+#include <QPointer>
+#include <QVariantMap>
+#include <QVector>
+
+class QInputEvent;
+class QQuickWindow;
+
+/*
+ * Latencies counted into fixed buckets of doubling width, from 250 us up to
+ * half a second, the last bucket taking everything slower.
+ */
+class LatencyHistogram
+{
+public:
+    enum {
+        BucketCount = 13
+    };
+
+    void add(qint64 latency);   // Nanoseconds
+    void clear();
+
+    quint64 count() const;
+    quint64 bucket(int index) const;
+    // Upper bound of the bucket in microseconds, -1 for the last one
+    static qint64 bucketBound(int index);
+    // Milliseconds, the upper bound of the bucket the percentile falls in
+    qreal percentile(qreal fraction) const;
+    qreal maximum() const;      // Milliseconds
+
+    QVariantMap toVariantMap() const;
+
+private:
+    quint64 m_buckets[BucketCount] = {};
+    quint64 m_count = 0;
+    qint64 m_maximum = 0;
+};
+
+// Timestamps of one input event in nanoseconds on the monotonic clock, zero when not known
+struct InputLatency
+{
+    QEvent::Type type = QEvent::None;
+    ulong timestamp = 0;        // Of the event, in milliseconds
+    qint64 eventTime = 0;       // The kernel read the event
+    qint64 filtered = 0;        // Seen by the application event filter
+    qint64 dispatched = 0;      // Sent to the client
+    qint64 swapped = 0;         // The first frame swapped after that
+};
+
+/*
+ * Traces input events from the kernel to the client they are delivered to.
+ *
+ * An event is picked up when it passes the event filter of TouchScreen, is
+ * matched by its timestamp when the compositor sends it to a client, and is
+ * complete once the next frame is swapped. The time spent in each of these
+ * stages is counted into histograms. Events that never reach a client, like
+ * those coalesced with later ones, and dispatched events no frame follows
+ * are dropped after a second, and at most MaximumPending of each are kept.
+ *
+ * The timestamp the platform plugin gives an event is only taken for the
+ * time the kernel read it when it is on the monotonic clock, which depends on
+ * the input backend. Otherwise the trace starts at the event filter.
+ *
+ * Setting LIPSTICK_INPUT_TRACE to a file name additionally appends every
+ * completed event to that file.
+ */
+class InputLatencyRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Stage {
+        KernelToFilter,
+        FilterToDispatch,
+        DispatchToSwap,
+        EndToEnd,
+        StageCount
+    };
+
+    enum {
+        MaximumPending = 64,
+        Timeout = 1000      // Milliseconds
+    };
+
+    explicit InputLatencyRecorder(QObject *parent = nullptr);
+    ~InputLatencyRecorder();
+
+    static InputLatencyRecorder *instance();
+
+    // Completes dispatched events as frames of the window are swapped
+    void setWindow(QQuickWindow *window);
+
+    static bool isTraced(QEvent::Type type);
+    static qint64 monotonicTime();
+
+    // Times are in nanoseconds on the monotonic clock, -1 being now
+    void eventFiltered(const QEvent *event, qint64 now = -1);
+    void eventDispatched(const QInputEvent *event, qint64 now = -1);
+    void frameSwapped(qint64 now = -1);
+
+    const LatencyHistogram &histogram(Stage stage) const;
+    int pendingCount() const;
+    void clear();
+
+    // Histograms of every stage, keyed by stage name
+    QVariantMap toVariantMap() const;
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private slots:
+    void windowFrameSwapped();
+
+private:
+    void complete(const InputLatency &latency);
+    void writeTrace();
+
+    QVector<InputLatency> m_pending;    // Filtered, not yet dispatched
+    QVector<InputLatency> m_dispatched; // Waiting for the next frame
+    LatencyHistogram m_histograms[StageCount];
+
+    QPointer<QQuickWindow> m_window;
+    QAtomicInteger<qint64> m_swapped;   // Written on the render thread
+
+    QFile m_traceFile;
+    QBasicTimer m_traceTimer;
+    QVector<InputLatency> m_trace;
+};
+
+#endif // INPUTLATENCYRECORDER_H
@@ -0,0 +1,239 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QSocketNotifier>
+
+#include <grp.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "processinfocache.h"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+namespace {
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+int openPidfd(qint64 processId)
+{
+    return int(::syscall(SYS_pidfd_open, pid_t(processId), 0));
+}
+
+bool hasExited(int pidfd)
+{
+    // A pidfd turns readable once the process has exited
+    pollfd fd = { pidfd, POLLIN, 0 };
+    return ::poll(&fd, 1, 0) > 0;
+}
+
+}
+
+QString ProcessInfo::name() const
+{
+    return arguments.isEmpty() ? QString() : QFileInfo(arguments.first()).fileName();
+}
+
+bool ProcessInfo::isPrivileged() const
+{
+    static const gid_t privilegedGroup = [] {
+        const group *entry = ::getgrnam("privileged");
+        return entry ? entry->gr_gid : gid_t(-1);
+    }();
+
+    if (!isValid())
+        return false;
+
+    // The /proc/<pid> directory is owned by EUID:EGID of the process
+    struct stat status;
+    if (::stat(QFile::encodeName(directory).constData(), &status) != 0)
+        return false;
+
+    return status.st_uid == 0 || (privilegedGroup != gid_t(-1) && status.st_gid == privilegedGroup);
+}
+
+bool ProcessInfo::startsWith(const QStringList &prefix) const
+{
+    if (prefix.isEmpty() || prefix.count() > arguments.count())
+        return false;
+
+    for (int i = 0; i < prefix.count(); ++i) {
+        if (arguments.at(i) != prefix.at(i))
+            return false;
+    }
+    return true;
+}
+
+ProcessInfoCache::ProcessInfoCache(const QString &procRoot, QObject *parent)
+    : QObject(parent)
+    , m_procRoot(procRoot)
+{
+}
+
+ProcessInfoCache::~ProcessInfoCache()
+{
+    for (const Entry &entry : m_entries) {
+        if (entry.pidfd >= 0)
+            ::close(entry.pidfd);
+    }
+}
+
+ProcessInfoCache *ProcessInfoCache::instance()
+{
+    static QPointer<ProcessInfoCache> cache;
+    if (!cache)
+        cache = new ProcessInfoCache(QStringLiteral("/proc"), qApp);
+    return cache;
+}
+
+ProcessInfo ProcessInfoCache::info(qint64 processId)
+{
+    if (processId <= 0)
+        return ProcessInfo();
+
+    QHash<qint64, Entry>::iterator it = m_entries.find(processId);
+    if (it != m_entries.end()) {
+        if (it->pidfd >= 0 || readStartTime(processId) == it->info.startTime)
+            return it->info;
+        remove(it);
+    }
+
+    Entry entry;
+    // Opened before reading, so that the pidfd refers to the process that was read
+    if (m_procRoot == QLatin1String("/proc"))
+        entry.pidfd = openPidfd(processId);
+    entry.info = read(processId);
+
+    if (!entry.info.isValid() || (entry.pidfd >= 0 && hasExited(entry.pidfd))) {
+        if (entry.pidfd >= 0)
+            ::close(entry.pidfd);
+        return entry.info;
+    }
+
+    if (entry.pidfd >= 0) {
+        entry.notifier = new QSocketNotifier(entry.pidfd, QSocketNotifier::Read, this);
+        connect(entry.notifier, SIGNAL(activated(int)), this, SLOT(processExited(int)));
+        m_pidfds.insert(entry.pidfd, processId);
+    }
+    if (!entry.info.arguments.isEmpty())
+        m_binaries.insert(entry.info.arguments.first(), processId);
+
+    m_entries.insert(processId, entry);
+    return entry.info;
+}
+
+QList<qint64> ProcessInfoCache::processes(const QStringList &argumentPrefix) const
+{
+    QList<qint64> processes;
+    if (argumentPrefix.isEmpty())
+        return processes;
+
+    for (qint64 processId : m_binaries.values(argumentPrefix.first())) {
+        if (m_entries.value(processId).info.startsWith(argumentPrefix))
+            processes.append(processId);
+    }
+    return processes;
+}
+
+bool ProcessInfoCache::contains(qint64 processId) const
+{
+    return m_entries.contains(processId);
+}
+
+void ProcessInfoCache::invalidate(qint64 processId)
+{
+    QHash<qint64, Entry>::iterator it = m_entries.find(processId);
+    if (it != m_entries.end())
+        remove(it);
+}
+
+void ProcessInfoCache::processExited(int pidfd)
+{
+    invalidate(m_pidfds.value(pidfd));
+}
+
+void ProcessInfoCache::remove(QHash<qint64, Entry>::iterator it)
+{
+    if (!it->info.arguments.isEmpty())
+        m_binaries.remove(it->info.arguments.first(), it.key());
+
+    if (it->pidfd >= 0) {
+        m_pidfds.remove(it->pidfd);
+        // May be called from the notifier's own signal
+        it->notifier->setEnabled(false);
+        it->notifier->deleteLater();
+        ::close(it->pidfd);
+    }
+
+    m_entries.erase(it);
+}
+
+qint64 ProcessInfoCache::parseStartTime(const QByteArray &stat)
+{
+    // The command name in parenthesis may contain spaces, the fields after it do not
+    const int commEnd = stat.lastIndexOf(')');
+    if (commEnd < 0)
+        return -1;
+
+    // starttime is field 22, the state after the command name being field 3
+    const QList<QByteArray> fields = stat.mid(commEnd + 2).split(' ');
+    if (fields.count() < 20)
+        return -1;
+
+    bool ok = false;
+    const qint64 startTime = fields.at(19).toLongLong(&ok);
+    return ok ? startTime : -1;
+}
+
+qint64 ProcessInfoCache::readStartTime(qint64 processId) const
+{
+    return parseStartTime(readFile(QStringLiteral("%1/%2/stat").arg(m_procRoot).arg(processId)));
+}
+
+ProcessInfo ProcessInfoCache::read(qint64 processId) const
+{
+    const QString directory = QStringLiteral("%1/%2").arg(m_procRoot).arg(processId);
+
+    ProcessInfo info;
+    info.startTime = parseStartTime(readFile(directory + QStringLiteral("/stat")));
+    if (!info.isValid())
+        return info;
+
+    info.processId = processId;
+    info.directory = directory;
+
+    // Command line arguments are split by '\0' in /proc/*/cmdline
+    for (const QByteArray &argument : readFile(directory + QStringLiteral("/cmdline")).split('\0')) {
+        if (!argument.isEmpty())
+            info.arguments.append(QString::fromUtf8(argument));
+    }
+
+    const QByteArray comm = readFile(directory + QStringLiteral("/comm"));
+    info.comm = QFile::decodeName(comm.left(comm.indexOf('\n')));
+    info.exe = QFile::symLinkTarget(directory + QStringLiteral("/exe"));
+
+    return info;
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef PROCESSINFOCACHE_H
+#define PROCESSINFOCACHE_H
+
+#include <QHash>
+#include <QMultiHash>
+#include <QObject>
+#include <QStringList>
+
+class QSocketNotifier;
+
+struct ProcessInfo
+{
+    qint64 processId = 0;
+    QStringList arguments;  // From cmdline, the first one being the binary
+    QString comm;
+    QString exe;            // Empty when the exe link is not readable
+    qint64 startTime = -1;  // Clock ticks after boot, from stat
+    QString directory;      // The /proc/<pid> directory
+
+    bool isValid() const { return startTime >= 0; }
+    // File name of the binary
+    QString name() const;
+    // Not cached, the process may have changed its credentials since it was read
+    bool isPrivileged() const;
+    bool startsWith(const QStringList &arguments) const;
+};
+
+/*
+ * Process metadata read from /proc, parsed once per process.
+ *
+ * An entry is dropped as soon as its process exits, which is noticed through
+ * a pidfd of the process. Where pidfds are not available, the start time of
+ * the process is checked on every lookup instead, so that a reused pid is
+ * never given the metadata of the process that had it before. Cached
+ * processes are also indexed by their binary.
+ *
+ * A process that execs keeps its pid and pidfd, so the cached command line of
+ * a process that replaces itself is that of the process it was first seen as.
+ * Credentials are never cached: whether a process is privileged is checked
+ * from its /proc directory on every call.
+ */
+class ProcessInfoCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProcessInfoCache(const QString &procRoot = QStringLiteral("/proc"), QObject *parent = nullptr);
+    ~ProcessInfoCache();
+
+    static ProcessInfoCache *instance();
+
+    // Invalid for processes that do not exist
+    ProcessInfo info(qint64 processId);
+    // Cached processes whose command line starts with the given arguments
+    QList<qint64> processes(const QStringList &argumentPrefix) const;
+    bool contains(qint64 processId) const;
+
+    void invalidate(qint64 processId);
+
+    static qint64 parseStartTime(const QByteArray &stat);
+
+private slots:
+    void processExited(int pidfd);
+
+private:
+    struct Entry
+    {
+        ProcessInfo info;
+        int pidfd = -1;
+        QSocketNotifier *notifier = nullptr;
+    };
+
+    ProcessInfo read(qint64 processId) const;
+    qint64 readStartTime(qint64 processId) const;
+    void remove(QHash<qint64, Entry>::iterator it);
+
+    QString m_procRoot;
+    QHash<qint64, Entry> m_entries;
+    QHash<int, qint64> m_pidfds;
+    QMultiHash<QString, qint64> m_binaries;
+};
+
+#endif // PROCESSINFOCACHE_H
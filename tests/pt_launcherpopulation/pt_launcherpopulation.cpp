@@ -0,0 +1,340 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QDBusConnection>
+#include <QColor>
+#include <QImage>
+
+#include <malloc.h>
+
+#include "launcherfoldermodel.h"
+#include "launcheritem.h"
+#include "launchermodel.h"
+#include "pt_launcherpopulation.h"
+
+// Number of applications installed when the benchmark starts
+static const int InstalledApplications = 300;
+// Number of applications added or removed at once, as by a bulk install
+static const int PackageApplications = 50;
+
+static const int WaitTimeoutMs = 30000;
+
+class BenchmarkFolderModel : public LauncherFolderModel
+{
+public:
+    BenchmarkFolderModel()
+        : LauncherFolderModel(DeferInitialization)
+    {
+    }
+
+    using LauncherFolderModel::initialize;
+};
+
+static QString applicationName(int index)
+{
+    return QStringLiteral("pt-app-%1").arg(index, 4, 10, QLatin1Char('0'));
+}
+
+static size_t allocatedBytes()
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return mallinfo().uordblks;
+#endif
+}
+
+QVariantMap SailjailStub::GetAppInfo(const QString &application)
+{
+    ++calls;
+
+    QVariantMap info;
+    info.insert(QStringLiteral("Mode"), sandboxedApplications.contains(application)
+                ? QStringLiteral("Normal")
+                : QStringLiteral("None"));
+    return info;
+}
+
+void Pt_LauncherPopulation::initTestCase()
+{
+    dbusDaemon.start(QStringLiteral("dbus-daemon"),
+                     QStringList() << "--session" << "--nofork" << "--print-address");
+    if (!dbusDaemon.waitForStarted() || !dbusDaemon.waitForReadyRead()) {
+        QSKIP("dbus-daemon is needed to stub the sailjail service");
+    }
+
+    // Launcher items query sailjaild on the system bus, keep all of it private
+    const QByteArray address = dbusDaemon.readLine().trimmed();
+    qputenv("DBUS_SYSTEM_BUS_ADDRESS", address);
+    qputenv("DBUS_SESSION_BUS_ADDRESS", address);
+
+    QDBusConnection bus = QDBusConnection::systemBus();
+    QVERIFY(bus.isConnected());
+    QVERIFY(bus.registerObject("/org/sailfishos/sailjaild1", &sailjail, QDBusConnection::ExportAllSlots));
+    QVERIFY(bus.registerService("org.sailfishos.sailjaild1"));
+
+    // The launcher order is stored in the user's lipstick settings
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(tempDir->path() + "/config"));
+    qputenv("XDG_DATA_HOME", QFile::encodeName(tempDir->path() + "/data"));
+
+    applicationsDir = tempDir->path() + "/applications/";
+    iconsDir = tempDir->path() + "/icons/";
+    configDir = tempDir->path() + "/config/lipstick/";
+    LauncherFolderModel::setConfigDir(configDir);
+}
+
+void Pt_LauncherPopulation::cleanupTestCase()
+{
+    delete tempDir;
+    tempDir = nullptr;
+
+    dbusDaemon.kill();
+    dbusDaemon.waitForFinished();
+}
+
+void Pt_LauncherPopulation::init()
+{
+    QDir(tempDir->path() + "/config").removeRecursively();
+    QDir(applicationsDir).removeRecursively();
+    QDir(iconsDir).removeRecursively();
+    QVERIFY(QDir().mkpath(applicationsDir));
+    QVERIFY(QDir().mkpath(iconsDir));
+    QVERIFY(QDir().mkpath(configDir));
+
+    sailjail.sandboxedApplications.clear();
+    sailjail.calls = 0;
+}
+
+void Pt_LauncherPopulation::cleanup()
+{
+}
+
+void Pt_LauncherPopulation::createApplications(int first, int count)
+{
+    QImage icon(86, 86, QImage::Format_ARGB32);
+
+    for (int i = first; i < first + count; ++i) {
+        const QString name = applicationName(i);
+
+        icon.fill(QColor::fromHsv(i % 360, 200, 200));
+        QVERIFY(icon.save(iconsDir + name + ".png"));
+
+        QFile file(applicationsDir + name + ".desktop");
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QTextStream stream(&file);
+        stream << "[Desktop Entry]\n"
+               << "Type=Application\n"
+               << "Name=Application " << i << "\n"
+               << "Name[fi]=Sovellus " << i << "\n"
+               << "Icon=" << name << "\n"
+               << "Exec=/usr/bin/invoker --type=silica-qt5 -s /usr/bin/" << name << "\n"
+               << "Categories=Utility;\n";
+
+        // Every third application is sandboxed, like most store applications
+        if (i % 3 == 0) {
+            stream << "\n[X-Sailjail]\n"
+                   << "OrganizationName=org.example\n"
+                   << "ApplicationName=App" << i << "\n";
+            sailjail.sandboxedApplications.insert(name);
+        }
+    }
+}
+
+void Pt_LauncherPopulation::removeApplications(int first, int count)
+{
+    for (int i = first; i < first + count; ++i) {
+        const QString name = applicationName(i);
+        QVERIFY(QFile::remove(applicationsDir + name + ".desktop"));
+        QVERIFY(QFile::remove(iconsDir + name + ".png"));
+    }
+}
+
+LauncherFolderModel *Pt_LauncherPopulation::createModel()
+{
+    BenchmarkFolderModel *model = new BenchmarkFolderModel;
+    model->setDirectories(QStringList() << applicationsDir);
+    model->setIconDirectories(QStringList() << iconsDir);
+    model->initialize();
+    return model;
+}
+
+bool Pt_LauncherPopulation::waitForItemCount(LauncherModel *model, int count)
+{
+    if (model->itemCount() == count) {
+        return true;
+    }
+
+    QEventLoop loop;
+    QTimer::singleShot(WaitTimeoutMs, &loop, SLOT(quit()));
+    connect(model, &QObjectListModel::itemCountChanged, &loop, [&]() {
+        if (model->itemCount() == count) {
+            loop.quit();
+        }
+    });
+    loop.exec();
+
+    return model->itemCount() == count;
+}
+
+void Pt_LauncherPopulation::benchmarkPopulate_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100 applications") << 100;
+    QTest::newRow("500 applications") << 500;
+    QTest::newRow("1000 applications") << 1000;
+}
+
+void Pt_LauncherPopulation::benchmarkPopulate()
+{
+    QFETCH(int, count);
+    createApplications(0, count);
+
+    LauncherFolderModel *model = nullptr;
+    QBENCHMARK_ONCE {
+        model = createModel();
+    }
+    QCOMPARE(model->allItems()->itemCount(), count);
+
+    delete model;
+}
+
+void Pt_LauncherPopulation::benchmarkSandboxingInfo_data()
+{
+    benchmarkPopulate_data();
+}
+
+void Pt_LauncherPopulation::benchmarkSandboxingInfo()
+{
+    QFETCH(int, count);
+    createApplications(0, count);
+
+    LauncherFolderModel *model = createModel();
+    QCOMPARE(model->allItems()->itemCount(), count);
+
+    // Sandboxing info arrives asynchronously, each reply updates its item
+    int updatedItems = 0;
+    for (int i = 0; i < count; ++i) {
+        connect(static_cast<LauncherItem *>(model->allItems()->get(i)), &LauncherItem::itemChanged,
+                this, [&updatedItems]() { ++updatedItems; });
+    }
+    QBENCHMARK_ONCE {
+        QTRY_VERIFY_WITH_TIMEOUT(updatedItems >= count, WaitTimeoutMs);
+    }
+
+    delete model;
+}
+
+void Pt_LauncherPopulation::benchmarkMemoryPerItem_data()
+{
+    benchmarkPopulate_data();
+}
+
+void Pt_LauncherPopulation::benchmarkMemoryPerItem()
+{
+    QFETCH(int, count);
+    createApplications(0, count);
+
+    // Populate once so that one time allocations are not accounted per item
+    delete createModel();
+    QCoreApplication::processEvents();
+
+    const size_t before = allocatedBytes();
+    LauncherFolderModel *model = createModel();
+    const size_t after = allocatedBytes();
+    QCOMPARE(model->allItems()->itemCount(), count);
+
+    QTest::setBenchmarkResult(qreal(after - before) / count, QTest::BytesAllocated);
+
+    delete model;
+}
+
+void Pt_LauncherPopulation::benchmarkInstallPackages()
+{
+    createApplications(0, InstalledApplications);
+    LauncherFolderModel *model = createModel();
+    QCOMPARE(model->allItems()->itemCount(), InstalledApplications);
+
+    createApplications(InstalledApplications, PackageApplications);
+    QBENCHMARK_ONCE {
+        QVERIFY(waitForItemCount(model->allItems(), InstalledApplications + PackageApplications));
+    }
+
+    delete model;
+}
+
+void Pt_LauncherPopulation::benchmarkRemovePackages()
+{
+    createApplications(0, InstalledApplications + PackageApplications);
+    LauncherFolderModel *model = createModel();
+    QCOMPARE(model->allItems()->itemCount(), InstalledApplications + PackageApplications);
+
+    removeApplications(InstalledApplications, PackageApplications);
+    QBENCHMARK_ONCE {
+        QVERIFY(waitForItemCount(model->allItems(), InstalledApplications));
+    }
+
+    delete model;
+}
+
+static void createFolders(LauncherFolderModel *model)
+{
+    // Twenty folders of five applications, the rest stays at the top level
+    for (int i = 0; i < 20; ++i) {
+        LauncherFolderItem *folder = model->createFolder(model->itemCount(), QStringLiteral("Folder %1").arg(i));
+        for (int j = 0; j < 5; ++j) {
+            model->moveToFolder(model->get(0), folder);
+        }
+    }
+}
+
+void Pt_LauncherPopulation::benchmarkFolderSave()
+{
+    createApplications(0, InstalledApplications);
+    LauncherFolderModel *model = createModel();
+    createFolders(model);
+
+    // Only the snapshot taken on the main thread is measured, writing happens
+    // in the background and skips menus that did not change
+    QBENCHMARK {
+        model->save();
+    }
+
+    delete model;
+    QVERIFY(QFile::exists(LauncherFolderModel::configFile()));
+}
+
+void Pt_LauncherPopulation::benchmarkFolderLoad()
+{
+    createApplications(0, InstalledApplications);
+    LauncherFolderModel *model = createModel();
+    createFolders(model);
+    model->save();
+    // Waits for the menu to be written
+    delete model;
+
+    model = createModel();
+    QCOMPARE(model->itemCount(), InstalledApplications - 100 + 20);
+
+    QBENCHMARK {
+        model->load();
+    }
+
+    delete model;
+}
+
+QTEST_MAIN(Pt_LauncherPopulation)
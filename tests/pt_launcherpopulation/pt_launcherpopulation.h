@@ -0,0 +1,77 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef PT_LAUNCHERPOPULATION_H
+#define PT_LAUNCHERPOPULATION_H
+
+#include <QDBusContext>
+#include <QObject>
+#include <QProcess>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QVariantMap>
+
+class LauncherFolderModel;
+class LauncherModel;
+
+// Answers GetAppInfo like sailjaild does, on a private bus
+class SailjailStub : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.sailfishos.sailjaild1")
+
+public:
+    QSet<QString> sandboxedApplications;
+    int calls = 0;
+
+public slots:
+    QVariantMap GetAppInfo(const QString &application);
+};
+
+class Pt_LauncherPopulation : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void benchmarkPopulate_data();
+    void benchmarkPopulate();
+    void benchmarkSandboxingInfo_data();
+    void benchmarkSandboxingInfo();
+    void benchmarkMemoryPerItem_data();
+    void benchmarkMemoryPerItem();
+    void benchmarkInstallPackages();
+    void benchmarkRemovePackages();
+    void benchmarkFolderSave();
+    void benchmarkFolderLoad();
+
+private:
+    void createApplications(int first, int count);
+    void removeApplications(int first, int count);
+    LauncherFolderModel *createModel();
+    bool waitForItemCount(LauncherModel *model, int count);
+
+    QProcess dbusDaemon;
+    SailjailStub sailjail;
+    QTemporaryDir *tempDir = nullptr;
+    QString applicationsDir;
+    QString iconsDir;
+    QString configDir;
+};
+
+#endif
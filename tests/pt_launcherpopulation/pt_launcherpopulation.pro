@@ -0,0 +1,50 @@
+include(../common.pri)
+TARGET = pt_launcherpopulation
+
+INCLUDEPATH += $$COMPONENTSSRCDIR
+INCLUDEPATH += $$UTILITYSRCDIR
+INCLUDEPATH += $$3RDPARTYSRCDIR
+
+QMAKE_CXXFLAGS += `pkg-config --cflags-only-I mlite5`
+
+QT += dbus qml quick
+
+# Report file system changes right away instead of batching them
+DEFINES += LAUNCHER_MONITOR_HOLDBACK_TIMEOUT_MS=0
+
+PKGCONFIG += glib-2.0
+
+packagesExist(contentaction5) {
+    PKGCONFIG += contentaction5
+    DEFINES += HAVE_CONTENTACTION
+} else {
+    PKGCONFIG += \
+        gio-2.0
+}
+
+SOURCES += \
+    pt_launcherpopulation.cpp \
+    $$COMPONENTSSRCDIR/launchermodel.cpp \
+    $$COMPONENTSSRCDIR/launchermonitor.cpp \
+    $$COMPONENTSSRCDIR/launcheritem.cpp \
+    $$COMPONENTSSRCDIR/launcherdbus.cpp \
+    $$COMPONENTSSRCDIR/launcherfoldermodel.cpp \
+    $$COMPONENTSSRCDIR/launchericonindex.cpp \
+    $$COMPONENTSSRCDIR/launchericonprovider.cpp \
+    $$COMPONENTSSRCDIR/launcherorderstore.cpp \
+    $$UTILITYSRCDIR/qobjectlistmodel.cpp \
+    $$SRCDIR/logging.cpp \
+
+HEADERS += \
+    pt_launcherpopulation.h \
+    $$COMPONENTSSRCDIR/launchermodel.h \
+    $$COMPONENTSSRCDIR/launchermonitor.h \
+    $$COMPONENTSSRCDIR/launcheritem.h \
+    $$COMPONENTSSRCDIR/launcherdbus.h \
+    $$COMPONENTSSRCDIR/launcherfoldermodel.h \
+    $$COMPONENTSSRCDIR/launchericonindex.h \
+    $$COMPONENTSSRCDIR/launchericonprovider.h \
+    $$COMPONENTSSRCDIR/launcherorderstore.h \
+    $$UTILITYSRCDIR/qobjectlistmodel.h \
+    $$3RDPARTYSRCDIR/synchronizelists.h \
+    $$SRCDIR/logging.h \
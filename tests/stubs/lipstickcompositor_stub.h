@@ -45,7 +45,7 @@ public:
     virtual bool displayDimmed() const;
     virtual LipstickKeymap *keymap() const;
     virtual void setKeymap(LipstickKeymap *keymap);
-    virtual void updateKeymap();
+    virtual void applyKeymap();
     virtual QObject *clipboard() const;
     virtual bool debug() const;
     virtual QObject *windowForId(int) const;
@@ -60,7 +60,6 @@ public:
     virtual void surfaceTitleChanged();
     virtual void surfaceRaised();
     virtual void surfaceLowered();
-    virtual void surfaceDamaged(const QRegion &);
     virtual void windowSwapped();
     virtual void windowDestroyed();
     virtual void windowPropertyChanged(const QString &);
@@ -73,7 +72,6 @@ public:
     virtual void readContent();
     virtual void initialize();
     virtual bool completed();
-    virtual void timerEvent(QTimerEvent *e);
     virtual bool event(QEvent *e);
     virtual void sendKeyEvent(QEvent::Type type, Qt::Key key, quint32 nativeScanCode);
 };
@@ -206,9 +204,9 @@ void LipstickCompositorStub::setKeymap(LipstickKeymap *keymap)
     stubMethodEntered("setKeymap", params);
 }
 
-void LipstickCompositorStub::updateKeymap()
+void LipstickCompositorStub::applyKeymap()
 {
-    stubMethodEntered("updateKeymap");
+    stubMethodEntered("applyKeymap");
 }
 
 QObject *LipstickCompositorStub::clipboard() const
@@ -312,13 +310,6 @@ bool LipstickCompositorStub::completed()
     return true;
 }
 
-void LipstickCompositorStub::timerEvent(QTimerEvent *e)
-{
-    QList<ParameterBase *> params;
-    params.append(new Parameter<QTimerEvent *>(e));
-    stubMethodEntered("timerEvent", params);
-}
-
 bool LipstickCompositorStub::event(QEvent *e)
 {
     QList<ParameterBase *> params;
@@ -336,13 +327,6 @@ void LipstickCompositorStub::sendKeyEvent(QEvent::Type type, Qt::Key key, quint3
   stubMethodEntered("sendKeyEvent", params);
 }
 
-void LipstickCompositorStub::surfaceDamaged(const QRegion &rect)
-{
-    QList<ParameterBase *> params;
-    params.append(new Parameter<QRegion>(rect));
-    stubMethodEntered("surfaceDamaged", params);
-}
-
 void LipstickCompositorStub::windowSwapped()
 {
     stubMethodEntered("windowSwapped");
@@ -404,6 +388,7 @@ LipstickCompositorStub *gLipstickCompositorStub = &gDefaultLipstickCompositorStu
 
 // 4. CREATE A PROXY WHICH CALLS THE STUB
 LipstickCompositor::LipstickCompositor()
+    : m_topmostWindowOrientation(Qt::PrimaryOrientation)
 {
     gLipstickCompositorStub->LipstickCompositorConstructor();
 }
@@ -498,9 +483,9 @@ void LipstickCompositor::setKeymap(LipstickKeymap *keymap)
     gLipstickCompositorStub->setKeymap(keymap);
 }
 
-void LipstickCompositor::updateKeymap()
+void LipstickCompositor::applyKeymap()
 {
-    gLipstickCompositorStub->updateKeymap();
+    gLipstickCompositorStub->applyKeymap();
 }
 
 QObject *LipstickCompositor::clipboard() const
@@ -573,11 +558,6 @@ void LipstickCompositor::surfaceLowered()
     gLipstickCompositorStub->surfaceLowered();
 }
 
-void LipstickCompositor::surfaceDamaged(const QRegion &rect)
-{
-    gLipstickCompositorStub->surfaceDamaged(rect);
-}
-
 void LipstickCompositor::windowSwapped()
 {
     gLipstickCompositorStub->windowSwapped();
@@ -637,11 +617,6 @@ bool LipstickCompositor::completed()
     return gLipstickCompositorStub->completed();
 }
 
-void LipstickCompositor::timerEvent(QTimerEvent *e)
-{
-    gLipstickCompositorStub->timerEvent(e);
-}
-
 bool LipstickCompositor::event(QEvent *e)
 {
     return gLipstickCompositorStub->event(e);
@@ -656,4 +631,16 @@ void LipstickCompositor::processQueuedSetUpdatesEnabledCalls()
 {
 }
 
+void LipstickCompositor::updateSnapshotPoolBudget()
+{
+}
+
+void LipstickCompositor::updateClientAccountingLogInterval()
+{
+}
+
+void LipstickCompositor::updateTouchMotionCompression()
+{
+}
+
 #endif
@@ -0,0 +1,314 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef LIPSTICKCOMPOSITORWINDOW_STUB
+#define LIPSTICKCOMPOSITORWINDOW_STUB
+
+#include "lipstickcompositorwindow.h"
+#include <stubbase.h>
+
+
+// 1. DECLARE STUB
+// FIXME - stubgen is not yet finished
+class LipstickCompositorWindowStub : public StubBase
+{
+public:
+    virtual void LipstickCompositorWindowConstructor(int windowId, const QString &category, QWaylandQuickSurface *surface, QQuickItem *parent);
+    virtual void LipstickCompositorWindowDestructor();
+    virtual QVariant userData() const;
+    virtual void setUserData(QVariant data);
+    virtual QString policyApplicationId() const;
+    virtual bool delayRemove() const;
+    virtual void setDelayRemove(bool delay);
+    virtual QString title() const;
+    virtual bool isInProcess() const;
+    virtual bool isAlien() const;
+    virtual QRect mouseRegionBounds() const;
+    virtual bool eventFilter(QObject *object, QEvent *event);
+    virtual void terminateProcess(int killTimeout);
+    virtual bool focusOnTouch() const;
+    virtual void setFocusOnTouch(bool focusOnTouch);
+    virtual void resize(const QSize &size);
+    virtual void handleTouchCancel();
+    virtual void killProcess();
+};
+
+// 2. IMPLEMENT STUB
+void LipstickCompositorWindowStub::LipstickCompositorWindowConstructor(int windowId, const QString &category, QWaylandQuickSurface *surface, QQuickItem *parent)
+{
+    Q_UNUSED(windowId);
+    Q_UNUSED(category);
+    Q_UNUSED(surface);
+    Q_UNUSED(parent);
+}
+void LipstickCompositorWindowStub::LipstickCompositorWindowDestructor()
+{
+}
+QVariant LipstickCompositorWindowStub::userData() const
+{
+    stubMethodEntered("userData");
+    return stubReturnValue<QVariant>("userData");
+}
+void LipstickCompositorWindowStub::setUserData(QVariant data)
+{
+    QList<ParameterBase *> params;
+    params.append(new Parameter<QVariant>(data));
+    stubMethodEntered("setUserData", params);
+}
+QString LipstickCompositorWindowStub::policyApplicationId() const
+{
+    stubMethodEntered("policyApplicationId");
+    return stubReturnValue<QString>("policyApplicationId");
+}
+bool LipstickCompositorWindowStub::delayRemove() const
+{
+    stubMethodEntered("delayRemove");
+    return stubReturnValue<bool>("delayRemove");
+}
+void LipstickCompositorWindowStub::setDelayRemove(bool delay)
+{
+    QList<ParameterBase *> params;
+    params.append(new Parameter<bool>(delay));
+    stubMethodEntered("setDelayRemove", params);
+}
+QString LipstickCompositorWindowStub::title() const
+{
+    stubMethodEntered("title");
+    return stubReturnValue<QString>("title");
+}
+bool LipstickCompositorWindowStub::isInProcess() const
+{
+    stubMethodEntered("isInProcess");
+    return stubReturnValue<bool>("isInProcess");
+}
+bool LipstickCompositorWindowStub::isAlien() const
+{
+    stubMethodEntered("isAlien");
+    return stubReturnValue<bool>("isAlien");
+}
+QRect LipstickCompositorWindowStub::mouseRegionBounds() const
+{
+    stubMethodEntered("mouseRegionBounds");
+    return stubReturnValue<QRect>("mouseRegionBounds");
+}
+bool LipstickCompositorWindowStub::eventFilter(QObject *object, QEvent *event)
+{
+    QList<ParameterBase *> params;
+    params.append(new Parameter<QObject *>(object));
+    params.append(new Parameter<QEvent *>(event));
+    stubMethodEntered("eventFilter", params);
+    return stubReturnValue<bool>("eventFilter");
+}
+void LipstickCompositorWindowStub::terminateProcess(int killTimeout)
+{
+    QList<ParameterBase *> params;
+    params.append(new Parameter<int>(killTimeout));
+    stubMethodEntered("terminateProcess", params);
+}
+bool LipstickCompositorWindowStub::focusOnTouch() const
+{
+    stubMethodEntered("focusOnTouch");
+    return stubReturnValue<bool>("focusOnTouch");
+}
+void LipstickCompositorWindowStub::setFocusOnTouch(bool focusOnTouch)
+{
+    QList<ParameterBase *> params;
+    params.append(new Parameter<bool>(focusOnTouch));
+    stubMethodEntered("setFocusOnTouch", params);
+}
+void LipstickCompositorWindowStub::resize(const QSize &size)
+{
+    QList<ParameterBase *> params;
+    params.append(new Parameter<QSize>(size));
+    stubMethodEntered("resize", params);
+}
+void LipstickCompositorWindowStub::handleTouchCancel()
+{
+    stubMethodEntered("handleTouchCancel");
+}
+void LipstickCompositorWindowStub::killProcess()
+{
+    stubMethodEntered("killProcess");
+}
+
+
+
+// 3. CREATE A STUB INSTANCE
+LipstickCompositorWindowStub gDefaultLipstickCompositorWindowStub;
+LipstickCompositorWindowStub *gLipstickCompositorWindowStub = &gDefaultLipstickCompositorWindowStub;
+
+
+// 4. CREATE A PROXY WHICH CALLS THE STUB
+// The id, process and category are kept by the window, so that several windows can be told apart
+LipstickCompositorWindow::LipstickCompositorWindow(int windowId, const QString &category,
+                                                   QWaylandQuickSurface *surface, QQuickItem *parent)
+    : QWaylandSurfaceItem(surface, parent), m_processId(0), m_windowId(windowId), m_isAlien(false), m_category(category),
+      m_delayRemove(false), m_windowClosed(false), m_removePosted(false), m_mouseRegionValid(false),
+      m_interceptingTouch(false), m_mapped(false),
+      m_focusOnTouch(false)
+{
+    gLipstickCompositorWindowStub->LipstickCompositorWindowConstructor(windowId, category, surface, parent);
+}
+
+LipstickCompositorWindow::~LipstickCompositorWindow()
+{
+    gLipstickCompositorWindowStub->LipstickCompositorWindowDestructor();
+}
+
+QVariant LipstickCompositorWindow::userData() const
+{
+    return gLipstickCompositorWindowStub->userData();
+}
+
+void LipstickCompositorWindow::setUserData(QVariant data)
+{
+    gLipstickCompositorWindowStub->setUserData(data);
+}
+
+int LipstickCompositorWindow::windowId() const
+{
+    return m_windowId;
+}
+
+qint64 LipstickCompositorWindow::processId() const
+{
+    return m_processId;
+}
+
+QString LipstickCompositorWindow::policyApplicationId() const
+{
+    return gLipstickCompositorWindowStub->policyApplicationId();
+}
+
+bool LipstickCompositorWindow::delayRemove() const
+{
+    return gLipstickCompositorWindowStub->delayRemove();
+}
+
+void LipstickCompositorWindow::setDelayRemove(bool delay)
+{
+    gLipstickCompositorWindowStub->setDelayRemove(delay);
+}
+
+QString LipstickCompositorWindow::category() const
+{
+    return m_category;
+}
+
+QString LipstickCompositorWindow::title() const
+{
+    return gLipstickCompositorWindowStub->title();
+}
+
+bool LipstickCompositorWindow::isInProcess() const
+{
+    return gLipstickCompositorWindowStub->isInProcess();
+}
+
+bool LipstickCompositorWindow::isAlien() const
+{
+    return gLipstickCompositorWindowStub->isAlien();
+}
+
+QRect LipstickCompositorWindow::mouseRegionBounds() const
+{
+    return gLipstickCompositorWindowStub->mouseRegionBounds();
+}
+
+bool LipstickCompositorWindow::eventFilter(QObject *object, QEvent *event)
+{
+    return gLipstickCompositorWindowStub->eventFilter(object, event);
+}
+
+void LipstickCompositorWindow::terminateProcess(int killTimeout)
+{
+    gLipstickCompositorWindowStub->terminateProcess(killTimeout);
+}
+
+bool LipstickCompositorWindow::focusOnTouch() const
+{
+    return gLipstickCompositorWindowStub->focusOnTouch();
+}
+
+void LipstickCompositorWindow::setFocusOnTouch(bool focusOnTouch)
+{
+    gLipstickCompositorWindowStub->setFocusOnTouch(focusOnTouch);
+}
+
+void LipstickCompositorWindow::resize(const QSize &size)
+{
+    gLipstickCompositorWindowStub->resize(size);
+}
+
+void LipstickCompositorWindow::itemChange(ItemChange change, const ItemChangeData &data)
+{
+    QWaylandSurfaceItem::itemChange(change, data);
+}
+
+bool LipstickCompositorWindow::event(QEvent *e)
+{
+    return QWaylandSurfaceItem::event(e);
+}
+
+void LipstickCompositorWindow::mousePressEvent(QMouseEvent *event)
+{
+    QWaylandSurfaceItem::mousePressEvent(event);
+}
+
+void LipstickCompositorWindow::mouseMoveEvent(QMouseEvent *event)
+{
+    QWaylandSurfaceItem::mouseMoveEvent(event);
+}
+
+void LipstickCompositorWindow::mouseReleaseEvent(QMouseEvent *event)
+{
+    QWaylandSurfaceItem::mouseReleaseEvent(event);
+}
+
+void LipstickCompositorWindow::wheelEvent(QWheelEvent *event)
+{
+    QWaylandSurfaceItem::wheelEvent(event);
+}
+
+void LipstickCompositorWindow::touchEvent(QTouchEvent *event)
+{
+    QWaylandSurfaceItem::touchEvent(event);
+}
+
+void LipstickCompositorWindow::keyPressEvent(QKeyEvent *event)
+{
+    QWaylandSurfaceItem::keyPressEvent(event);
+}
+
+void LipstickCompositorWindow::keyReleaseEvent(QKeyEvent *event)
+{
+    QWaylandSurfaceItem::keyReleaseEvent(event);
+}
+
+void LipstickCompositorWindow::timerEvent(QTimerEvent *event)
+{
+    QWaylandSurfaceItem::timerEvent(event);
+}
+
+void LipstickCompositorWindow::handleTouchCancel()
+{
+    gLipstickCompositorWindowStub->handleTouchCancel();
+}
+
+void LipstickCompositorWindow::killProcess()
+{
+    gLipstickCompositorWindowStub->killProcess();
+}
+
+
+#endif
@@ -1,20 +1,44 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+          ut_cgroupfreezer \
+          ut_clientaccounting \
           ut_closeeventeater \
+          ut_framecallbackpolicy \
+          ut_framereadback \
+          ut_frametimings \
+          ut_inputlatencyrecorder \
+          ut_keymapupdater \
+          ut_launcherfoldermodel \
+          ut_launchericonindex \
+          ut_launchericonprovider \
           ut_launchermodel \
+          ut_launcherorderstore \
+          ut_launchersearchindex \
           ut_lipsticksettings \
           ut_lipsticknotification \
           ut_notificationfeedbackplayer \
           ut_notificationlistmodel \
           ut_notificationmanager \
           ut_notificationpreviewpresenter \
+          ut_oomscorepolicy \
+          ut_processinfocache \
           ut_qobjectlistmodel \
+          ut_regionhittest \
           ut_screenlock \
+          ut_screenshotburst \
+          ut_screenshotservice \
           ut_shutdownscreen \
+          ut_snapshotpool \
+          ut_texturedownscaler \
           ut_thermalnotifier \
+          ut_touchmotioncompressor \
           ut_touchscreen \
           ut_usbmodeselector \
           ut_volumecontrol \
+          ut_windowocclusion \
+          ut_windowpropertydispatcher \
+          ut_windowregistry \
+          pt_launcherpopulation \
 
 support_files.commands += $$PWD/gen-tests-xml.sh > $$OUT_PWD/tests.xml
 support_files.target = support_files
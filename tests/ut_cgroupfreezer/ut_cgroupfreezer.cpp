@@ -0,0 +1,156 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+#include "cgroupfreezer.h"
+#include "ut_cgroupfreezer.h"
+
+static const QString Group = QStringLiteral("user.slice/lipstick.service/apps");
+static const QString OriginalCgroup = QStringLiteral("/user.slice/app-123.scope");
+
+static QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+static void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+}
+
+void Ut_CgroupFreezer::init()
+{
+    m_dir = new QTemporaryDir;
+    QVERIFY(m_dir->isValid());
+
+    m_cgroupRoot = m_dir->path() + QStringLiteral("/cgroup");
+    m_procRoot = m_dir->path() + QStringLiteral("/proc");
+    QVERIFY(QDir().mkpath(m_cgroupRoot + OriginalCgroup));
+    QVERIFY(QDir().mkpath(m_procRoot));
+
+    addProcess(123, "0::" + OriginalCgroup.toUtf8() + "\n");
+}
+
+void Ut_CgroupFreezer::cleanup()
+{
+    delete m_dir;
+    m_dir = nullptr;
+}
+
+void Ut_CgroupFreezer::addProcess(qint64 processId, const QByteArray &cgroups)
+{
+    const QString path = QStringLiteral("%1/%2").arg(m_procRoot).arg(processId);
+    QVERIFY(QDir().mkpath(path));
+    writeFile(path + QStringLiteral("/cgroup"), cgroups);
+}
+
+void Ut_CgroupFreezer::testProcessCgroup()
+{
+    QCOMPARE(CgroupFreezer::processCgroup(m_procRoot, 123), OriginalCgroup);
+
+    // Hybrid hierarchies list the v1 controllers as well
+    addProcess(200, "12:cpuset:/\n1:name=systemd:/user.slice/app.scope\n0::/user.slice/app.scope\n");
+    QCOMPARE(CgroupFreezer::processCgroup(m_procRoot, 200), QStringLiteral("/user.slice/app.scope"));
+
+    // Only the legacy hierarchy
+    addProcess(300, "1:name=systemd:/user.slice/app.scope\n");
+    QCOMPARE(CgroupFreezer::processCgroup(m_procRoot, 300), QString());
+
+    QCOMPARE(CgroupFreezer::processCgroup(m_procRoot, 400), QString());
+}
+
+void Ut_CgroupFreezer::testFreezeAndThaw()
+{
+    CgroupFreezer freezer(m_cgroupRoot, Group, m_procRoot);
+    QVERIFY(freezer.isAvailable());
+    QCOMPARE(freezer.groupPath(), m_cgroupRoot + QLatin1Char('/') + Group);
+
+    const QString appPath = freezer.groupPath() + QStringLiteral("/app-123");
+
+    QVERIFY(freezer.freeze(123));
+    QVERIFY(QFileInfo(appPath).isDir());
+    QCOMPARE(readFile(appPath + "/cgroup.procs"), QByteArray("123"));
+    QCOMPARE(readFile(appPath + "/cgroup.freeze"), QByteArray("1"));
+    QVERIFY(freezer.isFrozen(123));
+    QVERIFY(freezer.hasFrozen());
+    QCOMPARE(freezer.processes(), QList<qint64>() << 123);
+
+    QVERIFY(freezer.thaw(123));
+    QCOMPARE(readFile(appPath + "/cgroup.freeze"), QByteArray("0"));
+    QVERIFY(!freezer.isFrozen(123));
+    QVERIFY(!freezer.hasFrozen());
+
+    // The process stays in its cgroup in between
+    writeFile(appPath + "/cgroup.procs", QByteArray());
+    QVERIFY(freezer.freeze(123));
+    QCOMPARE(readFile(appPath + "/cgroup.procs"), QByteArray());
+    QCOMPARE(readFile(appPath + "/cgroup.freeze"), QByteArray("1"));
+
+    // Thawing a process that was never frozen does nothing
+    QVERIFY(!freezer.thaw(456));
+}
+
+void Ut_CgroupFreezer::testRelease()
+{
+    CgroupFreezer freezer(m_cgroupRoot, Group, m_procRoot);
+    const QString appPath = freezer.groupPath() + QStringLiteral("/app-123");
+
+    QVERIFY(freezer.freeze(123));
+    freezer.release(123);
+
+    QCOMPARE(readFile(appPath + "/cgroup.freeze"), QByteArray("0"));
+    QCOMPARE(readFile(m_cgroupRoot + OriginalCgroup + "/cgroup.procs"), QByteArray("123"));
+    QVERIFY(!freezer.isFrozen(123));
+    QVERIFY(freezer.processes().isEmpty());
+}
+
+void Ut_CgroupFreezer::testReleaseExitedProcess()
+{
+    CgroupFreezer freezer(m_cgroupRoot, Group, m_procRoot);
+
+    QVERIFY(freezer.freeze(123));
+    QVERIFY(QDir(m_procRoot + QStringLiteral("/123")).removeRecursively());
+    freezer.release(123);
+
+    QVERIFY(!QFile::exists(m_cgroupRoot + OriginalCgroup + "/cgroup.procs"));
+    QVERIFY(freezer.processes().isEmpty());
+}
+
+void Ut_CgroupFreezer::testUnknownProcess()
+{
+    CgroupFreezer freezer(m_cgroupRoot, Group, m_procRoot);
+
+    QVERIFY(!freezer.freeze(999));
+    QVERIFY(!freezer.freeze(0));
+    QVERIFY(!QFileInfo(freezer.groupPath() + QStringLiteral("/app-999")).exists());
+    QVERIFY(!freezer.hasFrozen());
+}
+
+void Ut_CgroupFreezer::testUnavailable()
+{
+    CgroupFreezer missing(m_dir->path() + QStringLiteral("/missing"), Group, m_procRoot);
+    QVERIFY(!missing.isAvailable());
+    QVERIFY(!missing.freeze(123));
+
+    CgroupFreezer noGroup(m_cgroupRoot, QString(), m_procRoot);
+    QVERIFY(!noGroup.isAvailable());
+    QVERIFY(!noGroup.freeze(123));
+}
+
+QTEST_MAIN(Ut_CgroupFreezer)
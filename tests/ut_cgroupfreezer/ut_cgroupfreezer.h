@@ -0,0 +1,45 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_CGROUPFREEZER_H
+#define UT_CGROUPFREEZER_H
+
+#include <QObject>
+#include <QString>
+
+class QTemporaryDir;
+
+class Ut_CgroupFreezer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testProcessCgroup();
+    void testFreezeAndThaw();
+    void testRelease();
+    void testReleaseExitedProcess();
+    void testUnknownProcess();
+    void testUnavailable();
+
+private:
+    void addProcess(qint64 processId, const QByteArray &cgroups);
+
+    QTemporaryDir *m_dir = nullptr;
+    QString m_cgroupRoot;
+    QString m_procRoot;
+};
+
+#endif
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_cgroupfreezer
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_cgroupfreezer.cpp \
+    $$COMPOSITORSRCDIR/cgroupfreezer.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_cgroupfreezer.h \
+    $$COMPOSITORSRCDIR/cgroupfreezer.h
@@ -0,0 +1,188 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QRegion>
+
+#include "clientaccounting.h"
+#include "ut_clientaccounting.h"
+
+void Ut_ClientAccounting::testCounters()
+{
+    ClientAccounting accounting;
+    accounting.setApplicationId(10, QStringLiteral("browser"));
+    accounting.bufferCommitted(10, QSize(100, 50), 0);
+    accounting.bufferCommitted(10, QSize(100, 50), 10);
+    accounting.damaged(10, QRegion(0, 0, 10, 10));
+    accounting.frameCallbackRequested(10);
+    accounting.frameCallbackRequested(10);
+    accounting.frameCallbackSent(10);
+    accounting.frameCallbackThrottled(10);
+    accounting.inputEventDelivered(10);
+    accounting.inputEventDelivered(10);
+    accounting.inputEventDelivered(10);
+    accounting.touchEventDispatched(10, 0);
+    accounting.touchEventDispatched(10, 12, 3);
+    accounting.touchEventDispatched(10, 5, 1);
+
+    const ClientUsage usage = accounting.usage(10, 10);
+    QCOMPARE(usage.applicationId, QStringLiteral("browser"));
+    QCOMPARE(usage.commits, quint64(2));
+    QCOMPARE(usage.bufferBytes, quint64(2 * 100 * 50 * 4));
+    QCOMPARE(usage.damageArea, quint64(100));
+    QCOMPARE(usage.frameCallbacksRequested, quint64(2));
+    QCOMPARE(usage.frameCallbacksSent, quint64(1));
+    QCOMPARE(usage.frameCallbacksThrottled, quint64(1));
+    QCOMPARE(usage.inputEvents, quint64(3));
+    QCOMPARE(usage.touchMotionsCoalesced, quint64(4));
+    QCOMPARE(usage.touchDispatchLatency, quint64(17));
+    QCOMPARE(usage.touchDispatchLatencyMax, quint64(12));
+
+    // Unknown clients cost nothing
+    QCOMPARE(accounting.usage(20, 10).commits, quint64(0));
+    QCOMPARE(accounting.usage(10).commits, quint64(2));
+    QCOMPARE(accounting.usage().count(), 1);
+}
+
+void Ut_ClientAccounting::testCommitRate()
+{
+    ClientAccounting accounting;
+    for (int i = 0; i < 5; ++i)
+        accounting.bufferCommitted(10, QSize(1, 1), 500);
+    for (int i = 0; i < 5; ++i)
+        accounting.bufferCommitted(10, QSize(1, 1), 1500);
+
+    QCOMPARE(accounting.usage(10, 1999).commitRate, 1.0);
+    QCOMPARE(accounting.usage(10, 9999).commitRate, 1.0);
+    // The commits of the first second have left the window
+    QCOMPARE(accounting.usage(10, 10500).commitRate, 0.5);
+    QCOMPARE(accounting.usage(10, 11000).commitRate, 0.0);
+
+    // Buckets are reused after a gap longer than the window
+    accounting.bufferCommitted(10, QSize(1, 1), 25000);
+    QCOMPARE(accounting.usage(10, 25000).commitRate, 0.1);
+    QCOMPARE(accounting.usage(10, 25000).commits, quint64(11));
+
+    // And after a short gap only the skipped seconds are cleared
+    accounting.bufferCommitted(10, QSize(1, 1), 28000);
+    QCOMPARE(accounting.usage(10, 28000).commitRate, 0.2);
+    QCOMPARE(accounting.usage(10, 35500).commitRate, 0.1);
+}
+
+void Ut_ClientAccounting::testRegionArea()
+{
+    QCOMPARE(ClientAccounting::regionArea(QRegion()), quint64(0));
+    QCOMPARE(ClientAccounting::regionArea(QRegion(0, 0, 10, 20)), quint64(200));
+
+    // Overlapping damage is counted once
+    const QRegion region = QRegion(0, 0, 10, 10).united(QRect(5, 5, 10, 10));
+    QCOMPARE(ClientAccounting::regionArea(region), quint64(175));
+}
+
+void Ut_ClientAccounting::testVariantMap()
+{
+    ClientAccounting accounting;
+    accounting.setApplicationId(42, QStringLiteral("camera"));
+    accounting.bufferCommitted(42, QSize(2, 2));
+    accounting.inputEventDelivered(7);
+
+    const QVariantMap map = accounting.toVariantMap();
+    QCOMPARE(map.count(), 2);
+    QVERIFY(map.contains(QStringLiteral("7")));
+
+    const QVariantMap client = map.value(QStringLiteral("42")).toMap();
+    QCOMPARE(client.value(QStringLiteral("applicationId")).toString(), QStringLiteral("camera"));
+    QCOMPARE(client.value(QStringLiteral("commits")).toULongLong(), quint64(1));
+    QCOMPARE(client.value(QStringLiteral("bufferBytes")).toULongLong(), quint64(16));
+    QVERIFY(client.contains(QStringLiteral("commitRate")));
+    QVERIFY(client.contains(QStringLiteral("frameCallbacksThrottled")));
+}
+
+void Ut_ClientAccounting::testLogLinesOrderedByBufferTraffic()
+{
+    ClientAccounting accounting;
+    accounting.setApplicationId(20, QStringLiteral("video"));
+    accounting.bufferCommitted(10, QSize(10, 10));
+    accounting.bufferCommitted(20, QSize(100, 100));
+    accounting.bufferCommitted(30, QSize(50, 50));
+
+    const QStringList lines = accounting.logLines();
+    QCOMPARE(lines.count(), 3);
+    QVERIFY(lines.at(0).startsWith(QStringLiteral("Client 20 (video):")));
+    QVERIFY(lines.at(1).startsWith(QStringLiteral("Client 30 (none):")));
+    QVERIFY(lines.at(2).startsWith(QStringLiteral("Client 10 (none):")));
+}
+
+void Ut_ClientAccounting::testLogLinesOnlyShowActivitySinceLastLog()
+{
+    ClientAccounting accounting;
+    accounting.bufferCommitted(10, QSize(10, 10));
+    accounting.bufferCommitted(10, QSize(10, 10));
+    accounting.bufferCommitted(20, QSize(10, 10));
+    QCOMPARE(accounting.logLines().count(), 2);
+
+    // Nothing happened since
+    QVERIFY(accounting.logLines().isEmpty());
+
+    accounting.bufferCommitted(20, QSize(10, 10));
+    const QStringList lines = accounting.logLines();
+    QCOMPARE(lines.count(), 1);
+    QVERIFY(lines.first().startsWith(QStringLiteral("Client 20 ")));
+    QVERIFY(lines.first().contains(QStringLiteral(", 1 commits,")));
+
+    // The totals are kept
+    QCOMPARE(accounting.usage(10).commits, quint64(2));
+    QCOMPARE(accounting.usage(20).commits, quint64(2));
+}
+
+void Ut_ClientAccounting::testLogLinesLimited()
+{
+    ClientAccounting accounting;
+    for (qint64 processId = 1; processId <= ClientAccounting::LoggedClients + 2; ++processId)
+        accounting.bufferCommitted(processId, QSize(int(processId), 1));
+
+    const QStringList lines = accounting.logLines();
+    QCOMPARE(lines.count(), int(ClientAccounting::LoggedClients));
+    QVERIFY(lines.first().startsWith(QStringLiteral("Client %1 ").arg(ClientAccounting::LoggedClients + 2)));
+    QVERIFY(lines.last().startsWith(QStringLiteral("Client 3 ")));
+}
+
+void Ut_ClientAccounting::testGoneClients()
+{
+    ClientAccounting accounting;
+    QCOMPARE(accounting.logInterval(), 0);
+
+    // Without logging a client is forgotten as soon as it is gone
+    accounting.bufferCommitted(10, QSize(10, 10));
+    accounting.clientGone(10);
+    QVERIFY(accounting.usage().isEmpty());
+
+    // With logging it is kept until its last usage has been logged
+    accounting.setLogInterval(60);
+    QCOMPARE(accounting.logInterval(), 60);
+    accounting.bufferCommitted(10, QSize(10, 10));
+    accounting.clientGone(10);
+    QCOMPARE(accounting.usage().count(), 1);
+    QCOMPARE(accounting.logLines().count(), 1);
+    QVERIFY(accounting.usage().isEmpty());
+
+    // Turning logging off drops the ones left
+    accounting.bufferCommitted(20, QSize(10, 10));
+    accounting.clientGone(20);
+    QCOMPARE(accounting.usage().count(), 1);
+    accounting.setLogInterval(0);
+    QVERIFY(accounting.usage().isEmpty());
+}
+
+QTEST_MAIN(Ut_ClientAccounting)
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_clientaccounting
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_clientaccounting.cpp \
+    $$COMPOSITORSRCDIR/clientaccounting.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_clientaccounting.h \
+    $$COMPOSITORSRCDIR/clientaccounting.h
@@ -0,0 +1,78 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "framecallbackpolicy.h"
+#include "ut_framecallbackpolicy.h"
+
+void Ut_FrameCallbackPolicy::testDefaults()
+{
+    FrameCallbackPolicy policy;
+    QCOMPARE(policy.defaultRate(), 1.0);
+    QCOMPARE(policy.categoryRate("cover"), 1.0);
+    QCOMPARE(policy.displayOffInterval(QString(), true, 0), 1000);
+}
+
+void Ut_FrameCallbackPolicy::testWakeLockRequired()
+{
+    FrameCallbackPolicy policy;
+    QCOMPARE(policy.displayOffInterval(QString(), false, 0), -1);
+    QCOMPARE(policy.displayOffInterval("alarm", false, 0), -1);
+}
+
+void Ut_FrameCallbackPolicy::testCategoryRates()
+{
+    FrameCallbackPolicy policy;
+    policy.setRates(QStringList() << "=0.5" << "alarm=10" << "cover=0");
+
+    QCOMPARE(policy.defaultRate(), 0.5);
+    QCOMPARE(policy.displayOffInterval(QString(), true, 0), 2000);
+    QCOMPARE(policy.displayOffInterval("alarm", true, 0), 100);
+    QCOMPARE(policy.displayOffInterval("cover", true, 0), -1);
+
+    // Setting new rates drops the old ones
+    policy.setRates(QStringList() << "alarm=4");
+    QCOMPARE(policy.defaultRate(), 1.0);
+    QCOMPARE(policy.displayOffInterval("alarm", true, 0), 250);
+    QCOMPARE(policy.displayOffInterval("cover", true, 0), 1000);
+}
+
+void Ut_FrameCallbackPolicy::testInvalidRatesIgnored()
+{
+    FrameCallbackPolicy policy;
+    policy.setRates(QStringList() << "alarm=fast" << "cover" << "dialog=2");
+
+    QCOMPARE(policy.categoryRate("alarm"), 1.0);
+    QCOMPARE(policy.categoryRate("cover"), 1.0);
+    QCOMPARE(policy.categoryRate("dialog"), 2.0);
+}
+
+void Ut_FrameCallbackPolicy::testBackoff()
+{
+    FrameCallbackPolicy policy;
+    policy.setMaximumInterval(10000);
+
+    QCOMPARE(policy.displayOffInterval(QString(), true, 1), 2000);
+    QCOMPARE(policy.displayOffInterval(QString(), true, 2), 4000);
+    QCOMPARE(policy.displayOffInterval(QString(), true, 3), 8000);
+    QCOMPARE(policy.displayOffInterval(QString(), true, 4), 10000);
+    QCOMPARE(policy.displayOffInterval(QString(), true, 1000), 10000);
+
+    // The maximum never makes the interval shorter than the category rate
+    policy.setRates(QStringList() << "=0.05");
+    QCOMPARE(policy.displayOffInterval(QString(), true, 5), 20000);
+}
+
+QTEST_MAIN(Ut_FrameCallbackPolicy)
@@ -0,0 +1,32 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_FRAMECALLBACKPOLICY_H
+#define UT_FRAMECALLBACKPOLICY_H
+
+#include <QObject>
+
+class Ut_FrameCallbackPolicy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testDefaults();
+    void testWakeLockRequired();
+    void testCategoryRates();
+    void testInvalidRatesIgnored();
+    void testBackoff();
+};
+
+#endif
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_framecallbackpolicy
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_framecallbackpolicy.cpp \
+    $$COMPOSITORSRCDIR/framecallbackpolicy.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_framecallbackpolicy.h \
+    $$COMPOSITORSRCDIR/framecallbackpolicy.h
@@ -0,0 +1,306 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+
+#include <string.h>
+
+#include "framereadback.h"
+#include "ut_framereadback.h"
+
+static const QSize FrameSize(256, 128);
+
+static QRgb pixel(const CapturedFrame &frame, int x, int y)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(frame.pixels.constData()) + y * frame.stride() + x * 4;
+    return qRgba(p[0], p[1], p[2], p[3]);
+}
+
+static CapturedFrame solidFrame(const QSize &size, char value)
+{
+    CapturedFrame frame;
+    frame.size = size;
+    frame.pixels.fill(value, frame.stride() * size.height());
+    return frame;
+}
+
+static void paint(CapturedFrame *frame, const QRect &rect, char value)
+{
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        memset(frame->pixels.data() + y * frame->stride() + rect.left() * 4, value, rect.width() * 4);
+    }
+}
+
+void Ut_FrameReadback::initTestCase()
+{
+    m_surface = new QOffscreenSurface;
+    m_surface->create();
+
+    m_context = new QOpenGLContext;
+    if (!m_context->create() || !m_context->makeCurrent(m_surface)) {
+        QSKIP("No OpenGL context available");
+    }
+
+    m_fbo = new QOpenGLFramebufferObject(FrameSize);
+    QVERIFY(m_fbo->bind());
+}
+
+void Ut_FrameReadback::cleanupTestCase()
+{
+    if (m_context && m_context->makeCurrent(m_surface)) {
+        delete m_fbo;
+        m_context->doneCurrent();
+    }
+    delete m_context;
+    delete m_surface;
+}
+
+void Ut_FrameReadback::fill(const QColor &color, const QRect &rect)
+{
+    QOpenGLFunctions *gl = m_context->functions();
+    if (rect.isValid()) {
+        gl->glEnable(GL_SCISSOR_TEST);
+        gl->glScissor(rect.x(), rect.y(), rect.width(), rect.height());
+    }
+    gl->glClearColor(color.redF(), color.greenF(), color.blueF(), color.alphaF());
+    gl->glClear(GL_COLOR_BUFFER_BIT);
+    gl->glDisable(GL_SCISSOR_TEST);
+}
+
+void Ut_FrameReadback::testSynchronousRead()
+{
+    FrameReadback readback(m_context, false);
+    QVERIFY(!readback.isAsynchronous());
+
+    fill(Qt::red);
+    fill(Qt::green, QRect(10, 20, 30, 40));
+
+    const CapturedFramePointer frame = readback.read(QRect(QPoint(0, 0), FrameSize), 42);
+    QVERIFY(frame);
+    QVERIFY(!readback.isPending());
+    QCOMPARE(frame->size, FrameSize);
+    QCOMPARE(frame->time, quint32(42));
+    QCOMPARE(frame->pixels.size(), FrameSize.width() * FrameSize.height() * 4);
+
+    // Rows are bottom up as in OpenGL
+    QCOMPARE(pixel(*frame, 0, 0), qRgba(255, 0, 0, 255));
+    QCOMPARE(pixel(*frame, 10, 20), qRgba(0, 255, 0, 255));
+    QCOMPARE(pixel(*frame, 39, 59), qRgba(0, 255, 0, 255));
+    QCOMPARE(pixel(*frame, 40, 60), qRgba(255, 0, 0, 255));
+}
+
+void Ut_FrameReadback::testRegionRead()
+{
+    FrameReadback readback(m_context, false);
+
+    fill(Qt::red);
+    fill(Qt::green, QRect(10, 20, 30, 40));
+
+    const CapturedFramePointer frame = readback.read(QRect(10, 20, 30, 40), 0);
+    QVERIFY(frame);
+    QCOMPARE(frame->origin, QPoint(10, 20));
+    QCOMPARE(frame->size, QSize(30, 40));
+    QCOMPARE(pixel(*frame, 0, 0), qRgba(0, 255, 0, 255));
+    QCOMPARE(pixel(*frame, 29, 39), qRgba(0, 255, 0, 255));
+}
+
+void Ut_FrameReadback::testAsynchronousRead()
+{
+    FrameReadback readback(m_context);
+    if (!readback.isAsynchronous()) {
+        QSKIP("Context does not support asynchronous readback");
+    }
+
+    fill(Qt::red);
+    QVERIFY(!readback.read(QRect(QPoint(0, 0), FrameSize), 1));
+    QVERIFY(readback.isPending());
+
+    // Drawing the next frame must not affect the one already queued
+    fill(Qt::blue);
+    CapturedFramePointer frame = readback.read(QRect(QPoint(0, 0), FrameSize), 2);
+    QVERIFY(frame);
+    QCOMPARE(frame->time, quint32(1));
+    QCOMPARE(pixel(*frame, 100, 100), qRgba(255, 0, 0, 255));
+
+    fill(Qt::green);
+    frame = readback.finish();
+    QVERIFY(frame);
+    QCOMPARE(frame->time, quint32(2));
+    QCOMPARE(pixel(*frame, 100, 100), qRgba(0, 0, 255, 255));
+
+    QVERIFY(!readback.isPending());
+    QVERIFY(!readback.finish());
+}
+
+void Ut_FrameReadback::testReady()
+{
+    FrameReadback synchronous(m_context, false);
+    QVERIFY(synchronous.isReady());
+
+    FrameReadback readback(m_context);
+    if (!readback.isAsynchronous()) {
+        QSKIP("Context does not support asynchronous readback");
+    }
+    QVERIFY(readback.isReady());
+
+    fill(Qt::red);
+    QVERIFY(!readback.read(QRect(QPoint(0, 0), FrameSize), 1));
+    QVERIFY(readback.isPending());
+
+    // Polling does not complete the read
+    m_context->functions()->glFinish();
+    QVERIFY(readback.isReady());
+    QVERIFY(readback.isReady());
+    QVERIFY(readback.isPending());
+
+    const CapturedFramePointer frame = readback.finish();
+    QVERIFY(frame);
+    QCOMPARE(frame->time, quint32(1));
+    QCOMPARE(pixel(*frame, 100, 100), qRgba(255, 0, 0, 255));
+    QVERIFY(readback.isReady());
+}
+
+void Ut_FrameReadback::testPixelsReused()
+{
+    FrameReadback readback(m_context);
+    if (!readback.isAsynchronous()) {
+        QSKIP("Context does not support asynchronous readback");
+    }
+
+    const QRect rect(QPoint(0, 0), FrameSize);
+    fill(Qt::red);
+    readback.read(rect, 1);
+    fill(Qt::green);
+    CapturedFramePointer first = readback.read(rect, 2);
+    QVERIFY(first);
+    const char * const firstPixels = first->pixels.constData();
+    first.clear();
+
+    fill(Qt::blue);
+    const CapturedFramePointer second = readback.read(rect, 3);
+    QVERIFY(second);
+
+    // Released pixels are reused by the next read into the same buffer
+    fill(Qt::white);
+    const CapturedFramePointer third = readback.read(rect, 4);
+    QVERIFY(third);
+    QVERIFY(third->pixels.constData() == firstPixels);
+    QCOMPARE(pixel(*third, 100, 100), qRgba(0, 0, 255, 255));
+
+    // while the pixels of a frame still held are left alone
+    const CapturedFramePointer fourth = readback.finish();
+    QVERIFY(fourth);
+    QVERIFY(fourth->pixels.constData() != second->pixels.constData());
+    QCOMPARE(pixel(*second, 100, 100), qRgba(0, 255, 0, 255));
+    QCOMPARE(pixel(*fourth, 100, 100), qRgba(255, 255, 255, 255));
+}
+
+void Ut_FrameReadback::testDamage()
+{
+    const CapturedFrame previous = solidFrame(QSize(200, 150), 0);
+    QVERIFY(FrameReadback::damage(previous, previous).isEmpty());
+
+    // Changes within one tile damage the whole tile
+    CapturedFrame current = previous;
+    paint(&current, QRect(70, 10, 2, 2), 1);
+    QCOMPARE(FrameReadback::damage(previous, current), QVector<QRect>() << QRect(64, 0, 64, 64));
+
+    // Adjacent tiles are merged horizontally and vertically
+    current = previous;
+    paint(&current, QRect(10, 10, 70, 70), 1);
+    QCOMPARE(FrameReadback::damage(previous, current), QVector<QRect>() << QRect(0, 0, 128, 128));
+
+    // Edge tiles are clipped to the frame
+    current = previous;
+    paint(&current, QRect(199, 149, 1, 1), 1);
+    QCOMPARE(FrameReadback::damage(previous, current), QVector<QRect>() << QRect(192, 128, 8, 22));
+
+    // Separate regions stay separate
+    current = previous;
+    paint(&current, QRect(0, 0, 1, 1), 1);
+    paint(&current, QRect(199, 0, 1, 1), 1);
+    QCOMPARE(FrameReadback::damage(previous, current).count(), 2);
+}
+
+void Ut_FrameReadback::testDamageSizeChange()
+{
+    const CapturedFrame previous = solidFrame(QSize(100, 100), 0);
+    const CapturedFrame current = solidFrame(QSize(100, 50), 0);
+    QCOMPARE(FrameReadback::damage(previous, current), QVector<QRect>() << QRect(0, 0, 100, 50));
+}
+
+void Ut_FrameReadback::testExtract()
+{
+    QSharedPointer<CapturedFrame> frame(new CapturedFrame(solidFrame(QSize(64, 32), 0)));
+    frame->origin = QPoint(16, 8);
+    frame->time = 7;
+    paint(frame.data(), QRect(0, 0, 2, 2), char(0x80));
+
+    // The whole frame at full size is shared rather than copied
+    QCOMPARE(FrameReadback::extract(frame, QRect(0, 0, 100, 100), 1), CapturedFramePointer(frame));
+
+    CapturedFramePointer result = FrameReadback::extract(frame, QRect(16, 8, 4, 4), 1);
+    QCOMPARE(result->origin, QPoint(16, 8));
+    QCOMPARE(result->size, QSize(4, 4));
+    QCOMPARE(result->time, quint32(7));
+    QCOMPARE(pixel(*result, 1, 1), qRgba(0x80, 0x80, 0x80, 0x80));
+    QCOMPARE(pixel(*result, 2, 2), qRgba(0, 0, 0, 0));
+
+    // Each output pixel averages a scale x scale block
+    result = FrameReadback::extract(frame, QRect(16, 8, 64, 32), 2);
+    QCOMPARE(result->origin, QPoint(8, 4));
+    QCOMPARE(result->size, QSize(32, 16));
+    QCOMPARE(pixel(*result, 0, 0), qRgba(0x80, 0x80, 0x80, 0x80));
+    QCOMPARE(pixel(*result, 1, 0), qRgba(0, 0, 0, 0));
+
+    result = FrameReadback::extract(frame, QRect(16, 8, 64, 32), 4);
+    QCOMPARE(result->size, QSize(16, 8));
+    QCOMPARE(pixel(*result, 0, 0), qRgba(0x20, 0x20, 0x20, 0x20));
+
+    // Regions outside the frame are clipped
+    result = FrameReadback::extract(frame, QRect(0, 0, 24, 12), 1);
+    QCOMPARE(result->origin, QPoint(16, 8));
+    QCOMPARE(result->size, QSize(8, 4));
+}
+
+void Ut_FrameReadback::benchmarkRenderThreadTime_data()
+{
+    QTest::addColumn<bool>("asynchronous");
+
+    QTest::newRow("synchronous") << false;
+    QTest::newRow("asynchronous") << true;
+}
+
+void Ut_FrameReadback::benchmarkRenderThreadTime()
+{
+    QFETCH(bool, asynchronous);
+
+    FrameReadback readback(m_context, asynchronous);
+    if (asynchronous && !readback.isAsynchronous()) {
+        QSKIP("Context does not support asynchronous readback");
+    }
+
+    int frame = 0;
+    QBENCHMARK {
+        fill(frame++ % 2 ? Qt::red : Qt::blue);
+        readback.read(QRect(QPoint(0, 0), FrameSize), frame);
+    }
+    readback.finish();
+}
+
+QTEST_MAIN(Ut_FrameReadback)
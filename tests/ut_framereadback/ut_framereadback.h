@@ -0,0 +1,50 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_FRAMEREADBACK_H
+#define UT_FRAMEREADBACK_H
+
+#include <QObject>
+
+class QOffscreenSurface;
+class QOpenGLContext;
+class QOpenGLFramebufferObject;
+
+class Ut_FrameReadback : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testSynchronousRead();
+    void testRegionRead();
+    void testAsynchronousRead();
+    void testReady();
+    void testPixelsReused();
+    void testDamage();
+    void testDamageSizeChange();
+    void testExtract();
+    void benchmarkRenderThreadTime_data();
+    void benchmarkRenderThreadTime();
+
+private:
+    void fill(const QColor &color, const QRect &rect = QRect());
+
+    QOffscreenSurface *m_surface = nullptr;
+    QOpenGLContext *m_context = nullptr;
+    QOpenGLFramebufferObject *m_fbo = nullptr;
+};
+
+#endif
@@ -0,0 +1,15 @@
+include(../common.pri)
+TARGET = ut_framereadback
+QT += gui
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_framereadback.cpp \
+    $$COMPOSITORSRCDIR/framereadback.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_framereadback.h \
+    $$COMPOSITORSRCDIR/framereadback.h
@@ -0,0 +1,144 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "frametimings.h"
+#include "ut_frametimings.h"
+
+static const qint64 Millisecond = 1000000;
+static const qint64 RefreshInterval = 16666667;
+
+static FrameTiming frame(qint64 started, qint64 frameTime, qint64 renderTime = 0)
+{
+    FrameTiming timing;
+    timing.started = started;
+    timing.beforeRendering = started + Millisecond;
+    timing.afterRendering = timing.beforeRendering + renderTime;
+    timing.swapped = started + frameTime;
+    return timing;
+}
+
+void Ut_FrameTimings::testSnapshot()
+{
+    FrameTimingBuffer buffer(4);
+    QCOMPARE(buffer.capacity(), 4);
+    QVERIFY(buffer.snapshot().isEmpty());
+
+    buffer.push(frame(1, 10));
+    buffer.push(frame(2, 10));
+
+    const QVector<FrameTiming> timings = buffer.snapshot();
+    QCOMPARE(timings.count(), 2);
+    QCOMPARE(timings.at(0).started, qint64(1));
+    QCOMPARE(timings.at(1).started, qint64(2));
+}
+
+void Ut_FrameTimings::testWrapAround()
+{
+    // Capacity is rounded up to a power of two
+    FrameTimingBuffer buffer(3);
+    QCOMPARE(buffer.capacity(), 4);
+
+    for (int i = 1; i <= 10; ++i) {
+        buffer.push(frame(i, 10));
+    }
+
+    const QVector<FrameTiming> timings = buffer.snapshot();
+    QCOMPARE(timings.count(), 4);
+    QCOMPARE(timings.first().started, qint64(7));
+    QCOMPARE(timings.last().started, qint64(10));
+}
+
+void Ut_FrameTimings::testReadSince()
+{
+    FrameTimingBuffer buffer(4);
+    quint32 sequence = 0;
+    quint32 lost = 0;
+
+    buffer.push(frame(1, 10));
+    buffer.push(frame(2, 10));
+    QVector<FrameTiming> timings = buffer.readSince(&sequence, &lost);
+    QCOMPARE(timings.count(), 2);
+    QCOMPARE(lost, quint32(0));
+    QCOMPARE(sequence, quint32(2));
+
+    timings = buffer.readSince(&sequence, &lost);
+    QVERIFY(timings.isEmpty());
+
+    for (int i = 3; i <= 8; ++i) {
+        buffer.push(frame(i, 10));
+    }
+    timings = buffer.readSince(&sequence, &lost);
+    QCOMPARE(timings.count(), 4);
+    QCOMPARE(lost, quint32(2));
+    QCOMPARE(timings.first().started, qint64(5));
+    QCOMPARE(sequence, quint32(8));
+}
+
+void Ut_FrameTimings::testPercentiles()
+{
+    QVector<FrameTiming> timings;
+    for (int i = 100; i >= 1; --i) {
+        timings.append(frame(i * 100 * Millisecond, i * Millisecond / 10, i * Millisecond / 20));
+        timings.last().callbacksSent = timings.last().started + i * Millisecond / 10;
+    }
+
+    const FrameTimingSummary summary = FrameTimingSummary::summarize(timings, RefreshInterval);
+    QCOMPARE(summary.frames, 100);
+    QCOMPARE(summary.droppedFrames, 0);
+    QCOMPARE(summary.frameTimeP50, 5.0);
+    QCOMPARE(summary.frameTimeP95, 9.5);
+    QCOMPARE(summary.frameTimeP99, 9.9);
+    QCOMPARE(summary.renderTimeP50, 2.5);
+    QCOMPARE(summary.renderTimeP99, 4.95);
+    QCOMPARE(summary.callbackDelayP95, 9.5);
+
+    const QVariantMap map = summary.toVariantMap();
+    QCOMPARE(map.value("frames").toInt(), 100);
+    QCOMPARE(map.value("frameTimeP50").toDouble(), 5.0);
+}
+
+void Ut_FrameTimings::testDroppedFrames()
+{
+    QVector<FrameTiming> timings;
+    // Waiting for the vertical blank makes on time frames take about one interval
+    timings.append(frame(1, RefreshInterval + Millisecond));
+    // Missed one vertical blank
+    timings.append(frame(100 * Millisecond, 2 * RefreshInterval));
+    // Missed three
+    timings.append(frame(200 * Millisecond, 4 * RefreshInterval + Millisecond));
+
+    const FrameTimingSummary summary = FrameTimingSummary::summarize(timings, RefreshInterval);
+    QCOMPARE(summary.frames, 3);
+    QCOMPARE(summary.droppedFrames, 4);
+}
+
+void Ut_FrameTimings::testIncompleteFramesIgnored()
+{
+    QVector<FrameTiming> timings;
+    timings.append(frame(Millisecond, 10 * Millisecond));
+
+    // Synchronized but never swapped, e.g. because nothing had changed
+    FrameTiming unswapped;
+    unswapped.started = 50 * Millisecond;
+    timings.append(unswapped);
+
+    const FrameTimingSummary summary = FrameTimingSummary::summarize(timings, RefreshInterval);
+    QCOMPARE(summary.frames, 1);
+    QCOMPARE(summary.frameTimeP99, 10.0);
+    QCOMPARE(summary.callbackDelayP50, 0.0);
+}
+
+QTEST_MAIN(Ut_FrameTimings)
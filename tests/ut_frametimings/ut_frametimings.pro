@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_frametimings
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_frametimings.cpp \
+    $$COMPOSITORSRCDIR/frametimings.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_frametimings.h \
+    $$COMPOSITORSRCDIR/frametimings.h
@@ -0,0 +1,332 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QQuickWindow>
+#include <QTemporaryDir>
+
+#include "inputlatencyrecorder.h"
+#include "ut_inputlatencyrecorder.h"
+
+static const qint64 Msec = 1000000;
+// Far enough from zero for event timestamps in milliseconds to look like the monotonic clock
+static const qint64 Boot = 3600 * 1000 * Msec;
+
+static QTouchEvent touchEvent(QEvent::Type type, ulong timestamp)
+{
+    QTouchEvent::TouchPoint point(0);
+    point.setState(type == QEvent::TouchBegin ? Qt::TouchPointPressed
+                   : type == QEvent::TouchEnd ? Qt::TouchPointReleased
+                   : Qt::TouchPointMoved);
+
+    QTouchEvent event(type, nullptr, Qt::NoModifier, point.state(), QList<QTouchEvent::TouchPoint>() << point);
+    event.setTimestamp(timestamp);
+    return event;
+}
+
+static QKeyEvent keyEvent(ulong timestamp)
+{
+    QKeyEvent event(QEvent::KeyPress, Qt::Key_A, Qt::NoModifier);
+    event.setTimestamp(timestamp);
+    return event;
+}
+
+void Ut_InputLatencyRecorder::testHistogramBuckets()
+{
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(LatencyHistogram::bucketBound(0), qint64(250));
+    QCOMPARE(LatencyHistogram::bucketBound(2), qint64(1000));
+    QCOMPARE(LatencyHistogram::bucketBound(LatencyHistogram::BucketCount - 1), qint64(-1));
+
+    histogram.add(0);
+    histogram.add(250000);      // On the bound
+    histogram.add(250001);
+    histogram.add(3 * Msec);
+    histogram.add(10000 * Msec);
+    histogram.add(-5);          // Clock skew counts as no latency
+
+    QCOMPARE(histogram.count(), quint64(6));
+    QCOMPARE(histogram.bucket(0), quint64(3));
+    QCOMPARE(histogram.bucket(1), quint64(1));
+    QCOMPARE(histogram.bucket(4), quint64(1));
+    QCOMPARE(histogram.bucket(LatencyHistogram::BucketCount - 1), quint64(1));
+    QCOMPARE(histogram.maximum(), 10000.0);
+
+    histogram.clear();
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.bucket(0), quint64(0));
+}
+
+void Ut_InputLatencyRecorder::testHistogramPercentiles()
+{
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.percentile(0.5), 0.0);
+
+    for (int i = 0; i < 90; ++i)
+        histogram.add(Msec / 2);
+    for (int i = 0; i < 9; ++i)
+        histogram.add(6 * Msec);
+    histogram.add(20 * Msec);
+
+    QCOMPARE(histogram.percentile(0.50), 0.5);
+    // The upper bound of the bucket of 4 to 8 ms
+    QCOMPARE(histogram.percentile(0.95), 8.0);
+    QCOMPARE(histogram.percentile(0.99), 8.0);
+    // Not beyond the slowest one
+    QCOMPARE(histogram.percentile(1.00), 20.0);
+}
+
+void Ut_InputLatencyRecorder::testStages()
+{
+    InputLatencyRecorder recorder;
+
+    // Read by the kernel 2 ms before the filter saw it
+    const ulong timestamp = ulong(Boot / Msec);
+    const QTouchEvent event = touchEvent(QEvent::TouchBegin, timestamp);
+    recorder.eventFiltered(&event, Boot + 2 * Msec);
+    QCOMPARE(recorder.pendingCount(), 1);
+
+    recorder.eventDispatched(&event, Boot + 3 * Msec);
+    QCOMPARE(recorder.pendingCount(), 1);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::EndToEnd).count(), quint64(0));
+
+    recorder.frameSwapped(Boot + 10 * Msec);
+    QCOMPARE(recorder.pendingCount(), 0);
+
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::KernelToFilter).count(), quint64(1));
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::KernelToFilter).maximum(), 2.0);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::FilterToDispatch).maximum(), 1.0);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::DispatchToSwap).maximum(), 7.0);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::EndToEnd).maximum(), 10.0);
+
+    // Completed events are not completed again by later frames
+    recorder.frameSwapped(Boot + 20 * Msec);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::EndToEnd).count(), quint64(1));
+}
+
+void Ut_InputLatencyRecorder::testEventTimeOnOtherClock()
+{
+    InputLatencyRecorder recorder;
+
+    // Milliseconds since the application started, not the monotonic clock
+    const QTouchEvent event = touchEvent(QEvent::TouchBegin, 1234);
+    recorder.eventFiltered(&event, Boot);
+    recorder.eventDispatched(&event, Boot + Msec);
+    recorder.frameSwapped(Boot + 5 * Msec);
+
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::KernelToFilter).count(), quint64(0));
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::FilterToDispatch).count(), quint64(1));
+    // Measured from the filter instead
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::EndToEnd).maximum(), 5.0);
+}
+
+void Ut_InputLatencyRecorder::testUntracedEvents()
+{
+    InputLatencyRecorder recorder;
+
+    QEvent paint(QEvent::UpdateRequest);
+    recorder.eventFiltered(&paint, Boot);
+    QCOMPARE(recorder.pendingCount(), 0);
+
+    // Events without a timestamp cannot be matched when dispatched
+    const QKeyEvent key = keyEvent(0);
+    recorder.eventFiltered(&key, Boot);
+    QCOMPARE(recorder.pendingCount(), 0);
+
+    // Nor can events that were never filtered
+    const QKeyEvent other = keyEvent(42);
+    recorder.eventDispatched(&other, Boot);
+    recorder.frameSwapped(Boot + Msec);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::EndToEnd).count(), quint64(0));
+}
+
+void Ut_InputLatencyRecorder::testRedeliveredEventsIgnored()
+{
+    InputLatencyRecorder recorder;
+
+    // The window and then its items see the same event
+    const ulong timestamp = ulong(Boot / Msec);
+    const QTouchEvent event = touchEvent(QEvent::TouchUpdate, timestamp);
+    recorder.eventFiltered(&event, Boot + Msec);
+    recorder.eventFiltered(&event, Boot + 2 * Msec);
+    QCOMPARE(recorder.pendingCount(), 1);
+
+    recorder.eventDispatched(&event, Boot + 3 * Msec);
+    // Delivered on after being dispatched
+    recorder.eventFiltered(&event, Boot + 4 * Msec);
+    QCOMPARE(recorder.pendingCount(), 1);
+
+    recorder.frameSwapped(Boot + 5 * Msec);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::FilterToDispatch).maximum(), 2.0);
+}
+
+void Ut_InputLatencyRecorder::testUndispatchedEventsExpire()
+{
+    InputLatencyRecorder recorder;
+
+    for (int i = 0; i < InputLatencyRecorder::MaximumPending + 10; ++i) {
+        const QKeyEvent event = keyEvent(ulong(i + 1));
+        recorder.eventFiltered(&event, Boot + i * Msec);
+    }
+    QCOMPARE(recorder.pendingCount(), int(InputLatencyRecorder::MaximumPending));
+
+    // The oldest ones made way for the newer ones
+    const QKeyEvent oldest = keyEvent(1);
+    recorder.eventDispatched(&oldest, Boot + 100 * Msec);
+    QCOMPARE(recorder.pendingCount(), int(InputLatencyRecorder::MaximumPending));
+
+    // After the timeout every forgotten one is dropped
+    const QKeyEvent late = keyEvent(1000);
+    recorder.eventFiltered(&late, Boot + 2000 * Msec);
+    QCOMPARE(recorder.pendingCount(), 1);
+}
+
+void Ut_InputLatencyRecorder::testDispatchedEventsExpire()
+{
+    InputLatencyRecorder recorder;
+
+    const QKeyEvent event = keyEvent(7);
+    recorder.eventFiltered(&event, Boot);
+    recorder.eventDispatched(&event, Boot + 5 * Msec);
+    QCOMPARE(recorder.pendingCount(), 1);
+
+    // No frame followed, the event is dropped once the next one is traced
+    const QKeyEvent late = keyEvent(2000);
+    recorder.eventFiltered(&late, Boot + 2000 * Msec);
+    QCOMPARE(recorder.pendingCount(), 1);
+
+    // Nor is a frame that comes that late counted for it
+    const QKeyEvent other = keyEvent(3000);
+    recorder.eventFiltered(&other, Boot + 3000 * Msec);
+    recorder.eventDispatched(&other, Boot + 3000 * Msec);
+    recorder.frameSwapped(Boot + 3000 * Msec + InputLatencyRecorder::Timeout * Msec);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::DispatchToSwap).count(), quint64(0));
+    QCOMPARE(recorder.pendingCount(), 0);
+}
+
+void Ut_InputLatencyRecorder::testDispatchedEventsBounded()
+{
+    InputLatencyRecorder recorder;
+
+    // A window that never swaps leaves every dispatched event waiting
+    for (int i = 0; i < InputLatencyRecorder::MaximumPending + 10; ++i) {
+        const QKeyEvent event = keyEvent(ulong(i + 1));
+        recorder.eventFiltered(&event, Boot + i * Msec);
+        recorder.eventDispatched(&event, Boot + i * Msec);
+    }
+    QCOMPARE(recorder.pendingCount(), int(InputLatencyRecorder::MaximumPending));
+
+    // The newest ones are kept
+    recorder.frameSwapped(Boot + 100 * Msec);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::DispatchToSwap).count(),
+             quint64(InputLatencyRecorder::MaximumPending));
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::DispatchToSwap).maximum(),
+             qreal(100 - 10));
+    QCOMPARE(recorder.pendingCount(), 0);
+}
+
+void Ut_InputLatencyRecorder::testSwapBeforeDispatch()
+{
+    InputLatencyRecorder recorder;
+
+    const QKeyEvent event = keyEvent(7);
+    recorder.eventFiltered(&event, Boot);
+    recorder.eventDispatched(&event, Boot + 5 * Msec);
+
+    // A swap timed before the dispatch does not show the event
+    recorder.frameSwapped(Boot + 4 * Msec);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::DispatchToSwap).count(), quint64(0));
+
+    recorder.frameSwapped(Boot + 6 * Msec);
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::DispatchToSwap).count(), quint64(1));
+}
+
+void Ut_InputLatencyRecorder::testWindowFrameSwapped()
+{
+    InputLatencyRecorder recorder;
+    QQuickWindow window;
+    recorder.setWindow(&window);
+
+    const QTouchEvent event = touchEvent(QEvent::TouchBegin, 99);
+    recorder.eventFiltered(&event);
+    recorder.eventDispatched(&event);
+
+    // Emitted on the render thread normally, the event is completed on the main thread
+    emit window.frameSwapped();
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::EndToEnd).count(), quint64(0));
+    QTRY_COMPARE(recorder.histogram(InputLatencyRecorder::EndToEnd).count(), quint64(1));
+
+    recorder.setWindow(nullptr);
+    const QTouchEvent next = touchEvent(QEvent::TouchEnd, 100);
+    recorder.eventFiltered(&next);
+    recorder.eventDispatched(&next);
+    emit window.frameSwapped();
+    QCoreApplication::processEvents();
+    QCOMPARE(recorder.pendingCount(), 1);
+}
+
+void Ut_InputLatencyRecorder::testTraceFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.path() + QStringLiteral("/input.trace");
+
+    qputenv("LIPSTICK_INPUT_TRACE", QFile::encodeName(fileName));
+    {
+        InputLatencyRecorder recorder;
+        const QKeyEvent event = keyEvent(ulong(Boot / Msec));
+        recorder.eventFiltered(&event, Boot + Msec);
+        recorder.eventDispatched(&event, Boot + 2 * Msec);
+        recorder.frameSwapped(Boot + 3 * Msec);
+    }
+    qunsetenv("LIPSTICK_INPUT_TRACE");
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QStringList lines = QString::fromUtf8(file.readAll()).split(QLatin1Char('\n'), QString::SkipEmptyParts);
+    QCOMPARE(lines.count(), 2);
+    QVERIFY(lines.at(0).startsWith(QLatin1Char('#')));
+    QCOMPARE(lines.at(1), QStringLiteral("%1 %2 %3 %4 %5 %6")
+             .arg(int(QEvent::KeyPress))
+             .arg(Boot / Msec)
+             .arg(Boot)
+             .arg(Boot + Msec)
+             .arg(Boot + 2 * Msec)
+             .arg(Boot + 3 * Msec));
+}
+
+void Ut_InputLatencyRecorder::testVariantMap()
+{
+    InputLatencyRecorder recorder;
+    const QKeyEvent event = keyEvent(5);
+    recorder.eventFiltered(&event, Boot);
+    recorder.eventDispatched(&event, Boot + Msec);
+    recorder.frameSwapped(Boot + 3 * Msec);
+
+    const QVariantMap map = recorder.toVariantMap();
+    QCOMPARE(map.keys(), QStringList() << "dispatchToSwap" << "endToEnd" << "filterToDispatch" << "kernelToFilter");
+
+    const QVariantMap endToEnd = map.value(QStringLiteral("endToEnd")).toMap();
+    QCOMPARE(endToEnd.value(QStringLiteral("count")).toULongLong(), quint64(1));
+    QCOMPARE(endToEnd.value(QStringLiteral("bounds")).toList().count(), int(LatencyHistogram::BucketCount));
+    QCOMPARE(endToEnd.value(QStringLiteral("buckets")).toList().count(), int(LatencyHistogram::BucketCount));
+    QCOMPARE(endToEnd.value(QStringLiteral("maximum")).toReal(), 3.0);
+    QCOMPARE(map.value(QStringLiteral("kernelToFilter")).toMap().value(QStringLiteral("count")).toULongLong(), quint64(0));
+
+    recorder.clear();
+    QCOMPARE(recorder.histogram(InputLatencyRecorder::EndToEnd).count(), quint64(0));
+}
+
+QTEST_MAIN(Ut_InputLatencyRecorder)
@@ -0,0 +1,40 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_INPUTLATENCYRECORDER_H
+#define UT_INPUTLATENCYRECORDER_H
+
+#include <QObject>
+
+class Ut_InputLatencyRecorder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testHistogramBuckets();
+    void testHistogramPercentiles();
+    void testStages();
+    void testEventTimeOnOtherClock();
+    void testUntracedEvents();
+    void testRedeliveredEventsIgnored();
+    void testUndispatchedEventsExpire();
+    void testDispatchedEventsExpire();
+    void testDispatchedEventsBounded();
+    void testSwapBeforeDispatch();
+    void testWindowFrameSwapped();
+    void testTraceFile();
+    void testVariantMap();
+};
+
+#endif
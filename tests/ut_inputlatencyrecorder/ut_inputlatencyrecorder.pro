@@ -0,0 +1,15 @@
+include(../common.pri)
+TARGET = ut_inputlatencyrecorder
+QT += quick
+
+INCLUDEPATH += $$UTILITYSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_inputlatencyrecorder.cpp \
+    $$UTILITYSRCDIR/inputlatencyrecorder.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_inputlatencyrecorder.h \
+    $$UTILITYSRCDIR/inputlatencyrecorder.h
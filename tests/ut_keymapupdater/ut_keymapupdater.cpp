@@ -0,0 +1,152 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "keymapupdater.h"
+#include "lipstickkeymap.h"
+#include "ut_keymapupdater.h"
+
+// Runs the event loop until the updater has applied what was pending
+static void settle(KeymapUpdater *updater)
+{
+    QTRY_VERIFY(!updater->isPending());
+}
+
+void Ut_KeymapUpdater::testKeymapSet()
+{
+    KeymapUpdater updater;
+    QSignalSpy spy(&updater, SIGNAL(keymapApplied()));
+
+    LipstickKeymap keymap;
+    keymap.setLayout("fi");
+    updater.setKeymap(&keymap);
+    QCOMPARE(updater.keymap(), &keymap);
+
+    // Applied once the event loop runs, not right away
+    QVERIFY(updater.isPending());
+    QCOMPARE(spy.count(), 0);
+
+    settle(&updater);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(updater.appliedKeymap().layout(), QString("fi"));
+}
+
+void Ut_KeymapUpdater::testChangesCoalesced()
+{
+    KeymapUpdater updater;
+    LipstickKeymap keymap;
+    updater.setKeymap(&keymap);
+    settle(&updater);
+
+    QSignalSpy spy(&updater, SIGNAL(keymapApplied()));
+    keymap.setRules("evdev");
+    keymap.setModel("jollasbj");
+    keymap.setLayout("us,ru");
+    keymap.setVariant("intl");
+    keymap.setOptions("grp:alt_shift_toggle");
+    QVERIFY(updater.isPending());
+
+    settle(&updater);
+    QCOMPARE(spy.count(), 1);
+
+    const QWaylandKeymap applied = updater.appliedKeymap();
+    QCOMPARE(applied.rules(), QString("evdev"));
+    QCOMPARE(applied.model(), QString("jollasbj"));
+    QCOMPARE(applied.layout(), QString("us,ru"));
+    QCOMPARE(applied.variant(), QString("intl"));
+    QCOMPARE(applied.options(), QString("grp:alt_shift_toggle"));
+}
+
+void Ut_KeymapUpdater::testChangeReverted()
+{
+    KeymapUpdater updater;
+    LipstickKeymap keymap;
+    keymap.setLayout("fi");
+    updater.setKeymap(&keymap);
+    settle(&updater);
+
+    QSignalSpy spy(&updater, SIGNAL(keymapApplied()));
+    keymap.setLayout("de");
+    keymap.setOptions("ctrl:nocaps");
+    keymap.setLayout("fi");
+    keymap.setOptions(QString());
+    QVERIFY(updater.isPending());
+
+    // The keymap in use is not compiled again
+    settle(&updater);
+    QCOMPARE(spy.count(), 0);
+    QCOMPARE(updater.appliedKeymap().layout(), QString("fi"));
+}
+
+void Ut_KeymapUpdater::testEqualKeymapSwapped()
+{
+    KeymapUpdater updater;
+    LipstickKeymap keymap;
+    keymap.setLayout("fi");
+    updater.setKeymap(&keymap);
+    settle(&updater);
+
+    QSignalSpy spy(&updater, SIGNAL(keymapApplied()));
+    LipstickKeymap other;
+    other.setLayout("fi");
+    updater.setKeymap(&other);
+    settle(&updater);
+    QCOMPARE(spy.count(), 0);
+
+    // Only the keymap set is followed
+    keymap.setLayout("de");
+    QVERIFY(!updater.isPending());
+    other.setLayout("de");
+    settle(&updater);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(updater.appliedKeymap().layout(), QString("de"));
+}
+
+void Ut_KeymapUpdater::testKeymapUnset()
+{
+    KeymapUpdater updater;
+    LipstickKeymap keymap;
+    keymap.setLayout("fi");
+    updater.setKeymap(&keymap);
+    settle(&updater);
+
+    QSignalSpy spy(&updater, SIGNAL(keymapApplied()));
+    updater.setKeymap(nullptr);
+    settle(&updater);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(updater.appliedKeymap().layout(), QWaylandKeymap().layout());
+}
+
+void Ut_KeymapUpdater::testUpdateNow()
+{
+    KeymapUpdater updater;
+    QSignalSpy spy(&updater, SIGNAL(keymapApplied()));
+
+    LipstickKeymap keymap;
+    keymap.setLayout("fi");
+    updater.setKeymap(&keymap);
+    keymap.setVariant("nodeadkeys");
+
+    updater.update();
+    QVERIFY(!updater.isPending());
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(updater.appliedKeymap().variant(), QString("nodeadkeys"));
+
+    // Nothing is left to apply when the event loop runs
+    QTest::qWait(10);
+    QCOMPARE(spy.count(), 1);
+}
+
+QTEST_MAIN(Ut_KeymapUpdater)
@@ -0,0 +1,18 @@
+include(../common.pri)
+TARGET = ut_keymapupdater
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+QT += compositor
+
+# unit test and unit
+SOURCES += \
+    ut_keymapupdater.cpp \
+    $$COMPOSITORSRCDIR/keymapupdater.cpp \
+    $$COMPOSITORSRCDIR/lipstickkeymap.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_keymapupdater.h \
+    $$COMPOSITORSRCDIR/keymapupdater.h \
+    $$COMPOSITORSRCDIR/lipstickkeymap.h
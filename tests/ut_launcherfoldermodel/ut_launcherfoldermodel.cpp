@@ -0,0 +1,318 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+#include "launcherfoldermodel.h"
+#include "launcheritem.h"
+#include "launchermodel.h"
+#include "ut_launcherfoldermodel.h"
+
+class TestFolderModel : public LauncherFolderModel
+{
+public:
+    TestFolderModel()
+        : LauncherFolderModel(DeferInitialization)
+    {
+    }
+
+    using LauncherFolderModel::initialize;
+};
+
+static LauncherItem *findItem(LauncherFolderItem *folder, const QString &name)
+{
+    for (int i = 0; i < folder->itemCount(); ++i) {
+        LauncherItem *item = qobject_cast<LauncherItem *>(folder->get(i));
+        if (item && item->filename() == name + QLatin1String(".desktop"))
+            return item;
+    }
+    return 0;
+}
+
+static LauncherFolderItem *findFolder(LauncherFolderItem *folder, const QString &title)
+{
+    for (int i = 0; i < folder->itemCount(); ++i) {
+        LauncherFolderItem *subFolder = qobject_cast<LauncherFolderItem *>(folder->get(i));
+        if (subFolder && subFolder->title() == title)
+            return subFolder;
+    }
+    return 0;
+}
+
+static QString itemName(LauncherFolderItem *folder, int index)
+{
+    if (LauncherItem *item = qobject_cast<LauncherItem *>(folder->get(index)))
+        return item->filename();
+    if (LauncherFolderItem *subFolder = qobject_cast<LauncherFolderItem *>(folder->get(index)))
+        return QLatin1Char('[') + subFolder->title() + QLatin1Char(']');
+    return QString();
+}
+
+void Ut_LauncherFolderModel::initTestCase()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(tempDir->path() + "/config"));
+    qputenv("XDG_DATA_HOME", QFile::encodeName(tempDir->path() + "/data"));
+
+    applicationsDir = tempDir->path() + "/applications/";
+    configDir = tempDir->path() + "/config/lipstick/";
+    LauncherFolderModel::setConfigDir(configDir);
+}
+
+void Ut_LauncherFolderModel::cleanupTestCase()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+void Ut_LauncherFolderModel::init()
+{
+    QDir(tempDir->path() + "/config").removeRecursively();
+    QDir(applicationsDir).removeRecursively();
+    QVERIFY(QDir().mkpath(applicationsDir));
+    QVERIFY(QDir().mkpath(configDir));
+
+    createApplication("app-a");
+    createApplication("app-b");
+    createApplication("app-c");
+}
+
+void Ut_LauncherFolderModel::createApplication(const QString &name)
+{
+    QFile file(applicationsDir + name + ".desktop");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QTextStream stream(&file);
+    stream << "[Desktop Entry]\n"
+           << "Type=Application\n"
+           << "Name=" << name << "\n"
+           << "Icon=" << name << "\n"
+           << "Exec=/usr/bin/" << name << "\n";
+}
+
+void Ut_LauncherFolderModel::writeMenu(const QByteArray &content)
+{
+    QFile file(LauncherFolderModel::configFile());
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(content);
+}
+
+QByteArray Ut_LauncherFolderModel::readMenu()
+{
+    QFile file(LauncherFolderModel::configFile());
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+LauncherFolderModel *Ut_LauncherFolderModel::createModel()
+{
+    TestFolderModel *model = new TestFolderModel;
+    model->setDirectories(QStringList() << applicationsDir);
+    model->initialize();
+    return model;
+}
+
+void Ut_LauncherFolderModel::testImportWithoutMenu()
+{
+    LauncherFolderModel *model = createModel();
+    QCOMPARE(model->itemCount(), 3);
+    QVERIFY(findItem(model, "app-a"));
+    QVERIFY(findItem(model, "app-b"));
+    QVERIFY(findItem(model, "app-c"));
+
+    // Importing is not a change that needs to be saved
+    delete model;
+    QVERIFY(!QFile::exists(LauncherFolderModel::configFile()));
+}
+
+void Ut_LauncherFolderModel::testSaveWritesMenu()
+{
+    LauncherFolderModel *model = createModel();
+    LauncherFolderItem *folder = model->createFolder(model->itemCount(), "Tools");
+    QVERIFY(folder);
+    QVERIFY(model->moveToFolder(findItem(model, "app-a"), folder));
+    model->save();
+
+    // Waits for the background write
+    delete model;
+
+    const QByteArray menu = readMenu();
+    QVERIFY(menu.contains("<Name>Tools</Name>"));
+    QVERIFY(menu.contains("<Filename>app-a.desktop</Filename>"));
+    QVERIFY(menu.contains("<Filename>app-b.desktop</Filename>"));
+    QVERIFY(menu.contains("<Filename>app-c.desktop</Filename>"));
+    QVERIFY(menu.indexOf("<Name>Tools</Name>") < menu.indexOf("<Filename>app-a.desktop</Filename>"));
+
+    // Nothing is left behind by the atomic replace
+    QCOMPARE(QDir(configDir).entryList(QStringList() << "applications.menu*", QDir::Files),
+             QStringList() << "applications.menu");
+}
+
+void Ut_LauncherFolderModel::testLoad()
+{
+    writeMenu("<Menu>\n"
+              "  <Name>Applications</Name>\n"
+              "  <Filename>app-b.desktop</Filename>\n"
+              "  <Menu>\n"
+              "    <Name>Tools</Name>\n"
+              "    <Filename>app-a.desktop</Filename>\n"
+              "    <Filename>app-missing.desktop</Filename>\n"
+              "  </Menu>\n"
+              "</Menu>\n");
+
+    LauncherFolderModel *model = createModel();
+
+    // Entries without an application are skipped and applications not in
+    // the menu are appended
+    QCOMPARE(model->itemCount(), 3);
+    QCOMPARE(itemName(model, 0), QString("app-b.desktop"));
+    QCOMPARE(itemName(model, 1), QString("[Tools]"));
+    QCOMPARE(itemName(model, 2), QString("app-c.desktop"));
+
+    LauncherFolderItem *folder = findFolder(model, "Tools");
+    QVERIFY(folder);
+    QCOMPARE(folder->parentFolder(), static_cast<LauncherFolderItem *>(model));
+    QCOMPARE(folder->itemCount(), 1);
+    QCOMPARE(itemName(folder, 0), QString("app-a.desktop"));
+
+    delete model;
+}
+
+void Ut_LauncherFolderModel::testLoadRoundTrip()
+{
+    LauncherFolderModel *model = createModel();
+    LauncherFolderItem *tools = model->createFolder(model->itemCount(), "Tools");
+    LauncherFolderItem *games = tools->createFolder(0, "Games");
+    QVERIFY(model->moveToFolder(findItem(model, "app-c"), games));
+    QVERIFY(model->moveToFolder(findItem(model, "app-a"), tools));
+    model->save();
+    delete model;
+
+    model = createModel();
+    QCOMPARE(model->itemCount(), 2);
+    QCOMPARE(itemName(model, 0), QString("app-b.desktop"));
+    tools = findFolder(model, "Tools");
+    QVERIFY(tools);
+    QCOMPARE(tools->itemCount(), 2);
+    QCOMPARE(itemName(tools, 0), QString("[Games]"));
+    QCOMPARE(itemName(tools, 1), QString("app-a.desktop"));
+    games = findFolder(tools, "Games");
+    QVERIFY(games);
+    QCOMPARE(games->parentFolder(), tools);
+    QCOMPARE(games->itemCount(), 1);
+    QCOMPARE(itemName(games, 0), QString("app-c.desktop"));
+
+    delete model;
+}
+
+void Ut_LauncherFolderModel::testUnchangedNotRewritten()
+{
+    writeMenu("<Menu>\n"
+              "  <Name>Applications</Name>\n"
+              "  <Filename>app-b.desktop</Filename>\n"
+              "  <Menu>\n"
+              "    <Name>Tools</Name>\n"
+              "    <Filename>app-a.desktop</Filename>\n"
+              "  </Menu>\n"
+              "  <Filename>app-c.desktop</Filename>\n"
+              "</Menu>\n");
+
+    LauncherFolderModel *model = createModel();
+    QCOMPARE(model->itemCount(), 3);
+
+    // The loaded menu counts as saved, so saving it again writes nothing
+    QVERIFY(QFile::remove(LauncherFolderModel::configFile()));
+    model->save();
+    delete model;
+    QVERIFY(!QFile::exists(LauncherFolderModel::configFile()));
+
+    // Neither does saving twice
+    model = createModel();
+    QVERIFY(model->moveToFolder(findItem(model, "app-b"), findFolder(model, "Tools")));
+    model->save();
+    QTRY_VERIFY(QFile::exists(LauncherFolderModel::configFile()));
+    QTRY_VERIFY(readMenu().contains("<Filename>app-b.desktop</Filename>"));
+    QVERIFY(QFile::remove(LauncherFolderModel::configFile()));
+    model->save();
+    delete model;
+    QVERIFY(!QFile::exists(LauncherFolderModel::configFile()));
+}
+
+void Ut_LauncherFolderModel::testRapidChangesMerged()
+{
+    LauncherFolderModel *model = createModel();
+    LauncherFolderItem *folder = model->createFolder(model->itemCount(), "Tools");
+    QVERIFY(model->moveToFolder(findItem(model, "app-a"), folder));
+    QVERIFY(model->moveToFolder(findItem(model, "app-b"), folder));
+    QVERIFY(model->moveToFolder(findItem(folder, "app-b"), model, 0));
+
+    // Changes wait for the save timer
+    QCoreApplication::processEvents();
+    QVERIFY(!QFile::exists(LauncherFolderModel::configFile()));
+
+    // and are not lost when the model goes away before it fires
+    delete model;
+
+    model = createModel();
+    QCOMPARE(itemName(model, 0), QString("app-b.desktop"));
+    folder = findFolder(model, "Tools");
+    QVERIFY(folder);
+    QCOMPARE(folder->itemCount(), 1);
+    QCOMPARE(itemName(folder, 0), QString("app-a.desktop"));
+
+    delete model;
+}
+
+void Ut_LauncherFolderModel::testDirectoryFile()
+{
+    LauncherFolderModel *model = createModel();
+    LauncherFolderItem *folder = model->createFolder(model->itemCount(), "Tools");
+    QVERIFY(model->moveToFolder(findItem(model, "app-a"), folder));
+    folder->setIconId("icon-tools");
+
+    // The name is reserved right away, the content comes with the save
+    const QString directoryFile = folder->directoryFile();
+    QVERIFY(directoryFile.startsWith(configDir));
+    QVERIFY(directoryFile.endsWith(".directory"));
+    QVERIFY(QFile::exists(directoryFile));
+
+    model->save();
+    delete model;
+
+    QFile file(directoryFile);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray content = file.readAll();
+    file.close();
+    QVERIFY(content.contains("[Desktop Entry]"));
+    QVERIFY(content.contains("Icon=icon-tools"));
+    QVERIFY(readMenu().contains("<Directory>" + directoryFile.toUtf8() + "</Directory>"));
+
+    model = createModel();
+    folder = findFolder(model, "Tools");
+    QVERIFY(folder);
+    QCOMPARE(folder->directoryFile(), directoryFile);
+    QCOMPARE(folder->iconId(), QString("icon-tools"));
+
+    // Only folders with a changed icon rewrite their .directory file
+    QVERIFY(QFile::remove(directoryFile));
+    QVERIFY(model->moveToFolder(findItem(model, "app-b"), folder));
+    model->save();
+    delete model;
+    QVERIFY(!QFile::exists(directoryFile));
+    QVERIFY(readMenu().contains("<Filename>app-b.desktop</Filename>"));
+}
+
+QTEST_MAIN(Ut_LauncherFolderModel)
@@ -0,0 +1,52 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_LAUNCHERFOLDERMODEL_H
+#define UT_LAUNCHERFOLDERMODEL_H
+
+#include <QObject>
+#include <QString>
+
+class LauncherFolderModel;
+class QTemporaryDir;
+
+class Ut_LauncherFolderModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void testImportWithoutMenu();
+    void testSaveWritesMenu();
+    void testLoad();
+    void testLoadRoundTrip();
+    void testUnchangedNotRewritten();
+    void testRapidChangesMerged();
+    void testDirectoryFile();
+
+private:
+    void createApplication(const QString &name);
+    void writeMenu(const QByteArray &content);
+    QByteArray readMenu();
+    LauncherFolderModel *createModel();
+
+    QTemporaryDir *tempDir;
+    QString applicationsDir;
+    QString configDir;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "launchericonindex.h"
+#include "ut_launchericonindex.h"
+
+void Ut_LauncherIconIndex::createIcon(const QString &directory, const QString &name)
+{
+    QFile file(directory + name);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+}
+
+void Ut_LauncherIconIndex::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+
+    highPriority = tempDir->path() + QStringLiteral("/high/");
+    lowPriority = tempDir->path() + QStringLiteral("/low/");
+    QDir().mkpath(highPriority);
+    QDir().mkpath(lowPriority);
+}
+
+void Ut_LauncherIconIndex::cleanup()
+{
+    delete tempDir;
+}
+
+void Ut_LauncherIconIndex::testInitialScan()
+{
+    createIcon(lowPriority, "icon-launcher-a.png");
+    createIcon(lowPriority, "org.example.b.png");
+    createIcon(lowPriority, "readme.txt");
+
+    LauncherIconIndex index;
+    index.setDirectories(QStringList() << highPriority << lowPriority);
+
+    QCOMPARE(index.count(), 2);
+    QCOMPARE(index.iconPath("icon-launcher-a"), lowPriority + "icon-launcher-a.png");
+    QCOMPARE(index.iconPath("org.example.b"), lowPriority + "org.example.b.png");
+    QVERIFY(index.iconPath("readme").isEmpty());
+    QVERIFY(index.iconPath("missing").isEmpty());
+}
+
+void Ut_LauncherIconIndex::testDirectoryPriority()
+{
+    createIcon(highPriority, "shared.png");
+    createIcon(lowPriority, "shared.png");
+
+    LauncherIconIndex index;
+    index.setDirectories(QStringList() << highPriority << lowPriority);
+    QCOMPARE(index.iconPath("shared"), highPriority + "shared.png");
+
+    // Removing the preferred file falls back to the next directory
+    QVERIFY(index.removeFile(highPriority + "shared.png"));
+    QCOMPARE(index.iconPath("shared"), lowPriority + "shared.png");
+
+    // Adding it back restores the preferred file
+    QVERIFY(index.addFile(highPriority + "shared.png"));
+    QCOMPARE(index.iconPath("shared"), highPriority + "shared.png");
+}
+
+void Ut_LauncherIconIndex::testAddAndRemoveFiles()
+{
+    LauncherIconIndex index;
+    index.setDirectories(QStringList() << highPriority << lowPriority);
+    QCOMPARE(index.count(), 0);
+
+    QVERIFY(index.addFile(lowPriority + "new.png"));
+    QVERIFY(index.addFile(lowPriority + "new.png"));
+    QCOMPARE(index.count(), 1);
+    QCOMPARE(index.iconPath("new"), lowPriority + "new.png");
+
+    // Files outside of the indexed directories or of other types are ignored
+    QVERIFY(!index.addFile(tempDir->path() + "/other.png"));
+    QVERIFY(!index.addFile(lowPriority + "new.svg"));
+    QCOMPARE(index.count(), 1);
+
+    QVERIFY(index.removeFile(lowPriority + "new.png"));
+    QCOMPARE(index.count(), 0);
+    QVERIFY(index.iconPath("new").isEmpty());
+}
+
+void Ut_LauncherIconIndex::testIconIdForPath()
+{
+    LauncherIconIndex index;
+    index.setDirectories(QStringList() << highPriority);
+
+    QCOMPARE(index.iconIdForPath(highPriority + "org.example.app.png"), QString("org.example.app"));
+    QVERIFY(index.iconIdForPath(lowPriority + "org.example.app.png").isEmpty());
+}
+
+QTEST_MAIN(Ut_LauncherIconIndex)
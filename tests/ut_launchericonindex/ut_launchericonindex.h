@@ -0,0 +1,41 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_LAUNCHERICONINDEX_H
+#define UT_LAUNCHERICONINDEX_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class Ut_LauncherIconIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testInitialScan();
+    void testDirectoryPriority();
+    void testAddAndRemoveFiles();
+    void testIconIdForPath();
+
+private:
+    void createIcon(const QString &directory, const QString &name);
+
+    QTemporaryDir *tempDir;
+    QString highPriority;
+    QString lowPriority;
+};
+
+#endif
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_launchericonindex
+
+INCLUDEPATH += $$COMPONENTSSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_launchericonindex.cpp \
+    $$COMPONENTSSRCDIR/launchericonindex.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_launchericonindex.h \
+    $$COMPONENTSSRCDIR/launchericonindex.h
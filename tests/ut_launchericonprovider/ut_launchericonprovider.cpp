@@ -0,0 +1,169 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QQuickTextureFactory>
+#include <QTemporaryDir>
+
+#include "launchericonprovider.h"
+#include "ut_launchericonprovider.h"
+
+QString Ut_LauncherIconProvider::createIcon(const QString &name, const QSize &size)
+{
+    QImage image(size, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+
+    const QString path = tempDir->path() + QLatin1Char('/') + name;
+    if (!image.save(path, "PNG"))
+        return QString();
+    return path;
+}
+
+QImage Ut_LauncherIconProvider::request(const QString &id, const QSize &size, QString *errorString)
+{
+    LauncherIconProvider provider;
+    QQuickImageResponse *response = provider.requestImageResponse(id, size);
+
+    // Finished is emitted on a decoding thread. Should decoding be done
+    // before the spy is connected, the wait just times out.
+    QSignalSpy finished(response, SIGNAL(finished()));
+    finished.wait(1000);
+
+    QImage image;
+    if (QQuickTextureFactory *factory = response->textureFactory()) {
+        image = factory->image();
+        delete factory;
+    }
+    if (errorString)
+        *errorString = response->errorString();
+    delete response;
+    return image;
+}
+
+void Ut_LauncherIconProvider::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+    LauncherIconProvider::clearCache();
+}
+
+void Ut_LauncherIconProvider::cleanup()
+{
+    delete tempDir;
+    tempDir = nullptr;
+}
+
+void Ut_LauncherIconProvider::testDecode()
+{
+    const QString path = createIcon("icon.png", QSize(86, 86));
+    QVERIFY(!path.isEmpty());
+
+    QString error;
+    const QImage image = request(path.mid(1), QSize(), &error);
+    QCOMPARE(image.size(), QSize(86, 86));
+    QCOMPARE(image.format(), QImage::Format_ARGB32_Premultiplied);
+    QVERIFY(error.isEmpty());
+}
+
+void Ut_LauncherIconProvider::testScaledToRequestedSize()
+{
+    const QString path = createIcon("large.png", QSize(256, 128));
+
+    // Aspect ratio is kept within the requested size
+    QCOMPARE(request(path, QSize(64, 64)).size(), QSize(64, 32));
+}
+
+void Ut_LauncherIconProvider::testNotScaledUp()
+{
+    const QString path = createIcon("small.png", QSize(32, 32));
+    QCOMPARE(request(path, QSize(86, 86)).size(), QSize(32, 32));
+}
+
+void Ut_LauncherIconProvider::testSerialSuffix()
+{
+    const QString path = createIcon("serial.png", QSize(16, 16));
+    QCOMPARE(request(path + "#serial=3", QSize()).size(), QSize(16, 16));
+}
+
+void Ut_LauncherIconProvider::testMissingIcon()
+{
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Failed to decode launcher icon .*"));
+
+    QString error;
+    const QImage image = request(tempDir->path() + "/missing.png", QSize(86, 86), &error);
+    QVERIFY(image.isNull());
+    QVERIFY(error.contains("missing.png"));
+}
+
+void Ut_LauncherIconProvider::testCached()
+{
+    const QString path = createIcon("cached.png", QSize(40, 40));
+    QCOMPARE(request(path, QSize(40, 40)).size(), QSize(40, 40));
+
+    // Served from the cache once decoded
+    QVERIFY(QFile::remove(path));
+    QCOMPARE(request(path, QSize(40, 40)).size(), QSize(40, 40));
+
+    // Other sizes are decoded separately
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Failed to decode launcher icon .*"));
+    QVERIFY(request(path, QSize(20, 20)).isNull());
+
+    LauncherIconProvider::clearCache();
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Failed to decode launcher icon .*"));
+    QVERIFY(request(path, QSize(40, 40)).isNull());
+}
+
+void Ut_LauncherIconProvider::testPreload()
+{
+    const QString path = createIcon("preloaded.png", QSize(50, 50));
+    LauncherIconProvider::preload(path, QSize(50, 50));
+
+    // Requests for an icon being preloaded wait for it, so once answered the file is no longer needed
+    QCOMPARE(request(path, QSize(50, 50)).size(), QSize(50, 50));
+    QVERIFY(QFile::remove(path));
+    QCOMPARE(request(path, QSize(50, 50)).size(), QSize(50, 50));
+}
+
+void Ut_LauncherIconProvider::testPreloadIgnoresThemeIcons()
+{
+    const QString path = createIcon("theme.png", QSize(50, 50));
+
+    // Theme icon names are resolved elsewhere, only file paths are preloaded
+    LauncherIconProvider::preload(path.mid(1), QSize(50, 50));
+    QTest::qWait(50);
+    QVERIFY(QFile::remove(path));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Failed to decode launcher icon .*"));
+    QVERIFY(request(path, QSize(50, 50)).isNull());
+}
+
+void Ut_LauncherIconProvider::testCacheSize()
+{
+    const int defaultSize = LauncherIconProvider::cacheSize();
+    QVERIFY(defaultSize > 0);
+
+    // A 64x64 icon takes 16 kB, which does not fit a cache of 8 kB
+    LauncherIconProvider::setCacheSize(8);
+    QCOMPARE(LauncherIconProvider::cacheSize(), 8);
+
+    const QString path = createIcon("big.png", QSize(64, 64));
+    QCOMPARE(request(path, QSize()).size(), QSize(64, 64));
+    QVERIFY(QFile::remove(path));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Failed to decode launcher icon .*"));
+    QVERIFY(request(path, QSize()).isNull());
+
+    LauncherIconProvider::setCacheSize(defaultSize);
+}
+
+QTEST_MAIN(Ut_LauncherIconProvider)
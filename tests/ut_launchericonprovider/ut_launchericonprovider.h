@@ -0,0 +1,49 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_LAUNCHERICONPROVIDER_H
+#define UT_LAUNCHERICONPROVIDER_H
+
+#include <QImage>
+#include <QObject>
+#include <QSize>
+
+class QTemporaryDir;
+
+class Ut_LauncherIconProvider : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testDecode();
+    void testScaledToRequestedSize();
+    void testNotScaledUp();
+    void testSerialSuffix();
+    void testMissingIcon();
+    void testCached();
+    void testPreload();
+    void testPreloadIgnoresThemeIcons();
+    void testCacheSize();
+
+private:
+    QString createIcon(const QString &name, const QSize &size);
+    QImage request(const QString &id, const QSize &size, QString *errorString = nullptr);
+
+    QTemporaryDir *tempDir;
+};
+
+#endif
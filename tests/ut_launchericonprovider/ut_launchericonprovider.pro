@@ -0,0 +1,15 @@
+include(../common.pri)
+TARGET = ut_launchericonprovider
+QT += quick
+
+INCLUDEPATH += $$COMPONENTSSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_launchericonprovider.cpp \
+    $$COMPONENTSSRCDIR/launchericonprovider.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_launchericonprovider.h \
+    $$COMPONENTSSRCDIR/launchericonprovider.h
@@ -7,7 +7,7 @@ INCLUDEPATH += $$3RDPARTYSRCDIR
 
 QMAKE_CXXFLAGS += `pkg-config --cflags-only-I mlite5`
 
-QT += dbus qml
+QT += dbus qml quick
 
 packagesExist(contentaction5) {
     PKGCONFIG += contentaction5
@@ -23,6 +23,9 @@ SOURCES += \
     $$COMPONENTSSRCDIR/launchermonitor.cpp \
     $$COMPONENTSSRCDIR/launcheritem.cpp \
     $$COMPONENTSSRCDIR/launcherdbus.cpp \
+    $$COMPONENTSSRCDIR/launchericonindex.cpp \
+    $$COMPONENTSSRCDIR/launchericonprovider.cpp \
+    $$COMPONENTSSRCDIR/launcherorderstore.cpp \
     $$STUBSDIR/stubbase.cpp \
     $$UTILITYSRCDIR/qobjectlistmodel.cpp \
     $$SRCDIR/logging.cpp \
@@ -33,6 +36,9 @@ HEADERS += \
     $$COMPONENTSSRCDIR/launchermonitor.h \
     $$COMPONENTSSRCDIR/launcheritem.h \
     $$COMPONENTSSRCDIR/launcherdbus.h \
+    $$COMPONENTSSRCDIR/launchericonindex.h \
+    $$COMPONENTSSRCDIR/launchericonprovider.h \
+    $$COMPONENTSSRCDIR/launcherorderstore.h \
     $$UTILITYSRCDIR/qobjectlistmodel.h \
     $$3RDPARTYSRCDIR/synchronizelists.h \
     $$SRCDIR/logging.h \
@@ -0,0 +1,139 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QSettings>
+
+#include "launcherorderstore.h"
+#include "ut_launcherorderstore.h"
+
+static const QString Group = QStringLiteral("LauncherOrder");
+static const QString AppA = QStringLiteral("/usr/share/applications/a.desktop");
+static const QString AppB = QStringLiteral("/usr/share/applications/b.desktop");
+static const QString AppC = QStringLiteral("/usr/share/applications/c.desktop");
+
+void Ut_LauncherOrderStore::flush()
+{
+    store->waitForWritten();
+    // Deliver the queued write completion and any file watcher notifications
+    QTest::qWait(50);
+}
+
+void Ut_LauncherOrderStore::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+    fileName = tempDir->path() + QStringLiteral("/lipstick.conf");
+
+    store = new LauncherOrderStore(fileName);
+    store->setGroup(Group);
+}
+
+void Ut_LauncherOrderStore::cleanup()
+{
+    delete store;
+    delete tempDir;
+}
+
+void Ut_LauncherOrderStore::testPositionsArePersisted()
+{
+    QVERIFY(store->setPositions(QStringList() << AppA << AppB << AppC));
+    QCOMPARE(store->position(AppB), QVariant(1));
+    flush();
+
+    LauncherOrderStore other(fileName);
+    other.setGroup(Group);
+    QCOMPARE(other.position(AppA), QVariant(0));
+    QCOMPARE(other.position(AppB), QVariant(1));
+    QCOMPARE(other.position(AppC), QVariant(2));
+}
+
+void Ut_LauncherOrderStore::testOnlyMovedEntriesAreWritten()
+{
+    store->setPositions(QStringList() << AppA << AppB << AppC);
+    flush();
+    const QDateTime written = QFileInfo(fileName).lastModified();
+
+    // Unchanged order does not touch the disk
+    QVERIFY(!store->setPositions(QStringList() << AppA << AppB << AppC));
+    flush();
+    QCOMPARE(QFileInfo(fileName).lastModified(), written);
+
+    QVERIFY(store->setPositions(QStringList() << AppB << AppA << AppC));
+    flush();
+
+    QSettings settings(fileName, QSettings::IniFormat);
+    QCOMPARE(settings.value(Group + QLatin1Char('/') + AppA).toInt(), 1);
+    QCOMPARE(settings.value(Group + QLatin1Char('/') + AppB).toInt(), 0);
+    QCOMPARE(settings.value(Group + QLatin1Char('/') + AppC).toInt(), 2);
+}
+
+void Ut_LauncherOrderStore::testRemovedEntriesAreDropped()
+{
+    store->setPositions(QStringList() << AppA << AppB);
+    flush();
+
+    QVERIFY(store->setPositions(QStringList() << AppB));
+    QVERIFY(!store->position(AppA).isValid());
+    flush();
+
+    QSettings settings(fileName, QSettings::IniFormat);
+    QVERIFY(!settings.contains(Group + QLatin1Char('/') + AppA));
+    QCOMPARE(settings.value(Group + QLatin1Char('/') + AppB).toInt(), 0);
+}
+
+void Ut_LauncherOrderStore::testOwnWritesDoNotNotify()
+{
+    QSignalSpy spy(store, SIGNAL(changed()));
+
+    store->setPositions(QStringList() << AppA << AppB);
+    flush();
+    store->setPositions(QStringList() << AppB << AppA);
+    store->setPositions(QStringList() << AppA << AppB << AppC);
+    flush();
+
+    QCOMPARE(spy.count(), 0);
+}
+
+void Ut_LauncherOrderStore::testExternalChangesNotify()
+{
+    store->setPositions(QStringList() << AppA << AppB);
+    flush();
+
+    QSignalSpy spy(store, SIGNAL(changed()));
+    {
+        QSettings settings(fileName, QSettings::IniFormat);
+        settings.setValue(Group + QLatin1Char('/') + AppA, 5);
+    }
+
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(store->position(AppA), QVariant(5));
+}
+
+void Ut_LauncherOrderStore::testGroupsAreSeparate()
+{
+    store->setPositions(QStringList() << AppA << AppB);
+    flush();
+
+    store->setGroup(QStringLiteral("scope/LauncherOrder"));
+    QVERIFY(!store->position(AppA).isValid());
+    store->setPositions(QStringList() << AppB);
+    flush();
+
+    store->setGroup(Group);
+    QCOMPARE(store->position(AppA), QVariant(0));
+    QCOMPARE(store->position(AppB), QVariant(1));
+}
+
+QTEST_MAIN(Ut_LauncherOrderStore)
@@ -0,0 +1,45 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_LAUNCHERORDERSTORE_H
+#define UT_LAUNCHERORDERSTORE_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class LauncherOrderStore;
+
+class Ut_LauncherOrderStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testPositionsArePersisted();
+    void testOnlyMovedEntriesAreWritten();
+    void testRemovedEntriesAreDropped();
+    void testOwnWritesDoNotNotify();
+    void testExternalChangesNotify();
+    void testGroupsAreSeparate();
+
+private:
+    void flush();
+
+    QTemporaryDir *tempDir;
+    QString fileName;
+    LauncherOrderStore *store;
+};
+
+#endif
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_launcherorderstore
+
+INCLUDEPATH += $$COMPONENTSSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_launcherorderstore.cpp \
+    $$COMPONENTSSRCDIR/launcherorderstore.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_launcherorderstore.h \
+    $$COMPONENTSSRCDIR/launcherorderstore.h
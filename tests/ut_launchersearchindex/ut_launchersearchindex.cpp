@@ -0,0 +1,180 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "launchersearchindex.h"
+#include "ut_launchersearchindex.h"
+
+typedef QVector<QObject *> Items;
+
+void Ut_LauncherSearchIndex::addItem(LauncherSearchIndex &index, QObject *item, const QString &title,
+                                     const QString &keywords)
+{
+    QVector<LauncherSearchIndex::Field> fields;
+    fields.append(LauncherSearchIndex::Field(title, 4));
+    for (const QString &keyword : keywords.split(QLatin1Char(';'), QString::SkipEmptyParts)) {
+        fields.append(LauncherSearchIndex::Field(keyword, 2));
+    }
+    QVERIFY(index.update(item, fields));
+}
+
+void Ut_LauncherSearchIndex::testNormalize()
+{
+    QCOMPARE(LauncherSearchIndex::normalize(QString::fromUtf8("Säätiedot")), QStringLiteral("saatiedot"));
+    QCOMPARE(LauncherSearchIndex::normalize(QString::fromUtf8("CAFÉ")), QStringLiteral("cafe"));
+    QCOMPARE(LauncherSearchIndex::normalize(QString::fromUtf8("Ångström")), QStringLiteral("angstrom"));
+}
+
+void Ut_LauncherSearchIndex::testWordPrefix()
+{
+    QObject camera, calendar, clock;
+    LauncherSearchIndex index;
+    addItem(index, &camera, "Camera");
+    addItem(index, &calendar, "Calendar");
+    addItem(index, &clock, "Clock");
+
+    QCOMPARE(index.search("ca"), Items() << &calendar << &camera);
+    QCOMPARE(index.search("CLO"), Items() << &clock);
+    QCOMPARE(index.search(QString::fromUtf8("cälé")), Items() << &calendar);
+    QVERIFY(index.search("x").isEmpty());
+    QVERIFY(index.search(" ").isEmpty());
+}
+
+void Ut_LauncherSearchIndex::testSubstring()
+{
+    QObject settings, weather;
+    LauncherSearchIndex index;
+    addItem(index, &settings, "Settings");
+    addItem(index, &weather, QString::fromUtf8("Sääennuste"));
+
+    QCOMPARE(index.search("ttin"), Items() << &settings);
+    QCOMPARE(index.search("ennus"), Items() << &weather);
+    QVERIFY(index.search("tings x").isEmpty());
+}
+
+void Ut_LauncherSearchIndex::testShortTermsOnlyMatchWordStarts()
+{
+    QObject settings, terminal;
+    LauncherSearchIndex index;
+    addItem(index, &settings, "Settings");
+    addItem(index, &terminal, "Terminal");
+
+    // "te" is inside "settings" but too short for a substring match
+    QCOMPARE(index.search("te"), Items() << &terminal);
+}
+
+void Ut_LauncherSearchIndex::testRanking()
+{
+    QObject mail, messages, email;
+    LauncherSearchIndex index;
+    addItem(index, &mail, "Mail");
+    addItem(index, &messages, "Messages", "sms;mail");
+    addItem(index, &email, "Email client");
+
+    // A title match beats a keyword match, which beats a substring
+    QCOMPARE(index.search("mail"), Items() << &mail << &messages << &email);
+}
+
+void Ut_LauncherSearchIndex::testMultipleTerms()
+{
+    QObject browser, store;
+    LauncherSearchIndex index;
+    addItem(index, &browser, "Web browser", "internet;www");
+    addItem(index, &store, "Store", "apps;internet");
+
+    QCOMPARE(index.search("internet"), Items() << &store << &browser);
+    QCOMPARE(index.search("internet web"), Items() << &browser);
+    QCOMPARE(index.search("web, internet"), Items() << &browser);
+    QVERIFY(index.search("store web").isEmpty());
+}
+
+void Ut_LauncherSearchIndex::testUpdateAndRemove()
+{
+    QObject item;
+    LauncherSearchIndex index;
+    addItem(index, &item, "Notes");
+    QCOMPARE(index.count(), 1);
+
+    // Unchanged fields do not touch the index
+    QVector<LauncherSearchIndex::Field> fields;
+    fields.append(LauncherSearchIndex::Field("Notes", 4));
+    QVERIFY(!index.update(&item, fields));
+
+    fields[0].text = "Memos";
+    QVERIFY(index.update(&item, fields));
+    QVERIFY(index.search("notes").isEmpty());
+    QVERIFY(index.search("ote").isEmpty());
+    QCOMPARE(index.search("memo"), Items() << &item);
+
+    index.remove(&item);
+    QVERIFY(!index.contains(&item));
+    QCOMPARE(index.count(), 0);
+    QVERIFY(index.search("memo").isEmpty());
+}
+
+void Ut_LauncherSearchIndex::testLimit()
+{
+    QObject items[5];
+    LauncherSearchIndex index;
+    for (int i = 0; i < 5; ++i) {
+        addItem(index, &items[i], QStringLiteral("Game %1").arg(i));
+    }
+
+    QCOMPARE(index.search("game").count(), 5);
+    QCOMPARE(index.search("game", 2), Items() << &items[0] << &items[1]);
+    QVERIFY(index.search("game", 0).isEmpty());
+}
+
+void Ut_LauncherSearchIndex::benchmarkSearch_data()
+{
+    QTest::addColumn<QString>("pattern");
+
+    QTest::newRow("prefix") << "ca";
+    QTest::newRow("substring") << "ttin";
+    QTest::newRow("keyword") << "photo";
+    QTest::newRow("two terms") << "se 4";
+    QTest::newRow("no match") << "xyz";
+}
+
+void Ut_LauncherSearchIndex::benchmarkSearch()
+{
+    QFETCH(QString, pattern);
+
+    // A launcher with a lot of applications installed
+    static const int ApplicationCount = 500;
+    static const char * const Titles[] = {
+        "Camera", "Calendar", "Calculator", "Clock", "Contacts", "Settings", "Messages",
+        "Mail", "Maps", "Music", "Notes", "Gallery", "Browser", "Weather", "Terminal",
+        "Documents", "Phone", "Store", "Tasks", "Translator"
+    };
+    static const int TitleCount = sizeof(Titles) / sizeof(Titles[0]);
+
+    QVector<QObject *> items;
+    LauncherSearchIndex index;
+    for (int i = 0; i < ApplicationCount; ++i) {
+        items.append(new QObject(this));
+        addItem(index, items.last(), QStringLiteral("%1 %2").arg(QLatin1String(Titles[i % TitleCount])).arg(i),
+                i % 4 == 0 ? QStringLiteral("photo;picture;image") : QStringLiteral("tool;utility"));
+    }
+
+    QVector<QObject *> result;
+    QBENCHMARK {
+        result = index.search(pattern);
+    }
+
+    qDeleteAll(items);
+}
+
+QTEST_MAIN(Ut_LauncherSearchIndex)
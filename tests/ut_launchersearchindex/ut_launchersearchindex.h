@@ -0,0 +1,43 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_LAUNCHERSEARCHINDEX_H
+#define UT_LAUNCHERSEARCHINDEX_H
+
+#include <QObject>
+
+class LauncherSearchIndex;
+
+class Ut_LauncherSearchIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testNormalize();
+    void testWordPrefix();
+    void testSubstring();
+    void testShortTermsOnlyMatchWordStarts();
+    void testRanking();
+    void testMultipleTerms();
+    void testUpdateAndRemove();
+    void testLimit();
+    void benchmarkSearch_data();
+    void benchmarkSearch();
+
+private:
+    void addItem(LauncherSearchIndex &index, QObject *item, const QString &title,
+                 const QString &keywords = QString());
+};
+
+#endif
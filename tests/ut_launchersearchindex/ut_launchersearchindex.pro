@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_launchersearchindex
+
+INCLUDEPATH += $$COMPONENTSSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_launchersearchindex.cpp \
+    $$COMPONENTSSRCDIR/launchersearchindex.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_launchersearchindex.h \
+    $$COMPONENTSSRCDIR/launchersearchindex.h
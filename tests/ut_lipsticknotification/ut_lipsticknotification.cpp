@@ -68,6 +68,7 @@ void Ut_Notification::testGettersAndSetters()
     QVERIFY(notification.hintValues().contains("x-nemo.testing.custom-hint-value"));
     QVERIFY(!notification.hintValues().contains(LipstickNotification::HINT_CATEGORY));
     QCOMPARE(notification.hintValues().value("x-nemo.testing.custom-hint-value").toDouble(), M_PI);
+    QCOMPARE(notification.clientPid(), 0);
 
     appName = "appName2";
     disambiguatedAppName = "appName2-2-3";
@@ -98,6 +99,7 @@ void Ut_Notification::testGettersAndSetters()
     notification.setActions(actions);
     notification.setHints(hints);
     notification.setExpireTimeout(expireTimeout);
+    notification.setClientPid(1234);
     QCOMPARE(notification.appName(), appName);
     QCOMPARE(notification.disambiguatedAppName(), disambiguatedAppName);
     QCOMPARE(notification.appIcon(), appIcon);
@@ -112,6 +114,7 @@ void Ut_Notification::testGettersAndSetters()
     QCOMPARE(notification.itemCount(), itemCount);
     QCOMPARE(notification.priority(), priority);
     QCOMPARE(notification.category(), category);
+    QCOMPARE(notification.clientPid(), 1234);
 }
 
 void Ut_Notification::testIcon_data()
@@ -1,6 +1,6 @@
 include(../common.pri)
 TARGET = ut_notificationmanager
-INCLUDEPATH += $$NOTIFICATIONSRCDIR
+INCLUDEPATH += $$NOTIFICATIONSRCDIR $$UTILITYSRCDIR
 CONFIG += link_pkgconfig
 QT += sql dbus
 PKGCONFIG += mlite5
@@ -10,6 +10,7 @@ SOURCES += \
     ut_notificationmanager.cpp \
     $$NOTIFICATIONSRCDIR/notificationmanager.cpp \
     $$NOTIFICATIONSRCDIR/lipsticknotification.cpp \
+    $$UTILITYSRCDIR/processinfocache.cpp \
     $$STUBSDIR/stubbase.cpp \
 
 # unit test and unit
@@ -20,6 +21,7 @@ HEADERS += \
     $$NOTIFICATIONSRCDIR/notificationmanageradaptor.h \
     $$NOTIFICATIONSRCDIR/categorydefinitionstore.h \
     $$NOTIFICATIONSRCDIR/androidprioritystore.h \
+    $$UTILITYSRCDIR/processinfocache.h \
     /usr/include/systemsettings/aboutsettings.h
 
 QMAKE_CXXFLAGS += `pkg-config --cflags-only-I systemsettings`
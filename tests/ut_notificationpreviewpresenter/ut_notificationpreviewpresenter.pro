@@ -13,6 +13,7 @@ SOURCES += \
     $$NOTIFICATIONSRCDIR/lipsticknotification.cpp \
     $$SCREENLOCKSRCDIR/screenlock.cpp \
     $$TOUCHSCREENSRCDIR/touchscreen.cpp \
+    $$UTILITYSRCDIR/inputlatencyrecorder.cpp \
     $$STUBSDIR/stubbase.cpp
 
 # unit test and unit
@@ -24,6 +25,7 @@ HEADERS += \
     $$NOTIFICATIONSRCDIR/lipsticknotification.h \
     $$SCREENLOCKSRCDIR/screenlock.h \
     $$TOUCHSCREENSRCDIR/touchscreen.h \
+    $$UTILITYSRCDIR/inputlatencyrecorder.h \
     $$UTILITYSRCDIR/closeeventeater.h \
     $$COMPOSITORSRCDIR/lipstickcompositor.h \
     $$DEVICESTATE/displaystate.h \
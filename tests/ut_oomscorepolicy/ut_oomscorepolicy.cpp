@@ -0,0 +1,165 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "oomscorepolicy.h"
+#include "ut_oomscorepolicy.h"
+
+Q_DECLARE_METATYPE(OomScorePolicy::Pressure)
+
+static OomScorePolicy::Client client(qint64 processId, qint64 lastFocused,
+                                     bool focused = false, bool visible = false,
+                                     const QStringList &categories = QStringList())
+{
+    OomScorePolicy::Client client;
+    client.processId = processId;
+    client.lastFocused = lastFocused;
+    client.focused = focused;
+    client.visible = visible;
+    client.categories = categories;
+    return client;
+}
+
+void Ut_OomScorePolicy::testForegroundAndVisible()
+{
+    OomScorePolicy policy;
+    const QHash<qint64, int> scores = policy.scores(QVector<OomScorePolicy::Client>()
+            << client(10, 1, true)
+            << client(20, 2, false, true)
+            << client(30, 3),
+            OomScorePolicy::NoPressure);
+
+    QCOMPARE(scores.count(), 3);
+    QCOMPARE(scores.value(10), int(OomScorePolicy::ForegroundScore));
+    QCOMPARE(scores.value(20), int(OomScorePolicy::VisibleScore));
+    QCOMPARE(scores.value(30), 200);
+}
+
+void Ut_OomScorePolicy::testRecencyRanking()
+{
+    OomScorePolicy policy;
+    const QHash<qint64, int> scores = policy.scores(QVector<OomScorePolicy::Client>()
+            << client(1, 3)
+            << client(2, 7)
+            << client(4, 0)
+            << client(3, 0)
+            << client(5, 9, true),
+            OomScorePolicy::NoPressure);
+
+    // The focused client does not take a background rank
+    QCOMPARE(scores.value(5), 0);
+    QCOMPARE(scores.value(2), 200);
+    QCOMPARE(scores.value(1), 250);
+    // Never focused clients come last, the older process first
+    QCOMPARE(scores.value(3), 300);
+    QCOMPARE(scores.value(4), 350);
+
+    QCOMPARE(policy.backgroundScore(100, OomScorePolicy::NoPressure), int(OomScorePolicy::MaximumScore));
+}
+
+void Ut_OomScorePolicy::testPressureRaisesBackground()
+{
+    OomScorePolicy policy;
+    const QVector<OomScorePolicy::Client> clients = QVector<OomScorePolicy::Client>()
+            << client(1, 1, true)
+            << client(2, 2, false, true)
+            << client(3, 3)
+            << client(4, 4);
+
+    QHash<qint64, int> scores = policy.scores(clients, OomScorePolicy::SomePressure);
+    QCOMPARE(scores.value(1), 0);
+    QCOMPARE(scores.value(2), 100);
+    QCOMPARE(scores.value(4), 300);
+    QCOMPARE(scores.value(3), 400);
+
+    scores = policy.scores(clients, OomScorePolicy::FullPressure);
+    QCOMPARE(scores.value(1), 0);
+    QCOMPARE(scores.value(2), 100);
+    QCOMPARE(scores.value(4), 500);
+    QCOMPARE(scores.value(3), 600);
+}
+
+void Ut_OomScorePolicy::testCategoryScores()
+{
+    OomScorePolicy policy;
+    QCOMPARE(policy.categoryScore("alarm"), int(OomScorePolicy::MaximumScore));
+
+    policy.setCategoryScores(QStringList() << "alarm=50" << "dialog = -100");
+    QCOMPARE(policy.categoryScore("alarm"), 50);
+    QCOMPARE(policy.categoryScore("dialog"), -100);
+
+    QHash<qint64, int> scores = policy.scores(QVector<OomScorePolicy::Client>()
+            << client(1, 1, true, false, QStringList() << "dialog")
+            << client(2, 2, false, false, QStringList() << "alarm")
+            << client(3, 3, false, false, QStringList() << "cover" << "alarm"),
+            OomScorePolicy::FullPressure);
+    QCOMPARE(scores.value(1), -100);
+    QCOMPARE(scores.value(2), 50);
+    QCOMPARE(scores.value(3), 50);
+
+    // Setting new scores drops the old ones
+    policy.setCategoryScores(QStringList() << "cover=10");
+    QCOMPARE(policy.categoryScore("alarm"), int(OomScorePolicy::MaximumScore));
+    QCOMPARE(policy.categoryScore("cover"), 10);
+}
+
+void Ut_OomScorePolicy::testInvalidCategoryScoresIgnored()
+{
+    OomScorePolicy policy;
+    policy.setCategoryScores(QStringList() << "alarm=high" << "=10" << "cover" << "call=2000" << "dialog=300");
+
+    QCOMPARE(policy.categoryScore("alarm"), int(OomScorePolicy::MaximumScore));
+    QCOMPARE(policy.categoryScore(QString()), int(OomScorePolicy::MaximumScore));
+    QCOMPARE(policy.categoryScore("cover"), int(OomScorePolicy::MaximumScore));
+    QCOMPARE(policy.categoryScore("call"), int(OomScorePolicy::MaximumScore));
+    QCOMPARE(policy.categoryScore("dialog"), 300);
+}
+
+void Ut_OomScorePolicy::testParsePressure_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<OomScorePolicy::Pressure>("pressure");
+
+    QTest::newRow("empty") << QByteArray() << OomScorePolicy::NoPressure;
+    QTest::newRow("idle")
+            << QByteArray("some avg10=0.00 avg60=0.00 avg300=0.00 total=0\n"
+                          "full avg10=0.00 avg60=0.00 avg300=0.00 total=0\n")
+            << OomScorePolicy::NoPressure;
+    QTest::newRow("some")
+            << QByteArray("some avg10=12.50 avg60=3.00 avg300=1.00 total=123456\n"
+                          "full avg10=1.00 avg60=0.50 avg300=0.10 total=2345\n")
+            << OomScorePolicy::SomePressure;
+    QTest::newRow("full")
+            << QByteArray("some avg10=30.00 avg60=10.00 avg300=2.00 total=123456\n"
+                          "full avg10=4.20 avg60=1.00 avg300=0.20 total=23456\n")
+            << OomScorePolicy::FullPressure;
+    QTest::newRow("older averages ignored")
+            << QByteArray("some avg10=1.00 avg60=50.00 avg300=50.00 total=123456\n"
+                          "full avg10=0.00 avg60=20.00 avg300=20.00 total=23456\n")
+            << OomScorePolicy::NoPressure;
+    QTest::newRow("no full line")
+            << QByteArray("some avg10=10.00 avg60=0.00 avg300=0.00 total=100\n")
+            << OomScorePolicy::SomePressure;
+}
+
+void Ut_OomScorePolicy::testParsePressure()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(OomScorePolicy::Pressure, pressure);
+
+    QCOMPARE(OomScorePolicy::parsePressure(data), pressure);
+}
+
+QTEST_MAIN(Ut_OomScorePolicy)
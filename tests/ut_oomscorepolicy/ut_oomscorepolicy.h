@@ -0,0 +1,34 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_OOMSCOREPOLICY_H
+#define UT_OOMSCOREPOLICY_H
+
+#include <QObject>
+
+class Ut_OomScorePolicy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testForegroundAndVisible();
+    void testRecencyRanking();
+    void testPressureRaisesBackground();
+    void testCategoryScores();
+    void testInvalidCategoryScoresIgnored();
+    void testParsePressure_data();
+    void testParsePressure();
+};
+
+#endif
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_oomscorepolicy
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_oomscorepolicy.cpp \
+    $$COMPOSITORSRCDIR/oomscorepolicy.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_oomscorepolicy.h \
+    $$COMPOSITORSRCDIR/oomscorepolicy.h
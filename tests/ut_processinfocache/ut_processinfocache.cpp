@@ -0,0 +1,211 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <unistd.h>
+
+#include "processinfocache.h"
+#include "ut_processinfocache.h"
+
+static void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+}
+
+static QByteArray statLine(qint64 processId, const QByteArray &comm, qint64 startTime)
+{
+    return QByteArray::number(processId) + " (" + comm + ") S 1 123 123 0 -1 4194560 100 0 0 0 1 2 0 0 20 0 1 0 "
+            + QByteArray::number(startTime) + " 1000 200 18446744073709551615 1 1 0 0 0 0 0 4096 0\n";
+}
+
+void Ut_ProcessInfoCache::init()
+{
+    m_dir = new QTemporaryDir;
+    QVERIFY(m_dir->isValid());
+
+    m_procRoot = m_dir->path() + QStringLiteral("/proc");
+    QVERIFY(QDir().mkpath(m_procRoot));
+
+    addProcess(123, 4567, QByteArray("/usr/bin/foo\0--bar\0baz\0", 23));
+}
+
+void Ut_ProcessInfoCache::cleanup()
+{
+    delete m_dir;
+    m_dir = nullptr;
+}
+
+void Ut_ProcessInfoCache::addProcess(qint64 processId, qint64 startTime, const QByteArray &cmdline)
+{
+    const QString path = QStringLiteral("%1/%2").arg(m_procRoot).arg(processId);
+    QVERIFY(QDir().mkpath(path));
+    writeFile(path + QStringLiteral("/stat"), statLine(processId, "foo", startTime));
+    writeFile(path + QStringLiteral("/cmdline"), cmdline);
+    writeFile(path + QStringLiteral("/comm"), "foo\n");
+}
+
+void Ut_ProcessInfoCache::testParseStartTime_data()
+{
+    QTest::addColumn<QByteArray>("stat");
+    QTest::addColumn<qint64>("startTime");
+
+    QTest::newRow("plain") << statLine(1, "foo", 4567) << qint64(4567);
+    QTest::newRow("spaces in comm") << statLine(1, "foo bar baz", 89) << qint64(89);
+    QTest::newRow("parenthesis in comm") << statLine(1, "foo) S 1 2 (", 1234) << qint64(1234);
+    QTest::newRow("truncated") << QByteArray("1 (foo) S 1 123 123") << qint64(-1);
+    QTest::newRow("no comm") << QByteArray("1 foo S") << qint64(-1);
+    QTest::newRow("empty") << QByteArray() << qint64(-1);
+}
+
+void Ut_ProcessInfoCache::testParseStartTime()
+{
+    QFETCH(QByteArray, stat);
+    QFETCH(qint64, startTime);
+
+    QCOMPARE(ProcessInfoCache::parseStartTime(stat), startTime);
+}
+
+void Ut_ProcessInfoCache::testInfo()
+{
+    ProcessInfoCache cache(m_procRoot);
+    const ProcessInfo info = cache.info(123);
+
+    QVERIFY(info.isValid());
+    QCOMPARE(info.processId, qint64(123));
+    QCOMPARE(info.startTime, qint64(4567));
+    QCOMPARE(info.arguments, QStringList() << "/usr/bin/foo" << "--bar" << "baz");
+    QCOMPARE(info.name(), QStringLiteral("foo"));
+    QCOMPARE(info.comm, QStringLiteral("foo"));
+    QVERIFY(info.exe.isEmpty());
+    QCOMPARE(info.directory, m_procRoot + QStringLiteral("/123"));
+    QVERIFY(cache.contains(123));
+}
+
+void Ut_ProcessInfoCache::testUnknownProcess()
+{
+    ProcessInfoCache cache(m_procRoot);
+
+    QVERIFY(!cache.info(456).isValid());
+    QVERIFY(!cache.info(0).isValid());
+    QVERIFY(!cache.info(-1).isValid());
+    QVERIFY(!cache.info(456).isPrivileged());
+    QVERIFY(cache.info(456).name().isEmpty());
+    QVERIFY(!cache.contains(456));
+}
+
+void Ut_ProcessInfoCache::testCachedUntilPidReused()
+{
+    ProcessInfoCache cache(m_procRoot);
+    QCOMPARE(cache.info(123).arguments.count(), 3);
+
+    // The command line is not read again for the same process
+    writeFile(m_procRoot + QStringLiteral("/123/cmdline"), QByteArray("/usr/bin/other\0", 15));
+    QCOMPARE(cache.info(123).name(), QStringLiteral("foo"));
+
+    // But it is for a new process with the same pid
+    addProcess(123, 9999, QByteArray("/usr/bin/other\0", 15));
+    QCOMPARE(cache.info(123).name(), QStringLiteral("other"));
+    QCOMPARE(cache.info(123).startTime, qint64(9999));
+
+    // And a process that is gone is forgotten
+    QVERIFY(QDir(m_procRoot + QStringLiteral("/123")).removeRecursively());
+    QVERIFY(!cache.info(123).isValid());
+    QVERIFY(!cache.contains(123));
+}
+
+void Ut_ProcessInfoCache::testInvalidate()
+{
+    ProcessInfoCache cache(m_procRoot);
+    cache.info(123);
+
+    writeFile(m_procRoot + QStringLiteral("/123/cmdline"), QByteArray("/usr/bin/other\0", 15));
+    cache.invalidate(123);
+    QVERIFY(!cache.contains(123));
+    QCOMPARE(cache.info(123).name(), QStringLiteral("other"));
+
+    // Unknown processes are ignored
+    cache.invalidate(456);
+}
+
+void Ut_ProcessInfoCache::testPrivilegeNotCached()
+{
+    ProcessInfoCache cache(m_procRoot);
+    const QString directory = m_procRoot + QStringLiteral("/123");
+    QVERIFY(cache.info(123).isValid());
+
+    if (geteuid() == 0) {
+        QVERIFY(cache.info(123).isPrivileged());
+
+        // Dropping root is noticed although the process stays cached
+        QCOMPARE(::chown(QFile::encodeName(directory).constData(), 65534, 65534), 0);
+        QVERIFY(cache.contains(123));
+        QVERIFY(!cache.info(123).isPrivileged());
+
+        QCOMPARE(::chown(QFile::encodeName(directory).constData(), 0, 0), 0);
+        QVERIFY(cache.info(123).isPrivileged());
+    }
+
+    // A copy checks the process at the time of the call, not when it was read
+    const ProcessInfo info = cache.info(123);
+    QVERIFY(QDir(directory).removeRecursively());
+    QVERIFY(!info.isPrivileged());
+}
+
+void Ut_ProcessInfoCache::testProcessesByArguments()
+{
+    addProcess(200, 1, QByteArray("/usr/bin/foo\0--qux\0", 19));
+    addProcess(300, 1, QByteArray("/usr/bin/sailfish-browser\0", 26));
+
+    ProcessInfoCache cache(m_procRoot);
+
+    // Only processes the cache has seen are indexed
+    QVERIFY(cache.processes(QStringList() << "/usr/bin/foo").isEmpty());
+
+    cache.info(123);
+    cache.info(200);
+    cache.info(300);
+
+    QList<qint64> processes = cache.processes(QStringList() << "/usr/bin/foo");
+    std::sort(processes.begin(), processes.end());
+    QCOMPARE(processes, QList<qint64>() << 123 << 200);
+    QCOMPARE(cache.processes(QStringList() << "/usr/bin/foo" << "--bar"), QList<qint64>() << 123);
+    QCOMPARE(cache.processes(QStringList() << "/usr/bin/foo" << "--bar" << "baz"), QList<qint64>() << 123);
+    QVERIFY(cache.processes(QStringList() << "/usr/bin/foo" << "--bar" << "baz" << "more").isEmpty());
+    QVERIFY(cache.processes(QStringList() << "foo").isEmpty());
+    QVERIFY(cache.processes(QStringList()).isEmpty());
+
+    cache.invalidate(200);
+    QCOMPARE(cache.processes(QStringList() << "/usr/bin/foo"), QList<qint64>() << 123);
+}
+
+void Ut_ProcessInfoCache::testOwnProcess()
+{
+    ProcessInfoCache cache;
+    const ProcessInfo info = cache.info(QCoreApplication::applicationPid());
+
+    QVERIFY(info.isValid());
+    QCOMPARE(info.name(), QFileInfo(QCoreApplication::applicationFilePath()).fileName());
+    QCOMPARE(info.exe, QCoreApplication::applicationFilePath());
+    QCOMPARE(info.directory, QStringLiteral("/proc/%1").arg(QCoreApplication::applicationPid()));
+    if (geteuid() == 0)
+        QVERIFY(info.isPrivileged());
+    QVERIFY(cache.contains(QCoreApplication::applicationPid()));
+}
+
+QTEST_MAIN(Ut_ProcessInfoCache)
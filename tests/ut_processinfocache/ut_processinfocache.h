@@ -0,0 +1,47 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_PROCESSINFOCACHE_H
+#define UT_PROCESSINFOCACHE_H
+
+#include <QObject>
+#include <QString>
+
+class QTemporaryDir;
+
+class Ut_ProcessInfoCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testParseStartTime_data();
+    void testParseStartTime();
+    void testInfo();
+    void testUnknownProcess();
+    void testCachedUntilPidReused();
+    void testInvalidate();
+    void testPrivilegeNotCached();
+    void testProcessesByArguments();
+    void testOwnProcess();
+
+private:
+    void addProcess(qint64 processId, qint64 startTime, const QByteArray &cmdline);
+
+    QTemporaryDir *m_dir = nullptr;
+    QString m_procRoot;
+};
+
+#endif
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_processinfocache
+
+INCLUDEPATH += $$UTILITYSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_processinfocache.cpp \
+    $$UTILITYSRCDIR/processinfocache.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_processinfocache.h \
+    $$UTILITYSRCDIR/processinfocache.h
@@ -0,0 +1,193 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QRegion>
+
+#include "regionhittest.h"
+#include "ut_regionhittest.h"
+
+// Pseudo random but repeatable
+static quint32 nextRandom(quint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+// A region of the given number of scattered rectangles in a phone sized window
+static QRegion scatteredRegion(int rects, quint32 seed)
+{
+    QRegion region;
+    for (int i = 0; i < rects; ++i) {
+        const int x = int(nextRandom(seed) % 1000);
+        const int y = int(nextRandom(seed) % 1900);
+        region += QRect(x, y, 8 + int(nextRandom(seed) % 80), 8 + int(nextRandom(seed) % 80));
+    }
+    return region;
+}
+
+// Points along a swipe across the window, as touch motion delivers them
+static QVector<QPoint> swipe()
+{
+    QVector<QPoint> points;
+    for (int i = 0; i < 1000; ++i)
+        points.append(QPoint((i * 7) % 1080, (i * 13) % 1920));
+    return points;
+}
+
+void Ut_RegionHitTest::testEmpty()
+{
+    const RegionHitTest empty;
+    QVERIFY(empty.isEmpty());
+    QVERIFY(!empty.contains(QPoint(0, 0)));
+    QCOMPARE(empty.bandCount(), 0);
+
+    const RegionHitTest emptyRegion((QRegion()));
+    QVERIFY(emptyRegion.isEmpty());
+    QVERIFY(!emptyRegion.contains(QPoint(0, 0)));
+}
+
+void Ut_RegionHitTest::testSingleRect()
+{
+    const RegionHitTest hitTest(QRegion(10, 20, 30, 40));
+    QVERIFY(!hitTest.isEmpty());
+    QCOMPARE(hitTest.boundingRect(), QRect(10, 20, 30, 40));
+    QCOMPARE(hitTest.bandCount(), 1);
+    QCOMPARE(hitTest.spanCount(), 1);
+
+    QVERIFY(hitTest.contains(QPoint(10, 20)));
+    QVERIFY(hitTest.contains(QPoint(25, 40)));
+    QVERIFY(!hitTest.contains(QPoint(5, 40)));
+    QVERIFY(!hitTest.contains(QPoint(25, 100)));
+}
+
+void Ut_RegionHitTest::testEdges()
+{
+    // Right and bottom edges are outside, as with QRegion
+    const RegionHitTest hitTest(QRegion(0, 0, 10, 10));
+    QVERIFY(hitTest.contains(QPoint(9, 9)));
+    QVERIFY(!hitTest.contains(QPoint(10, 9)));
+    QVERIFY(!hitTest.contains(QPoint(9, 10)));
+    QVERIFY(!hitTest.contains(QPoint(-1, 0)));
+    QVERIFY(!hitTest.contains(QPoint(0, -1)));
+}
+
+void Ut_RegionHitTest::testBandsJoined()
+{
+    // Two columns of equal height make a single band
+    QRegion region = QRegion(0, 0, 10, 100).united(QRect(50, 0, 10, 100));
+    RegionHitTest hitTest(region);
+    QCOMPARE(hitTest.bandCount(), 1);
+    QCOMPARE(hitTest.spanCount(), 2);
+    QVERIFY(hitTest.contains(QPoint(5, 50)));
+    QVERIFY(!hitTest.contains(QPoint(30, 50)));
+    QVERIFY(hitTest.contains(QPoint(55, 99)));
+
+    // Stacked rectangles of the same width as well
+    hitTest = RegionHitTest(QRegion(0, 0, 10, 10).united(QRect(0, 10, 10, 10)));
+    QCOMPARE(hitTest.bandCount(), 1);
+    QVERIFY(hitTest.contains(QPoint(5, 15)));
+
+    // A gap between them splits the bands
+    hitTest = RegionHitTest(QRegion(0, 0, 10, 10).united(QRect(0, 20, 10, 10)));
+    QCOMPARE(hitTest.bandCount(), 2);
+    QVERIFY(!hitTest.contains(QPoint(5, 15)));
+    QVERIFY(hitTest.contains(QPoint(5, 25)));
+}
+
+void Ut_RegionHitTest::testOverlappingRects()
+{
+    // An L shape with a notch
+    const QRegion region = QRegion(0, 0, 100, 20).united(QRect(0, 0, 20, 100)).subtracted(QRect(5, 5, 5, 5));
+    const RegionHitTest hitTest(region);
+    QVERIFY(hitTest.contains(QPoint(90, 10)));
+    QVERIFY(hitTest.contains(QPoint(10, 90)));
+    QVERIFY(!hitTest.contains(QPoint(50, 50)));
+    QVERIFY(!hitTest.contains(QPoint(7, 7)));
+    QVERIFY(hitTest.contains(QPoint(12, 7)));
+}
+
+void Ut_RegionHitTest::testMatchesRegion_data()
+{
+    QTest::addColumn<int>("rects");
+    QTest::addColumn<quint32>("seed");
+
+    QTest::newRow("4 rects") << 4 << 1u;
+    QTest::newRow("32 rects") << 32 << 2u;
+    QTest::newRow("256 rects") << 256 << 3u;
+}
+
+void Ut_RegionHitTest::testMatchesRegion()
+{
+    QFETCH(int, rects);
+    QFETCH(quint32, seed);
+
+    const QRegion region = scatteredRegion(rects, seed);
+    const RegionHitTest hitTest(region);
+    QCOMPARE(hitTest.boundingRect(), region.boundingRect());
+
+    for (int y = -10; y < 2000; y += 3) {
+        for (int x = -10; x < 1100; x += 3) {
+            const QPoint point(x, y);
+            if (hitTest.contains(point) != region.contains(point))
+                QFAIL(qPrintable(QStringLiteral("Mismatch at %1,%2").arg(x).arg(y)));
+        }
+    }
+}
+
+void Ut_RegionHitTest::benchmarkRegionContains_data()
+{
+    QTest::addColumn<int>("rects");
+
+    QTest::newRow("16 rects") << 16;
+    QTest::newRow("256 rects") << 256;
+    QTest::newRow("1024 rects") << 1024;
+}
+
+void Ut_RegionHitTest::benchmarkRegionContains()
+{
+    QFETCH(int, rects);
+
+    const QRegion region = scatteredRegion(rects, 42);
+    const QVector<QPoint> points = swipe();
+
+    int hits = 0;
+    QBENCHMARK {
+        for (const QPoint &point : points)
+            hits += region.contains(point) ? 1 : 0;
+    }
+    QVERIFY(hits >= 0);
+}
+
+void Ut_RegionHitTest::benchmarkHitTestContains_data()
+{
+    benchmarkRegionContains_data();
+}
+
+void Ut_RegionHitTest::benchmarkHitTestContains()
+{
+    QFETCH(int, rects);
+
+    const RegionHitTest hitTest(scatteredRegion(rects, 42));
+    const QVector<QPoint> points = swipe();
+
+    int hits = 0;
+    QBENCHMARK {
+        for (const QPoint &point : points)
+            hits += hitTest.contains(point) ? 1 : 0;
+    }
+    QVERIFY(hits >= 0);
+}
+
+QTEST_MAIN(Ut_RegionHitTest)
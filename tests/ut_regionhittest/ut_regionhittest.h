@@ -0,0 +1,39 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_REGIONHITTEST_H
+#define UT_REGIONHITTEST_H
+
+#include <QObject>
+
+class Ut_RegionHitTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEmpty();
+    void testSingleRect();
+    void testEdges();
+    void testBandsJoined();
+    void testOverlappingRects();
+    void testMatchesRegion_data();
+    void testMatchesRegion();
+
+    void benchmarkRegionContains_data();
+    void benchmarkRegionContains();
+    void benchmarkHitTestContains_data();
+    void benchmarkHitTestContains();
+};
+
+#endif
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_regionhittest
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_regionhittest.cpp \
+    $$COMPOSITORSRCDIR/regionhittest.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_regionhittest.h \
+    $$COMPOSITORSRCDIR/regionhittest.h
@@ -7,12 +7,14 @@ INCLUDEPATH += $$SCREENLOCKSRCDIR $$UTILITYSRCDIR $$TOUCHSCREENSRCDIR $$SRCDIR/x
 SOURCES += ut_screenlock.cpp \
     $$SCREENLOCKSRCDIR/screenlock.cpp \
     $$TOUCHSCREENSRCDIR/touchscreen.cpp \
+    $$UTILITYSRCDIR/inputlatencyrecorder.cpp \
     $$STUBSDIR/homeapplication.cpp \
     $$STUBSDIR/stubbase.cpp
 
 HEADERS += ut_screenlock.h \
     $$SCREENLOCKSRCDIR/screenlock.h \
     $$TOUCHSCREENSRCDIR/touchscreen.h \
+    $$UTILITYSRCDIR/inputlatencyrecorder.h \
     $$DEVICESTATE/displaystate.h \
     $$SRCDIR/homeapplication.h \
     $$UTILITYSRCDIR/closeeventeater.h
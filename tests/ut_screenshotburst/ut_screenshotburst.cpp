@@ -0,0 +1,237 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QQuickWindow>
+#include <QTemporaryDir>
+
+#include "lipstickcompositor_stub.h"
+#include "ut_screenshotburst.h"
+
+static const QSize FrameSize(4, 2);
+static const int TarBlockSize = 512;
+
+static CapturedFramePointer frame(int index)
+{
+    QSharedPointer<CapturedFrame> frame(new CapturedFrame);
+    frame->size = FrameSize;
+    frame->pixels.fill(char(index * 10), frame->stride() * FrameSize.height());
+    return frame;
+}
+
+// Entry names of a tar archive, which must end with two empty blocks
+static QStringList archiveEntries(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QStringList() << "<not readable>";
+    }
+    const QByteArray archive = file.readAll();
+    if (archive.size() % TarBlockSize != 0) {
+        return QStringList() << "<truncated>";
+    }
+
+    QStringList entries;
+    for (int offset = 0; offset < archive.size();) {
+        const QByteArray header = archive.mid(offset, TarBlockSize);
+        if (header.count('\0') == TarBlockSize) {
+            if (archive.size() - offset != 2 * TarBlockSize
+                    || archive.mid(offset).count('\0') != 2 * TarBlockSize) {
+                entries.append("<no end>");
+            }
+            return entries;
+        }
+
+        const QString name = QString::fromUtf8(header.left(100).constData());
+        bool ok = false;
+        const int size = header.mid(124, 11).toInt(&ok, 8);
+        if (!ok || QImage::fromData(archive.mid(offset + TarBlockSize, size), "PNG").size() != FrameSize) {
+            entries.append("<invalid " + name + ">");
+            return entries;
+        }
+
+        entries.append(name);
+        offset += TarBlockSize + (size + TarBlockSize - 1) / TarBlockSize * TarBlockSize;
+    }
+
+    entries.append("<no end>");
+    return entries;
+}
+
+void Ut_ScreenshotBurst::init()
+{
+    window = new QQuickWindow;
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_ScreenshotBurst::cleanup()
+{
+    delete tempDir;
+    delete window;
+}
+
+ScreenshotBurst *Ut_ScreenshotBurst::createBurst(const QString &path, int count, ScreenshotBurst::Output output)
+{
+    return new ScreenshotBurst(window, path, count, 0, output, ScreenshotOptions(), 0);
+}
+
+// Hands frames over as the render thread does after reading them back
+void Ut_ScreenshotBurst::deliver(ScreenshotBurst *burst, const QList<bool> &frames)
+{
+    QMutexLocker lock(&burst->m_mutex);
+    for (bool ok : frames) {
+        const int index = burst->m_captured++;
+        burst->m_reading.enqueue(index);
+        burst->deliver(ok ? frame(index) : CapturedFramePointer());
+    }
+    burst->m_due = 0;
+}
+
+ScreenshotBurst::Status Ut_ScreenshotBurst::waitForStatus(ScreenshotBurst *burst)
+{
+    QSignalSpy finished(burst, SIGNAL(finished()));
+    QSignalSpy error(burst, SIGNAL(error()));
+
+    QElapsedTimer timer;
+    timer.start();
+    while (finished.isEmpty() && error.isEmpty() && timer.elapsed() < 5000) {
+        QTest::qWait(10);
+    }
+
+    if (!finished.isEmpty()) {
+        return ScreenshotBurst::Finished;
+    } else if (!error.isEmpty()) {
+        return ScreenshotBurst::Error;
+    }
+    return ScreenshotBurst::Capturing;
+}
+
+void Ut_ScreenshotBurst::testFileName()
+{
+    ScreenshotBurst *burst = createBurst(tempDir->path() + "/shot%1.jpg", 2, ScreenshotBurst::Sequence);
+    QCOMPARE(burst->fileName(0), tempDir->path() + "/shot0001.jpg");
+    QCOMPARE(burst->fileName(11), tempDir->path() + "/shot0012.jpg");
+    delete burst;
+
+    burst = createBurst(tempDir->path() + "/shot.webp", 2, ScreenshotBurst::Sequence);
+    QCOMPARE(burst->fileName(1), tempDir->path() + "/shot-0002.webp");
+    delete burst;
+
+    burst = createBurst(tempDir->path() + "/shots.tar", 2, ScreenshotBurst::Archive);
+    QCOMPARE(burst->fileName(0), QString("frame-0001.png"));
+    delete burst;
+}
+
+void Ut_ScreenshotBurst::testSequence()
+{
+    QPointer<ScreenshotBurst> burst = createBurst(tempDir->path() + "/shot%1.png", 3, ScreenshotBurst::Sequence);
+    QCOMPARE(burst->status(), ScreenshotBurst::Capturing);
+    QCOMPARE(burst->count(), 3);
+
+    QSignalSpy written(burst.data(), SIGNAL(frameWritten(int,qreal)));
+    deliver(burst, QList<bool>() << true << true << true);
+    QCOMPARE(waitForStatus(burst), ScreenshotBurst::Finished);
+    QCOMPARE(written.count(), 3);
+
+    for (int i = 1; i <= 3; ++i) {
+        const QImage image(tempDir->path() + QStringLiteral("/shot%1.png").arg(i, 4, 10, QLatin1Char('0')));
+        QCOMPARE(image.size(), FrameSize);
+        QCOMPARE(qRed(image.pixel(0, 0)), (i - 1) * 10);
+    }
+
+    // The burst is done with
+    QTRY_VERIFY(!burst);
+}
+
+void Ut_ScreenshotBurst::testSequenceWithFailedFrame()
+{
+    QPointer<ScreenshotBurst> burst = createBurst(tempDir->path() + "/shot%1.png", 3, ScreenshotBurst::Sequence);
+    QSignalSpy written(burst.data(), SIGNAL(frameWritten(int,qreal)));
+    deliver(burst, QList<bool>() << true << false << true);
+
+    // The rest of the burst is still written
+    QCOMPARE(waitForStatus(burst), ScreenshotBurst::Error);
+    QCOMPARE(written.count(), 2);
+    QCOMPARE(written.at(0).at(0).toInt(), 0);
+    QCOMPARE(written.at(1).at(0).toInt(), 2);
+    QVERIFY(QFile::exists(tempDir->path() + "/shot0001.png"));
+    QVERIFY(!QFile::exists(tempDir->path() + "/shot0002.png"));
+    QVERIFY(QFile::exists(tempDir->path() + "/shot0003.png"));
+}
+
+void Ut_ScreenshotBurst::testArchive()
+{
+    const QString path = tempDir->path() + "/shots.tar";
+    QPointer<ScreenshotBurst> burst = createBurst(path, 3, ScreenshotBurst::Archive);
+    deliver(burst, QList<bool>() << true << true << true);
+    QCOMPARE(waitForStatus(burst), ScreenshotBurst::Finished);
+
+    QCOMPARE(archiveEntries(path), QStringList() << "frame-0001.png" << "frame-0002.png" << "frame-0003.png");
+}
+
+void Ut_ScreenshotBurst::testArchiveWithFailedFrame()
+{
+    const QString path = tempDir->path() + "/shots.tar";
+    QPointer<ScreenshotBurst> burst = createBurst(path, 4, ScreenshotBurst::Archive);
+    QSignalSpy written(burst.data(), SIGNAL(frameWritten(int,qreal)));
+    deliver(burst, QList<bool>() << true << false << true << true);
+
+    // Frames after the failed one are not held back, and the archive is completed
+    QCOMPARE(waitForStatus(burst), ScreenshotBurst::Error);
+    QCOMPARE(written.count(), 3);
+    QCOMPARE(archiveEntries(path), QStringList() << "frame-0001.png" << "frame-0003.png" << "frame-0004.png");
+}
+
+void Ut_ScreenshotBurst::testArchiveNotWritable()
+{
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Screenshot archive could not be opened.*"));
+    QPointer<ScreenshotBurst> burst = createBurst(tempDir->path() + "/missing/shots.tar", 2, ScreenshotBurst::Archive);
+    QCOMPARE(waitForStatus(burst), ScreenshotBurst::Error);
+    QTRY_VERIFY(!burst);
+}
+
+void Ut_ScreenshotBurst::testTimeout()
+{
+    QPointer<ScreenshotBurst> burst = createBurst(tempDir->path() + "/shot%1.png", 3, ScreenshotBurst::Sequence);
+    QCOMPARE(burst->m_timeout.interval(), int(ScreenshotBurst::TimeoutMs));
+    QVERIFY(burst->m_timeout.isActive());
+
+    // The window stops rendering after the first frame
+    QSignalSpy written(burst.data(), SIGNAL(frameWritten(int,qreal)));
+    deliver(burst, QList<bool>() << true);
+    QTRY_COMPARE(written.count(), 1);
+    QCOMPARE(burst->status(), ScreenshotBurst::Capturing);
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Screenshot burst did not complete.*"));
+    burst->m_timeout.start(10);
+    QCOMPARE(waitForStatus(burst), ScreenshotBurst::Error);
+    QTRY_VERIFY(!burst);
+}
+
+void Ut_ScreenshotBurst::testWindowDestroyed()
+{
+    QPointer<ScreenshotBurst> burst = createBurst(tempDir->path() + "/shot%1.png", 3, ScreenshotBurst::Sequence);
+    QSignalSpy error(burst.data(), SIGNAL(error()));
+
+    delete window;
+    window = nullptr;
+    QCOMPARE(error.count(), 1);
+    QCOMPARE(burst->status(), ScreenshotBurst::Error);
+
+    // Cleaning up does not touch the destroyed window
+    QTRY_VERIFY(!burst);
+}
+
+QTEST_MAIN(Ut_ScreenshotBurst)
@@ -0,0 +1,51 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_SCREENSHOTBURST_H
+#define UT_SCREENSHOTBURST_H
+
+#include <QObject>
+
+#include "screenshotburst.h"
+
+class QQuickWindow;
+class QTemporaryDir;
+
+class Ut_ScreenshotBurst : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testFileName();
+    void testSequence();
+    void testSequenceWithFailedFrame();
+    void testArchive();
+    void testArchiveWithFailedFrame();
+    void testArchiveNotWritable();
+    void testTimeout();
+    void testWindowDestroyed();
+
+private:
+    ScreenshotBurst *createBurst(const QString &path, int count, ScreenshotBurst::Output output);
+    void deliver(ScreenshotBurst *burst, const QList<bool> &frames);
+    ScreenshotBurst::Status waitForStatus(ScreenshotBurst *burst);
+
+    QQuickWindow *window;
+    QTemporaryDir *tempDir;
+};
+
+#endif
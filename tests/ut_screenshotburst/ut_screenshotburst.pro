@@ -0,0 +1,23 @@
+include(../common.pri)
+TARGET = ut_screenshotburst
+INCLUDEPATH += $$SRCDIR $$SRCDIR/compositor
+QT += qml quick dbus compositor gui-private
+
+DEFINES += \
+    LIPSTICK_UNIT_TEST_STUB
+
+# unit test and unit
+SOURCES += \
+    ut_screenshotburst.cpp \
+    $$SRCDIR/screenshotburst.cpp \
+    $$SRCDIR/screenshotservice.cpp \
+    $$COMPOSITORSRCDIR/framereadback.cpp \
+    $$STUBSDIR/stubbase.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_screenshotburst.h \
+    $$SRCDIR/screenshotburst.h \
+    $$SRCDIR/screenshotservice.h \
+    $$COMPOSITORSRCDIR/framereadback.h \
+    $$COMPOSITORSRCDIR/lipstickcompositor.h
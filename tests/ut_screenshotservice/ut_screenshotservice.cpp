@@ -0,0 +1,259 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QOpenGLContext>
+#include <QTemporaryDir>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lipstickcompositor_stub.h"
+#include "screenshotburst.h"
+#include "ut_screenshotservice.h"
+
+static const int ResultTimeoutMs = 10000;
+
+// Reports back through the result, which deletes itself after that
+static ScreenshotResult::Status waitForResult(ScreenshotResult *result)
+{
+    QSignalSpy finished(result, SIGNAL(finished()));
+    QSignalSpy error(result, SIGNAL(error()));
+
+    QElapsedTimer timer;
+    timer.start();
+    while (finished.isEmpty() && error.isEmpty() && timer.elapsed() < ResultTimeoutMs) {
+        QTest::qWait(10);
+    }
+
+    // Writers hold on to a duplicate of the result's eventfd until they are deleted
+    QThreadPool::globalInstance()->waitForDone();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    if (!finished.isEmpty()) {
+        return ScreenshotResult::Finished;
+    } else if (!error.isEmpty()) {
+        return ScreenshotResult::Error;
+    }
+    return ScreenshotResult::Writing;
+}
+
+static int openFileDescriptors()
+{
+    return QDir(QStringLiteral("/proc/self/fd")).entryList(
+                QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot).count();
+}
+
+void Ut_ScreenshotService::initTestCase()
+{
+    compositor = new LipstickCompositor;
+    compositor->resize(120, 80);
+    gLipstickCompositorStub->stubSetReturnValue("instance", compositor);
+}
+
+void Ut_ScreenshotService::cleanupTestCase()
+{
+    gLipstickCompositorStub->stubSetReturnValue("instance", static_cast<LipstickCompositor *>(nullptr));
+    delete compositor;
+}
+
+void Ut_ScreenshotService::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_ScreenshotService::cleanup()
+{
+    compositor->hide();
+    delete tempDir;
+}
+
+bool Ut_ScreenshotService::showCompositor()
+{
+    QOpenGLContext context;
+    if (!context.create()) {
+        return false;
+    }
+
+    compositor->show();
+    return QTest::qWaitForWindowExposed(compositor);
+}
+
+void Ut_ScreenshotService::testOptionsFromVariantMap()
+{
+    QVariantMap map;
+    map.insert("format", "JPG");
+    map.insert("quality", 80);
+    map.insert("scale", 2.0);
+    ScreenshotOptions options = ScreenshotOptions::fromVariantMap(map);
+    QCOMPARE(options.format, ScreenshotOptions::Jpeg);
+    QCOMPARE(options.quality, 80);
+    QCOMPARE(options.compression, -1);
+    QCOMPARE(options.scale, 1.0);
+
+    map.clear();
+    map.insert("format", "bmp");
+    map.insert("compression", 9);
+    map.insert("scale", 0.5);
+    QTest::ignoreMessage(QtWarningMsg, "Unknown screenshot format \"bmp\"");
+    options = ScreenshotOptions::fromVariantMap(map);
+    QCOMPARE(options.format, ScreenshotOptions::Automatic);
+    QCOMPARE(options.compression, 9);
+    QCOMPARE(options.scale, 0.5);
+}
+
+void Ut_ScreenshotService::testFormat()
+{
+    ScreenshotOptions options;
+    QCOMPARE(ScreenshotService::format(options, "/tmp/a.JPG"), ScreenshotOptions::Jpeg);
+    QCOMPARE(ScreenshotService::format(options, "/tmp/a.webp"), ScreenshotOptions::WebP);
+    QCOMPARE(ScreenshotService::format(options, "/tmp/a.raw"), ScreenshotOptions::Raw);
+    QCOMPARE(ScreenshotService::format(options, "/tmp/a"), ScreenshotOptions::Png);
+
+    options.format = ScreenshotOptions::Raw;
+    QCOMPARE(ScreenshotService::format(options, "/tmp/a.png"), ScreenshotOptions::Raw);
+}
+
+void Ut_ScreenshotService::testNoCompositor()
+{
+    gLipstickCompositorStub->stubSetReturnValue("instance", static_cast<LipstickCompositor *>(nullptr));
+    QVERIFY(!ScreenshotService::saveScreenshot(tempDir->path() + "/shot.png"));
+    QVERIFY(!ScreenshotService::saveScreenshot(STDOUT_FILENO, ScreenshotOptions()));
+    QVERIFY(!ScreenshotService::captureBurst(tempDir->path() + "/shot%1.png", 2, 0, false));
+    gLipstickCompositorStub->stubSetReturnValue("instance", compositor);
+}
+
+void Ut_ScreenshotService::testEmptyPath()
+{
+    const int descriptors = openFileDescriptors();
+
+    QTest::ignoreMessage(QtWarningMsg, "Screenshot path is empty.");
+    ScreenshotResult *result = ScreenshotService::saveScreenshot(QString());
+    QVERIFY(result);
+    QCOMPARE(result->status(), ScreenshotResult::Writing);
+    QCOMPARE(waitForResult(result), ScreenshotResult::Error);
+
+    QCOMPARE(openFileDescriptors(), descriptors);
+}
+
+void Ut_ScreenshotService::testInvalidFd()
+{
+    const int descriptors = openFileDescriptors();
+
+    // A descriptor number that is not open
+    const int fd = ::dup(STDIN_FILENO);
+    QVERIFY(fd >= 0);
+    ::close(fd);
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Screenshot file descriptor could not be duplicated.*"));
+    ScreenshotResult *result = ScreenshotService::saveScreenshot(fd, ScreenshotOptions());
+    QVERIFY(result);
+    QCOMPARE(waitForResult(result), ScreenshotResult::Error);
+
+    QCOMPARE(openFileDescriptors(), descriptors);
+}
+
+void Ut_ScreenshotService::testNotVisible()
+{
+    QFile file(tempDir->path() + "/shot.png");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    const int descriptors = openFileDescriptors();
+
+    // Nothing can be grabbed from a hidden window, which must not leak the duplicated descriptor
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(".*grabToImage.*"));
+    ScreenshotResult *result = ScreenshotService::saveScreenshot(file.handle(), ScreenshotOptions());
+    QVERIFY(result);
+    QCOMPARE(waitForResult(result), ScreenshotResult::Error);
+
+    QCOMPARE(openFileDescriptors(), descriptors);
+    QCOMPARE(file.size(), qint64(0));
+}
+
+void Ut_ScreenshotService::testSaveToPath()
+{
+    if (!showCompositor()) {
+        QSKIP("The compositor window cannot be rendered");
+    }
+
+    const QString path = tempDir->path() + "/shot.png";
+    ScreenshotResult *result = ScreenshotService::saveScreenshot(path);
+    QVERIFY(result);
+    QCOMPARE(result->path(), QUrl(path));
+    QCOMPARE(waitForResult(result), ScreenshotResult::Finished);
+
+    const QImage image(path, "PNG");
+    QCOMPARE(image.size(), compositor->size() * compositor->devicePixelRatio());
+}
+
+void Ut_ScreenshotService::testSaveToFd()
+{
+    if (!showCompositor()) {
+        QSKIP("The compositor window cannot be rendered");
+    }
+
+    QFile file(tempDir->path() + "/shot.raw");
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const int descriptors = openFileDescriptors();
+
+    ScreenshotOptions options;
+    options.format = ScreenshotOptions::Raw;
+    options.scale = 0.5;
+    ScreenshotResult *result = ScreenshotService::saveScreenshot(file.handle(), options);
+    QVERIFY(result);
+    QCOMPARE(waitForResult(result), ScreenshotResult::Finished);
+
+    // The duplicate is closed and the caller's descriptor is left open
+    QCOMPARE(openFileDescriptors(), descriptors);
+    QVERIFY(::fcntl(file.handle(), F_GETFD) != -1);
+
+    const QSize size = compositor->size() * compositor->devicePixelRatio() * 0.5;
+    QCOMPARE(file.size(), qint64(size.width() * size.height() * 4));
+}
+
+void Ut_ScreenshotService::testUnwritableFd()
+{
+    if (!showCompositor()) {
+        QSKIP("The compositor window cannot be rendered");
+    }
+
+    QFile output(tempDir->path() + "/shot.png");
+    QVERIFY(output.open(QIODevice::WriteOnly));
+    output.close();
+
+    QFile file(output.fileName());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const int descriptors = openFileDescriptors();
+
+    // Writes only fail once they reach the descriptor
+    ScreenshotResult *result = ScreenshotService::saveScreenshot(file.handle(), ScreenshotOptions());
+    QVERIFY(result);
+    QCOMPARE(waitForResult(result), ScreenshotResult::Error);
+
+    QCOMPARE(openFileDescriptors(), descriptors);
+}
+
+void Ut_ScreenshotService::testUnwritablePath()
+{
+    if (!showCompositor()) {
+        QSKIP("The compositor window cannot be rendered");
+    }
+
+    ScreenshotResult *result = ScreenshotService::saveScreenshot(tempDir->path() + "/missing/shot.png");
+    QVERIFY(result);
+    QCOMPARE(waitForResult(result), ScreenshotResult::Error);
+    QVERIFY(!QFile::exists(tempDir->path() + "/missing/shot.png"));
+}
+
+QTEST_MAIN(Ut_ScreenshotService)
@@ -0,0 +1,53 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_SCREENSHOTSERVICE_H
+#define UT_SCREENSHOTSERVICE_H
+
+#include <QObject>
+
+#include "screenshotservice.h"
+
+class LipstickCompositor;
+class QTemporaryDir;
+
+class Ut_ScreenshotService : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testOptionsFromVariantMap();
+    void testFormat();
+    void testNoCompositor();
+    void testEmptyPath();
+    void testInvalidFd();
+    void testNotVisible();
+    void testSaveToPath();
+    void testSaveToFd();
+    void testUnwritableFd();
+    void testUnwritablePath();
+
+private:
+    bool showCompositor();
+
+    LipstickCompositor *compositor;
+    QTemporaryDir *tempDir;
+};
+
+#endif
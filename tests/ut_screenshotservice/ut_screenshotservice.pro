@@ -0,0 +1,23 @@
+include(../common.pri)
+TARGET = ut_screenshotservice
+INCLUDEPATH += $$SRCDIR $$SRCDIR/compositor
+QT += qml quick dbus compositor gui-private
+
+DEFINES += \
+    LIPSTICK_UNIT_TEST_STUB
+
+# unit test and unit
+SOURCES += \
+    ut_screenshotservice.cpp \
+    $$SRCDIR/screenshotservice.cpp \
+    $$SRCDIR/screenshotburst.cpp \
+    $$COMPOSITORSRCDIR/framereadback.cpp \
+    $$STUBSDIR/stubbase.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_screenshotservice.h \
+    $$SRCDIR/screenshotservice.h \
+    $$SRCDIR/screenshotburst.h \
+    $$COMPOSITORSRCDIR/framereadback.h \
+    $$COMPOSITORSRCDIR/lipstickcompositor.h
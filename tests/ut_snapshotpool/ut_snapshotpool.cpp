@@ -0,0 +1,185 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+
+#include "snapshotpool.h"
+#include "ut_snapshotpool.h"
+
+static const qint64 KiB = 1024;
+
+void Ut_SnapshotPool::initTestCase()
+{
+    m_surface = new QOffscreenSurface;
+    m_surface->create();
+
+    m_context = new QOpenGLContext;
+    if (!m_context->create() || !m_context->makeCurrent(m_surface)) {
+        QSKIP("No OpenGL context available");
+    }
+}
+
+void Ut_SnapshotPool::cleanupTestCase()
+{
+    delete m_context;
+    delete m_surface;
+}
+
+void Ut_SnapshotPool::testBucketSize_data()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<QSize>("bucket");
+
+    QTest::newRow("empty") << QSize(0, 0) << QSize(64, 64);
+    QTest::newRow("small") << QSize(1, 1) << QSize(64, 64);
+    QTest::newRow("exact") << QSize(128, 64) << QSize(128, 64);
+    QTest::newRow("above") << QSize(129, 65) << QSize(192, 128);
+    QTest::newRow("screen") << QSize(540, 960) << QSize(576, 960);
+}
+
+void Ut_SnapshotPool::testBucketSize()
+{
+    QFETCH(QSize, size);
+    QFETCH(QSize, bucket);
+
+    QCOMPARE(SnapshotPool::bucketSize(size), bucket);
+}
+
+void Ut_SnapshotPool::testReuse()
+{
+    SnapshotPool pool;
+
+    QOpenGLFramebufferObject *buffer = pool.acquire(QSize(100, 100));
+    QVERIFY(buffer);
+    QCOMPARE(buffer->size(), QSize(128, 128));
+    pool.release(buffer);
+
+    // A different size within the same bucket gets the same buffer back
+    QCOMPARE(pool.acquire(QSize(120, 90)), buffer);
+
+    // While leased it cannot be handed out again
+    QOpenGLFramebufferObject *other = pool.acquire(QSize(128, 128));
+    QVERIFY(other != buffer);
+
+    SnapshotPoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.buffers, 2);
+    QCOMPARE(statistics.idleBuffers, 0);
+    QCOMPARE(statistics.bytes, 2 * 64 * KiB);
+    QCOMPARE(statistics.hits, quint64(1));
+    QCOMPARE(statistics.misses, quint64(2));
+
+    pool.release(other);
+    pool.release(buffer);
+
+    statistics = pool.statistics();
+    QCOMPARE(statistics.idleBuffers, 2);
+    QCOMPARE(statistics.idleBytes, 2 * 64 * KiB);
+}
+
+void Ut_SnapshotPool::testBudget()
+{
+    SnapshotPool pool;
+    pool.setBudget(64 * KiB);
+
+    QOpenGLFramebufferObject *a = pool.acquire(QSize(64, 64));     // 16 KiB
+    QOpenGLFramebufferObject *b = pool.acquire(QSize(128, 64));    // 32 KiB
+    QOpenGLFramebufferObject *c = pool.acquire(QSize(64, 128));    // 32 KiB
+    QCOMPARE(pool.statistics().bytes, 80 * KiB);
+
+    // The least recently released buffer is evicted first
+    pool.release(a);
+    pool.release(b);
+    pool.release(c);
+
+    SnapshotPoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.buffers, 2);
+    QCOMPARE(statistics.bytes, 64 * KiB);
+    QCOMPARE(statistics.evictions, quint64(1));
+
+    // Allocating a new buffer evicts b, and c is still there
+    pool.acquire(QSize(64, 64));
+    QCOMPARE(pool.statistics().evictions, quint64(2));
+    QCOMPARE(pool.acquire(QSize(64, 128)), c);
+
+    statistics = pool.statistics();
+    QCOMPARE(statistics.buffers, 2);
+    QCOMPARE(statistics.idleBuffers, 0);
+    QCOMPARE(statistics.hits, quint64(1));
+    QCOMPARE(statistics.misses, quint64(4));
+}
+
+void Ut_SnapshotPool::testLeasedBuffersExceedBudget()
+{
+    SnapshotPool pool;
+    pool.setBudget(0);
+
+    QOpenGLFramebufferObject *buffer = pool.acquire(QSize(64, 64));
+    QVERIFY(buffer);
+    QCOMPARE(pool.statistics().bytes, 16 * KiB);
+
+    pool.release(buffer);
+
+    const SnapshotPoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.buffers, 0);
+    QCOMPARE(statistics.bytes, qint64(0));
+    QCOMPARE(statistics.evictions, quint64(1));
+}
+
+void Ut_SnapshotPool::testReleaseResources()
+{
+    SnapshotPool pool;
+
+    QOpenGLFramebufferObject *leased = pool.acquire(QSize(64, 64));
+    pool.release(pool.acquire(QSize(128, 128)));
+    QCOMPARE(pool.statistics().buffers, 2);
+
+    pool.releaseResources();
+
+    SnapshotPoolStatistics statistics = pool.statistics();
+    QCOMPARE(statistics.buffers, 1);
+    QCOMPARE(statistics.idleBuffers, 0);
+    QCOMPARE(statistics.bytes, 16 * KiB);
+    QCOMPARE(statistics.evictions, quint64(0));
+
+    pool.release(leased);
+    pool.releaseResources();
+    QCOMPARE(pool.statistics().buffers, 0);
+}
+
+void Ut_SnapshotPool::testTexture()
+{
+    SnapshotPool pool;
+
+    SnapshotTexture *texture = new SnapshotTexture(QSize(96, 32), &pool);
+    QCOMPARE(texture->textureSize(), QSize(96, 32));
+    QCOMPARE(texture->framebufferObject()->size(), QSize(128, 64));
+    QCOMPARE(texture->textureId(), int(texture->framebufferObject()->texture()));
+    QCOMPARE(texture->normalizedTextureSubRect(), QRectF(0, 0, 0.75, 0.5));
+    QCOMPARE(texture->convertToNormalizedSourceRect(QRectF(48, 16, 48, 16)),
+             QRectF(0.375, 0.25, 0.375, 0.25));
+
+    QOpenGLFramebufferObject *buffer = texture->framebufferObject();
+    delete texture;
+    QCOMPARE(pool.statistics().idleBuffers, 1);
+
+    // A snapshot of a smaller window shares the buffer
+    texture = new SnapshotTexture(QSize(128, 50), &pool);
+    QCOMPARE(texture->framebufferObject(), buffer);
+    delete texture;
+}
+
+QTEST_MAIN(Ut_SnapshotPool)
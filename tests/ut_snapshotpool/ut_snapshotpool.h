@@ -0,0 +1,43 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_SNAPSHOTPOOL_H
+#define UT_SNAPSHOTPOOL_H
+
+#include <QObject>
+
+class QOffscreenSurface;
+class QOpenGLContext;
+
+class Ut_SnapshotPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testBucketSize_data();
+    void testBucketSize();
+    void testReuse();
+    void testBudget();
+    void testLeasedBuffersExceedBudget();
+    void testReleaseResources();
+    void testTexture();
+
+private:
+    QOffscreenSurface *m_surface = nullptr;
+    QOpenGLContext *m_context = nullptr;
+};
+
+#endif
@@ -0,0 +1,15 @@
+include(../common.pri)
+TARGET = ut_snapshotpool
+QT += gui quick
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_snapshotpool.cpp \
+    $$COMPOSITORSRCDIR/snapshotpool.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_snapshotpool.h \
+    $$COMPOSITORSRCDIR/snapshotpool.h
@@ -0,0 +1,192 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+
+#include "snapshotpool.h"
+#include "texturedownscaler.h"
+#include "ut_texturedownscaler.h"
+
+static const QSize SourceSize(256, 128);
+static const QSize TargetSize(64, 32);
+
+static quint64 bytes(const QSize &size)
+{
+    return quint64(size.width()) * size.height() * 4;
+}
+
+static bool similar(QRgb a, QRgb b, int tolerance)
+{
+    return qAbs(qRed(a) - qRed(b)) <= tolerance
+            && qAbs(qGreen(a) - qGreen(b)) <= tolerance
+            && qAbs(qBlue(a) - qBlue(b)) <= tolerance;
+}
+
+void Ut_TextureDownscaler::initTestCase()
+{
+    m_surface = new QOffscreenSurface;
+    m_surface->create();
+
+    m_context = new QOpenGLContext;
+    if (!m_context->create() || !m_context->makeCurrent(m_surface)) {
+        QSKIP("No OpenGL context available");
+    }
+}
+
+void Ut_TextureDownscaler::cleanupTestCase()
+{
+    delete m_context;
+    delete m_surface;
+}
+
+void Ut_TextureDownscaler::fill(SnapshotTexture *texture, const QColor &color, const QRect &rect)
+{
+    QOpenGLFunctions *gl = m_context->functions();
+    texture->framebufferObject()->bind();
+    if (rect.isValid()) {
+        gl->glEnable(GL_SCISSOR_TEST);
+        gl->glScissor(rect.x(), rect.y(), rect.width(), rect.height());
+    }
+    gl->glClearColor(color.redF(), color.greenF(), color.blueF(), color.alphaF());
+    gl->glClear(GL_COLOR_BUFFER_BIT);
+    gl->glDisable(GL_SCISSOR_TEST);
+    texture->framebufferObject()->release();
+}
+
+QImage Ut_TextureDownscaler::image(SnapshotTexture *texture)
+{
+    // The texture is in the bottom left corner of the buffer
+    QOpenGLFramebufferObject *buffer = texture->framebufferObject();
+    const QSize size = texture->textureSize();
+    return buffer->toImage().copy(0, buffer->height() - size.height(), size.width(), size.height())
+            .convertToFormat(QImage::Format_ARGB32);
+}
+
+void Ut_TextureDownscaler::testPassSizes_data()
+{
+    QTest::addColumn<QSize>("source");
+    QTest::addColumn<QSize>("target");
+    QTest::addColumn<QList<QSize> >("passes");
+
+    QTest::newRow("same") << QSize(100, 100) << QSize(100, 100)
+                          << (QList<QSize>() << QSize(100, 100));
+    QTest::newRow("within two") << QSize(100, 100) << QSize(60, 60)
+                                << (QList<QSize>() << QSize(60, 60));
+    QTest::newRow("quarter") << SourceSize << TargetSize
+                             << (QList<QSize>() << QSize(128, 64) << TargetSize);
+    QTest::newRow("screen") << QSize(1080, 1920) << QSize(135, 240)
+                            << (QList<QSize>() << QSize(540, 960) << QSize(270, 480) << QSize(135, 240));
+    QTest::newRow("odd") << QSize(301, 99) << QSize(70, 30)
+                         << (QList<QSize>() << QSize(151, 50) << QSize(76, 30) << QSize(70, 30));
+    QTest::newRow("one dimension") << QSize(300, 100) << QSize(70, 100)
+                                   << (QList<QSize>() << QSize(150, 100) << QSize(75, 100) << QSize(70, 100));
+}
+
+void Ut_TextureDownscaler::testPassSizes()
+{
+    QFETCH(QSize, source);
+    QFETCH(QSize, target);
+    QFETCH(QList<QSize>, passes);
+
+    QCOMPARE(TextureDownscaler::passSizes(source, target), passes);
+}
+
+void Ut_TextureDownscaler::testOutputImage()
+{
+    SnapshotPool pool;
+    TextureDownscaler downscaler(&pool);
+
+    SnapshotTexture source(SourceSize, &pool);
+    fill(&source, Qt::red, QRect(0, 0, 128, 64));
+    fill(&source, Qt::green, QRect(0, 64, 128, 64));
+    fill(&source, Qt::blue, QRect(128, 64, 128, 64));
+    // Every fourth column black, which a single bilinear sample per pixel
+    // would either miss or overweight
+    fill(&source, Qt::white, QRect(128, 0, 128, 64));
+    for (int x = 128; x < 256; x += 4)
+        fill(&source, Qt::black, QRect(x, 0, 1, 64));
+
+    SnapshotTexture target(TargetSize, &pool);
+    QVERIFY(downscaler.downscale(&source, &target));
+
+    const QImage reference = image(&source).scaled(TargetSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    const QImage result = image(&target);
+    QCOMPARE(result.size(), TargetSize);
+
+    for (int y = 0; y < TargetSize.height(); ++y) {
+        for (int x = 0; x < TargetSize.width(); ++x) {
+            if (!similar(result.pixel(x, y), reference.pixel(x, y), 3)) {
+                QFAIL(qPrintable(QString("Pixel %1,%2 is %3, expected %4").arg(x).arg(y)
+                        .arg(result.pixel(x, y), 8, 16).arg(reference.pixel(x, y), 8, 16)));
+            }
+        }
+    }
+
+    // The stripes are in the bottom right quarter of the image
+    QVERIFY(similar(result.pixel(48, 24), qRgb(191, 191, 191), 3));
+}
+
+void Ut_TextureDownscaler::testSubRect()
+{
+    SnapshotPool pool;
+    TextureDownscaler downscaler(&pool);
+
+    // The rest of the pooled buffer must not leak into the copy
+    SnapshotTexture source(QSize(200, 100), &pool);
+    QCOMPARE(source.framebufferObject()->size(), QSize(256, 128));
+    fill(&source, Qt::red);
+    fill(&source, Qt::green, QRect(0, 0, 200, 100));
+
+    SnapshotTexture target(QSize(50, 25), &pool);
+    QVERIFY(downscaler.downscale(&source, &target));
+
+    const QImage result = image(&target);
+    for (int y = 0; y < result.height(); ++y) {
+        for (int x = 0; x < result.width(); ++x) {
+            QVERIFY(similar(result.pixel(x, y), qRgb(0, 255, 0), 1));
+        }
+    }
+
+    // Intermediate buffers went back to the pool
+    QCOMPARE(pool.statistics().idleBuffers, 1);
+}
+
+void Ut_TextureDownscaler::testBandwidth()
+{
+    SnapshotPool pool;
+    TextureDownscaler downscaler(&pool);
+
+    SnapshotTexture source(SourceSize, &pool);
+    fill(&source, Qt::white);
+    SnapshotTexture target(TargetSize, &pool);
+
+    QVERIFY(downscaler.downscale(&source, &target));
+
+    const TextureDownscaler::Statistics statistics = downscaler.statistics();
+    QCOMPARE(statistics.updates, quint64(1));
+    QCOMPARE(statistics.passes, quint64(2));
+    QCOMPARE(statistics.bytesRead, bytes(SourceSize) + bytes(QSize(128, 64)));
+    QCOMPARE(statistics.bytesWritten, bytes(QSize(128, 64)) + bytes(TargetSize));
+
+    // Each frame a cover samples a sixteenth of the window, and an update of
+    // the copy costs less than sampling the window twice
+    QCOMPARE(bytes(TargetSize) * 16, bytes(SourceSize));
+    QVERIFY(statistics.bytesRead + statistics.bytesWritten < 2 * bytes(SourceSize));
+}
+
+QTEST_MAIN(Ut_TextureDownscaler)
@@ -0,0 +1,46 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_TEXTUREDOWNSCALER_H
+#define UT_TEXTUREDOWNSCALER_H
+
+#include <QImage>
+#include <QObject>
+
+class QOffscreenSurface;
+class QOpenGLContext;
+class SnapshotTexture;
+
+class Ut_TextureDownscaler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testPassSizes_data();
+    void testPassSizes();
+    void testOutputImage();
+    void testSubRect();
+    void testBandwidth();
+
+private:
+    void fill(SnapshotTexture *texture, const QColor &color, const QRect &rect = QRect());
+    QImage image(SnapshotTexture *texture);
+
+    QOffscreenSurface *m_surface = nullptr;
+    QOpenGLContext *m_context = nullptr;
+};
+
+#endif
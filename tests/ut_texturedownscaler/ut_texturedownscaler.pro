@@ -0,0 +1,17 @@
+include(../common.pri)
+TARGET = ut_texturedownscaler
+QT += gui quick
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_texturedownscaler.cpp \
+    $$COMPOSITORSRCDIR/snapshotpool.cpp \
+    $$COMPOSITORSRCDIR/texturedownscaler.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_texturedownscaler.h \
+    $$COMPOSITORSRCDIR/snapshotpool.h \
+    $$COMPOSITORSRCDIR/texturedownscaler.h
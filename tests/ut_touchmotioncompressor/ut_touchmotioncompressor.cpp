@@ -0,0 +1,248 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "touchmotioncompressor.h"
+#include "ut_touchmotioncompressor.h"
+
+static QTouchEvent::TouchPoint touchPoint(int id, Qt::TouchPointState state, const QPointF &pos, const QPointF &lastPos = QPointF())
+{
+    QTouchEvent::TouchPoint point(id);
+    point.setState(state);
+    point.setPos(pos);
+    point.setLastPos(lastPos.isNull() ? pos : lastPos);
+    return point;
+}
+
+static QTouchEvent touchEvent(QEvent::Type type, const QList<QTouchEvent::TouchPoint> &points, ulong timestamp = 0)
+{
+    Qt::TouchPointStates states = 0;
+    for (const QTouchEvent::TouchPoint &point : points)
+        states |= point.state();
+
+    QTouchEvent event(type, nullptr, Qt::NoModifier, states, points);
+    event.setTimestamp(timestamp);
+    return event;
+}
+
+static QTouchEvent move(int id, const QPointF &pos, const QPointF &lastPos, ulong timestamp = 0)
+{
+    return touchEvent(QEvent::TouchUpdate, QList<QTouchEvent::TouchPoint>() << touchPoint(id, Qt::TouchPointMoved, pos, lastPos), timestamp);
+}
+
+void Ut_TouchMotionCompressor::testDisabled()
+{
+    TouchMotionCompressor compressor;
+    QVERIFY(!compressor.isEnabled());
+
+    for (int i = 0; i < 5; ++i) {
+        const QTouchEvent event = move(0, QPointF(i + 1, 0), QPointF(i, 0));
+        QVERIFY(!compressor.hold(&event, i));
+    }
+    QVERIFY(!compressor.hasPending());
+}
+
+void Ut_TouchMotionCompressor::testFirstMotionDelivered()
+{
+    TouchMotionCompressor compressor;
+    compressor.setEnabled(true);
+
+    const QTouchEvent press = touchEvent(QEvent::TouchBegin, QList<QTouchEvent::TouchPoint>() << touchPoint(0, Qt::TouchPointPressed, QPointF(10, 10)));
+    QVERIFY(!compressor.hold(&press, 0));
+
+    const QTouchEvent first = move(0, QPointF(11, 10), QPointF(10, 10));
+    QVERIFY(!compressor.hold(&first, 4));
+    QVERIFY(!compressor.hasPending());
+}
+
+void Ut_TouchMotionCompressor::testMotionCoalescedUntilFrame()
+{
+    TouchMotionCompressor compressor;
+    compressor.setEnabled(true);
+
+    const QTouchEvent first = move(0, QPointF(1, 0), QPointF(0, 0), 100);
+    QVERIFY(!compressor.hold(&first, 0));
+
+    // A 240 Hz panel reports four times per 60 Hz frame
+    for (int i = 1; i <= 4; ++i) {
+        const QTouchEvent event = move(0, QPointF(i + 1, 0), QPointF(i, 0), 100 + i * 4);
+        QVERIFY(compressor.hold(&event, i * 4));
+    }
+
+    QVERIFY(compressor.hasPending());
+    QCOMPARE(compressor.pendingCount(), 4);
+    QCOMPARE(compressor.pendingAge(20), qint64(16));
+
+    QVERIFY(compressor.frameSent());
+    const QTouchEvent coalesced = compressor.takePending(20);
+    QVERIFY(!compressor.hasPending());
+    QCOMPARE(coalesced.type(), QEvent::TouchUpdate);
+    QCOMPARE(coalesced.timestamp(), ulong(116));
+    QCOMPARE(coalesced.touchPointStates(), Qt::TouchPointStates(Qt::TouchPointMoved));
+    QCOMPARE(coalesced.touchPoints().count(), 1);
+    QCOMPARE(coalesced.touchPoints().at(0).pos(), QPointF(5, 0));
+    // Moved all the way from where the first held motion started
+    QCOMPARE(coalesced.touchPoints().at(0).lastPos(), QPointF(1, 0));
+
+    // The coalesced motion waits for a frame too
+    const QTouchEvent next = move(0, QPointF(6, 0), QPointF(5, 0));
+    QVERIFY(compressor.hold(&next, 24));
+}
+
+void Ut_TouchMotionCompressor::testFrameWithoutMotion()
+{
+    TouchMotionCompressor compressor;
+    compressor.setEnabled(true);
+
+    const QTouchEvent first = move(0, QPointF(1, 0), QPointF(0, 0));
+    QVERIFY(!compressor.hold(&first, 0));
+
+    // Nothing held, the next motion is delivered right away
+    QVERIFY(!compressor.frameSent());
+    const QTouchEvent second = move(0, QPointF(2, 0), QPointF(1, 0));
+    QVERIFY(!compressor.hold(&second, 16));
+}
+
+void Ut_TouchMotionCompressor::testTransitionsNeverHeld()
+{
+    TouchMotionCompressor compressor;
+    compressor.setEnabled(true);
+
+    const QTouchEvent first = move(0, QPointF(1, 0), QPointF(0, 0));
+    QVERIFY(!compressor.hold(&first, 0));
+    const QTouchEvent second = move(0, QPointF(2, 0), QPointF(1, 0));
+    QVERIFY(compressor.hold(&second, 4));
+
+    // A second finger while motion is held
+    const QTouchEvent press = touchEvent(QEvent::TouchUpdate, QList<QTouchEvent::TouchPoint>()
+                                         << touchPoint(0, Qt::TouchPointStationary, QPointF(2, 0))
+                                         << touchPoint(1, Qt::TouchPointPressed, QPointF(50, 50)));
+    QVERIFY(!compressor.hold(&press, 8));
+    // The held motion stays for the caller to deliver first
+    QVERIFY(compressor.hasPending());
+    compressor.takePending(8);
+
+    const QTouchEvent release = touchEvent(QEvent::TouchEnd, QList<QTouchEvent::TouchPoint>()
+                                           << touchPoint(0, Qt::TouchPointReleased, QPointF(2, 0)));
+    QVERIFY(!compressor.hold(&release, 12));
+
+    const QTouchEvent cancel = touchEvent(QEvent::TouchCancel, QList<QTouchEvent::TouchPoint>());
+    QVERIFY(!compressor.hold(&cancel, 12));
+}
+
+void Ut_TouchMotionCompressor::testPointsMerged()
+{
+    TouchMotionCompressor compressor;
+    compressor.setEnabled(true);
+
+    const QTouchEvent first = move(0, QPointF(1, 0), QPointF(0, 0));
+    QVERIFY(!compressor.hold(&first, 0));
+
+    const QTouchEvent both = touchEvent(QEvent::TouchUpdate, QList<QTouchEvent::TouchPoint>()
+                                        << touchPoint(0, Qt::TouchPointMoved, QPointF(2, 0), QPointF(1, 0))
+                                        << touchPoint(1, Qt::TouchPointMoved, QPointF(50, 51), QPointF(50, 50)));
+    QVERIFY(compressor.hold(&both, 4));
+
+    // Only the first finger moves, the second one is stationary since
+    const QTouchEvent one = touchEvent(QEvent::TouchUpdate, QList<QTouchEvent::TouchPoint>()
+                                       << touchPoint(0, Qt::TouchPointMoved, QPointF(3, 0), QPointF(2, 0))
+                                       << touchPoint(1, Qt::TouchPointStationary, QPointF(50, 51)));
+    QVERIFY(compressor.hold(&one, 8));
+
+    const QTouchEvent coalesced = compressor.takePending(16);
+    const QList<QTouchEvent::TouchPoint> points = coalesced.touchPoints();
+    QCOMPARE(points.count(), 2);
+    QCOMPARE(points.at(0).id(), 0);
+    QCOMPARE(points.at(0).pos(), QPointF(3, 0));
+    QCOMPARE(points.at(0).lastPos(), QPointF(1, 0));
+    QCOMPARE(points.at(1).id(), 1);
+    QCOMPARE(points.at(1).pos(), QPointF(50, 51));
+    // Still moved over the coalesced interval
+    QCOMPARE(points.at(1).state(), Qt::TouchPointMoved);
+    QCOMPARE(points.at(1).lastPos(), QPointF(50, 50));
+}
+
+void Ut_TouchMotionCompressor::testMaximumHold()
+{
+    TouchMotionCompressor compressor;
+    compressor.setEnabled(true);
+
+    const QTouchEvent first = move(0, QPointF(1, 0), QPointF(0, 0));
+    QVERIFY(!compressor.hold(&first, 0));
+    const QTouchEvent second = move(0, QPointF(2, 0), QPointF(1, 0));
+    QVERIFY(compressor.hold(&second, 10));
+
+    // The client never drew, motion goes out anyway once it has waited long enough
+    const QTouchEvent late = move(0, QPointF(3, 0), QPointF(2, 0));
+    QVERIFY(!compressor.hold(&late, TouchMotionCompressor::MaximumHold));
+    QVERIFY(compressor.hasPending());
+}
+
+void Ut_TouchMotionCompressor::testHeldMotionDueWithoutEvent()
+{
+    TouchMotionCompressor compressor;
+    compressor.setEnabled(true);
+    QCOMPARE(compressor.dueIn(0), qint64(-1));
+
+    const QTouchEvent first = move(0, QPointF(1, 0), QPointF(0, 0));
+    QVERIFY(!compressor.hold(&first, 0));
+    QCOMPARE(compressor.dueIn(0), qint64(-1));
+    const QTouchEvent second = move(0, QPointF(2, 0), QPointF(1, 0));
+    QVERIFY(compressor.hold(&second, 10));
+
+    // Counted from the motion delivered before, not from when it was held
+    QCOMPARE(compressor.dueIn(10), qint64(TouchMotionCompressor::MaximumHold - 10));
+    QCOMPARE(compressor.dueIn(TouchMotionCompressor::MaximumHold), qint64(0));
+    QCOMPARE(compressor.dueIn(TouchMotionCompressor::MaximumHold + 50), qint64(0));
+
+    // Nothing follows the held motion, it is taken when due
+    const QTouchEvent due = compressor.takePending(TouchMotionCompressor::MaximumHold);
+    QCOMPARE(due.touchPoints().count(), 1);
+    QCOMPARE(due.touchPoints().at(0).pos(), QPointF(2, 0));
+    QVERIFY(!compressor.hasPending());
+    QCOMPARE(compressor.dueIn(TouchMotionCompressor::MaximumHold), qint64(-1));
+
+    // The motion taken waits for a frame as well, the hold starts over from it
+    const QTouchEvent third = move(0, QPointF(3, 0), QPointF(2, 0));
+    QVERIFY(compressor.hold(&third, TouchMotionCompressor::MaximumHold + 20));
+    QCOMPARE(compressor.dueIn(TouchMotionCompressor::MaximumHold + 20), qint64(TouchMotionCompressor::MaximumHold - 20));
+}
+
+void Ut_TouchMotionCompressor::testReset()
+{
+    TouchMotionCompressor compressor;
+    compressor.setEnabled(true);
+
+    const QTouchEvent first = move(0, QPointF(1, 0), QPointF(0, 0));
+    QVERIFY(!compressor.hold(&first, 0));
+    const QTouchEvent second = move(0, QPointF(2, 0), QPointF(1, 0));
+    QVERIFY(compressor.hold(&second, 4));
+
+    compressor.reset();
+    QVERIFY(!compressor.hasPending());
+    QCOMPARE(compressor.pendingAge(8), qint64(0));
+
+    // A new touch sequence starts without waiting for a frame
+    const QTouchEvent next = move(0, QPointF(10, 0), QPointF(9, 0));
+    QVERIFY(!compressor.hold(&next, 8));
+
+    // Disabling drops held motion as well
+    const QTouchEvent held = move(0, QPointF(11, 0), QPointF(10, 0));
+    QVERIFY(compressor.hold(&held, 12));
+    compressor.setEnabled(false);
+    QVERIFY(!compressor.hasPending());
+}
+
+QTEST_MAIN(Ut_TouchMotionCompressor)
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_touchmotioncompressor
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_touchmotioncompressor.cpp \
+    $$COMPOSITORSRCDIR/touchmotioncompressor.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_touchmotioncompressor.h \
+    $$COMPOSITORSRCDIR/touchmotioncompressor.h
@@ -8,10 +8,12 @@ INCLUDEPATH += $$TOUCHSCREENSRCDIR $$UTILITYSRCDIR $$SRCDIR/xtools $$DEVICESTATE
 
 SOURCES += ut_touchscreen.cpp \
     $$TOUCHSCREENSRCDIR/touchscreen.cpp \
+    $$UTILITYSRCDIR/inputlatencyrecorder.cpp \
     $$STUBSDIR/homeapplication.cpp \
     $$STUBSDIR/stubbase.cpp
 
 HEADERS += ut_touchscreen.h \
     $$TOUCHSCREENSRCDIR/touchscreen.h \
+    $$UTILITYSRCDIR/inputlatencyrecorder.h \
     $$DEVICESTATE/displaystate.h \
     $$SRCDIR/homeapplication.h
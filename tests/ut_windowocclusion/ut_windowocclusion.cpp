@@ -0,0 +1,303 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QSGSimpleRectNode>
+#include <private/qquickitem_p.h>
+
+#include "windowocclusion.h"
+#include "ut_windowocclusion.h"
+
+static const QSize WindowSize(400, 400);
+
+// Counts how many times it is rendered, which a culled subtree never is
+class CountingNode : public QSGSimpleRectNode
+{
+public:
+    CountingNode(const QRectF &rect)
+        : QSGSimpleRectNode(rect, Qt::white)
+    {
+        setFlag(UsePreprocess);
+    }
+
+    void preprocess() override
+    {
+        ++rendered;
+    }
+
+    static int rendered;
+};
+
+int CountingNode::rendered = 0;
+
+class CountingItem : public QQuickItem
+{
+public:
+    explicit CountingItem(QQuickItem *parent)
+        : QQuickItem(parent)
+    {
+        setFlag(ItemHasContents);
+    }
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override
+    {
+        CountingNode *node = static_cast<CountingNode *>(oldNode);
+        if (!node)
+            node = new CountingNode(boundingRect());
+        else
+            node->setRect(boundingRect());
+        return node;
+    }
+};
+
+static bool isCulled(QQuickItem *item)
+{
+    return QQuickItemPrivate::get(item)->culled;
+}
+
+void Ut_WindowOcclusion::initTestCase()
+{
+    QQuickWindow window;
+    window.resize(WindowSize);
+    new CountingItem(window.contentItem());
+    if (window.grabWindow().isNull()) {
+        QSKIP("Cannot render the test scene");
+    }
+}
+
+void Ut_WindowOcclusion::init()
+{
+    m_window = new QQuickWindow;
+    m_window->resize(WindowSize);
+    m_occlusion = new WindowOcclusion(m_window);
+
+    // Home screen content below the windows is never culled
+    m_home = new CountingItem(m_window->contentItem());
+    m_home->setSize(WindowSize);
+}
+
+void Ut_WindowOcclusion::cleanup()
+{
+    delete m_window;
+    m_window = nullptr;
+    m_occlusion = nullptr;
+    m_home = nullptr;
+}
+
+QQuickItem *Ut_WindowOcclusion::addWindow(const QRect &geometry, QQuickItem *parent)
+{
+    QQuickItem *item = new CountingItem(parent ? parent : m_window->contentItem());
+    item->setPosition(geometry.topLeft());
+    item->setSize(geometry.size());
+
+    m_occlusion->addWindow(item);
+    m_occlusion->setOpaqueRegion(item, QRect(QPoint(0, 0), geometry.size()));
+    return item;
+}
+
+int Ut_WindowOcclusion::renderedNodes()
+{
+    m_occlusion->update();
+
+    CountingNode::rendered = 0;
+    m_window->grabWindow();
+    return CountingNode::rendered;
+}
+
+void Ut_WindowOcclusion::testStackingOrder()
+{
+    QQuickItem *a = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QQuickItem *b = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QQuickItem *child = addWindow(QRect(10, 10, 100, 100), b);
+
+    QVERIFY(WindowOcclusion::isAbove(b, a));
+    QVERIFY(!WindowOcclusion::isAbove(a, b));
+    QVERIFY(WindowOcclusion::isAbove(child, b));
+    QVERIFY(WindowOcclusion::isAbove(child, a));
+    QVERIFY(!WindowOcclusion::isAbove(a, a));
+
+    a->setZ(1);
+    QVERIFY(WindowOcclusion::isAbove(a, b));
+    QVERIFY(WindowOcclusion::isAbove(a, child));
+
+    child->setZ(-1);
+    QVERIFY(WindowOcclusion::isAbove(b, child));
+}
+
+void Ut_WindowOcclusion::testFullscreenWindowCoversBelow()
+{
+    QQuickItem *a = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QQuickItem *b = addWindow(QRect(QPoint(0, 0), WindowSize));
+
+    QCOMPARE(renderedNodes(), 2);
+    QVERIFY(m_occlusion->isOccluded(a));
+    QVERIFY(!m_occlusion->isOccluded(b));
+    QVERIFY(isCulled(a));
+    QCOMPARE(m_occlusion->occludedCount(), 1);
+}
+
+void Ut_WindowOcclusion::testPartialCover()
+{
+    QQuickItem *a = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QQuickItem *b = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QCOMPARE(renderedNodes(), 2);
+
+    b->setX(100);
+    QCOMPARE(renderedNodes(), 3);
+    QVERIFY(!m_occlusion->isOccluded(a));
+    QVERIFY(!isCulled(a));
+
+    // Only the part of the window above that is on the screen covers
+    a->setWidth(50);
+    a->setX(150);
+    QCOMPARE(renderedNodes(), 2);
+}
+
+void Ut_WindowOcclusion::testTranslucentWindowDoesNotCover()
+{
+    QQuickItem *a = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QQuickItem *b = addWindow(QRect(QPoint(0, 0), WindowSize));
+
+    b->setOpacity(0.5);
+    QCOMPARE(renderedNodes(), 3);
+    QVERIFY(!m_occlusion->isOccluded(a));
+
+    b->setOpacity(1);
+    QCOMPARE(renderedNodes(), 2);
+
+    // Scaled windows do not cover either
+    b->setScale(0.99);
+    QCOMPARE(renderedNodes(), 3);
+
+    b->setScale(1);
+    b->setVisible(false);
+    QCOMPARE(renderedNodes(), 2);
+    QVERIFY(!m_occlusion->isOccluded(a));
+}
+
+void Ut_WindowOcclusion::testOpaqueRegion()
+{
+    QQuickItem *a = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QQuickItem *b = addWindow(QRect(QPoint(0, 0), WindowSize));
+
+    m_occlusion->setOpaqueRegion(b, QRect(0, 0, 400, 200));
+    QCOMPARE(renderedNodes(), 3);
+
+    a->setHeight(200);
+    QCOMPARE(renderedNodes(), 2);
+    QVERIFY(m_occlusion->isOccluded(a));
+
+    m_occlusion->setOpaqueRegion(b, QRegion());
+    QCOMPARE(renderedNodes(), 3);
+}
+
+void Ut_WindowOcclusion::testRaiseAndLower()
+{
+    QQuickItem *a = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QQuickItem *b = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QCOMPARE(renderedNodes(), 2);
+    QVERIFY(m_occlusion->isOccluded(a));
+
+    a->setZ(1);
+    QCOMPARE(renderedNodes(), 2);
+    QVERIFY(!m_occlusion->isOccluded(a));
+    QVERIFY(m_occlusion->isOccluded(b));
+    QVERIFY(isCulled(b));
+    QVERIFY(!isCulled(a));
+
+    a->setZ(0);
+    QCOMPARE(renderedNodes(), 2);
+    QVERIFY(m_occlusion->isOccluded(a));
+    QVERIFY(!isCulled(b));
+}
+
+void Ut_WindowOcclusion::testRemoveWindow()
+{
+    QQuickItem *a = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QQuickItem *b = addWindow(QRect(QPoint(0, 0), WindowSize));
+    QCOMPARE(renderedNodes(), 2);
+
+    // A window that is no longer tracked is rendered as usual
+    m_occlusion->removeWindow(a);
+    QVERIFY(!isCulled(a));
+    QCOMPARE(renderedNodes(), 3);
+
+    // Nor does it cover others anymore
+    m_occlusion->addWindow(a);
+    m_occlusion->removeWindow(b);
+    QCOMPARE(renderedNodes(), 3);
+    QCOMPARE(m_occlusion->occludedCount(), 0);
+
+    delete b;
+    QCOMPARE(renderedNodes(), 2);
+}
+
+void Ut_WindowOcclusion::testShownChildKeepsParent()
+{
+    QQuickItem *a = addWindow(QRect(0, 0, 200, 400));
+    QQuickItem *child = addWindow(QRect(200, 0, 200, 400), a);
+    QQuickItem *b = addWindow(QRect(0, 0, 200, 400));
+
+    // Culling the parent would hide the child as well
+    QCOMPARE(renderedNodes(), 4);
+    QVERIFY(!m_occlusion->isOccluded(a));
+    QVERIFY(!m_occlusion->isOccluded(child));
+
+    b->setWidth(400);
+    QCOMPARE(renderedNodes(), 2);
+    QVERIFY(m_occlusion->isOccluded(a));
+    QVERIFY(m_occlusion->isOccluded(child));
+}
+
+void Ut_WindowOcclusion::testIncrementalUpdate()
+{
+    QQuickItem *a = addWindow(QRect(0, 0, 100, 100));
+    QQuickItem *b = addWindow(QRect(100, 0, 100, 100));
+    QQuickItem *c = addWindow(QRect(200, 0, 100, 100));
+
+    m_occlusion->update();
+    QCOMPARE(m_occlusion->updatedCount(), 3);
+
+    m_occlusion->update();
+    QCOMPARE(m_occlusion->updatedCount(), 0);
+
+    // Only the windows from the change downwards are recomputed
+    a->setX(10);
+    m_occlusion->update();
+    QCOMPARE(m_occlusion->updatedCount(), 1);
+
+    b->setX(110);
+    m_occlusion->update();
+    QCOMPARE(m_occlusion->updatedCount(), 2);
+
+    c->setX(210);
+    m_occlusion->update();
+    QCOMPARE(m_occlusion->updatedCount(), 3);
+
+    // Raising the bottom window changes the order from the top
+    a->setZ(1);
+    m_occlusion->update();
+    QCOMPARE(m_occlusion->updatedCount(), 3);
+
+    // Removing the bottom window leaves the coverage of the others as it was
+    m_occlusion->removeWindow(b);
+    m_occlusion->update();
+    QCOMPARE(m_occlusion->updatedCount(), 0);
+    QCOMPARE(m_occlusion->occludedCount(), 0);
+}
+
+QTEST_MAIN(Ut_WindowOcclusion)
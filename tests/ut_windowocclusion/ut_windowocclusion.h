@@ -0,0 +1,52 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_WINDOWOCCLUSION_H
+#define UT_WINDOWOCCLUSION_H
+
+#include <QObject>
+#include <QRect>
+
+class QQuickItem;
+class QQuickWindow;
+class WindowOcclusion;
+
+class Ut_WindowOcclusion : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void testStackingOrder();
+    void testFullscreenWindowCoversBelow();
+    void testPartialCover();
+    void testTranslucentWindowDoesNotCover();
+    void testOpaqueRegion();
+    void testRaiseAndLower();
+    void testRemoveWindow();
+    void testShownChildKeepsParent();
+    void testIncrementalUpdate();
+
+private:
+    QQuickItem *addWindow(const QRect &geometry, QQuickItem *parent = nullptr);
+    int renderedNodes();
+
+    QQuickWindow *m_window = nullptr;
+    WindowOcclusion *m_occlusion = nullptr;
+    QQuickItem *m_home = nullptr;
+};
+
+#endif
@@ -0,0 +1,15 @@
+include(../common.pri)
+TARGET = ut_windowocclusion
+QT += quick quick-private
+
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_windowocclusion.cpp \
+    $$COMPOSITORSRCDIR/windowocclusion.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_windowocclusion.h \
+    $$COMPOSITORSRCDIR/windowocclusion.h
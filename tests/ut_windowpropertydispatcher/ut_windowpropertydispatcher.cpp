@@ -0,0 +1,251 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "lipstickcompositor_stub.h"
+#include "lipstickcompositorwindow_stub.h"
+#include "windowproperty.h"
+#include "windowpropertydispatcher.h"
+#include "ut_windowpropertydispatcher.h"
+
+void Ut_WindowPropertyDispatcher::initTestCase()
+{
+    compositor = new LipstickCompositor;
+    gLipstickCompositorStub->stubSetReturnValue("instance", compositor);
+}
+
+void Ut_WindowPropertyDispatcher::cleanupTestCase()
+{
+    gLipstickCompositorStub->stubSetReturnValue("instance", static_cast<LipstickCompositor *>(nullptr));
+    delete compositor;
+}
+
+void Ut_WindowPropertyDispatcher::init()
+{
+    dispatcher = new WindowPropertyDispatcher(compositor);
+    compositor->m_windowProperties = dispatcher;
+}
+
+void Ut_WindowPropertyDispatcher::cleanup()
+{
+    qDeleteAll(compositor->m_windows);
+    compositor->m_windows.clear();
+    compositor->m_windowProperties = nullptr;
+    delete dispatcher;
+}
+
+// The windows have no surface, so their WINID is set on the dispatcher directly
+LipstickCompositorWindow *Ut_WindowPropertyDispatcher::addWindow(int windowId, uint link)
+{
+    LipstickCompositorWindow *window = new LipstickCompositorWindow(windowId, QString(), nullptr);
+    compositor->m_windows.insert(windowId, window);
+    if (link)
+        dispatcher->updateLink(window, link);
+    return window;
+}
+
+WindowProperty *Ut_WindowPropertyDispatcher::createProperty(int windowId, const QString &name)
+{
+    WindowProperty *property = new WindowProperty;
+    property->setWindowId(windowId);
+    property->setProperty(name);
+    return property;
+}
+
+void Ut_WindowPropertyDispatcher::testChangesCoalesced()
+{
+    LipstickCompositorWindow *first = addWindow(1);
+    LipstickCompositorWindow *second = addWindow(2);
+    QScopedPointer<WindowProperty> firstA(createProperty(1, "A"));
+    QScopedPointer<WindowProperty> otherFirstA(createProperty(1, "A"));
+    QScopedPointer<WindowProperty> firstB(createProperty(1, "B"));
+    QScopedPointer<WindowProperty> secondA(createProperty(2, "A"));
+
+    QSignalSpy firstASpy(firstA.data(), SIGNAL(valueChanged()));
+    QSignalSpy otherFirstASpy(otherFirstA.data(), SIGNAL(valueChanged()));
+    QSignalSpy firstBSpy(firstB.data(), SIGNAL(valueChanged()));
+    QSignalSpy secondASpy(secondA.data(), SIGNAL(valueChanged()));
+
+    dispatcher->propertyChanged(first, "A");
+    dispatcher->propertyChanged(first, "A");
+    dispatcher->propertyChanged(first, "C");
+    dispatcher->propertyChanged(first, "A");
+
+    // Nothing is delivered from within the change
+    QCOMPARE(firstASpy.count(), 0);
+    QCOMPARE(otherFirstASpy.count(), 0);
+
+    QTRY_COMPARE(firstASpy.count(), 1);
+    QCOMPARE(otherFirstASpy.count(), 1);
+    QCOMPARE(firstBSpy.count(), 0);
+    QCOMPARE(secondASpy.count(), 0);
+    QVERIFY(dispatcher->m_changed.isEmpty());
+
+    dispatcher->propertyChanged(first, "B");
+    dispatcher->propertyChanged(second, "A");
+    QTRY_COMPARE(firstBSpy.count(), 1);
+    QCOMPARE(secondASpy.count(), 1);
+    QCOMPARE(firstASpy.count(), 1);
+    QCOMPARE(otherFirstASpy.count(), 1);
+}
+
+void Ut_WindowPropertyDispatcher::testUnsubscribedWhilePending()
+{
+    LipstickCompositorWindow *window = addWindow(1);
+    QScopedPointer<WindowProperty> moved(createProperty(1, "A"));
+    QScopedPointer<WindowProperty> kept(createProperty(1, "A"));
+    QScopedPointer<WindowProperty> last(createProperty(1, "B"));
+
+    dispatcher->propertyChanged(window, "A");
+    dispatcher->propertyChanged(window, "B");
+
+    // Moving to another property tells the item itself
+    moved->setProperty("C");
+    last->setWindowId(2);
+
+    QSignalSpy movedSpy(moved.data(), SIGNAL(valueChanged()));
+    QSignalSpy keptSpy(kept.data(), SIGNAL(valueChanged()));
+    QSignalSpy lastSpy(last.data(), SIGNAL(valueChanged()));
+
+    // The change of a property nobody observes any longer is dropped
+    QVERIFY(!dispatcher->m_changed.contains(qMakePair(1, QString("B"))));
+    QVERIFY(!dispatcher->m_subscribers.contains(qMakePair(1, QString("B"))));
+
+    QTRY_COMPARE(keptSpy.count(), 1);
+    QCOMPARE(movedSpy.count(), 0);
+    QCOMPARE(lastSpy.count(), 0);
+    QVERIFY(dispatcher->m_changed.isEmpty());
+}
+
+void Ut_WindowPropertyDispatcher::testDestroyedWhilePending()
+{
+    LipstickCompositorWindow *window = addWindow(1);
+    WindowProperty *destroyed = createProperty(1, "A");
+    QScopedPointer<WindowProperty> kept(createProperty(1, "A"));
+    QSignalSpy keptSpy(kept.data(), SIGNAL(valueChanged()));
+
+    dispatcher->propertyChanged(window, "A");
+    delete destroyed;
+
+    QTRY_COMPARE(keptSpy.count(), 1);
+    QCOMPARE(dispatcher->m_subscribers.value(qMakePair(1, QString("A"))).count(), 1);
+}
+
+void Ut_WindowPropertyDispatcher::testLinkReplaced()
+{
+    addWindow(1);
+    LipstickCompositorWindow *linked = addWindow(2, 42);
+    LipstickCompositorWindow *sameLink = addWindow(3, 42);
+    QScopedPointer<WindowProperty> property(new WindowProperty);
+
+    // The first window with the WINID is the one linked to
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 42), 2);
+    QCOMPARE(dispatcher->windowIdForLink(1, 42), 2);
+
+    QSignalSpy spy(property.data(), SIGNAL(valueChanged()));
+
+    // Another window of the client with the same WINID takes its place
+    dispatcher->windowRemoved(linked);
+    QCOMPARE(dispatcher->windowIdForLink(1, 42), 3);
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 42), 3);
+
+    // A window taking the WINID of the linked one does not replace it
+    LipstickCompositorWindow *later = addWindow(4, 42);
+    QTest::qWait(10);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 42), 3);
+
+    // Changing the WINID of the linked window hands the link on
+    dispatcher->updateLink(sameLink, 43);
+    QTRY_COMPARE(spy.count(), 2);
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 42), 4);
+
+    dispatcher->windowRemoved(later);
+    QTRY_COMPARE(spy.count(), 3);
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 42), 0);
+    QVERIFY(!dispatcher->m_links.contains(qMakePair(qint64(0), uint(42))));
+}
+
+void Ut_WindowPropertyDispatcher::testLinkChangedOnce()
+{
+    LipstickCompositorWindow *window = addWindow(1);
+    LipstickCompositorWindow *linked = addWindow(2, 42);
+    addWindow(3, 42);
+    QScopedPointer<WindowProperty> property(createProperty(1, "A"));
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 42), 2);
+
+    QSignalSpy spy(property.data(), SIGNAL(valueChanged()));
+
+    // Both the property and the window it links to change
+    dispatcher->propertyChanged(window, "A");
+    dispatcher->windowRemoved(linked);
+    QTRY_COMPARE(spy.count(), 1);
+    QTest::qWait(10);
+    QCOMPARE(spy.count(), 1);
+}
+
+void Ut_WindowPropertyDispatcher::testResolveOtherLink()
+{
+    addWindow(1);
+    LipstickCompositorWindow *first = addWindow(2, 42);
+    QScopedPointer<WindowProperty> property(new WindowProperty);
+    QScopedPointer<WindowProperty> other(new WindowProperty);
+
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 42), 2);
+    QCOMPARE(dispatcher->resolveLink(other.data(), 1, 42), 2);
+
+    // The property now links to a WINID no window has yet
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 43), 0);
+    QCOMPARE(dispatcher->m_linkWatchers.value(qMakePair(qint64(0), uint(42))).count(), 1);
+
+    QSignalSpy spy(property.data(), SIGNAL(valueChanged()));
+    QSignalSpy otherSpy(other.data(), SIGNAL(valueChanged()));
+
+    dispatcher->windowRemoved(first);
+    QTRY_COMPARE(otherSpy.count(), 1);
+    QCOMPARE(spy.count(), 0);
+
+    addWindow(3, 43);
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(otherSpy.count(), 1);
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 43), 3);
+
+    // Links are resolved through an existing sibling only
+    QCOMPARE(dispatcher->resolveLink(property.data(), 5, 43), 0);
+    QVERIFY(!dispatcher->m_watchedLinks.contains(property.data()));
+}
+
+void Ut_WindowPropertyDispatcher::testUnwatchedWhilePending()
+{
+    addWindow(1);
+    LipstickCompositorWindow *linked = addWindow(2, 42);
+    QScopedPointer<WindowProperty> property(new WindowProperty);
+    QCOMPARE(dispatcher->resolveLink(property.data(), 1, 42), 2);
+
+    QSignalSpy spy(property.data(), SIGNAL(valueChanged()));
+
+    dispatcher->windowRemoved(linked);
+    QVERIFY(!dispatcher->m_changedLinks.isEmpty());
+    dispatcher->unwatchLink(property.data());
+    QVERIFY(dispatcher->m_changedLinks.isEmpty());
+    QVERIFY(dispatcher->m_linkWatchers.isEmpty());
+
+    QTest::qWait(10);
+    QCOMPARE(spy.count(), 0);
+}
+
+QTEST_MAIN(Ut_WindowPropertyDispatcher)
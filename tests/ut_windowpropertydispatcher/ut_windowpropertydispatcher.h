@@ -0,0 +1,51 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_WINDOWPROPERTYDISPATCHER_H
+#define UT_WINDOWPROPERTYDISPATCHER_H
+
+#include <QObject>
+
+class LipstickCompositor;
+class LipstickCompositorWindow;
+class WindowProperty;
+class WindowPropertyDispatcher;
+
+class Ut_WindowPropertyDispatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testChangesCoalesced();
+    void testUnsubscribedWhilePending();
+    void testDestroyedWhilePending();
+    void testLinkReplaced();
+    void testLinkChangedOnce();
+    void testResolveOtherLink();
+    void testUnwatchedWhilePending();
+
+private:
+    LipstickCompositorWindow *addWindow(int windowId, uint link = 0);
+    WindowProperty *createProperty(int windowId, const QString &name);
+
+    LipstickCompositor *compositor;
+    WindowPropertyDispatcher *dispatcher;
+};
+
+#endif
@@ -0,0 +1,24 @@
+include(../common.pri)
+TARGET = ut_windowpropertydispatcher
+INCLUDEPATH += $$COMPOSITORSRCDIR
+QT += qml quick dbus compositor gui-private
+
+DEFINES += \
+    LIPSTICK_UNIT_TEST_STUB
+
+# unit test and unit
+SOURCES += \
+    ut_windowpropertydispatcher.cpp \
+    $$COMPOSITORSRCDIR/windowpropertydispatcher.cpp \
+    $$COMPOSITORSRCDIR/windowproperty.cpp \
+    $$COMPOSITORSRCDIR/regionhittest.cpp \
+    $$COMPOSITORSRCDIR/touchmotioncompressor.cpp \
+    $$STUBSDIR/stubbase.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_windowpropertydispatcher.h \
+    $$COMPOSITORSRCDIR/windowpropertydispatcher.h \
+    $$COMPOSITORSRCDIR/windowproperty.h \
+    $$COMPOSITORSRCDIR/lipstickcompositor.h \
+    $$COMPOSITORSRCDIR/lipstickcompositorwindow.h
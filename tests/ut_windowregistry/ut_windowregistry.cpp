@@ -0,0 +1,292 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "lipstickcompositor_stub.h"
+#include "lipstickcompositorwindow_stub.h"
+#include "windowmodel.h"
+#include "windowregistry.h"
+#include "ut_windowregistry.h"
+
+static const int TitleRole = Qt::UserRole + 3;
+
+class TestWindow : public LipstickCompositorWindow
+{
+public:
+    TestWindow(int windowId, const QString &title)
+        : LipstickCompositorWindow(windowId, QString(), nullptr)
+        , m_title(title)
+    {
+    }
+
+    QString title() const override
+    {
+        return m_title;
+    }
+
+    void setTitle(const QString &title)
+    {
+        m_title = title;
+        emit titleChanged();
+    }
+
+private:
+    QString m_title;
+};
+
+// Lists the windows added while approve is set
+class TestWindowModel : public WindowModel
+{
+public:
+    bool approve = true;
+
+protected:
+    bool approveWindow(LipstickCompositorWindow *) override
+    {
+        return approve;
+    }
+};
+
+void Ut_WindowRegistry::initTestCase()
+{
+    compositor = new LipstickCompositor;
+    gLipstickCompositorStub->stubSetReturnValue("instance", compositor);
+}
+
+void Ut_WindowRegistry::cleanupTestCase()
+{
+    gLipstickCompositorStub->stubSetReturnValue("instance", static_cast<LipstickCompositor *>(nullptr));
+    delete compositor;
+}
+
+void Ut_WindowRegistry::init()
+{
+    registry = new WindowRegistry(compositor);
+    compositor->m_windowRegistry = registry;
+}
+
+void Ut_WindowRegistry::cleanup()
+{
+    compositor->m_mappedSurfaces.clear();
+    qDeleteAll(compositor->m_windows);
+    compositor->m_windows.clear();
+    compositor->m_windowRegistry = nullptr;
+    delete registry;
+}
+
+TestWindow *Ut_WindowRegistry::addWindow(int windowId, const QString &title)
+{
+    TestWindow *window = new TestWindow(windowId, title);
+    compositor->m_windows.insert(windowId, window);
+    compositor->m_mappedSurfaces.insert(windowId, window);
+    registry->windowAdded(windowId);
+    return window;
+}
+
+void Ut_WindowRegistry::removeWindow(int windowId)
+{
+    compositor->m_mappedSurfaces.remove(windowId);
+    registry->windowRemoved(windowId);
+    delete compositor->m_windows.take(windowId);
+}
+
+bool Ut_WindowRegistry::rowsConsistent(WindowModel *model) const
+{
+    if (model->m_rows.count() != model->m_items.count())
+        return false;
+
+    for (int row = 0; row < model->m_items.count(); ++row) {
+        if (model->m_rows.value(model->m_items.at(row), -1) != row)
+            return false;
+    }
+    return true;
+}
+
+void Ut_WindowRegistry::testInsert()
+{
+    TestWindowModel model;
+    model.componentComplete();
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+    addWindow(1, "first");
+    addWindow(2, "second");
+    addWindow(3, "third");
+
+    QCOMPARE(inserted.count(), 3);
+    for (int row = 0; row < 3; ++row) {
+        QCOMPARE(inserted.at(row).at(1).toInt(), row);
+        QCOMPARE(inserted.at(row).at(2).toInt(), row);
+        QCOMPARE(model.windowId(row), row + 1);
+    }
+    QCOMPARE(model.rowCount(), 3);
+    QVERIFY(rowsConsistent(&model));
+    QCOMPARE(model.data(model.index(1, 0), TitleRole).toString(), QString("second"));
+}
+
+void Ut_WindowRegistry::testRemove()
+{
+    TestWindowModel model;
+    model.componentComplete();
+    for (int windowId = 1; windowId <= 5; ++windowId)
+        addWindow(windowId);
+
+    QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+
+    // First, middle and last rows
+    removeWindow(1);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.last().at(1).toInt(), 0);
+    QCOMPARE(model.m_items, QList<int>() << 2 << 3 << 4 << 5);
+    QVERIFY(rowsConsistent(&model));
+
+    removeWindow(4);
+    QCOMPARE(removed.count(), 2);
+    QCOMPARE(removed.last().at(1).toInt(), 2);
+    QCOMPARE(model.m_items, QList<int>() << 2 << 3 << 5);
+    QVERIFY(rowsConsistent(&model));
+
+    removeWindow(5);
+    QCOMPARE(removed.count(), 3);
+    QCOMPARE(removed.last().at(1).toInt(), 2);
+    QCOMPARE(model.m_items, QList<int>() << 2 << 3);
+    QVERIFY(rowsConsistent(&model));
+
+    // A window already removed is not removed again
+    removeWindow(4);
+    QCOMPARE(removed.count(), 3);
+
+    addWindow(6);
+    QCOMPARE(model.m_items, QList<int>() << 2 << 3 << 6);
+    QVERIFY(rowsConsistent(&model));
+
+    removeWindow(2);
+    QCOMPARE(removed.last().at(1).toInt(), 0);
+    QCOMPARE(model.m_items, QList<int>() << 3 << 6);
+    QVERIFY(rowsConsistent(&model));
+}
+
+void Ut_WindowRegistry::testTitleChanged()
+{
+    TestWindowModel model;
+    model.componentComplete();
+    addWindow(1, "first");
+    addWindow(2, "second");
+    TestWindow *third = addWindow(3, "third");
+    removeWindow(1);
+
+    QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+
+    // Changes are passed on once the event loop runs
+    third->setTitle("changed");
+    third->setTitle("changed again");
+    QCOMPARE(changed.count(), 0);
+    QTRY_COMPARE(changed.count(), 1);
+
+    QCOMPARE(changed.at(0).at(0).value<QModelIndex>().row(), 1);
+    QCOMPARE(changed.at(0).at(1).value<QModelIndex>().row(), 1);
+    QCOMPARE(changed.at(0).at(2).value<QVector<int> >(), QVector<int>() << TitleRole);
+    QCOMPARE(model.data(model.index(1, 0), TitleRole).toString(), QString("changed again"));
+
+    // Title changes leave the rows as they are
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(model.m_items, QList<int>() << 2 << 3);
+    QVERIFY(rowsConsistent(&model));
+
+    // Setting the same title again is not a change
+    third->setTitle("changed again");
+    QTest::qWait(10);
+    QCOMPARE(changed.count(), 1);
+}
+
+void Ut_WindowRegistry::testTitleChangedThenRemoved()
+{
+    TestWindowModel model;
+    model.componentComplete();
+    TestWindow *first = addWindow(1, "first");
+    addWindow(2, "second");
+
+    QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+
+    first->setTitle("changed");
+    removeWindow(1);
+    QTest::qWait(10);
+
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(model.m_items, QList<int>() << 2);
+    QVERIFY(rowsConsistent(&model));
+}
+
+void Ut_WindowRegistry::testRejectedWindow()
+{
+    TestWindowModel model;
+    model.componentComplete();
+    addWindow(1, "first");
+    model.approve = false;
+    TestWindow *rejected = addWindow(2, "second");
+    model.approve = true;
+    TestWindow *third = addWindow(3, "third");
+
+    QCOMPARE(model.m_items, QList<int>() << 1 << 3);
+    QVERIFY(rowsConsistent(&model));
+
+    QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+
+    // Windows not listed by the model are not passed on to it
+    rejected->setTitle("changed");
+    QTest::qWait(10);
+    QCOMPARE(changed.count(), 0);
+
+    removeWindow(2);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(model.m_items, QList<int>() << 1 << 3);
+    QVERIFY(rowsConsistent(&model));
+
+    third->setTitle("changed");
+    QTRY_COMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).value<QModelIndex>().row(), 1);
+}
+
+void Ut_WindowRegistry::testRefresh()
+{
+    addWindow(1);
+    addWindow(2);
+    addWindow(3);
+
+    // Created after the windows were added, the model lists them on refresh
+    TestWindowModel model;
+    model.componentComplete();
+    QCOMPARE(model.rowCount(), 3);
+    QVERIFY(rowsConsistent(&model));
+
+    QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    const int row = model.m_rows.value(2);
+    removeWindow(2);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.last().at(1).toInt(), row);
+    QCOMPARE(model.rowCount(), 2);
+    QVERIFY(!model.m_rows.contains(2));
+    QVERIFY(rowsConsistent(&model));
+
+    QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    static_cast<TestWindow *>(compositor->m_windows.value(3))->setTitle("changed");
+    QTRY_COMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).value<QModelIndex>().row(), model.m_rows.value(3));
+}
+
+QTEST_MAIN(Ut_WindowRegistry)
@@ -0,0 +1,51 @@
+/***************************************************************************
+**
+** Copyright (c) 2026 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_WINDOWREGISTRY_H
+#define UT_WINDOWREGISTRY_H
+
+#include <QObject>
+
+class LipstickCompositor;
+class WindowModel;
+class WindowRegistry;
+class TestWindow;
+
+class Ut_WindowRegistry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testInsert();
+    void testRemove();
+    void testTitleChanged();
+    void testTitleChangedThenRemoved();
+    void testRejectedWindow();
+    void testRefresh();
+
+private:
+    TestWindow *addWindow(int windowId, const QString &title = QString());
+    void removeWindow(int windowId);
+    bool rowsConsistent(WindowModel *model) const;
+
+    LipstickCompositor *compositor;
+    WindowRegistry *registry;
+};
+
+#endif
@@ -0,0 +1,26 @@
+include(../common.pri)
+TARGET = ut_windowregistry
+INCLUDEPATH += $$COMPOSITORSRCDIR $$UTILITYSRCDIR
+QT += qml quick dbus compositor gui-private
+
+DEFINES += \
+    LIPSTICK_UNIT_TEST_STUB
+
+# unit test and unit
+SOURCES += \
+    ut_windowregistry.cpp \
+    $$COMPOSITORSRCDIR/windowregistry.cpp \
+    $$COMPOSITORSRCDIR/windowmodel.cpp \
+    $$COMPOSITORSRCDIR/regionhittest.cpp \
+    $$COMPOSITORSRCDIR/touchmotioncompressor.cpp \
+    $$UTILITYSRCDIR/processinfocache.cpp \
+    $$STUBSDIR/stubbase.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_windowregistry.h \
+    $$COMPOSITORSRCDIR/windowregistry.h \
+    $$COMPOSITORSRCDIR/windowmodel.h \
+    $$COMPOSITORSRCDIR/lipstickcompositor.h \
+    $$COMPOSITORSRCDIR/lipstickcompositorwindow.h \
+    $$UTILITYSRCDIR/processinfocache.h